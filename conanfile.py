@@ -51,7 +51,7 @@ class LibConan(ConanFile):
     default_options = 'gtest:shared=False', 'gtest:build_gmock=True'
 
     exports = 'vcs_info.py', 'vcs_data'
-    exports_sources = 'CMakeLists.txt', 'src/*', 'src-test/*', 'include/*', 'cmake/*', 'license*'
+    exports_sources = 'CMakeLists.txt', 'src/*', 'src-test/*', 'src-bench/*', 'include/*', 'cmake/*', 'license*'
     no_copy_source = True
 
     generators = 'cmake'
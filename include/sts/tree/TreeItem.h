@@ -30,11 +30,89 @@
 */
 
 #include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
 #include "TreeItemContainers.h"
 
 namespace sts {
 namespace tree {
 
+    template<typename ITEM>
+    class TreeItemParallelCloner;
+
+    /********************************************************************************************************/
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /********************************************************************************************************/
+
+    /*!
+     * \details The default dispatch of \link sts::tree::TreeItem \endlink.
+     *          It declares the tree item methods as virtual, so your type and the layers
+     *          like \link sts::tree::TreeItemRootCache \endlink can override them.
+     * \see \link sts::tree::TreeItemStaticDispatch \endlink
+     * \tparam TYPE your type.
+     * \tparam CONTAINER container type.
+     */
+    template<typename TYPE, typename CONTAINER>
+    class TreeItemVirtualDispatch : public TreeItemContainerTraits<CONTAINER>::Hook {
+    public:
+
+        typedef std::size_t Index;
+        typedef CONTAINER Children;
+
+        virtual ~TreeItemVirtualDispatch() = default;
+
+        virtual bool isRoot() const = 0;
+        virtual TYPE * root() = 0;
+        virtual const TYPE * root() const = 0;
+
+        virtual void setParent(TYPE * inOutParent) = 0;
+        virtual TYPE * parent() = 0;
+        virtual const TYPE * parent() const = 0;
+
+        virtual Index childrenCount() const = 0;
+        virtual TYPE * childAt(Index index) = 0;
+        virtual const TYPE * childAt(Index index) const = 0;
+        virtual TYPE * takeChildAt(Index index) = 0;
+        virtual const Children & children() const = 0;
+
+        virtual TYPE * prependChild(TYPE * inOutItem) = 0;
+        virtual TYPE * insertChild(Index where, TYPE * inOutItem) = 0;
+        virtual TYPE * appendChild(TYPE * inOutItem) = 0;
+        virtual void reserveChildren(Index count) = 0;
+
+        virtual void deleteChild(Index index) = 0;
+        virtual bool deleteChild(TYPE * inOutItem) = 0;
+        virtual void deleteChildren() = 0;
+
+        virtual bool hasChildren() const = 0;
+        virtual Index indexOf(const TYPE * item) const = 0;
+
+        virtual bool isLeaf() const = 0;
+        virtual bool isBranch() const = 0;
+        virtual bool isChildOf(const TYPE * parent) const = 0;
+
+        virtual TYPE * clone() const = 0;
+
+    protected:
+
+        virtual void childAdded(TYPE * child) = 0;
+        virtual void childRemoved(TYPE * child) = 0;
+
+        /*! \details The default clone returns nullptr, TYPE may have no copy constructor. */
+        typedef std::false_type CopyByDefault;
+
+        /*!
+         * \details The hooks and the clone method are called through the tree item itself,
+         *          the virtual call reaches the overridden ones.
+         */
+        template<typename ITEM>
+        static ITEM * dispatch(ITEM * item) {
+            return item;
+        }
+
+    };
+
     /********************************************************************************************************/
     //////////////////////////////////////////////////////////////////////////////////////////////////////////
     /********************************************************************************************************/
@@ -44,10 +122,47 @@ namespace tree {
      * \pre
      *      - You can use one of the two predefined containers \link sts::tree::TreeItemContainerVector \endlink and \link sts::tree::TreeItemContainerList \endlink.
      *      - You can specify you own container type, look at \link sts::tree::TreeItemContainerVector \endlink and \link sts::tree::TreeItemContainerList \endlink for example.
+     *      - If the tree items are often re-parented or asked for their index use
+     *  \link sts::tree::TreeItemContainerSlotVector \endlink or \link sts::tree::TreeItemContainerSlotList \endlink,
+     *  each child keeps its position in those containers (the container's Hook type is inherited by the tree item).
+     *      - \link sts::tree::TreeItemContainerIntrusiveList \endlink links the children with the sibling pointers
+     *  kept inside the tree items, so adding and removing a child don't allocate memory.
+     *      - If the tree items have a lot of children which are accessed and changed by index use
+     *  \link sts::tree::TreeItemContainerBTree \endlink, it does those operations in O(log(n)).
+     *      - If most of the tree items have a few children use \link sts::tree::TreeItemContainerSmallVector \endlink,
+     *  it keeps the first N children without the memory allocation.
+     *      - If the children are often added to the front use \link sts::tree::TreeItemContainerGapVector \endlink,
+     *  it prepends and appends in amortized O(1) and still accesses the children by index in O(1).
+     *      - A custom container must provide operator[], erase(index), insert(index, item), push_front, push_back,
+     *  size, empty and the forward iterators. The other members of the predefined containers are optional,
+     *  see \link sts::tree::TreeItemContainerTraits \endlink.
+     *      - The methods are virtual by default. If you don't need to override them use
+     *  \link sts::tree::TreeItemStatic \endlink, it is the same class with \link sts::tree::TreeItemStaticDispatch \endlink.
      *      - You must not use this class directly.
      *      - The tree item is owner of its children.
      *  When tree item is being destroyed it destroys all its children and remove itself from its parent.
+     *  The children are destroyed without recursion, so the hierarchy may be as deep as the memory allows.
+     *      - The children are deleted with the operator delete, so the items may be allocated in a per-tree pool,
+     *  see \link sts::tree::TreeItemPool \endlink.
+     *      - The item is notified about each added and removed child with the \link TreeItem::childAdded \endlink
+     *  and \link TreeItem::childRemoved \endlink methods, the layers like \link sts::tree::TreeItemRootCache \endlink and
+     *  \link sts::tree::TreeItemAggregate \endlink (subtree sizes, sums, min and max in O(1)) use them
+     *  to keep their data up to date.
+     *      - If only a small part of a huge hierarchy is visited use \link sts::tree::TreeItemLazy \endlink,
+     *  it makes the children on demand and can unload the cold subtrees.
+     *  The traversals get the children with \link TreeItem::loadedChildren \endlink which the layer hides,
+     *  so the visited items are loaded by them too.
+     *      - If the children are often found by a key (like the files by their names) use
+     *  \link sts::tree::TreeItemKeyIndex \endlink, it finds a child by its key in O(1).
      *      - If you need to use copy constructor and operator you must implement \link TreeItem::clone() \endlink method.
+     *  The copy constructor clones the hierarchy without recursion and reserves each children list once.
+     *  The items copied by the clone method get their children after the method returns,
+     *  so the copy constructors of your type don't see the children of the nested copies.
+     *  If the clones are allocated in a \link sts::tree::TreeItemPool \endlink reserve the pool for the whole hierarchy,
+     *  then all the clones are in one block. The big hierarchies can be cloned with several threads
+     *  by \link sts::tree::TreeItemParallelCloner \endlink.
+     *      - The move constructor and operator transfer the children without cloning,
+     *  the moved-from item keeps its parent and has no children.
      * \warning You should be careful for working with the copy operator and constructor!<br>
      *          If you don't actually need to use it define one in your derived class in the private level.<br>
      *          <b> It is necessarily! </b><br>
@@ -60,89 +175,106 @@ namespace tree {
      * 
      * \tparam TYPE your type.
      * \tparam CONTAINER container type.
+     * \tparam DISPATCH whether the methods are virtual, \link sts::tree::TreeItemVirtualDispatch \endlink
+     *                  or \link sts::tree::TreeItemStaticDispatch \endlink.
      */
-    template<typename TYPE, typename CONTAINER = TreeItemContainerVector<TYPE>>
-    class TreeItem {
+    template<typename TYPE, typename CONTAINER = TreeItemContainerVector<TYPE>,
+             typename DISPATCH = TreeItemVirtualDispatch<TYPE, CONTAINER>>
+    class TreeItem : public DISPATCH {
     protected:
 
-        TreeItem(const TreeItem<TYPE, CONTAINER> & copy);
-        TreeItem<TYPE, CONTAINER> & operator =(const TreeItem<TYPE, CONTAINER> & copy);
+        TreeItem(const TreeItem<TYPE, CONTAINER, DISPATCH> & copy);
+        TreeItem<TYPE, CONTAINER, DISPATCH> & operator =(const TreeItem<TYPE, CONTAINER, DISPATCH> & copy);
+        TreeItem(TreeItem<TYPE, CONTAINER, DISPATCH> && other);
+        TreeItem<TYPE, CONTAINER, DISPATCH> & operator =(TreeItem<TYPE, CONTAINER, DISPATCH> && other);
 
     public:
 
         typedef std::size_t Index;    /*!< \details Tree item index. */
-        const Index npos = Index(-1); /*!< \details Means no position. */
+        static const Index npos = Index(-1); /*!< \details Means no position. */
         typedef CONTAINER Children;
+        typedef TreeItem<TYPE, CONTAINER, DISPATCH> TreeBase; /*!< \details The class which implements the hierarchy. */
 
         //---------------------------------------------------------------
         /// @{ 
 
         TreeItem();
-        explicit TreeItem(TreeItem<TYPE, CONTAINER> * inOutParent);
-        virtual ~TreeItem();
+        explicit TreeItem(TreeItem<TYPE, CONTAINER, DISPATCH> * inOutParent);
+        ~TreeItem();
 
         /// @}
         //---------------------------------------------------------------
         /// @{
 
-        virtual bool isRoot() const;
-        virtual TYPE * root();
-        virtual const TYPE * root() const;
+        bool isRoot() const;
+        TYPE * root();
+        const TYPE * root() const;
 
         /// @}
         //---------------------------------------------------------------
         /// @{
 
-        virtual void setParent(TYPE * inOutParent);
-        virtual TYPE * parent();
-        virtual const TYPE * parent() const;
+        void setParent(TYPE * inOutParent);
+        TYPE * parent();
+        const TYPE * parent() const;
 
         /// @}
         //---------------------------------------------------------------
         /// @{
 
-        virtual Index childrenCount() const;
-        virtual TYPE * childAt(Index index);
-        virtual const TYPE * childAt(Index index) const;
-        virtual TYPE * takeChildAt(Index index);
-        virtual const Children & children() const;
+        Index childrenCount() const;
+        TYPE * childAt(Index index);
+        const TYPE * childAt(Index index) const;
+        TYPE * takeChildAt(Index index);
+        const Children & children() const;
+        const Children & loadedChildren() const;
 
         /// @}
         //---------------------------------------------------------------
         /// @{
 
-        virtual TYPE * prependChild(TYPE * inOutItem);
-        virtual TYPE * insertChild(Index where, TYPE * inOutItem);
-        virtual TYPE * appendChild(TYPE * inOutItem);
+        TYPE * prependChild(TYPE * inOutItem);
+        TYPE * insertChild(Index where, TYPE * inOutItem);
+        TYPE * appendChild(TYPE * inOutItem);
 
         /// @}
         //---------------------------------------------------------------
         /// @{
 
-        virtual void deleteChild(Index index);
-        virtual bool deleteChild(TYPE * inOutItem);
-        virtual void deleteChildren();
+        template<typename ITERATOR>
+        void insertChildren(Index where, ITERATOR first, ITERATOR last);
+        template<typename ITERATOR>
+        void appendChildren(ITERATOR first, ITERATOR last);
+        void reserveChildren(Index count);
 
         /// @}
         //---------------------------------------------------------------
         /// @{
 
-        virtual bool hasChildren() const;
-        virtual Index indexOf(const TYPE * item) const;
+        void deleteChild(Index index);
+        bool deleteChild(TYPE * inOutItem);
+        void deleteChildren();
 
         /// @}
         //---------------------------------------------------------------
         /// @{
 
-        virtual bool isLeaf() const;
-        virtual bool isBranch() const;
-        virtual bool isChildOf(const TYPE * parent) const;
+        bool hasChildren() const;
+        Index indexOf(const TYPE * item) const;
 
         /// @}
         //---------------------------------------------------------------
         /// @{
 
-        virtual TYPE * clone() const;
+        bool isLeaf() const;
+        bool isBranch() const;
+        bool isChildOf(const TYPE * parent) const;
+
+        /// @}
+        //---------------------------------------------------------------
+        /// @{
+
+        TYPE * clone() const;
 
         /// @}
         //---------------------------------------------------------------
@@ -151,15 +283,47 @@ namespace tree {
 
         Children & children();
 
+        //---------------------------------------------------------------
+        /// @{
+
+        void childAdded(TYPE * child);
+        void childRemoved(TYPE * child);
+
+        /// @}
+        //---------------------------------------------------------------
+
     private:
 
-        TYPE * mParent;
+        TreeItem * mParent; /*!< \details It is the base pointer, so it may be set while the parent is under construction. */
         Children mChildren;
         bool mRemoveFromParent;
+        bool mClonePending;
 
-        void removeFromContainer(Children * inOutContainer, const TreeItem * item);
         void cloneContainer(const Children * container);
+        void takeChildren(TreeItem & other, bool notify);
         void removeParent();
+        TYPE * selfOf(TreeItem * complete);
+
+        void notifyAdded(TYPE * child);
+        void notifyRemoved(TYPE * child);
+        TYPE * cloneDefault(std::false_type) const;
+        TYPE * cloneDefault(std::true_type) const;
+
+        typedef TreeItemContainerTraits<CONTAINER> Traits;
+        typedef std::vector<std::pair<TreeItem *, const Children *>> CloningList;
+
+        template<typename ITEM>
+        friend class TreeItemParallelCloner;
+
+        static TYPE * cloneItem(const TYPE * item, CloningList & outPending);
+        static void cloneChildren(TreeItem * item, const Children * children, CloningList & outPending);
+
+        static void deleteItems(const Children & items);
+        static std::vector<TYPE*> *& deletingItems();
+        static CloningList *& cloningItems();
+        typename CloningList::value_type * pendingCloning() const;
+        void dropPendingCloning();
+        void takePendingCloning(TreeItem & other);
 
         static const TreeItem * extractRoot(const TreeItem * item);
         static TreeItem * extractRoot(TreeItem * item);
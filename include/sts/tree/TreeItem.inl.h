@@ -30,41 +30,74 @@
 */
 
 #include <cassert>
+#include <algorithm>
+#include <utility>
+#include <iterator>
+#include <vector>
 
 namespace sts {
 namespace tree {
 
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    const typename TreeItem<TYPE, CONTAINER, DISPATCH>::Index TreeItem<TYPE, CONTAINER, DISPATCH>::npos;
+
     /**************************************************************************************************/
     ////////////////////////////////////////////////////////////////////////////////////////////////////
     /**************************************************************************************************/
 
     /*!
      * \details Constructor copy.
-     * \warning This constructor needs the \link TreeItem::clone \endlink to be implemented!
+     * \warning This constructor needs the \link TreeItem::clone \endlink to be implemented
+     *          if the item has the virtual methods (it is so by default)!
      *          The constructor will clone all children of the input tree item 
      *          with the \link TreeItem::clone \endlink method.
+     * \note If the copy is made by \link TreeItem::clone \endlink while a hierarchy is being cloned
+     *       its children are cloned after the clone method returns, so the copy has no children
+     *       in the copy constructors of the derived types.
      */
-    template<typename TYPE, typename CONTAINER>
-    TreeItem<TYPE, CONTAINER>::TreeItem(const TreeItem<TYPE, CONTAINER> & copy)
-        : mParent(nullptr),
-          mRemoveFromParent(true) {
-        cloneContainer(&copy.mChildren);
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    TreeItem<TYPE, CONTAINER, DISPATCH>::TreeItem(const TreeItem<TYPE, CONTAINER, DISPATCH> & copy)
+        : DISPATCH(),
+          mParent(nullptr),
+          mRemoveFromParent(true),
+          mClonePending(false) {
+        const auto * pending = copy.pendingCloning();
+        cloneContainer(pending ? pending->second : &copy.mChildren);
+    }
+
+    /*!
+     * \details Constructor move.
+     *          The constructed item takes all the children of the specified item without cloning,
+     *          the specified item keeps its parent and has no children after that.
+     *          The constructed item has no parent.
+     * \note It takes O(children count) time and doesn't allocate memory.
+     * \param [in, out] other
+     */
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    TreeItem<TYPE, CONTAINER, DISPATCH>::TreeItem(TreeItem<TYPE, CONTAINER, DISPATCH> && other)
+        : DISPATCH(),
+          mParent(nullptr),
+          mRemoveFromParent(true),
+          mClonePending(false) {
+        takeChildren(other, false);
     }
 
     /*! \details Constructor default */
-    template<typename TYPE, typename CONTAINER>
-    TreeItem<TYPE, CONTAINER>::TreeItem()
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    TreeItem<TYPE, CONTAINER, DISPATCH>::TreeItem()
         : mParent(nullptr),
-          mRemoveFromParent(true) {}
+          mRemoveFromParent(true),
+          mClonePending(false) {}
 
     /*!
      * \details Constructor init parent.
      * \param[in, out] inOutParent
      */
-    template<typename TYPE, typename CONTAINER>
-    TreeItem<TYPE, CONTAINER>::TreeItem(TreeItem<TYPE, CONTAINER> * inOutParent)
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    TreeItem<TYPE, CONTAINER, DISPATCH>::TreeItem(TreeItem<TYPE, CONTAINER, DISPATCH> * inOutParent)
         : mParent(nullptr),
-          mRemoveFromParent(true) {
+          mRemoveFromParent(true),
+          mClonePending(false) {
         assert(inOutParent);
         TreeItem::setParent(static_cast<TYPE*>(inOutParent));
     }
@@ -72,16 +105,18 @@ namespace tree {
     /*!
      * \details Destructor
      * \warning The destructor destroys all the item's children and removes this item from its parent.
+     * \note The destructor is virtual only if the item has the virtual methods,
+     *       with \link sts::tree::TreeItemStaticDispatch \endlink the items must be deleted as TYPE.
      */
-    template<typename TYPE, typename CONTAINER>
-    TreeItem<TYPE, CONTAINER>::~TreeItem() {
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    TreeItem<TYPE, CONTAINER, DISPATCH>::~TreeItem() {
+        if (mClonePending) {
+            dropPendingCloning();
+        }
         if (mRemoveFromParent) {
             TreeItem::setParent(nullptr);
         }
-        for (auto & it : mChildren) {
-            it->mRemoveFromParent = false;
-            delete it;
-        }
+        deleteItems(mChildren);
     }
 
     /**************************************************************************************************/
@@ -96,17 +131,39 @@ namespace tree {
      *         Operator will delete all existing item's children and
      *         copy children from specified item with the \link TreeItem::clone \endlink method.
      */
-    template<typename TYPE, typename CONTAINER>
-    TreeItem<TYPE, CONTAINER> & TreeItem<TYPE, CONTAINER>::operator =(const TreeItem<TYPE, CONTAINER> & copy) {
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    TreeItem<TYPE, CONTAINER, DISPATCH> & TreeItem<TYPE, CONTAINER, DISPATCH>::operator =(const TreeItem<TYPE, CONTAINER, DISPATCH> & copy) {
         assert(this != &copy);
         if (this != &copy) {
-            TreeItem<TYPE, CONTAINER> tmp(copy);
+            TreeItem<TYPE, CONTAINER, DISPATCH> tmp(copy);
             deleteChildren();
-            for (auto & it : tmp.mChildren) {
-                it->mParent = static_cast<TYPE*>(this);
-                mChildren.push_back(it);
+            std::swap(mChildren, tmp.mChildren); // tmp can't delete clones now
+            takePendingCloning(tmp);
+            for (auto & it : mChildren) {
+                it->mParent = this;
+                notifyAdded(it);
             }
-            tmp.mChildren.clear(); // tmp can't delete clones now
+        }
+        return *this;
+    }
+
+    /*!
+     * \details Operator move.
+     *          The item's children are deleted and the item takes all the children of the specified item
+     *          without cloning, the specified item keeps its parent and has no children after that.
+     * \note It takes O(children count) time and doesn't allocate memory.
+     * \pre The items must not be each other's descendants,
+     *      detach the specified item first if you need to replace this item's children with its children.
+     * \remark Position in the tree hierarchy (parent) will not be changed.
+     * \param [in, out] other
+     */
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    TreeItem<TYPE, CONTAINER, DISPATCH> & TreeItem<TYPE, CONTAINER, DISPATCH>::operator =(TreeItem<TYPE, CONTAINER, DISPATCH> && other) {
+        assert(this != &other);
+        if (this != &other) {
+            assert(!isChildOf(static_cast<TYPE*>(&other)));
+            assert(!other.isChildOf(static_cast<TYPE*>(this)));
+            takeChildren(other, true);
         }
         return *this;
     }
@@ -119,27 +176,29 @@ namespace tree {
      * \details Checks whether the item has a parent. No parent means the item is root.
      * \return True if the item is root otherwise false.
      */
-    template<typename TYPE, typename CONTAINER>
-    bool TreeItem<TYPE, CONTAINER>::isRoot() const {
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    bool TreeItem<TYPE, CONTAINER, DISPATCH>::isRoot() const {
         return (mParent == nullptr);
     }
 
     /*!
-     * \details Gets the tree hierarchy root (recursive by parents up to the root).
+     * \details Gets the tree hierarchy root (walks by parents up to the root).
+     * \note The search takes O(depth) time, use \link sts::tree::TreeItemRootCache \endlink if you need O(1) amortized.
      * \return Root of the tree hierarchy.
      */
-    template<typename TYPE, typename CONTAINER>
-    TYPE * TreeItem<TYPE, CONTAINER>::root() {
-        return static_cast<TYPE *>(TreeItem<TYPE, CONTAINER>::extractRoot(this));
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    TYPE * TreeItem<TYPE, CONTAINER, DISPATCH>::root() {
+        return static_cast<TYPE *>(TreeItem<TYPE, CONTAINER, DISPATCH>::extractRoot(this));
     }
 
     /*!
-     * \details Gets the tree hierarchy root (recursive by parents up to the root).
+     * \details Gets the tree hierarchy root (walks by parents up to the root).
+     * \note The search takes O(depth) time, use \link sts::tree::TreeItemRootCache \endlink if you need O(1) amortized.
      * \return Root of the tree hierarchy.
      */
-    template<typename TYPE, typename CONTAINER>
-    const TYPE * TreeItem<TYPE, CONTAINER>::root() const {
-        return static_cast<const TYPE *>(TreeItem<TYPE, CONTAINER>::extractRoot(this));
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    const TYPE * TreeItem<TYPE, CONTAINER, DISPATCH>::root() const {
+        return static_cast<const TYPE *>(TreeItem<TYPE, CONTAINER, DISPATCH>::extractRoot(this));
     }
 
     /*!
@@ -147,12 +206,12 @@ namespace tree {
      * \param [in] item Tree item whose root must be found.
      * \return Constant pointer to the root.
      */
-    template<typename TYPE, typename CONTAINER>
-    const TreeItem<TYPE, CONTAINER> * TreeItem<TYPE, CONTAINER>::extractRoot(const TreeItem<TYPE, CONTAINER> * item) {
-        if (item->isRoot()) {
-            return item;
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    const TreeItem<TYPE, CONTAINER, DISPATCH> * TreeItem<TYPE, CONTAINER, DISPATCH>::extractRoot(const TreeItem<TYPE, CONTAINER, DISPATCH> * item) {
+        while (item->mParent) {
+            item = item->mParent;
         }
-        return TreeItem<TYPE, CONTAINER>::extractRoot(item->parent());
+        return item;
     }
 
     /*!
@@ -160,12 +219,12 @@ namespace tree {
      * \param [in] item Tree item whose root must be found.
      * \return Pointer to the root.
      */
-    template<typename TYPE, typename CONTAINER>
-    TreeItem<TYPE, CONTAINER> * TreeItem<TYPE, CONTAINER>::extractRoot(TreeItem<TYPE, CONTAINER> * item) {
-        if (item->isRoot()) {
-            return item;
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    TreeItem<TYPE, CONTAINER, DISPATCH> * TreeItem<TYPE, CONTAINER, DISPATCH>::extractRoot(TreeItem<TYPE, CONTAINER, DISPATCH> * item) {
+        while (item->mParent) {
+            item = item->mParent;
         }
-        return TreeItem<TYPE, CONTAINER>::extractRoot(item->parent());
+        return item;
     }
 
     /**************************************************************************************************/
@@ -177,8 +236,8 @@ namespace tree {
      * \remark You can set parent as the nullptr then the item will be as a root.
      * \param [in, out] inOutParent pointer to new parent.
      */
-    template<typename TYPE, typename CONTAINER>
-    void TreeItem<TYPE, CONTAINER>::setParent(TYPE * inOutParent) {
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    void TreeItem<TYPE, CONTAINER, DISPATCH>::setParent(TYPE * inOutParent) {
         if (mParent == inOutParent) {
             return;
         }
@@ -186,7 +245,7 @@ namespace tree {
             removeParent();
         }
         else {
-            inOutParent->appendChild(static_cast<TYPE*>(this));
+            inOutParent->appendChild(selfOf(inOutParent));
         }
     }
 
@@ -194,18 +253,18 @@ namespace tree {
      * \details Gets the item's parent.
      * \return If the item has the parent then pointer to it otherwise nullptr.
      */
-    template<typename TYPE, typename CONTAINER>
-    TYPE * TreeItem<TYPE, CONTAINER>::parent() {
-        return mParent;
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    TYPE * TreeItem<TYPE, CONTAINER, DISPATCH>::parent() {
+        return static_cast<TYPE*>(mParent);
     }
 
     /*!
      * \details Gets the item's parent.
      * \return Pointer to item's parent or nullptr if the parent isn't set.
      */
-    template<typename TYPE, typename CONTAINER>
-    const TYPE * TreeItem<TYPE, CONTAINER>::parent() const {
-        return mParent;
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    const TYPE * TreeItem<TYPE, CONTAINER, DISPATCH>::parent() const {
+        return static_cast<const TYPE*>(mParent);
     }
 
     /**************************************************************************************************/
@@ -216,8 +275,8 @@ namespace tree {
      * \details Gets the item children's count.
      * \return Children's count.
      */
-    template<typename TYPE, typename CONTAINER>
-    size_t TreeItem<TYPE, CONTAINER>::childrenCount() const {
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    size_t TreeItem<TYPE, CONTAINER, DISPATCH>::childrenCount() const {
         return mChildren.size();
     }
 
@@ -226,8 +285,8 @@ namespace tree {
      * \param [in] index
      * \return Pointer to the child.
      */
-    template<typename TYPE, typename CONTAINER>
-    TYPE * TreeItem<TYPE, CONTAINER>::childAt(const Index index) {
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    TYPE * TreeItem<TYPE, CONTAINER, DISPATCH>::childAt(const Index index) {
         assert(index < mChildren.size());
         return mChildren[index];
     }
@@ -237,8 +296,8 @@ namespace tree {
      * \param [in] index
      * \return Pointer to the child.
      */
-    template<typename TYPE, typename CONTAINER>
-    const TYPE * TreeItem<TYPE, CONTAINER>::childAt(const Index index) const {
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    const TYPE * TreeItem<TYPE, CONTAINER, DISPATCH>::childAt(const Index index) const {
         assert(index < mChildren.size());
         return mChildren[index];
     }
@@ -249,12 +308,13 @@ namespace tree {
      * \param [in] index child index that must be removed from the children list and returned.
      * \return Item that is removed from the children list.
      */
-    template<typename TYPE, typename CONTAINER>
-    TYPE * TreeItem<TYPE, CONTAINER>::takeChildAt(const Index index) {
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    TYPE * TreeItem<TYPE, CONTAINER, DISPATCH>::takeChildAt(const Index index) {
         assert(index < mChildren.size());
         auto item = mChildren[index];
         mChildren.erase(index);
         item->mParent = nullptr;
+        notifyRemoved(item);
         return item;
     }
 
@@ -262,8 +322,19 @@ namespace tree {
      * \details Access to the constant children list.
      * \return Reference to the children list.
      */
-    template<typename TYPE, typename CONTAINER>
-    const CONTAINER & TreeItem<TYPE, CONTAINER>::children() const {
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    const CONTAINER & TreeItem<TYPE, CONTAINER, DISPATCH>::children() const {
+        return mChildren;
+    }
+
+    /*!
+     * \details Access to the constant children list for the traversals.
+     *          It isn't virtual, the traversals call it through TYPE, so the layers which make the children
+     *          on demand like \link sts::tree::TreeItemLazy \endlink hide it with the method which makes them first.
+     * \return Reference to the children list.
+     */
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    const CONTAINER & TreeItem<TYPE, CONTAINER, DISPATCH>::loadedChildren() const {
         return mChildren;
     }
 
@@ -273,8 +344,8 @@ namespace tree {
      *          You must understand what you do.
      * \return Reference to the children list.
      */
-    template<typename TYPE, typename CONTAINER>
-    CONTAINER & TreeItem<TYPE, CONTAINER>::children() {
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    CONTAINER & TreeItem<TYPE, CONTAINER, DISPATCH>::children() {
         return mChildren;
     }
 
@@ -288,13 +359,14 @@ namespace tree {
      * \param [in, out] inOutItem tree item that will be added as a child.
      * \return Pointer to the item which is the input parameter.
      */
-    template<typename TYPE, typename CONTAINER>
-    TYPE * TreeItem<TYPE, CONTAINER>::prependChild(TYPE * inOutItem) {
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    TYPE * TreeItem<TYPE, CONTAINER, DISPATCH>::prependChild(TYPE * inOutItem) {
         assert(inOutItem);
         assert(inOutItem->parent() != this);
         inOutItem->removeParent();
-        inOutItem->mParent = static_cast<TYPE*>(this);
+        inOutItem->mParent = this;
         mChildren.push_front(inOutItem);
+        notifyAdded(inOutItem);
         return inOutItem;
     }
 
@@ -305,14 +377,15 @@ namespace tree {
      * \param [in, out] inOutItem tree item that will be inserted as a child.
      * \return Pointer to the item which is the input parameter.
      */
-    template<typename TYPE, typename CONTAINER>
-    TYPE * TreeItem<TYPE, CONTAINER>::insertChild(const Index where, TYPE * inOutItem) {
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    TYPE * TreeItem<TYPE, CONTAINER, DISPATCH>::insertChild(const Index where, TYPE * inOutItem) {
         assert(inOutItem);
         assert(where <= mChildren.size());
         assert(inOutItem->parent() != this);
         inOutItem->removeParent();
-        inOutItem->mParent = static_cast<TYPE*>(this);
+        inOutItem->mParent = this;
         mChildren.insert(where, inOutItem);
+        notifyAdded(inOutItem);
         return inOutItem;
     }
 
@@ -322,13 +395,14 @@ namespace tree {
      * \param [in, out] inOutItem tree item that will be added as a child.
      * \return Pointer to the item which is the input parameter.
      */
-    template<typename TYPE, typename CONTAINER>
-    TYPE * TreeItem<TYPE, CONTAINER>::appendChild(TYPE * inOutItem) {
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    TYPE * TreeItem<TYPE, CONTAINER, DISPATCH>::appendChild(TYPE * inOutItem) {
         assert(inOutItem);
         assert(inOutItem->parent() != this);
         inOutItem->removeParent();
-        inOutItem->mParent = static_cast<TYPE*>(this);
+        inOutItem->mParent = this;
         mChildren.push_back(inOutItem);
+        notifyAdded(inOutItem);
         return inOutItem;
     }
 
@@ -336,16 +410,92 @@ namespace tree {
     ///////////////////////////////////////////* Functions *////////////////////////////////////////////
     /**************************************************************************************************/
 
+    /*!
+     * \details Inserts the range of items as children starting from the specified index.
+     *          It is faster than inserting the items one by one, the children list is shifted
+     *          and reallocated only once and each run of the adjacent items which have the same parent
+     *          is detached from it with one pass over its children list.
+     * \remark The Tree item takes ownership of the specified pointers.
+     * \pre The range must not contain the same item twice, this item's children and this item's ancestors.
+     * \param [in] where index where the first item must be inserted.
+     * \param [in, out] first forward iterator to the first tree item pointer.
+     * \param [in, out] last forward iterator to the position after the last tree item pointer.
+     */
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    template<typename ITERATOR>
+    void TreeItem<TYPE, CONTAINER, DISPATCH>::insertChildren(const Index where, ITERATOR first, ITERATOR last) {
+        assert(where <= mChildren.size());
+        for (auto run = first; run != last;) {
+            assert(*run);
+            assert((*run)->parent() != this);
+            TreeItem * parent = (*run)->mParent;
+            auto runEnd = run;
+            std::size_t runSize = 0;
+            for (; runEnd != last && (*runEnd)->mParent == parent; ++runEnd, ++runSize) {
+                (*runEnd)->mParent = nullptr;
+            }
+            if (parent == nullptr) {
+                run = runEnd;
+                continue;
+            }
+            if (runSize == 1) {
+                Traits::remove(parent->mChildren, *run);
+            }
+            else {
+                const TreeItem * owner = parent;
+                Traits::remove_if(parent->mChildren, [owner](const TYPE * child) { return child->mParent != owner; });
+            }
+            for (; run != runEnd; ++run) {
+                parent->notifyRemoved(*run);
+            }
+        }
+
+        Traits::insert(mChildren, where, first, last);
+        for (auto it = first; it != last; ++it) {
+            TYPE * item = *it;
+            item->mParent = this;
+            notifyAdded(item);
+        }
+    }
+
+    /*!
+     * \details Adds the range of items to the end of the children list.
+     * \see \link TreeItem::insertChildren \endlink
+     * \param [in, out] first forward iterator to the first tree item pointer.
+     * \param [in, out] last forward iterator to the position after the last tree item pointer.
+     */
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    template<typename ITERATOR>
+    void TreeItem<TYPE, CONTAINER, DISPATCH>::appendChildren(ITERATOR first, ITERATOR last) {
+        insertChildren(mChildren.size(), first, last);
+    }
+
+    /*!
+     * \details Reserves the children list capacity, so the next children may be added without reallocation.
+     * \note It does nothing for the list based containers.
+     * \param [in] count expected children count.
+     */
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    void TreeItem<TYPE, CONTAINER, DISPATCH>::reserveChildren(const Index count) {
+        Traits::reserve(mChildren, count);
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
     /*!
      * \details Removes child from item's children list by child's index. 
      *          The child's destructor will be called while removing.
      * \param [in] index index of a child that must be deleted.
      */
-    template<typename TYPE, typename CONTAINER>
-    void TreeItem<TYPE, CONTAINER>::deleteChild(const Index index) {
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    void TreeItem<TYPE, CONTAINER, DISPATCH>::deleteChild(const Index index) {
         assert(index < mChildren.size());
         auto item = mChildren[index];
         mChildren.erase(index);
+        item->mParent = nullptr;
+        notifyRemoved(item);
         item->mRemoveFromParent = false;
         delete item;
     }
@@ -353,13 +503,18 @@ namespace tree {
     /*!
      * \details Deletes <b>ALL</b> item's children.
      */
-    template<typename TYPE, typename CONTAINER>
-    void TreeItem<TYPE, CONTAINER>::deleteChildren() {
-        for (auto & it : mChildren) {
-            it->mRemoveFromParent = false;
-            delete it;
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    void TreeItem<TYPE, CONTAINER, DISPATCH>::deleteChildren() {
+        if (mChildren.empty()) {
+            return;
+        }
+        Children children;
+        std::swap(children, mChildren);
+        for (auto & it : children) {
+            it->mParent = nullptr;
+            notifyRemoved(it);
         }
-        mChildren.clear();
+        deleteItems(children);
     }
 
     /*!
@@ -368,8 +523,8 @@ namespace tree {
      * \param [in, out] inOutItem pointer to a children that must be deleted.
      * \return True if the child by the specified pointer was deleted otherwise false.
      */
-    template<typename TYPE, typename CONTAINER>
-    bool TreeItem<TYPE, CONTAINER>::deleteChild(TYPE * inOutItem) {
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    bool TreeItem<TYPE, CONTAINER, DISPATCH>::deleteChild(TYPE * inOutItem) {
         assert(inOutItem);
         const std::size_t index = indexOf(inOutItem);
         if (index == npos) {
@@ -387,8 +542,8 @@ namespace tree {
      * \details Checks whether the item has children.
      * \return True if the item has children otherwise false.
      */
-    template<typename TYPE, typename CONTAINER>
-    bool TreeItem<TYPE, CONTAINER>::hasChildren() const {
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    bool TreeItem<TYPE, CONTAINER, DISPATCH>::hasChildren() const {
         return !mChildren.empty();
     }
 
@@ -397,16 +552,10 @@ namespace tree {
      * \param [in] item pointer to tree item whose index must be found.
      * \return Index if specified pointer that was found otherwise \link TreeItem::npos \endlink.
      */
-    template<typename TYPE, typename CONTAINER>
-    size_t TreeItem<TYPE, CONTAINER>::indexOf(const TYPE * item) const {
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    size_t TreeItem<TYPE, CONTAINER, DISPATCH>::indexOf(const TYPE * item) const {
         assert(item);
-        Index outIndex = 0;
-        for (auto & it : mChildren) {
-            if (it == item)
-                return outIndex;
-            ++outIndex;
-        }
-        return npos;
+        return Traits::indexOf(mChildren, item);
     }
 
     /**************************************************************************************************/
@@ -418,8 +567,8 @@ namespace tree {
      * \details If the item doesn't have any children then the item is leaf.
      * \return True if the item is leaf otherwise false.
      */
-    template<typename TYPE, typename CONTAINER>
-    bool TreeItem<TYPE, CONTAINER>::isLeaf() const {
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    bool TreeItem<TYPE, CONTAINER, DISPATCH>::isLeaf() const {
         return mChildren.empty();
     }
 
@@ -428,26 +577,26 @@ namespace tree {
      * \details If the item has some children then the item is branch.
      * \return True if the item is branch otherwise false.
      */
-    template<typename TYPE, typename CONTAINER>
-    bool TreeItem<TYPE, CONTAINER>::isBranch() const {
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    bool TreeItem<TYPE, CONTAINER, DISPATCH>::isBranch() const {
         return !mChildren.empty();
     }
 
     /*!
      * \details Check whether this item is one of the children of specified parent.
      * \note This method checks full hierarchy chain up to the root.
+     *       Use \link sts::tree::TreeItemAncestorIndex \endlink if you need a lot of such checks for an unchanged hierarchy.
      * \param [in] parent a parent that you want to be checked.
      * \return True if this item has specified item as a parent otherwise false.
      */
-    template<typename TYPE, typename CONTAINER>
-    bool TreeItem<TYPE, CONTAINER>::isChildOf(const TYPE * parent) const {
-        if (!mParent) {
-            return false;
-        }
-        if (mParent == parent) {
-            return true;
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    bool TreeItem<TYPE, CONTAINER, DISPATCH>::isChildOf(const TYPE * parent) const {
+        for (const TreeItem * item = mParent; item; item = item->mParent) {
+            if (item == parent) {
+                return true;
+            }
         }
-        return mParent->isChildOf(parent);
+        return false;
     }
 
     /**************************************************************************************************/
@@ -457,13 +606,83 @@ namespace tree {
     /*!
      * \details Clones the tree item.
      * \details default implementation is \code return nullptr; \endcode
+     *          if the item has the virtual methods, otherwise it is
+     *          \code return new TYPE(static_cast<const TYPE &>(*this)); \endcode
      * \return Pointer to a cloned tree item.
      */
-    template<typename TYPE, typename CONTAINER>
-    TYPE * TreeItem<TYPE, CONTAINER>::clone() const {
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    TYPE * TreeItem<TYPE, CONTAINER, DISPATCH>::clone() const {
+        return cloneDefault(typename DISPATCH::CopyByDefault());
+    }
+
+    /*!
+     * \details Default clone of the items which have the virtual methods, TYPE may have no copy constructor.
+     * \return nullptr
+     */
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    TYPE * TreeItem<TYPE, CONTAINER, DISPATCH>::cloneDefault(std::false_type) const {
         return nullptr;
     }
 
+    /*!
+     * \details Default clone of the items which don't have the virtual methods.
+     * \return Pointer to the copy of this item made by TYPE's copy constructor.
+     */
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    TYPE * TreeItem<TYPE, CONTAINER, DISPATCH>::cloneDefault(std::true_type) const {
+        return new TYPE(static_cast<const TYPE &>(*this));
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details It is called after the child has been added to the children list.
+     * \details Default implementation does nothing.
+     * \note The child may be under construction when it is created with the parent,
+     *       then only its already constructed bases may be used.
+     * \param [in] child
+     */
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    void TreeItem<TYPE, CONTAINER, DISPATCH>::childAdded(TYPE * child) {
+        (void)child;
+    }
+
+    /*!
+     * \details It is called after the child has been removed from the children list, its parent is nullptr already.
+     *          If the child is being deleted by this item the method is called before the deleting.
+     * \details Default implementation does nothing.
+     * \note The child may be under destruction when it is deleted directly,
+     *       then only its not yet destroyed bases may be used.
+     *       The method isn't called for the children which are deleted by the item's destructor.
+     * \param [in] child
+     */
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    void TreeItem<TYPE, CONTAINER, DISPATCH>::childRemoved(TYPE * child) {
+        (void)child;
+    }
+
+    /*!
+     * \details Calls \link TreeItem::childAdded \endlink through the dispatch,
+     *          so it is the overridden method or TYPE's one.
+     * \param [in] child
+     */
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    void TreeItem<TYPE, CONTAINER, DISPATCH>::notifyAdded(TYPE * child) {
+        DISPATCH::dispatch(this)->childAdded(child);
+    }
+
+    /*!
+     * \details Calls \link TreeItem::childRemoved \endlink through the dispatch,
+     *          so it is the overridden method or TYPE's one.
+     * \param [in] child
+     */
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    void TreeItem<TYPE, CONTAINER, DISPATCH>::notifyRemoved(TYPE * child) {
+        DISPATCH::dispatch(this)->childRemoved(child);
+    }
+
     /**************************************************************************************************/
     ///////////////////////////////////////////* Functions *////////////////////////////////////////////
     /**************************************************************************************************/
@@ -471,42 +690,268 @@ namespace tree {
     /*!
      * \details Removes item's parent.
      */
-    template<typename TYPE, typename CONTAINER>
-    void TreeItem<TYPE, CONTAINER>::removeParent() {
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    void TreeItem<TYPE, CONTAINER, DISPATCH>::removeParent() {
         if (mParent != nullptr) {
-            assert(mParent->indexOf(static_cast<TYPE*>(this)) != npos);
-            removeFromContainer(&mParent->mChildren, this);
+            TreeItem * parent = mParent;
+            TYPE * self = selfOf(parent);
+            const bool removed = Traits::remove(parent->mChildren, self);
+            assert(removed);
+            (void)removed;
             mParent = nullptr;
+            parent->notifyRemoved(self);
+        }
+    }
+
+    /*!
+     * \details Gets the item as TYPE without the downcast of the item itself.
+     *          The item may be under construction or destruction (a parent is set by the constructor
+     *          and removed by the destructor) when it isn't TYPE object yet or anymore,
+     *          so the TYPE pointer is made from the base offset of the other item which is a complete one.
+     *          The offset is the same for all the items as TYPE derives from the tree item non-virtually.
+     * \note The hooks get this pointer while the item is under construction or destruction,
+     *       they may use the layers and the tree item parts of the child only.
+     * \param [in] complete any complete item, usually the parent.
+     * \return Pointer to the item as TYPE.
+     */
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    TYPE * TreeItem<TYPE, CONTAINER, DISPATCH>::selfOf(TreeItem * complete) {
+        char * completeType = reinterpret_cast<char *>(static_cast<TYPE*>(complete));
+        const std::ptrdiff_t offset = reinterpret_cast<char *>(complete) - completeType;
+        return reinterpret_cast<TYPE*>(reinterpret_cast<char *>(this) - offset);
+    }
+
+    /*!
+     * \details Deletes the items and their hierarchies without recursion, so the hierarchy depth is limited by the memory only.
+     *          The outermost call deletes the items one by one, the destructors which are called meanwhile
+     *          put their children into the outermost call's list instead of deleting them recursively.
+     *          The items are deleted in the same order as by recursion: an item's children right after the item.
+     * \note An item's children are still available in its destructor, but its parent isn't.
+     * \param [in] items
+     */
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    void TreeItem<TYPE, CONTAINER, DISPATCH>::deleteItems(const Children & items) {
+        if (items.empty()) {
+            return;
+        }
+        std::vector<TYPE*> *& deleting = deletingItems();
+        if (deleting != nullptr) {
+            const std::size_t first = deleting->size();
+            for (auto & it : items) {
+                it->mRemoveFromParent = false;
+                it->mParent = nullptr;
+                deleting->push_back(it);
+            }
+            std::reverse(deleting->begin() + first, deleting->end());
+            return;
+        }
+        std::vector<TYPE*> descendants;
+        deleting = &descendants;
+        for (auto it = items.begin(); it != items.end();) {
+            TYPE * item = *it;
+            ++it;
+            item->mRemoveFromParent = false;
+            item->mParent = nullptr;
+            delete item;
+            while (!descendants.empty()) {
+                TYPE * descendant = descendants.back();
+                descendants.pop_back();
+                delete descendant;
+            }
+        }
+        deleting = nullptr;
+    }
+
+    /*!
+     * \details Items list of the deletion which is in progress in the current thread.
+     * \return Reference to pointer to the list, the pointer is nullptr if there is no deletion in progress.
+     */
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    std::vector<TYPE*> *& TreeItem<TYPE, CONTAINER, DISPATCH>::deletingItems() {
+        static thread_local std::vector<TYPE*> * items = nullptr;
+        return items;
+    }
+
+    /*!
+     * \details Replaces the children with the specified item's ones.
+     * \param [in, out] other
+     * \param [in] notify whether \link TreeItem::childAdded \endlink must be called,
+     *             it is false for the move constructor because TYPE isn't constructed yet.
+     */
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    void TreeItem<TYPE, CONTAINER, DISPATCH>::takeChildren(TreeItem & other, const bool notify) {
+        Children children;
+        std::swap(children, other.mChildren);
+        for (auto & it : children) {
+            it->mParent = nullptr;
+            other.notifyRemoved(it);
+        }
+        deleteChildren();
+        std::swap(mChildren, children);
+        takePendingCloning(other);
+        for (auto & it : mChildren) {
+            it->mParent = this;
+            if (notify) {
+                notifyAdded(it);
+            }
         }
     }
 
     /*!
-     * \details Clones new children from specified list
+     * \details Clones new children from specified list without recursion, so the hierarchy depth is limited by the memory only.
+     *          The outermost call clones the children lists one by one, the copy constructors which are called
+     *          by \link TreeItem::clone \endlink meanwhile put their items into the outermost call's list
+     *          instead of cloning their children recursively.
+     *          Each children list is reserved once, \link TreeItem::childAdded \endlink isn't called for the clones.
+     * \note The clone method may make temporary copies, the moved and destroyed copies are removed from the list.
+     * \note If a clone method throws the clones which are made already are deleted and the exception is passed to the caller.
      * \param [in] container
      */
-    template<typename TYPE, typename CONTAINER>
-    void TreeItem<TYPE, CONTAINER>::cloneContainer(const Children * container) {
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    void TreeItem<TYPE, CONTAINER, DISPATCH>::cloneContainer(const Children * container) {
         assert(container);
-        for (auto & item : *container) {
-            appendChild(item->clone());
+        if (container->empty()) {
+            return;
+        }
+        CloningList *& cloning = cloningItems();
+        if (cloning != nullptr) {
+            cloning->emplace_back(this, container);
+            mClonePending = true;
+            return;
+        }
+        CloningList pending(1, std::make_pair(this, container));
+        try {
+            while (!pending.empty()) {
+                const auto task = pending.back();
+                pending.pop_back();
+                cloneChildren(task.first, task.second, pending);
+            }
+        }
+        catch (...) {
+            // the destructor isn't called if the constructor throws, so the clones are deleted here.
+            Children clones;
+            std::swap(clones, mChildren);
+            deleteItems(clones);
+            throw;
         }
     }
 
     /*!
-     * \details Finds and removes certain child from container without destruction.
-     * \param [in, out] inOutContainer
+     * \details Clones the item, the children lists of the clones are put into the specified list instead of cloning.
      * \param [in] item
+     * \param [out] outPending the clones and the children lists which must be cloned into them.
+     * \return Pointer to the cloned item.
      */
-    template<typename TYPE, typename CONTAINER>
-    void TreeItem<TYPE, CONTAINER>::removeFromContainer(Children * inOutContainer, const TreeItem<TYPE, CONTAINER> * item) {
-        assert(inOutContainer);
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    TYPE * TreeItem<TYPE, CONTAINER, DISPATCH>::cloneItem(const TYPE * item, CloningList & outPending) {
         assert(item);
-        for (auto it = inOutContainer->begin(); it != inOutContainer->end(); ++it) {
-            if (*it == item) {
-                inOutContainer->erase(it);
-                return;
+        CloningList *& cloning = cloningItems();
+        assert(cloning == nullptr);
+        cloning = &outPending;
+        TYPE * clone = nullptr;
+        try {
+            clone = DISPATCH::dispatch(static_cast<const TreeItem *>(item))->clone();
+        }
+        catch (...) {
+            cloning = nullptr;
+            throw;
+        }
+        cloning = nullptr;
+        assert(clone);
+        return clone;
+    }
+
+    /*!
+     * \details Fills the children list of the item with the clones of the specified children,
+     *          the children lists of the clones are put into the specified list instead of cloning.
+     * \param [in, out] item the clone which children list is empty.
+     * \param [in] children
+     * \param [out] outPending the clones and the children lists which must be cloned into them.
+     */
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    void TreeItem<TYPE, CONTAINER, DISPATCH>::cloneChildren(TreeItem * item, const Children * children, CloningList & outPending) {
+        assert(item && children);
+        CloningList *& cloning = cloningItems();
+        assert(cloning == nullptr);
+        cloning = &outPending;
+        item->mClonePending = false;
+        try {
+            Traits::reserve(item->mChildren, children->size());
+            for (auto & child : *children) {
+                TYPE * clone = DISPATCH::dispatch(static_cast<const TreeItem *>(child))->clone();
+                assert(clone);
+                clone->mParent = item;
+                item->mChildren.push_back(clone);
+            }
+        }
+        catch (...) {
+            cloning = nullptr;
+            throw;
+        }
+        cloning = nullptr;
+    }
+
+    /*!
+     * \details Finds the item in the list of the cloning which is in progress in the current thread.
+     * \return Pointer to the item and the children list which must be cloned into it
+     *         or nullptr if the item doesn't wait for its children.
+     */
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    typename TreeItem<TYPE, CONTAINER, DISPATCH>::CloningList::value_type * TreeItem<TYPE, CONTAINER, DISPATCH>::pendingCloning() const {
+        CloningList * cloning = cloningItems();
+        if (!mClonePending || cloning == nullptr) {
+            return nullptr;
+        }
+        // the item is usually made by the clone method which is being called, so it is at the end.
+        for (auto it = cloning->rbegin(); it != cloning->rend(); ++it) {
+            if (it->first == this) {
+                return &*it;
             }
         }
+        return nullptr;
+    }
+
+    /*!
+     * \details Removes the item from the list of the cloning which is in progress in the current thread,
+     *          it is called when the item is destroyed or its children are replaced before they are cloned.
+     */
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    void TreeItem<TYPE, CONTAINER, DISPATCH>::dropPendingCloning() {
+        const auto * pending = pendingCloning();
+        if (pending != nullptr) {
+            CloningList * cloning = cloningItems();
+            cloning->erase(cloning->begin() + (pending - cloning->data()));
+        }
+        mClonePending = false;
+    }
+
+    /*!
+     * \details Makes the children which the specified item waits for to be cloned into this item,
+     *          it is called when the children are moved (like by a clone method which moves a temporary copy).
+     * \param [in, out] other
+     */
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    void TreeItem<TYPE, CONTAINER, DISPATCH>::takePendingCloning(TreeItem & other) {
+        if (mClonePending) {
+            dropPendingCloning();
+        }
+        auto * pending = other.pendingCloning();
+        if (pending != nullptr) {
+            pending->first = this;
+            mClonePending = true;
+        }
+        other.mClonePending = false;
+    }
+
+    /*!
+     * \details Items list of the cloning which is in progress in the current thread.
+     * \return Reference to pointer to the list of the clones and the children lists which must be cloned into them,
+     *         the pointer is nullptr if there is no cloning in progress.
+     */
+    template<typename TYPE, typename CONTAINER, typename DISPATCH>
+    typename TreeItem<TYPE, CONTAINER, DISPATCH>::CloningList *& TreeItem<TYPE, CONTAINER, DISPATCH>::cloningItems() {
+        static thread_local CloningList * items = nullptr;
+        return items;
     }
 
     /********************************************************************************************************/
@@ -0,0 +1,196 @@
+#pragma once
+
+/*
+**  Copyright(C) 2018, StepToSky
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  1.Redistributions of source code must retain the above copyright notice, this
+**    list of conditions and the following disclaimer.
+**  2.Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and / or other materials provided with the distribution.
+**  3.Neither the name of StepToSky nor the names of its contributors
+**    may be used to endorse or promote products derived from this software
+**    without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**  DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**  Contacts: www.steptosky.com
+*/
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include "TreeItem.h"
+
+namespace sts {
+namespace tree {
+
+    /********************************************************************************************************/
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /********************************************************************************************************/
+
+    /*!
+     * \details Aggregate which keeps nothing, the \link sts::tree::TreeItemAggregate \endlink layer with it keeps the subtree sizes only.
+     * \details The aggregate type must provide the Value type and two static functions:
+     *          - combine(a, b) returns the aggregate of the both values, it must be associative and commutative;
+     *          - subtract(inOutTotal, part) removes the part from the total and returns true,
+     *  or returns false if the total must be combined from the rest of the values again.
+     */
+    struct TreeItemAggregateNone {
+        struct Value {};
+
+        static Value combine(const Value &, const Value &) {
+            return Value();
+        }
+
+        static bool subtract(Value &, const Value &) {
+            return true;
+        }
+    };
+
+    /*!
+     * \details Sum of the values, the removing is O(1).
+     */
+    template<typename VALUE>
+    struct TreeItemAggregateSum {
+        typedef VALUE Value;
+
+        static Value combine(const Value & a, const Value & b) {
+            return a + b;
+        }
+
+        static bool subtract(Value & inOutTotal, const Value & part) {
+            inOutTotal -= part;
+            return true;
+        }
+    };
+
+    /*!
+     * \details Minimum of the values, the total is combined again only if the minimum is removed.
+     */
+    template<typename VALUE>
+    struct TreeItemAggregateMin {
+        typedef VALUE Value;
+
+        static Value combine(const Value & a, const Value & b) {
+            return (std::min)(a, b);
+        }
+
+        static bool subtract(Value & inOutTotal, const Value & part) {
+            return inOutTotal < part;
+        }
+    };
+
+    /*!
+     * \details Maximum of the values, the total is combined again only if the maximum is removed.
+     */
+    template<typename VALUE>
+    struct TreeItemAggregateMax {
+        typedef VALUE Value;
+
+        static Value combine(const Value & a, const Value & b) {
+            return (std::max)(a, b);
+        }
+
+        static bool subtract(Value & inOutTotal, const Value & part) {
+            return part < inOutTotal;
+        }
+    };
+
+    /********************************************************************************************************/
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /********************************************************************************************************/
+
+    /*!
+     * \details Tree item layer which keeps the subtree size and the aggregate of the items' values
+     *          (sum, min, max or your own one), so reading them is O(1).
+     * \details Each item has its own value, the aggregate of an item is combined from its value and its children's aggregates.
+     *          Adding and removing a child (including \link TreeItem::setParent \endlink and deleting)
+     *          and changing a value update the item and its ancestors, it takes O(depth).
+     *          If the aggregate can't subtract a value (like the removed minimum) the ancestors are combined
+     *          from their children again, it takes O(depth * children count).
+     * \details Use the layer instead of the TreeItem:
+     * \code
+     *      class YourType : public TreeItemAggregate<YourType, TreeItemAggregateSum<std::uint64_t>> { ... };
+     *      // several aggregates are kept by your own aggregate type with a structure as the value.
+     * \endcode
+     * \note The clones have the same aggregates as the copied items.
+     * \warning If you override \link TreeItem::childAdded \endlink or \link TreeItem::childRemoved \endlink
+     *          you must call the layer's implementation too.
+     * \warning With \link sts::tree::TreeItemLazy \endlink the aggregates include the loaded items only.
+     * \tparam TYPE your type.
+     * \tparam AGGREGATE aggregate type, see \link sts::tree::TreeItemAggregateNone \endlink.
+     * \tparam BASE the tree item type or another layer.
+     */
+    template<typename TYPE, typename AGGREGATE = TreeItemAggregateNone, typename BASE = TreeItem<TYPE>>
+    class TreeItemAggregate : public BASE {
+    protected:
+
+        TreeItemAggregate(const TreeItemAggregate & copy);
+        TreeItemAggregate & operator =(const TreeItemAggregate & copy);
+        TreeItemAggregate(TreeItemAggregate && other);
+        TreeItemAggregate & operator =(TreeItemAggregate && other);
+
+    public:
+
+        typedef typename BASE::Index Index;
+        typedef typename AGGREGATE::Value Value;
+
+        //---------------------------------------------------------------
+        /// @{
+
+        explicit TreeItemAggregate(const Value & value = Value());
+        explicit TreeItemAggregate(TYPE * inOutParent, const Value & value = Value());
+        virtual ~TreeItemAggregate();
+
+        /// @}
+        //---------------------------------------------------------------
+        /// @{
+
+        const Value & aggregateValue() const;
+        void setAggregateValue(const Value & value);
+
+        /// @}
+        //---------------------------------------------------------------
+        /// @{
+
+        const Value & aggregate() const;
+        Index subtreeSize() const;
+
+        /// @}
+        //---------------------------------------------------------------
+
+    protected:
+
+        void childAdded(TYPE * child) override;
+        void childRemoved(TYPE * child) override;
+
+    private:
+
+        Value mValue;
+        Value mAggregate;
+        Index mSubtreeSize = 1;
+
+        void recombine();
+
+    };
+
+    /********************************************************************************************************/
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /********************************************************************************************************/
+}
+}
+
+#include "TreeItemAggregate.inl.h"
@@ -0,0 +1,236 @@
+#pragma once
+
+/*
+**  Copyright(C) 2018, StepToSky
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  1.Redistributions of source code must retain the above copyright notice, this
+**    list of conditions and the following disclaimer.
+**  2.Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and / or other materials provided with the distribution.
+**  3.Neither the name of StepToSky nor the names of its contributors
+**    may be used to endorse or promote products derived from this software
+**    without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**  DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**  Contacts: www.steptosky.com
+*/
+
+#include <cassert>
+
+namespace sts {
+namespace tree {
+
+    /**************************************************************************************************/
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Constructor init value.
+     * \param [in] value the item's own value.
+     */
+    template<typename TYPE, typename AGGREGATE, typename BASE>
+    TreeItemAggregate<TYPE, AGGREGATE, BASE>::TreeItemAggregate(const Value & value)
+        : mValue(value),
+          mAggregate(value) {}
+
+    /*!
+     * \details Constructor init.
+     * \note The item is appended to the parent after the layer is initialized,
+     *       so the parent's aggregates include the item's value.
+     * \param [in, out] inOutParent parent of this item, the item will be appended to its children list.
+     * \param [in] value the item's own value.
+     */
+    template<typename TYPE, typename AGGREGATE, typename BASE>
+    TreeItemAggregate<TYPE, AGGREGATE, BASE>::TreeItemAggregate(TYPE * inOutParent, const Value & value)
+        : mValue(value),
+          mAggregate(value) {
+        assert(inOutParent);
+        BASE::setParent(inOutParent);
+    }
+
+    /*!
+     * \details Destructor, removes the item from its parent while the aggregates are still available,
+     *          so the ancestors are updated.
+     */
+    template<typename TYPE, typename AGGREGATE, typename BASE>
+    TreeItemAggregate<TYPE, AGGREGATE, BASE>::~TreeItemAggregate() {
+        if (BASE::parent() != nullptr) {
+            BASE::setParent(nullptr);
+        }
+    }
+
+    /*!
+     * \details Constructor copy.
+     * \note The copy has the same hierarchy as the copied item, so the aggregates are copied.
+     * \param [in] copy
+     */
+    template<typename TYPE, typename AGGREGATE, typename BASE>
+    TreeItemAggregate<TYPE, AGGREGATE, BASE>::TreeItemAggregate(const TreeItemAggregate & copy)
+        : BASE(copy),
+          mValue(copy.mValue),
+          mAggregate(copy.mAggregate),
+          mSubtreeSize(copy.mSubtreeSize) {}
+
+    /*!
+     * \details Operator copy.
+     * \note The value is copied, the item's ancestors are updated.
+     * \param [in] copy
+     */
+    template<typename TYPE, typename AGGREGATE, typename BASE>
+    TreeItemAggregate<TYPE, AGGREGATE, BASE> & TreeItemAggregate<TYPE, AGGREGATE, BASE>::operator =(const TreeItemAggregate & copy) {
+        BASE::operator=(copy);
+        setAggregateValue(copy.mValue);
+        return *this;
+    }
+
+    /*!
+     * \details Constructor move.
+     * \note The value is copied, the aggregates are combined from the moved children.
+     *       The other item's ancestors are updated.
+     * \param [in, out] other
+     */
+    template<typename TYPE, typename AGGREGATE, typename BASE>
+    TreeItemAggregate<TYPE, AGGREGATE, BASE>::TreeItemAggregate(TreeItemAggregate && other)
+        : BASE(std::move(other)),
+          mValue(other.mValue),
+          mAggregate(other.mValue) {
+        for (auto & it : BASE::children()) {
+            mSubtreeSize += static_cast<const TreeItemAggregate*>(it)->mSubtreeSize;
+        }
+        recombine();
+    }
+
+    /*!
+     * \details Operator move.
+     * \note The value is copied, the ancestors of the both items are updated.
+     * \param [in, out] other
+     */
+    template<typename TYPE, typename AGGREGATE, typename BASE>
+    TreeItemAggregate<TYPE, AGGREGATE, BASE> & TreeItemAggregate<TYPE, AGGREGATE, BASE>::operator =(TreeItemAggregate && other) {
+        BASE::operator=(std::move(other));
+        setAggregateValue(other.mValue);
+        return *this;
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Gets the item's own value.
+     * \return The value.
+     */
+    template<typename TYPE, typename AGGREGATE, typename BASE>
+    const typename TreeItemAggregate<TYPE, AGGREGATE, BASE>::Value & TreeItemAggregate<TYPE, AGGREGATE, BASE>::aggregateValue() const {
+        return mValue;
+    }
+
+    /*!
+     * \details Sets the item's own value and updates the aggregates of the item and its ancestors.
+     * \param [in] value
+     */
+    template<typename TYPE, typename AGGREGATE, typename BASE>
+    void TreeItemAggregate<TYPE, AGGREGATE, BASE>::setAggregateValue(const Value & value) {
+        const Value old = mValue;
+        mValue = value;
+        for (TreeItemAggregate * item = this; item != nullptr; item = item->BASE::parent()) {
+            if (AGGREGATE::subtract(item->mAggregate, old)) {
+                item->mAggregate = AGGREGATE::combine(item->mAggregate, value);
+            }
+            else {
+                item->recombine();
+            }
+        }
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Gets the aggregate of the values of the item and all its descendants.
+     * \return The aggregate.
+     */
+    template<typename TYPE, typename AGGREGATE, typename BASE>
+    const typename TreeItemAggregate<TYPE, AGGREGATE, BASE>::Value & TreeItemAggregate<TYPE, AGGREGATE, BASE>::aggregate() const {
+        return mAggregate;
+    }
+
+    /*!
+     * \details Gets count of the items in the subtree.
+     * \return Count of the item and all its descendants.
+     */
+    template<typename TYPE, typename AGGREGATE, typename BASE>
+    typename TreeItemAggregate<TYPE, AGGREGATE, BASE>::Index TreeItemAggregate<TYPE, AGGREGATE, BASE>::subtreeSize() const {
+        return mSubtreeSize;
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Adds the child's subtree to the aggregates of the item and its ancestors.
+     * \param [in] child
+     */
+    template<typename TYPE, typename AGGREGATE, typename BASE>
+    void TreeItemAggregate<TYPE, AGGREGATE, BASE>::childAdded(TYPE * child) {
+        const TreeItemAggregate * added = child;
+        for (TreeItemAggregate * item = this; item != nullptr; item = item->BASE::parent()) {
+            item->mSubtreeSize += added->mSubtreeSize;
+            item->mAggregate = AGGREGATE::combine(item->mAggregate, added->mAggregate);
+        }
+        BASE::childAdded(child);
+    }
+
+    /*!
+     * \details Removes the child's subtree from the aggregates of the item and its ancestors.
+     * \param [in] child
+     */
+    template<typename TYPE, typename AGGREGATE, typename BASE>
+    void TreeItemAggregate<TYPE, AGGREGATE, BASE>::childRemoved(TYPE * child) {
+        const TreeItemAggregate * removed = child;
+        for (TreeItemAggregate * item = this; item != nullptr; item = item->BASE::parent()) {
+            item->mSubtreeSize -= removed->mSubtreeSize;
+            if (!AGGREGATE::subtract(item->mAggregate, removed->mAggregate)) {
+                item->recombine();
+            }
+        }
+        BASE::childRemoved(child);
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Combines the aggregate from the item's value and its children's aggregates.
+     * \note The children list is accessed without the virtual methods, so the layers below aren't involved.
+     */
+    template<typename TYPE, typename AGGREGATE, typename BASE>
+    void TreeItemAggregate<TYPE, AGGREGATE, BASE>::recombine() {
+        mAggregate = mValue;
+        for (auto & it : BASE::children()) {
+            mAggregate = AGGREGATE::combine(mAggregate, static_cast<const TreeItemAggregate*>(it)->mAggregate);
+        }
+    }
+
+    /**************************************************************************************************/
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /**************************************************************************************************/
+}
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+/*
+**  Copyright(C) 2018, StepToSky
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  1.Redistributions of source code must retain the above copyright notice, this
+**    list of conditions and the following disclaimer.
+**  2.Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and / or other materials provided with the distribution.
+**  3.Neither the name of StepToSky nor the names of its contributors
+**    may be used to endorse or promote products derived from this software
+**    without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**  DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**  Contacts: www.steptosky.com
+*/
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+namespace sts {
+namespace tree {
+
+    /********************************************************************************************************/
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /********************************************************************************************************/
+
+    /*!
+     * \details Index for fast ancestor queries of one tree hierarchy.
+     * \details The index is built on demand for a hierarchy snapshot, then it answers
+     *          whether one item is under another one and the item's depth in O(1),
+     *          and the k-th ancestor and the lowest common ancestor of two items in O(log(depth)),
+     *          so it fits the cases with a lot of such queries between the hierarchy changes
+     *          (culling, permissions checking, diffing etc...).
+     * \details The items are numbered in pre-order, so each subtree is a continuous numbers range,
+     *          the ancestors are found with the binary lifting table (ancestors at 1, 2, 4, 8... levels up).
+     * \code
+     *      TreeItemAncestorIndex<YourType> index(root);
+     *      if (index.isChildOf(item, parent)) { ... }
+     * \endcode
+     * \warning The index doesn't track the hierarchy changes, you must call \link TreeItemAncestorIndex::build \endlink
+     *          after any change of the hierarchy, otherwise the results are undefined.
+     * \tparam TYPE your tree item type.
+     */
+    template<typename TYPE>
+    class TreeItemAncestorIndex {
+    public:
+
+        typedef std::size_t Index;           /*!< \details Item's number in the index. */
+        static const Index npos = Index(-1); /*!< \details Means the item isn't in the index. */
+
+        //---------------------------------------------------------------
+        /// @{
+
+        TreeItemAncestorIndex() = default;
+        explicit TreeItemAncestorIndex(const TYPE * root);
+
+        /// @}
+        //---------------------------------------------------------------
+        /// @{
+
+        void build(const TYPE * root);
+        void clear();
+
+        Index size() const;
+        Index indexOf(const TYPE * item) const;
+        bool contains(const TYPE * item) const;
+
+        /// @}
+        //---------------------------------------------------------------
+        /// @{
+
+        Index depth(const TYPE * item) const;
+        bool isChildOf(const TYPE * item, const TYPE * parent) const;
+        const TYPE * ancestor(const TYPE * item, Index level) const;
+
+        /// @}
+        //---------------------------------------------------------------
+        /// @{
+
+        const TYPE * commonAncestor(const TYPE * item1, const TYPE * item2) const;
+        template<typename ITERATOR>
+        void commonAncestors(ITERATOR first, ITERATOR last, std::vector<const TYPE*> & outAncestors) const;
+
+        /// @}
+        //---------------------------------------------------------------
+
+    private:
+
+        std::unordered_map<const TYPE*, Index> mIndexes;
+        std::vector<const TYPE*> mItems;
+        std::vector<Index> mDepths;
+        std::vector<Index> mSubtreeSizes;
+        std::vector<std::vector<Index>> mAncestors;
+
+        bool isInSubtree(Index item, Index parent) const;
+        Index commonAncestor(Index item1, Index item2) const;
+
+    };
+
+    /********************************************************************************************************/
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /********************************************************************************************************/
+}
+}
+
+#include "TreeItemAncestorIndex.inl.h"
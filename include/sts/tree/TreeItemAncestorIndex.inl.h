@@ -0,0 +1,287 @@
+#pragma once
+
+/*
+**  Copyright(C) 2018, StepToSky
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  1.Redistributions of source code must retain the above copyright notice, this
+**    list of conditions and the following disclaimer.
+**  2.Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and / or other materials provided with the distribution.
+**  3.Neither the name of StepToSky nor the names of its contributors
+**    may be used to endorse or promote products derived from this software
+**    without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**  DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**  Contacts: www.steptosky.com
+*/
+
+#include <cassert>
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+namespace sts {
+namespace tree {
+
+    /**************************************************************************************************/
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    template<typename TYPE>
+    const typename TreeItemAncestorIndex<TYPE>::Index TreeItemAncestorIndex<TYPE>::npos;
+
+    /*!
+     * \details Constructor init, builds the index for the specified hierarchy.
+     * \param [in] root root of the hierarchy or of its part.
+     */
+    template<typename TYPE>
+    TreeItemAncestorIndex<TYPE>::TreeItemAncestorIndex(const TYPE * root) {
+        build(root);
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Builds the index for the specified item and all its descendants without recursion.
+     * \details The item isn't necessarily the hierarchy root, then the index knows nothing about the item's ancestors.
+     * \param [in] root root of the hierarchy or of its part.
+     */
+    template<typename TYPE>
+    void TreeItemAncestorIndex<TYPE>::build(const TYPE * root) {
+        assert(root);
+        clear();
+        std::vector<Index> parents;
+        std::vector<std::pair<const TYPE*, Index>> stack;
+        stack.emplace_back(root, npos);
+        while (!stack.empty()) {
+            const TYPE * item = stack.back().first;
+            const Index parent = stack.back().second;
+            stack.pop_back();
+
+            const Index index = mItems.size();
+            mIndexes.emplace(item, index);
+            mItems.push_back(item);
+            mDepths.push_back(parent == npos ? 0 : mDepths[parent] + 1);
+            parents.push_back(parent == npos ? index : parent);
+
+            const std::size_t first = stack.size();
+            for (auto & it : item->children()) {
+                stack.emplace_back(it, index);
+            }
+            std::reverse(stack.begin() + first, stack.end());
+        }
+
+        const Index count = mItems.size();
+        mSubtreeSizes.assign(count, 1);
+        for (Index i = count - 1; i > 0; --i) {
+            mSubtreeSizes[parents[i]] += mSubtreeSizes[i];
+        }
+
+        const Index maxDepth = *std::max_element(mDepths.begin(), mDepths.end());
+        mAncestors.push_back(std::move(parents));
+        for (Index step = 2; step <= maxDepth; step *= 2) {
+            const std::vector<Index> & prev = mAncestors.back();
+            std::vector<Index> level(count);
+            for (Index i = 0; i < count; ++i) {
+                level[i] = prev[prev[i]];
+            }
+            mAncestors.push_back(std::move(level));
+        }
+    }
+
+    /*!
+     * \details Clears the index.
+     */
+    template<typename TYPE>
+    void TreeItemAncestorIndex<TYPE>::clear() {
+        mIndexes.clear();
+        mItems.clear();
+        mDepths.clear();
+        mSubtreeSizes.clear();
+        mAncestors.clear();
+    }
+
+    /*!
+     * \details Gets count of the items in the index.
+     * \return Items count.
+     */
+    template<typename TYPE>
+    typename TreeItemAncestorIndex<TYPE>::Index TreeItemAncestorIndex<TYPE>::size() const {
+        return mItems.size();
+    }
+
+    /*!
+     * \details Gets the item's pre-order number.
+     * \param [in] item
+     * \return Pre-order number or \link TreeItemAncestorIndex::npos \endlink if the item isn't in the index.
+     */
+    template<typename TYPE>
+    typename TreeItemAncestorIndex<TYPE>::Index TreeItemAncestorIndex<TYPE>::indexOf(const TYPE * item) const {
+        const auto it = mIndexes.find(item);
+        return it != mIndexes.end() ? it->second : npos;
+    }
+
+    /*!
+     * \details Checks whether the item is in the index.
+     * \param [in] item
+     * \return True if the item is in the index otherwise false.
+     */
+    template<typename TYPE>
+    bool TreeItemAncestorIndex<TYPE>::contains(const TYPE * item) const {
+        return mIndexes.find(item) != mIndexes.end();
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Gets the item's depth, the index's root has depth 0.
+     * \pre The item must be in the index.
+     * \param [in] item
+     * \return Item's depth.
+     */
+    template<typename TYPE>
+    typename TreeItemAncestorIndex<TYPE>::Index TreeItemAncestorIndex<TYPE>::depth(const TYPE * item) const {
+        const Index index = indexOf(item);
+        assert(index != npos);
+        return mDepths[index];
+    }
+
+    /*!
+     * \details Check whether the item is one of the descendants of specified parent,
+     *          it is the same as \link TreeItem::isChildOf \endlink but it takes O(1) time.
+     * \param [in] item
+     * \param [in] parent
+     * \return True if the item has specified item as a parent, false if it doesn't or one of the items isn't in the index.
+     */
+    template<typename TYPE>
+    bool TreeItemAncestorIndex<TYPE>::isChildOf(const TYPE * item, const TYPE * parent) const {
+        const Index itemIndex = indexOf(item);
+        const Index parentIndex = indexOf(parent);
+        if (itemIndex == npos || parentIndex == npos) {
+            return false;
+        }
+        return parentIndex < itemIndex && itemIndex < parentIndex + mSubtreeSizes[parentIndex];
+    }
+
+    /*!
+     * \details Gets the item's ancestor at the specified level up.
+     * \pre The item must be in the index.
+     * \param [in] item
+     * \param [in] level 0 is the item itself, 1 is its parent etc...
+     * \return The ancestor or nullptr if the level is more than the item's depth.
+     */
+    template<typename TYPE>
+    const TYPE * TreeItemAncestorIndex<TYPE>::ancestor(const TYPE * item, Index level) const {
+        Index index = indexOf(item);
+        assert(index != npos);
+        if (level > mDepths[index]) {
+            return nullptr;
+        }
+        for (Index i = 0; level != 0; ++i, level >>= 1) {
+            if (level & 1) {
+                index = mAncestors[i][index];
+            }
+        }
+        return mItems[index];
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Gets the lowest common ancestor of the items, it takes O(log(depth)) time.
+     * \details If one item is an ancestor of the other one it is the result, the common ancestor of the item and itself is the item.
+     * \param [in] item1
+     * \param [in] item2
+     * \return The deepest item which has the both items in its subtree or nullptr if one of the items isn't in the index.
+     */
+    template<typename TYPE>
+    const TYPE * TreeItemAncestorIndex<TYPE>::commonAncestor(const TYPE * item1, const TYPE * item2) const {
+        const Index index1 = indexOf(item1);
+        const Index index2 = indexOf(item2);
+        if (index1 == npos || index2 == npos) {
+            return nullptr;
+        }
+        return mItems[commonAncestor(index1, index2)];
+    }
+
+    /*!
+     * \details Gets the lowest common ancestors of the items pairs, each pair takes O(log(depth)) time.
+     * \param [in] first forward iterator to the first pair, the pair has the first and second members (like std::pair).
+     * \param [in] last forward iterator to the position after the last pair.
+     * \param [out] outAncestors the ancestors in the same order as the pairs, nullptr for the pairs
+     *                           which have an item that isn't in the index. The previous content is replaced.
+     */
+    template<typename TYPE>
+    template<typename ITERATOR>
+    void TreeItemAncestorIndex<TYPE>::commonAncestors(ITERATOR first, ITERATOR last, std::vector<const TYPE*> & outAncestors) const {
+        outAncestors.clear();
+        outAncestors.reserve(std::size_t(std::distance(first, last)));
+        for (; first != last; ++first) {
+            outAncestors.push_back(commonAncestor(first->first, first->second));
+        }
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Checks whether the item is in the parent's subtree.
+     * \param [in] item
+     * \param [in] parent
+     * \return True if the item is the parent or one of its descendants.
+     */
+    template<typename TYPE>
+    bool TreeItemAncestorIndex<TYPE>::isInSubtree(const Index item, const Index parent) const {
+        return parent <= item && item < parent + mSubtreeSizes[parent];
+    }
+
+    /*!
+     * \details Gets the lowest common ancestor, the first item is lifted to the highest ancestor
+     *          which isn't an ancestor of the second one, then its parent is the result.
+     * \param [in] item1
+     * \param [in] item2
+     * \return Number of the common ancestor.
+     */
+    template<typename TYPE>
+    typename TreeItemAncestorIndex<TYPE>::Index TreeItemAncestorIndex<TYPE>::commonAncestor(Index item1, const Index item2) const {
+        if (isInSubtree(item2, item1)) {
+            return item1;
+        }
+        if (isInSubtree(item1, item2)) {
+            return item2;
+        }
+        for (auto level = mAncestors.rbegin(); level != mAncestors.rend(); ++level) {
+            const Index up = (*level)[item1];
+            if (!isInSubtree(item2, up)) {
+                item1 = up;
+            }
+        }
+        return mAncestors[0][item1];
+    }
+
+    /**************************************************************************************************/
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /**************************************************************************************************/
+}
+}
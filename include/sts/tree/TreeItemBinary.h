@@ -0,0 +1,164 @@
+#pragma once
+
+/*
+**  Copyright(C) 2018, StepToSky
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  1.Redistributions of source code must retain the above copyright notice, this
+**    list of conditions and the following disclaimer.
+**  2.Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and / or other materials provided with the distribution.
+**  3.Neither the name of StepToSky nor the names of its contributors
+**    may be used to endorse or promote products derived from this software
+**    without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**  DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**  Contacts: www.steptosky.com
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <type_traits>
+#include "TreeItemFrozen.h"
+
+namespace sts {
+namespace tree {
+
+    /********************************************************************************************************/
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /********************************************************************************************************/
+
+    /*!
+     * \details Binary format of a hierarchy with a fixed-size payload of each item.
+     * \details The data has the layout of \link sts::tree::TreeItemFrozen \endlink, so it is read in place
+     *          without parsing and allocation, for example from a memory mapped file,
+     *          and the items are traversed with the linear scans.
+     *          All the values are in the host byte order, each part starts at the offset which is a multiple of 8:
+     *          - header (24 bytes): "STSB" (4 bytes), version (uint32), byte order mark 0x01020304 (uint32),
+     *            payload size (uint32), items count (uint64);
+     *          - subtree sizes: uint32 for each item in pre-order;
+     *          - parents: uint32 for each item in pre-order, the root's parent is \link TreeItemBinary::npos \endlink;
+     *          - payloads: PAYLOAD for each item in pre-order.
+     * \details \link TreeItemBinary::materialize \endlink makes the tree items hierarchy in one pass,
+     *          each children list is filled with one \link TreeItem::appendChildren \endlink call.
+     * \code
+     *      TreeItemBinary<YourPayload>::write(stream, root, [](const YourType * item) { return item->payload(); });
+     *      ...
+     *      TreeItemBinary<YourPayload> binary;
+     *      if (binary.open(mappedData, mappedSize) && binary.validate()) {
+     *          YourType * root = binary.materialize<YourType>([](const YourPayload & p) { return new YourType(p); });
+     *      }
+     * \endcode
+     * \note The data must be aligned to 8 bytes and must live while it is used.
+     * \tparam PAYLOAD trivially copyable type of the items data, its alignment must not be more than 8.
+     */
+    template<typename PAYLOAD>
+    class TreeItemBinary {
+    public:
+
+        static_assert(std::is_trivially_copyable<PAYLOAD>::value, "The payload must be trivially copyable");
+        static_assert(alignof(PAYLOAD) <= 8, "The payload alignment must not be more than 8");
+
+        typedef std::uint32_t Index;         /*!< \details Item's pre-order number. */
+        static const Index npos = Index(-1); /*!< \details Means no item. */
+
+        //---------------------------------------------------------------
+        /// @{
+
+        TreeItemBinary() = default;
+        TreeItemBinary(const void * data, std::size_t size);
+
+        /// @}
+        //---------------------------------------------------------------
+        /// @{
+
+        template<typename TYPE>
+        static bool write(std::ostream & stream, const TreeItemFrozen<TYPE, PAYLOAD> & frozen);
+        template<typename TYPE, typename FUNCTION>
+        static bool write(std::ostream & stream, const TYPE * root, FUNCTION payloadOf);
+        static std::size_t dataSize(std::size_t count);
+
+        /// @}
+        //---------------------------------------------------------------
+        /// @{
+
+        bool open(const void * data, std::size_t size);
+        bool validate() const;
+        void close();
+        bool isOpen() const;
+
+        /// @}
+        //---------------------------------------------------------------
+        /// @{
+
+        template<typename TYPE, typename FUNCTION>
+        TYPE * materialize(FUNCTION makeItem) const;
+
+        /// @}
+        //---------------------------------------------------------------
+        /// @{
+
+        Index size() const;
+        const PAYLOAD & payload(Index index) const;
+        const PAYLOAD * payloads() const;
+
+        /// @}
+        //---------------------------------------------------------------
+        /// @{
+
+        Index parent(Index index) const;
+        Index firstChild(Index index) const;
+        Index nextSibling(Index index) const;
+        Index childrenCount(Index index) const;
+        Index subtreeSize(Index index) const;
+        Index subtreeEnd(Index index) const;
+        bool isLeaf(Index index) const;
+        bool isChildOf(Index index, Index parent) const;
+
+        /// @}
+        //---------------------------------------------------------------
+
+    private:
+
+        struct Header {
+            char mMagic[4];
+            std::uint32_t mVersion;
+            std::uint32_t mByteOrder;
+            std::uint32_t mPayloadSize;
+            std::uint64_t mCount;
+        };
+
+        static const std::uint32_t version = 1;
+        static const std::uint32_t byteOrder = 0x01020304;
+
+        Index mCount = 0;
+        const Index * mSubtreeSizes = nullptr;
+        const Index * mParents = nullptr;
+        const PAYLOAD * mPayloads = nullptr;
+
+        static std::size_t aligned(std::size_t size);
+        static bool writeAligned(std::ostream & stream, const void * data, std::size_t size);
+
+    };
+
+    /********************************************************************************************************/
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /********************************************************************************************************/
+}
+}
+
+#include "TreeItemBinary.inl.h"
@@ -0,0 +1,426 @@
+#pragma once
+
+/*
+**  Copyright(C) 2018, StepToSky
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  1.Redistributions of source code must retain the above copyright notice, this
+**    list of conditions and the following disclaimer.
+**  2.Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and / or other materials provided with the distribution.
+**  3.Neither the name of StepToSky nor the names of its contributors
+**    may be used to endorse or promote products derived from this software
+**    without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**  DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**  Contacts: www.steptosky.com
+*/
+
+#include <cassert>
+#include <cstring>
+#include <ostream>
+#include <vector>
+
+namespace sts {
+namespace tree {
+
+    /**************************************************************************************************/
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    template<typename PAYLOAD>
+    const typename TreeItemBinary<PAYLOAD>::Index TreeItemBinary<PAYLOAD>::npos;
+
+    template<typename PAYLOAD>
+    const std::uint32_t TreeItemBinary<PAYLOAD>::version;
+
+    template<typename PAYLOAD>
+    const std::uint32_t TreeItemBinary<PAYLOAD>::byteOrder;
+
+    /*!
+     * \details Constructor init, opens the data.
+     * \param [in] data
+     * \param [in] size data size in bytes.
+     */
+    template<typename PAYLOAD>
+    TreeItemBinary<PAYLOAD>::TreeItemBinary(const void * data, const std::size_t size) {
+        open(data, size);
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Writes the snapshot in the binary format.
+     * \param [in, out] stream binary output stream.
+     * \param [in] frozen the snapshot which must have less than \link TreeItemBinary::npos \endlink items.
+     * \return True if the data is written otherwise false.
+     */
+    template<typename PAYLOAD>
+    template<typename TYPE>
+    bool TreeItemBinary<PAYLOAD>::write(std::ostream & stream, const TreeItemFrozen<TYPE, PAYLOAD> & frozen) {
+        const std::size_t count = frozen.size();
+        if (count == 0 || count >= npos) {
+            return false;
+        }
+        Header header;
+        std::memcpy(header.mMagic, "STSB", sizeof(header.mMagic));
+        header.mVersion = version;
+        header.mByteOrder = byteOrder;
+        header.mPayloadSize = std::uint32_t(sizeof(PAYLOAD));
+        header.mCount = count;
+
+        std::vector<Index> column(count);
+        bool ok = writeAligned(stream, &header, sizeof(header));
+        for (std::size_t i = 0; i < count; ++i) {
+            column[i] = Index(frozen.subtreeSize(i));
+        }
+        ok = ok && writeAligned(stream, column.data(), count * sizeof(Index));
+        for (std::size_t i = 0; i < count; ++i) {
+            column[i] = Index(frozen.parent(i));
+        }
+        ok = ok && writeAligned(stream, column.data(), count * sizeof(Index));
+        ok = ok && writeAligned(stream, frozen.payloads().data(), count * sizeof(PAYLOAD));
+        return ok;
+    }
+
+    /*!
+     * \details Writes the hierarchy in the binary format.
+     * \param [in, out] stream binary output stream.
+     * \param [in] root root of the hierarchy or of its part.
+     * \param [in] payloadOf it is called for each item as PAYLOAD payloadOf(const TYPE *).
+     * \return True if the data is written otherwise false.
+     */
+    template<typename PAYLOAD>
+    template<typename TYPE, typename FUNCTION>
+    bool TreeItemBinary<PAYLOAD>::write(std::ostream & stream, const TYPE * root, FUNCTION payloadOf) {
+        return write(stream, TreeItemFrozen<TYPE, PAYLOAD>(root, payloadOf));
+    }
+
+    /*!
+     * \details Calculates the data size.
+     * \param [in] count items count.
+     * \return Data size in bytes.
+     */
+    template<typename PAYLOAD>
+    std::size_t TreeItemBinary<PAYLOAD>::dataSize(const std::size_t count) {
+        return aligned(sizeof(Header)) + 2 * aligned(count * sizeof(Index)) + aligned(count * sizeof(PAYLOAD));
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Opens the data without copying, it checks the header and the size only,
+     *          use \link TreeItemBinary::validate \endlink if the data may be damaged.
+     * \param [in] data it must be aligned to 8 bytes.
+     * \param [in] size data size in bytes.
+     * \return True if the data is opened otherwise false.
+     */
+    template<typename PAYLOAD>
+    bool TreeItemBinary<PAYLOAD>::open(const void * data, const std::size_t size) {
+        close();
+        if (data == nullptr || reinterpret_cast<std::uintptr_t>(data) % 8 != 0 || size < sizeof(Header)) {
+            return false;
+        }
+        const Header * header = static_cast<const Header *>(data);
+        if (std::memcmp(header->mMagic, "STSB", sizeof(header->mMagic)) != 0 ||
+            header->mVersion != version || header->mByteOrder != byteOrder ||
+            header->mPayloadSize != sizeof(PAYLOAD) || header->mCount == 0 || header->mCount >= npos) {
+            return false;
+        }
+        const std::size_t count = std::size_t(header->mCount);
+        if (size < dataSize(count)) {
+            return false;
+        }
+        const char * bytes = static_cast<const char *>(data) + aligned(sizeof(Header));
+        mSubtreeSizes = reinterpret_cast<const Index *>(bytes);
+        bytes += aligned(count * sizeof(Index));
+        mParents = reinterpret_cast<const Index *>(bytes);
+        bytes += aligned(count * sizeof(Index));
+        mPayloads = reinterpret_cast<const PAYLOAD *>(bytes);
+        mCount = Index(count);
+        return true;
+    }
+
+    /*!
+     * \details Checks the structure of the opened data in O(n): each item's subtree must be inside its parent's one
+     *          and the parent must be the nearest item which subtree contains the item.
+     *          After it the accessors and \link TreeItemBinary::materialize \endlink don't go out of the data.
+     * \return True if the structure is correct otherwise false.
+     */
+    template<typename PAYLOAD>
+    bool TreeItemBinary<PAYLOAD>::validate() const {
+        if (!isOpen() || mParents[0] != npos || mSubtreeSizes[0] != mCount) {
+            return false;
+        }
+        for (Index i = 1; i < mCount; ++i) {
+            // the previous item or its nearest ancestor which subtree isn't ended yet.
+            Index parent = i - 1;
+            while (parent != npos && parent + mSubtreeSizes[parent] <= i) {
+                parent = mParents[parent];
+            }
+            if (parent == npos || mParents[i] != parent ||
+                mSubtreeSizes[i] == 0 || mSubtreeSizes[i] > parent + mSubtreeSizes[parent] - i) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /*!
+     * \details Forgets the data.
+     */
+    template<typename PAYLOAD>
+    void TreeItemBinary<PAYLOAD>::close() {
+        mCount = 0;
+        mSubtreeSizes = nullptr;
+        mParents = nullptr;
+        mPayloads = nullptr;
+    }
+
+    /*!
+     * \details Checks whether the data is opened.
+     * \return True if the data is opened otherwise false.
+     */
+    template<typename PAYLOAD>
+    bool TreeItemBinary<PAYLOAD>::isOpen() const {
+        return mCount != 0;
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Makes the tree items hierarchy from the data in one pass without recursion.
+     *          All the items are made in pre-order, then each children list is filled with
+     *          one \link TreeItem::appendChildren \endlink call.
+     * \details If the function throws an exception the already made items are deleted and the exception is re-thrown.
+     * \pre The data must be opened.
+     * \param [in] makeItem it is called for each item in pre-order as TYPE * makeItem(const PAYLOAD &),
+     *                      so the items may be allocated in a \link sts::tree::TreeItemPool \endlink.
+     * \return Pointer to the root of the new hierarchy.
+     */
+    template<typename PAYLOAD>
+    template<typename TYPE, typename FUNCTION>
+    TYPE * TreeItemBinary<PAYLOAD>::materialize(FUNCTION makeItem) const {
+        assert(isOpen());
+        std::vector<TYPE*> items;
+        items.reserve(mCount);
+        try {
+            for (Index i = 0; i < mCount; ++i) {
+                items.push_back(makeItem(mPayloads[i]));
+                assert(items.back());
+            }
+            std::vector<TYPE*> children;
+            for (Index i = 0; i < mCount; ++i) {
+                if (mSubtreeSizes[i] == 1) {
+                    continue;
+                }
+                children.clear();
+                for (Index child = i + 1; child != npos; child = nextSibling(child)) {
+                    children.push_back(items[child]);
+                }
+                items[i]->appendChildren(children.begin(), children.end());
+            }
+        }
+        catch (...) {
+            // the roots delete their children.
+            std::vector<TYPE*> roots;
+            for (auto & it : items) {
+                if (it->isRoot()) {
+                    roots.push_back(it);
+                }
+            }
+            for (auto & it : roots) {
+                delete it;
+            }
+            throw;
+        }
+        return items.front();
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Gets count of the items.
+     * \return Items count, 0 if the data isn't opened.
+     */
+    template<typename PAYLOAD>
+    typename TreeItemBinary<PAYLOAD>::Index TreeItemBinary<PAYLOAD>::size() const {
+        return mCount;
+    }
+
+    /*!
+     * \details Gets the item's payload.
+     * \param [in] index
+     * \return The payload.
+     */
+    template<typename PAYLOAD>
+    const PAYLOAD & TreeItemBinary<PAYLOAD>::payload(const Index index) const {
+        assert(index < mCount);
+        return mPayloads[index];
+    }
+
+    /*!
+     * \details Gets the payloads column.
+     * \return Pointer to the payloads in pre-order, there are \link TreeItemBinary::size \endlink of them.
+     */
+    template<typename PAYLOAD>
+    const PAYLOAD * TreeItemBinary<PAYLOAD>::payloads() const {
+        return mPayloads;
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Gets the item's parent.
+     * \param [in] index
+     * \return Parent's number or \link TreeItemBinary::npos \endlink for the root.
+     */
+    template<typename PAYLOAD>
+    typename TreeItemBinary<PAYLOAD>::Index TreeItemBinary<PAYLOAD>::parent(const Index index) const {
+        assert(index < mCount);
+        return mParents[index];
+    }
+
+    /*!
+     * \details Gets the item's first child.
+     * \param [in] index
+     * \return First child's number or \link TreeItemBinary::npos \endlink if the item has no children.
+     */
+    template<typename PAYLOAD>
+    typename TreeItemBinary<PAYLOAD>::Index TreeItemBinary<PAYLOAD>::firstChild(const Index index) const {
+        assert(index < mCount);
+        return mSubtreeSizes[index] > 1 ? index + 1 : npos;
+    }
+
+    /*!
+     * \details Gets the item's next sibling.
+     * \param [in] index
+     * \return Next sibling's number or \link TreeItemBinary::npos \endlink if the item is the last child or the root.
+     */
+    template<typename PAYLOAD>
+    typename TreeItemBinary<PAYLOAD>::Index TreeItemBinary<PAYLOAD>::nextSibling(const Index index) const {
+        assert(index < mCount);
+        const Index parent = mParents[index];
+        if (parent == npos) {
+            return npos;
+        }
+        const Index next = index + mSubtreeSizes[index];
+        return next < parent + mSubtreeSizes[parent] ? next : npos;
+    }
+
+    /*!
+     * \details Counts the item's children, it takes O(children count) time.
+     * \param [in] index
+     * \return Children count.
+     */
+    template<typename PAYLOAD>
+    typename TreeItemBinary<PAYLOAD>::Index TreeItemBinary<PAYLOAD>::childrenCount(const Index index) const {
+        Index count = 0;
+        for (Index child = firstChild(index); child != npos; child = nextSibling(child)) {
+            ++count;
+        }
+        return count;
+    }
+
+    /*!
+     * \details Gets the items count in the item's subtree including the item.
+     * \param [in] index
+     * \return Subtree size, the subtree is the range [index, index + size).
+     */
+    template<typename PAYLOAD>
+    typename TreeItemBinary<PAYLOAD>::Index TreeItemBinary<PAYLOAD>::subtreeSize(const Index index) const {
+        assert(index < mCount);
+        return mSubtreeSizes[index];
+    }
+
+    /*!
+     * \details Gets the number after the item's subtree.
+     * \param [in] index
+     * \return The end of the subtree range.
+     */
+    template<typename PAYLOAD>
+    typename TreeItemBinary<PAYLOAD>::Index TreeItemBinary<PAYLOAD>::subtreeEnd(const Index index) const {
+        assert(index < mCount);
+        return index + mSubtreeSizes[index];
+    }
+
+    /*!
+     * \details Checks whether the item has no children.
+     * \param [in] index
+     * \return True if the item has no children otherwise false.
+     */
+    template<typename PAYLOAD>
+    bool TreeItemBinary<PAYLOAD>::isLeaf(const Index index) const {
+        assert(index < mCount);
+        return mSubtreeSizes[index] == 1;
+    }
+
+    /*!
+     * \details Check whether the item is one of the descendants of specified parent in O(1).
+     * \param [in] index
+     * \param [in] parent
+     * \return True if the item has specified item as a parent otherwise false.
+     */
+    template<typename PAYLOAD>
+    bool TreeItemBinary<PAYLOAD>::isChildOf(const Index index, const Index parent) const {
+        assert(index < mCount && parent < mCount);
+        return parent < index && index < parent + mSubtreeSizes[parent];
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Rounds the size up to the multiple of 8.
+     * \param [in] size
+     * \return Aligned size.
+     */
+    template<typename PAYLOAD>
+    std::size_t TreeItemBinary<PAYLOAD>::aligned(const std::size_t size) {
+        return (size + 7) / 8 * 8;
+    }
+
+    /*!
+     * \details Writes the data and the zero padding up to the multiple of 8 bytes.
+     * \param [in, out] stream
+     * \param [in] data
+     * \param [in] size data size in bytes.
+     * \return True if the stream is good otherwise false.
+     */
+    template<typename PAYLOAD>
+    bool TreeItemBinary<PAYLOAD>::writeAligned(std::ostream & stream, const void * data, const std::size_t size) {
+        static const char padding[8] = {};
+        stream.write(static_cast<const char *>(data), std::streamsize(size));
+        stream.write(padding, std::streamsize(aligned(size) - size));
+        return stream.good();
+    }
+
+    /**************************************************************************************************/
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /**************************************************************************************************/
+}
+}
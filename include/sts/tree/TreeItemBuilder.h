@@ -0,0 +1,128 @@
+#pragma once
+
+/*
+**  Copyright(C) 2018, StepToSky
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  1.Redistributions of source code must retain the above copyright notice, this
+**    list of conditions and the following disclaimer.
+**  2.Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and / or other materials provided with the distribution.
+**  3.Neither the name of StepToSky nor the names of its contributors
+**    may be used to endorse or promote products derived from this software
+**    without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**  DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**  Contacts: www.steptosky.com
+*/
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace sts {
+namespace tree {
+
+    /********************************************************************************************************/
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /********************************************************************************************************/
+
+    /*!
+     * \details Builds a hierarchy from a stream of the enter/leave events, for example while parsing a nested input.
+     * \details The children of the open items are collected in one stack which is shared by all the levels,
+     *          so the events don't allocate memory (except the stack's growth).
+     *          When an item is left its children are added with one \link TreeItem::appendChildren \endlink call,
+     *          so each children list is allocated once with the exact size.
+     *          Allocate the items in a \link sts::tree::TreeItemPool \endlink to allocate them in batches too.
+     * \details If the emitter is set the items at the emitting depth are passed to it as soon as they are left
+     *          instead of adding them to their parents, so the subtrees may be processed and deleted
+     *          without holding the whole hierarchy in the memory.
+     * \code
+     *      TreeItemBuilder<YourType> builder;
+     *      builder.enter(new YourType("root"));
+     *      builder.leaf(new YourType("child"));
+     *      builder.leave();
+     *      YourType * root = builder.take();
+     * \endcode
+     * \tparam TYPE your type.
+     */
+    template<typename TYPE>
+    class TreeItemBuilder {
+    public:
+
+        typedef std::size_t Index;
+        /*!
+         * \details It is called for the left subtree and the open item which would be its parent (nullptr for the root),
+         *          the function takes ownership of the subtree.
+         */
+        typedef std::function<void(TYPE * subtree, TYPE * parent)> Emitter;
+
+        //---------------------------------------------------------------
+        /// @{
+
+        TreeItemBuilder() = default;
+        TreeItemBuilder(Index emitDepth, Emitter emitter);
+        ~TreeItemBuilder();
+
+        TreeItemBuilder(const TreeItemBuilder &) = delete;
+        TreeItemBuilder & operator =(const TreeItemBuilder &) = delete;
+
+        /// @}
+        //---------------------------------------------------------------
+        /// @{
+
+        void setEmitter(Index emitDepth, Emitter emitter);
+        Index emitDepth() const;
+
+        /// @}
+        //---------------------------------------------------------------
+        /// @{
+
+        void enter(TYPE * item);
+        void leave();
+        void leaf(TYPE * item);
+
+        /// @}
+        //---------------------------------------------------------------
+        /// @{
+
+        Index depth() const;
+        TYPE * current() const;
+        bool isFinished() const;
+        TYPE * take();
+        void clear();
+
+        /// @}
+        //---------------------------------------------------------------
+
+    private:
+
+        std::vector<TYPE*> mPending;
+        std::vector<Index> mOpen;
+        Index mEmitDepth = 0;
+        Emitter mEmitter;
+
+        bool isEmitting() const;
+
+    };
+
+    /********************************************************************************************************/
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /********************************************************************************************************/
+}
+}
+
+#include "TreeItemBuilder.inl.h"
@@ -0,0 +1,214 @@
+#pragma once
+
+/*
+**  Copyright(C) 2018, StepToSky
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  1.Redistributions of source code must retain the above copyright notice, this
+**    list of conditions and the following disclaimer.
+**  2.Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and / or other materials provided with the distribution.
+**  3.Neither the name of StepToSky nor the names of its contributors
+**    may be used to endorse or promote products derived from this software
+**    without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**  DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**  Contacts: www.steptosky.com
+*/
+
+#include <cassert>
+#include <utility>
+
+namespace sts {
+namespace tree {
+
+    /**************************************************************************************************/
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Constructor init with the emitter.
+     * \param [in] emitDepth depth of the items which are passed to the emitter, 0 is the root.
+     * \param [in] emitter
+     */
+    template<typename TYPE>
+    TreeItemBuilder<TYPE>::TreeItemBuilder(const Index emitDepth, Emitter emitter)
+        : mEmitDepth(emitDepth),
+          mEmitter(std::move(emitter)) {}
+
+    /*!
+     * \details Destructor, deletes the items which aren't taken.
+     */
+    template<typename TYPE>
+    TreeItemBuilder<TYPE>::~TreeItemBuilder() {
+        clear();
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Sets the emitter.
+     * \param [in] emitDepth depth of the items which are passed to the emitter, 0 is the root.
+     * \param [in] emitter the empty function disables the emitting.
+     */
+    template<typename TYPE>
+    void TreeItemBuilder<TYPE>::setEmitter(const Index emitDepth, Emitter emitter) {
+        mEmitDepth = emitDepth;
+        mEmitter = std::move(emitter);
+    }
+
+    /*!
+     * \details Gets the emitting depth.
+     * \return Depth of the items which are passed to the emitter.
+     */
+    template<typename TYPE>
+    typename TreeItemBuilder<TYPE>::Index TreeItemBuilder<TYPE>::emitDepth() const {
+        return mEmitDepth;
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Opens the item, it is the current item's child.
+     * \remark The builder takes ownership of the specified pointer.
+     * \pre The item must have no parent and no children.
+     *      There must be an open item if the root is finished and it isn't emitted.
+     * \param [in, out] item
+     */
+    template<typename TYPE>
+    void TreeItemBuilder<TYPE>::enter(TYPE * item) {
+        assert(item && item->isRoot());
+        assert(!isFinished());
+        mPending.push_back(item);
+        mOpen.push_back(mPending.size());
+    }
+
+    /*!
+     * \details Closes the current item, its children are added to it with one call.
+     *          If the item is at the emitting depth it is passed to the emitter.
+     * \pre There must be an open item.
+     */
+    template<typename TYPE>
+    void TreeItemBuilder<TYPE>::leave() {
+        assert(!mOpen.empty());
+        const Index first = mOpen.back();
+        mOpen.pop_back();
+        TYPE * item = mPending[first - 1];
+        if (first != mPending.size()) {
+            item->appendChildren(mPending.begin() + std::ptrdiff_t(first), mPending.end());
+            mPending.resize(first);
+        }
+        if (isEmitting()) {
+            mPending.pop_back();
+            mEmitter(item, current());
+        }
+    }
+
+    /*!
+     * \details Adds the item without children, it is the same as \link TreeItemBuilder::enter \endlink
+     *          and \link TreeItemBuilder::leave \endlink.
+     * \remark The builder takes ownership of the specified pointer.
+     * \param [in, out] item
+     */
+    template<typename TYPE>
+    void TreeItemBuilder<TYPE>::leaf(TYPE * item) {
+        assert(item && item->isRoot());
+        assert(!isFinished());
+        if (isEmitting()) {
+            mEmitter(item, current());
+        }
+        else {
+            mPending.push_back(item);
+        }
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Gets count of the open items.
+     * \return Depth of the next entered item.
+     */
+    template<typename TYPE>
+    typename TreeItemBuilder<TYPE>::Index TreeItemBuilder<TYPE>::depth() const {
+        return mOpen.size();
+    }
+
+    /*!
+     * \details Gets the current item.
+     * \return The innermost open item or nullptr if there is no open item.
+     * \warning The item has no children until it is left.
+     */
+    template<typename TYPE>
+    TYPE * TreeItemBuilder<TYPE>::current() const {
+        return mOpen.empty() ? nullptr : mPending[mOpen.back() - 1];
+    }
+
+    /*!
+     * \details Checks whether the root is left and it can be taken.
+     * \return True if the root is finished otherwise false.
+     */
+    template<typename TYPE>
+    bool TreeItemBuilder<TYPE>::isFinished() const {
+        return mOpen.empty() && !mPending.empty();
+    }
+
+    /*!
+     * \details Takes the finished root, then the builder may be used for the next hierarchy.
+     * \return The root or nullptr if there is no finished root.
+     */
+    template<typename TYPE>
+    TYPE * TreeItemBuilder<TYPE>::take() {
+        if (!isFinished()) {
+            return nullptr;
+        }
+        TYPE * root = mPending.back();
+        mPending.clear();
+        return root;
+    }
+
+    /*!
+     * \details Deletes all the items which aren't taken or emitted, the emitter is kept.
+     */
+    template<typename TYPE>
+    void TreeItemBuilder<TYPE>::clear() {
+        // each pending item owns the children which are already added to it.
+        for (auto & it : mPending) {
+            delete it;
+        }
+        mPending.clear();
+        mOpen.clear();
+    }
+
+    /*!
+     * \details Checks whether the item which is being closed or added must be emitted.
+     * \return True if the emitter is set and the item's depth is the emitting one.
+     */
+    template<typename TYPE>
+    bool TreeItemBuilder<TYPE>::isEmitting() const {
+        return mEmitter && mOpen.size() == mEmitDepth;
+    }
+
+    /**************************************************************************************************/
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /**************************************************************************************************/
+}
+}
@@ -0,0 +1,213 @@
+#pragma once
+
+/*
+**  Copyright(C) 2018, StepToSky
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  1.Redistributions of source code must retain the above copyright notice, this
+**    list of conditions and the following disclaimer.
+**  2.Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and / or other materials provided with the distribution.
+**  3.Neither the name of StepToSky nor the names of its contributors
+**    may be used to endorse or promote products derived from this software
+**    without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**  DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**  Contacts: www.steptosky.com
+*/
+
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+namespace sts {
+namespace tree {
+
+    /********************************************************************************************************/
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /********************************************************************************************************/
+
+    /*!
+     * \details This class is using as a container for the TreeItem.
+     * \details The children are kept in a counted B+ tree: the leaves keep up to 64 children pointers
+     *          and are linked for iterating, the inner nodes keep up to 32 children nodes with the items count
+     *          of each child subtree, so a child is found by its index with O(log(n)) steps inside the wide nodes.
+     *          operator[], erase(index), insert(index), push_front and push_back are O(log(n)).
+     *          Each child keeps its leaf (the container's Hook), so indexOf and removing a child are O(log(n)) too.
+     * \details It fits the items with a lot of children (100k and more) which are accessed and changed by index.
+     *          An empty container doesn't allocate memory.
+     * \note A range insertion which is larger than 1/8 of the container and remove_if rebuild the tree in O(n).
+     * \warning A tree item can be in one container only. The container can be moved but can't be copied.
+     * \tparam TYPE your tree item type.
+     */
+    template<typename TYPE>
+    class TreeItemContainerBTree {
+        struct Node;
+        struct Leaf;
+        struct Inner;
+    public:
+
+        class Hook {
+            friend class TreeItemContainerBTree;
+            mutable Leaf * mTreeItemLeaf = nullptr;
+        };
+
+        /*!
+         * \details Forward iterator, the pointed values can't be changed through it.
+         */
+        class Iterator {
+            friend class TreeItemContainerBTree;
+        public:
+
+            typedef std::forward_iterator_tag iterator_category;
+            typedef TYPE * value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef TYPE * const * pointer;
+            typedef TYPE * const & reference;
+
+            Iterator() = default;
+
+            reference operator*() const;
+            pointer operator->() const;
+            Iterator & operator++();
+            Iterator operator++(int);
+            bool operator==(const Iterator & other) const;
+            bool operator!=(const Iterator & other) const;
+
+        private:
+
+            Iterator(const Leaf * leaf, std::size_t position);
+
+            const Leaf * mLeaf = nullptr;
+            std::size_t mPosition = 0;
+
+        };
+
+        typedef TYPE * value_type;
+        typedef std::size_t size_type;
+        typedef Iterator iterator;
+        typedef Iterator const_iterator;
+
+        static const std::size_t LeafCapacity = 64;  /*!< \details Max count of the items in a leaf. */
+        static const std::size_t InnerCapacity = 32; /*!< \details Max count of the children nodes in an inner node. */
+
+        //---------------------------------------------------------------
+        /// @{
+
+        TreeItemContainerBTree() = default;
+        TreeItemContainerBTree(TreeItemContainerBTree && other);
+        TreeItemContainerBTree & operator =(TreeItemContainerBTree && other);
+        ~TreeItemContainerBTree();
+
+        TreeItemContainerBTree(const TreeItemContainerBTree &) = delete;
+        TreeItemContainerBTree & operator =(const TreeItemContainerBTree &) = delete;
+
+        /// @}
+        //---------------------------------------------------------------
+        /// @{
+
+        Iterator begin() const;
+        Iterator end() const;
+        std::size_t size() const;
+        bool empty() const;
+        void clear();
+
+        /// @}
+        //---------------------------------------------------------------
+        /// @{
+
+        TYPE * operator[](std::size_t index) const;
+        TYPE * erase(std::size_t index);
+        void insert(std::size_t index, TYPE * val);
+        template<typename ITERATOR>
+        void insert(std::size_t index, ITERATOR first, ITERATOR last);
+        void push_front(TYPE * val);
+        void push_back(TYPE * val);
+        void reserve(std::size_t);
+
+        /// @}
+        //---------------------------------------------------------------
+        /// @{
+
+        std::size_t indexOf(const TYPE * item) const;
+        bool remove(const TYPE * item);
+        template<typename PREDICATE>
+        void remove_if(PREDICATE predicate);
+
+        /// @}
+        //---------------------------------------------------------------
+
+    private:
+
+        struct Node {
+            explicit Node(const bool leaf)
+                : mLeaf(leaf) {}
+
+            Inner * mParent = nullptr;
+            std::size_t mSize = 0; /*!< \details Count of the entries in this node. */
+            const bool mLeaf;
+        };
+
+        struct Leaf : Node {
+            Leaf()
+                : Node(true) {}
+
+            Leaf * mPrevious = nullptr;
+            Leaf * mNext = nullptr;
+            TYPE * mItems[LeafCapacity];
+        };
+
+        struct Inner : Node {
+            Inner()
+                : Node(false) {}
+
+            std::size_t mCounts[InnerCapacity]; /*!< \details Items count of each child subtree. */
+            Node * mChildren[InnerCapacity];
+        };
+
+        Node * mRoot = nullptr;
+        Leaf * mFirst = nullptr;
+        Leaf * mLast = nullptr;
+        std::size_t mSize = 0;
+
+        static Leaf *& leafOf(const TYPE * item);
+        static std::size_t countOf(const Node * node, std::size_t position, std::size_t count);
+        static std::size_t childIndex(const Inner * parent, const Node * child);
+
+        Leaf * findLeaf(std::size_t & inOutIndex) const;
+        void addCount(Node * node, std::size_t count, bool increase);
+        void insertAt(Leaf * leaf, std::size_t position, TYPE * val);
+        TYPE * eraseAt(Leaf * leaf, std::size_t position);
+        Leaf * splitLeaf(Leaf * leaf);
+        void splitInner(Inner * node);
+        void insertNode(Node * left, Node * right);
+        void rebalance(Node * node);
+        static void moveEntries(Node * from, std::size_t fromPosition, Node * to, std::size_t toPosition, std::size_t count);
+        static void removeEntry(Inner * node, std::size_t position);
+        void build(const std::vector<TYPE*> & items);
+        void collect(std::vector<TYPE*> & outItems) const;
+        void release();
+        static void releaseNode(Node * node);
+
+    };
+
+    /********************************************************************************************************/
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /********************************************************************************************************/
+}
+}
+
+#include "TreeItemContainerBTree.inl.h"
@@ -0,0 +1,693 @@
+#pragma once
+
+
+/*
+**  Copyright(C) 2018, StepToSky
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  1.Redistributions of source code must retain the above copyright notice, this
+**    list of conditions and the following disclaimer.
+**  2.Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and / or other materials provided with the distribution.
+**  3.Neither the name of StepToSky nor the names of its contributors
+**    may be used to endorse or promote products derived from this software
+**    without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**  DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**  Contacts: www.steptosky.com
+*/
+
+#include <cassert>
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace sts {
+namespace tree {
+
+    /**************************************************************************************************/
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    template<typename TYPE>
+    const std::size_t TreeItemContainerBTree<TYPE>::LeafCapacity;
+
+    template<typename TYPE>
+    const std::size_t TreeItemContainerBTree<TYPE>::InnerCapacity;
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Iterator */////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    template<typename TYPE>
+    TreeItemContainerBTree<TYPE>::Iterator::Iterator(const Leaf * leaf, const std::size_t position)
+        : mLeaf(leaf),
+          mPosition(position) {}
+
+    template<typename TYPE>
+    typename TreeItemContainerBTree<TYPE>::Iterator::reference TreeItemContainerBTree<TYPE>::Iterator::operator*() const {
+        return mLeaf->mItems[mPosition];
+    }
+
+    template<typename TYPE>
+    typename TreeItemContainerBTree<TYPE>::Iterator::pointer TreeItemContainerBTree<TYPE>::Iterator::operator->() const {
+        return &mLeaf->mItems[mPosition];
+    }
+
+    template<typename TYPE>
+    typename TreeItemContainerBTree<TYPE>::Iterator & TreeItemContainerBTree<TYPE>::Iterator::operator++() {
+        if (++mPosition == mLeaf->mSize) {
+            mLeaf = mLeaf->mNext;
+            mPosition = 0;
+        }
+        return *this;
+    }
+
+    template<typename TYPE>
+    typename TreeItemContainerBTree<TYPE>::Iterator TreeItemContainerBTree<TYPE>::Iterator::operator++(int) {
+        Iterator out(*this);
+        ++(*this);
+        return out;
+    }
+
+    template<typename TYPE>
+    bool TreeItemContainerBTree<TYPE>::Iterator::operator==(const Iterator & other) const {
+        return mLeaf == other.mLeaf && mPosition == other.mPosition;
+    }
+
+    template<typename TYPE>
+    bool TreeItemContainerBTree<TYPE>::Iterator::operator!=(const Iterator & other) const {
+        return !(*this == other);
+    }
+
+    /**************************************************************************************************/
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Constructor move.
+     */
+    template<typename TYPE>
+    TreeItemContainerBTree<TYPE>::TreeItemContainerBTree(TreeItemContainerBTree && other)
+        : mRoot(other.mRoot),
+          mFirst(other.mFirst),
+          mLast(other.mLast),
+          mSize(other.mSize) {
+        other.mRoot = nullptr;
+        other.mFirst = nullptr;
+        other.mLast = nullptr;
+        other.mSize = 0;
+    }
+
+    /*!
+     * \details Operator move.
+     */
+    template<typename TYPE>
+    TreeItemContainerBTree<TYPE> & TreeItemContainerBTree<TYPE>::operator =(TreeItemContainerBTree && other) {
+        if (this != &other) {
+            release();
+            std::swap(mRoot, other.mRoot);
+            std::swap(mFirst, other.mFirst);
+            std::swap(mLast, other.mLast);
+            std::swap(mSize, other.mSize);
+        }
+        return *this;
+    }
+
+    /*!
+     * \details Destructor, it releases the nodes only, the items aren't touched as they may be deleted already.
+     */
+    template<typename TYPE>
+    TreeItemContainerBTree<TYPE>::~TreeItemContainerBTree() {
+        release();
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    template<typename TYPE>
+    typename TreeItemContainerBTree<TYPE>::Iterator TreeItemContainerBTree<TYPE>::begin() const {
+        return mFirst ? Iterator(mFirst, 0) : Iterator();
+    }
+
+    template<typename TYPE>
+    typename TreeItemContainerBTree<TYPE>::Iterator TreeItemContainerBTree<TYPE>::end() const {
+        return Iterator();
+    }
+
+    template<typename TYPE>
+    std::size_t TreeItemContainerBTree<TYPE>::size() const {
+        return mSize;
+    }
+
+    template<typename TYPE>
+    bool TreeItemContainerBTree<TYPE>::empty() const {
+        return mSize == 0;
+    }
+
+    /*!
+     * \details Removes all the items.
+     */
+    template<typename TYPE>
+    void TreeItemContainerBTree<TYPE>::clear() {
+        for (Leaf * leaf = mFirst; leaf; leaf = leaf->mNext) {
+            for (std::size_t i = 0; i < leaf->mSize; ++i) {
+                leafOf(leaf->mItems[i]) = nullptr;
+            }
+        }
+        release();
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    template<typename TYPE>
+    TYPE * TreeItemContainerBTree<TYPE>::operator[](std::size_t index) const {
+        assert(index < mSize);
+        const Leaf * leaf = findLeaf(index);
+        return leaf->mItems[index];
+    }
+
+    template<typename TYPE>
+    TYPE * TreeItemContainerBTree<TYPE>::erase(std::size_t index) {
+        assert(index < mSize);
+        Leaf * leaf = findLeaf(index);
+        return eraseAt(leaf, index);
+    }
+
+    template<typename TYPE>
+    void TreeItemContainerBTree<TYPE>::insert(std::size_t index, TYPE * val) {
+        assert(index <= mSize);
+        if (mRoot == nullptr) {
+            push_back(val);
+            return;
+        }
+        Leaf * leaf = findLeaf(index);
+        insertAt(leaf, index, val);
+    }
+
+    /*!
+     * \details Inserts the items one by one if there are a few of them,
+     *          otherwise rebuilds the tree with all the items in O(n).
+     */
+    template<typename TYPE>
+    template<typename ITERATOR>
+    void TreeItemContainerBTree<TYPE>::insert(std::size_t index, ITERATOR first, ITERATOR last) {
+        assert(index <= mSize);
+        const std::size_t count = std::size_t(std::distance(first, last));
+        if (count * 8 > mSize) {
+            std::vector<TYPE*> items;
+            items.reserve(mSize + count);
+            collect(items);
+            items.insert(items.begin() + index, first, last);
+            build(items);
+        }
+        else {
+            for (; first != last; ++first, ++index) {
+                insert(index, *first);
+            }
+        }
+    }
+
+    template<typename TYPE>
+    void TreeItemContainerBTree<TYPE>::push_front(TYPE * val) {
+        if (mRoot == nullptr) {
+            push_back(val);
+            return;
+        }
+        insertAt(mFirst, 0, val);
+    }
+
+    template<typename TYPE>
+    void TreeItemContainerBTree<TYPE>::push_back(TYPE * val) {
+        if (mRoot == nullptr) {
+            mFirst = mLast = new Leaf;
+            mRoot = mFirst;
+        }
+        insertAt(mLast, mLast->mSize, val);
+    }
+
+    template<typename TYPE>
+    void TreeItemContainerBTree<TYPE>::reserve(const std::size_t) {}
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Gets the item's index by its leaf.
+     * \return Index or std::size_t(-1) if the item isn't in this container.
+     */
+    template<typename TYPE>
+    std::size_t TreeItemContainerBTree<TYPE>::indexOf(const TYPE * item) const {
+        const Leaf * leaf = leafOf(item);
+        if (leaf == nullptr) {
+            return std::size_t(-1);
+        }
+        const auto position = std::find(leaf->mItems, leaf->mItems + leaf->mSize, item);
+        assert(position != leaf->mItems + leaf->mSize);
+        std::size_t index = std::size_t(position - leaf->mItems);
+        const Node * node = leaf;
+        while (node->mParent) {
+            const Inner * parent = node->mParent;
+            const std::size_t child = childIndex(parent, node);
+            for (std::size_t i = 0; i < child; ++i) {
+                index += parent->mCounts[i];
+            }
+            node = parent;
+        }
+        return node == mRoot ? index : std::size_t(-1);
+    }
+
+    /*!
+     * \pre The item must be in this container.
+     */
+    template<typename TYPE>
+    bool TreeItemContainerBTree<TYPE>::remove(const TYPE * item) {
+        Leaf * leaf = leafOf(item);
+        assert(leaf);
+        const auto position = std::find(leaf->mItems, leaf->mItems + leaf->mSize, item);
+        assert(position != leaf->mItems + leaf->mSize);
+        eraseAt(leaf, std::size_t(position - leaf->mItems));
+        return true;
+    }
+
+    /*!
+     * \details Removes the items for which the predicate returns true, the tree is rebuilt in O(n).
+     */
+    template<typename TYPE>
+    template<typename PREDICATE>
+    void TreeItemContainerBTree<TYPE>::remove_if(PREDICATE predicate) {
+        std::vector<TYPE*> items;
+        items.reserve(mSize);
+        for (Leaf * leaf = mFirst; leaf; leaf = leaf->mNext) {
+            for (std::size_t i = 0; i < leaf->mSize; ++i) {
+                TYPE * item = leaf->mItems[i];
+                if (predicate(item)) {
+                    leafOf(item) = nullptr;
+                }
+                else {
+                    items.push_back(item);
+                }
+            }
+        }
+        if (items.size() != mSize) {
+            build(items);
+        }
+    }
+
+    /**************************************************************************************************/
+    ////////////////////////////////////////////* Nodes *///////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    template<typename TYPE>
+    typename TreeItemContainerBTree<TYPE>::Leaf *& TreeItemContainerBTree<TYPE>::leafOf(const TYPE * item) {
+        return static_cast<const Hook*>(item)->mTreeItemLeaf;
+    }
+
+    /*!
+     * \return Items count of the node's entries range.
+     */
+    template<typename TYPE>
+    std::size_t TreeItemContainerBTree<TYPE>::countOf(const Node * node, const std::size_t position, const std::size_t count) {
+        if (node->mLeaf) {
+            return count;
+        }
+        const Inner * inner = static_cast<const Inner*>(node);
+        std::size_t out = 0;
+        for (std::size_t i = position; i < position + count; ++i) {
+            out += inner->mCounts[i];
+        }
+        return out;
+    }
+
+    template<typename TYPE>
+    std::size_t TreeItemContainerBTree<TYPE>::childIndex(const Inner * parent, const Node * child) {
+        const auto it = std::find(parent->mChildren, parent->mChildren + parent->mSize, child);
+        assert(it != parent->mChildren + parent->mSize);
+        return std::size_t(it - parent->mChildren);
+    }
+
+    /*!
+     * \details Finds the leaf which contains the item with the specified index.
+     * \param [in, out] inOutIndex item's index in the container, it becomes the item's index in the leaf.
+     *                  The index which equals the items count gives the last leaf.
+     */
+    template<typename TYPE>
+    typename TreeItemContainerBTree<TYPE>::Leaf * TreeItemContainerBTree<TYPE>::findLeaf(std::size_t & inOutIndex) const {
+        Node * node = mRoot;
+        while (!node->mLeaf) {
+            const Inner * inner = static_cast<const Inner*>(node);
+            std::size_t i = 0;
+            while (i + 1 < inner->mSize && inOutIndex >= inner->mCounts[i]) {
+                inOutIndex -= inner->mCounts[i];
+                ++i;
+            }
+            node = inner->mChildren[i];
+        }
+        return static_cast<Leaf*>(node);
+    }
+
+    /*!
+     * \details Changes the items count of the node in all its ancestors.
+     */
+    template<typename TYPE>
+    void TreeItemContainerBTree<TYPE>::addCount(Node * node, const std::size_t count, const bool increase) {
+        while (node->mParent) {
+            Inner * parent = node->mParent;
+            std::size_t & parentCount = parent->mCounts[childIndex(parent, node)];
+            parentCount = increase ? parentCount + count : parentCount - count;
+            node = parent;
+        }
+    }
+
+    template<typename TYPE>
+    void TreeItemContainerBTree<TYPE>::insertAt(Leaf * leaf, std::size_t position, TYPE * val) {
+        if (leaf->mSize == LeafCapacity) {
+            Leaf * right = splitLeaf(leaf);
+            if (position > leaf->mSize) {
+                position -= leaf->mSize;
+                leaf = right;
+            }
+        }
+        std::copy_backward(leaf->mItems + position, leaf->mItems + leaf->mSize, leaf->mItems + leaf->mSize + 1);
+        leaf->mItems[position] = val;
+        ++leaf->mSize;
+        leafOf(val) = leaf;
+        ++mSize;
+        addCount(leaf, 1, true);
+    }
+
+    template<typename TYPE>
+    TYPE * TreeItemContainerBTree<TYPE>::eraseAt(Leaf * leaf, const std::size_t position) {
+        TYPE * out = leaf->mItems[position];
+        std::copy(leaf->mItems + position + 1, leaf->mItems + leaf->mSize, leaf->mItems + position);
+        --leaf->mSize;
+        leafOf(out) = nullptr;
+        --mSize;
+        addCount(leaf, 1, false);
+        rebalance(leaf);
+        return out;
+    }
+
+    /*!
+     * \details Moves the upper half of the full leaf to a new leaf which is placed right after it.
+     * \return The new leaf.
+     */
+    template<typename TYPE>
+    typename TreeItemContainerBTree<TYPE>::Leaf * TreeItemContainerBTree<TYPE>::splitLeaf(Leaf * leaf) {
+        Leaf * right = new Leaf;
+        const std::size_t half = leaf->mSize / 2;
+        moveEntries(leaf, half, right, 0, leaf->mSize - half);
+        right->mPrevious = leaf;
+        right->mNext = leaf->mNext;
+        if (leaf->mNext) {
+            leaf->mNext->mPrevious = right;
+        }
+        else {
+            mLast = right;
+        }
+        leaf->mNext = right;
+        insertNode(leaf, right);
+        return right;
+    }
+
+    /*!
+     * \details Moves the upper half of the full inner node to a new node which is placed right after it.
+     */
+    template<typename TYPE>
+    void TreeItemContainerBTree<TYPE>::splitInner(Inner * node) {
+        Inner * right = new Inner;
+        const std::size_t half = node->mSize / 2;
+        moveEntries(node, half, right, 0, node->mSize - half);
+        insertNode(node, right);
+    }
+
+    /*!
+     * \details Places the new node right after the left one in the left node's parent.
+     *          The new node's items are still counted in the left node's parent count.
+     */
+    template<typename TYPE>
+    void TreeItemContainerBTree<TYPE>::insertNode(Node * left, Node * right) {
+        const std::size_t rightCount = countOf(right, 0, right->mSize);
+        if (left == mRoot) {
+            Inner * root = new Inner;
+            root->mChildren[0] = left;
+            root->mChildren[1] = right;
+            root->mCounts[0] = countOf(left, 0, left->mSize);
+            root->mCounts[1] = rightCount;
+            root->mSize = 2;
+            left->mParent = root;
+            right->mParent = root;
+            mRoot = root;
+            return;
+        }
+        if (left->mParent->mSize == InnerCapacity) {
+            splitInner(left->mParent);
+        }
+        Inner * parent = left->mParent;
+        const std::size_t i = childIndex(parent, left);
+        std::copy_backward(parent->mChildren + i + 1, parent->mChildren + parent->mSize, parent->mChildren + parent->mSize + 1);
+        std::copy_backward(parent->mCounts + i + 1, parent->mCounts + parent->mSize, parent->mCounts + parent->mSize + 1);
+        parent->mChildren[i + 1] = right;
+        parent->mCounts[i + 1] = rightCount;
+        parent->mCounts[i] -= rightCount;
+        ++parent->mSize;
+        right->mParent = parent;
+    }
+
+    /*!
+     * \details Merges the node which has less than 1/4 of its capacity with its sibling
+     *          or takes some entries from the sibling if they don't fit into one node.
+     */
+    template<typename TYPE>
+    void TreeItemContainerBTree<TYPE>::rebalance(Node * node) {
+        if (node == mRoot) {
+            if (node->mLeaf) {
+                if (node->mSize == 0) {
+                    delete static_cast<Leaf*>(node);
+                    mRoot = nullptr;
+                    mFirst = nullptr;
+                    mLast = nullptr;
+                }
+            }
+            else if (node->mSize == 1) {
+                Inner * root = static_cast<Inner*>(node);
+                mRoot = root->mChildren[0];
+                mRoot->mParent = nullptr;
+                delete root;
+            }
+            return;
+        }
+        const std::size_t capacity = node->mLeaf ? LeafCapacity : InnerCapacity;
+        if (node->mSize >= capacity / 4) {
+            return;
+        }
+        Inner * parent = node->mParent;
+        std::size_t i = childIndex(parent, node);
+        if (i + 1 == parent->mSize) {
+            --i;
+        }
+        Node * left = parent->mChildren[i];
+        Node * right = parent->mChildren[i + 1];
+        if (left->mSize + right->mSize <= capacity) {
+            moveEntries(right, 0, left, left->mSize, right->mSize);
+            parent->mCounts[i] += parent->mCounts[i + 1];
+            removeEntry(parent, i + 1);
+            if (right->mLeaf) {
+                Leaf * leftLeaf = static_cast<Leaf*>(left);
+                Leaf * rightLeaf = static_cast<Leaf*>(right);
+                leftLeaf->mNext = rightLeaf->mNext;
+                if (rightLeaf->mNext) {
+                    rightLeaf->mNext->mPrevious = leftLeaf;
+                }
+                else {
+                    mLast = leftLeaf;
+                }
+                delete rightLeaf;
+            }
+            else {
+                delete static_cast<Inner*>(right);
+            }
+            rebalance(parent);
+        }
+        else {
+            const std::size_t leftSize = (left->mSize + right->mSize) / 2;
+            if (left->mSize > leftSize) {
+                const std::size_t count = left->mSize - leftSize;
+                const std::size_t moved = countOf(left, leftSize, count);
+                moveEntries(left, leftSize, right, 0, count);
+                parent->mCounts[i] -= moved;
+                parent->mCounts[i + 1] += moved;
+            }
+            else {
+                const std::size_t count = leftSize - left->mSize;
+                const std::size_t moved = countOf(right, 0, count);
+                moveEntries(right, 0, left, left->mSize, count);
+                parent->mCounts[i] += moved;
+                parent->mCounts[i + 1] -= moved;
+            }
+        }
+    }
+
+    /*!
+     * \details Moves the entries range of one node into another node of the same kind.
+     *          The items count of the nodes in their ancestors isn't changed.
+     */
+    template<typename TYPE>
+    void TreeItemContainerBTree<TYPE>::moveEntries(Node * from, const std::size_t fromPosition,
+                                                   Node * to, const std::size_t toPosition, const std::size_t count) {
+        assert(from->mLeaf == to->mLeaf);
+        if (from->mLeaf) {
+            Leaf * source = static_cast<Leaf*>(from);
+            Leaf * target = static_cast<Leaf*>(to);
+            std::copy_backward(target->mItems + toPosition, target->mItems + target->mSize, target->mItems + target->mSize + count);
+            std::copy(source->mItems + fromPosition, source->mItems + fromPosition + count, target->mItems + toPosition);
+            std::copy(source->mItems + fromPosition + count, source->mItems + source->mSize, source->mItems + fromPosition);
+            for (std::size_t i = toPosition; i < toPosition + count; ++i) {
+                leafOf(target->mItems[i]) = target;
+            }
+        }
+        else {
+            Inner * source = static_cast<Inner*>(from);
+            Inner * target = static_cast<Inner*>(to);
+            std::copy_backward(target->mChildren + toPosition, target->mChildren + target->mSize, target->mChildren + target->mSize + count);
+            std::copy_backward(target->mCounts + toPosition, target->mCounts + target->mSize, target->mCounts + target->mSize + count);
+            std::copy(source->mChildren + fromPosition, source->mChildren + fromPosition + count, target->mChildren + toPosition);
+            std::copy(source->mCounts + fromPosition, source->mCounts + fromPosition + count, target->mCounts + toPosition);
+            std::copy(source->mChildren + fromPosition + count, source->mChildren + source->mSize, source->mChildren + fromPosition);
+            std::copy(source->mCounts + fromPosition + count, source->mCounts + source->mSize, source->mCounts + fromPosition);
+            for (std::size_t i = toPosition; i < toPosition + count; ++i) {
+                target->mChildren[i]->mParent = target;
+            }
+        }
+        from->mSize -= count;
+        to->mSize += count;
+    }
+
+    template<typename TYPE>
+    void TreeItemContainerBTree<TYPE>::removeEntry(Inner * node, const std::size_t position) {
+        std::copy(node->mChildren + position + 1, node->mChildren + node->mSize, node->mChildren + position);
+        std::copy(node->mCounts + position + 1, node->mCounts + node->mSize, node->mCounts + position);
+        --node->mSize;
+    }
+
+    /*!
+     * \details Makes the tree of the specified items in O(n), the nodes are filled on 3/4.
+     */
+    template<typename TYPE>
+    void TreeItemContainerBTree<TYPE>::build(const std::vector<TYPE*> & items) {
+        release();
+        if (items.empty()) {
+            return;
+        }
+        mSize = items.size();
+        const std::size_t leafFill = LeafCapacity * 3 / 4;
+        const std::size_t leavesCount = (items.size() + leafFill - 1) / leafFill;
+        std::vector<Node*> level;
+        std::vector<std::size_t> counts;
+        level.reserve(leavesCount);
+        counts.reserve(leavesCount);
+        auto item = items.begin();
+        for (std::size_t l = 0; l < leavesCount; ++l) {
+            Leaf * leaf = new Leaf;
+            leaf->mSize = items.size() / leavesCount + (l < items.size() % leavesCount ? 1 : 0);
+            for (std::size_t i = 0; i < leaf->mSize; ++i, ++item) {
+                leaf->mItems[i] = *item;
+                leafOf(*item) = leaf;
+            }
+            leaf->mPrevious = mLast;
+            if (mLast) {
+                mLast->mNext = leaf;
+            }
+            else {
+                mFirst = leaf;
+            }
+            mLast = leaf;
+            level.push_back(leaf);
+            counts.push_back(leaf->mSize);
+        }
+
+        const std::size_t innerFill = InnerCapacity * 3 / 4;
+        while (level.size() > 1) {
+            const std::size_t nodesCount = (level.size() + innerFill - 1) / innerFill;
+            std::vector<Node*> upperLevel;
+            std::vector<std::size_t> upperCounts;
+            upperLevel.reserve(nodesCount);
+            upperCounts.reserve(nodesCount);
+            std::size_t position = 0;
+            for (std::size_t n = 0; n < nodesCount; ++n) {
+                Inner * inner = new Inner;
+                inner->mSize = level.size() / nodesCount + (n < level.size() % nodesCount ? 1 : 0);
+                std::size_t count = 0;
+                for (std::size_t i = 0; i < inner->mSize; ++i, ++position) {
+                    inner->mChildren[i] = level[position];
+                    inner->mCounts[i] = counts[position];
+                    level[position]->mParent = inner;
+                    count += counts[position];
+                }
+                upperLevel.push_back(inner);
+                upperCounts.push_back(count);
+            }
+            level.swap(upperLevel);
+            counts.swap(upperCounts);
+        }
+        mRoot = level.front();
+    }
+
+    template<typename TYPE>
+    void TreeItemContainerBTree<TYPE>::collect(std::vector<TYPE*> & outItems) const {
+        for (const Leaf * leaf = mFirst; leaf; leaf = leaf->mNext) {
+            outItems.insert(outItems.end(), leaf->mItems, leaf->mItems + leaf->mSize);
+        }
+    }
+
+    /*!
+     * \details Deletes all the nodes, the items aren't touched.
+     */
+    template<typename TYPE>
+    void TreeItemContainerBTree<TYPE>::release() {
+        releaseNode(mRoot);
+        mRoot = nullptr;
+        mFirst = nullptr;
+        mLast = nullptr;
+        mSize = 0;
+    }
+
+    template<typename TYPE>
+    void TreeItemContainerBTree<TYPE>::releaseNode(Node * node) {
+        if (node == nullptr) {
+            return;
+        }
+        if (node->mLeaf) {
+            delete static_cast<Leaf*>(node);
+            return;
+        }
+        Inner * inner = static_cast<Inner*>(node);
+        for (std::size_t i = 0; i < inner->mSize; ++i) {
+            releaseNode(inner->mChildren[i]);
+        }
+        delete inner;
+    }
+
+    /**************************************************************************************************/
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /**************************************************************************************************/
+}
+}
@@ -29,8 +29,14 @@
 **  Contacts: www.steptosky.com
 */
 
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 #include <list>
+#include <iterator>
+#include <algorithm>
+#include <cassert>
+#include <utility>
 
 namespace sts {
 namespace tree {
@@ -39,6 +45,163 @@ namespace tree {
     ////////////////////////////////////////////////////////////////////////////////////////////////////
     /**************************************************************************************************/
 
+    /*!
+     * \details Per-child data which a container keeps inside the tree item.
+     *          The tree item inherits the container's Hook type,
+     *          containers that don't need any data use this empty one.
+     */
+    struct TreeItemNoHook {};
+
+    /**************************************************************************************************/
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details The container access of the TreeItem.
+     * \details A container must provide:
+     *          operator[], erase(index), insert(index, item), push_front, push_back, size, empty,
+     *          the forward iterators with the const_iterator type and the default constructor.
+     *          The next members are optional, the faster paths are used if the container provides them:
+     *          - Hook, the per-child data which the tree item inherits, \link sts::tree::TreeItemNoHook \endlink otherwise.
+     *          - indexOf(item) which returns the index or std::size_t(-1), the linear search otherwise.
+     *          - remove(item) which returns whether the item was removed, indexOf and erase(index) otherwise.
+     *          - remove_if(predicate), erase(index) for each matched item otherwise.
+     *          - insert(index, first, last), insert(index, item) for each item otherwise.
+     *          - reserve(count), nothing otherwise.
+     *          - The move constructor and operator, the copy ones are used by std::swap otherwise.
+     * \tparam CONTAINER container type.
+     */
+    template<typename CONTAINER>
+    class TreeItemContainerTraits {
+
+        template<typename T>
+        struct Void {
+            typedef void Type;
+        };
+
+        template<typename C, typename = void>
+        struct HookOf {
+            typedef TreeItemNoHook Type;
+        };
+
+        template<typename C>
+        struct HookOf<C, typename Void<typename C::Hook>::Type> {
+            typedef typename C::Hook Type;
+        };
+
+    public:
+
+        typedef typename HookOf<CONTAINER>::Type Hook;
+
+        //--------------------------------------------
+
+        template<typename ITEM>
+        static std::size_t indexOf(const CONTAINER & container, const ITEM * item) {
+            return indexOf(container, item, 0);
+        }
+
+        template<typename ITEM>
+        static bool remove(CONTAINER & container, const ITEM * item) {
+            return remove(container, item, 0);
+        }
+
+        template<typename PREDICATE>
+        static void remove_if(CONTAINER & container, PREDICATE predicate) {
+            removeIf(container, predicate, 0);
+        }
+
+        template<typename ITERATOR>
+        static void insert(CONTAINER & container, const std::size_t index, ITERATOR first, ITERATOR last) {
+            insert(container, index, first, last, 0);
+        }
+
+        static void reserve(CONTAINER & container, const std::size_t count) {
+            reserve(container, count, 0);
+        }
+
+        //--------------------------------------------
+
+    private:
+
+        template<typename C, typename ITEM>
+        static auto indexOf(const C & container, const ITEM * item, int)
+            -> decltype(std::size_t(container.indexOf(item))) {
+            return container.indexOf(item);
+        }
+
+        template<typename C, typename ITEM>
+        static std::size_t indexOf(const C & container, const ITEM * item, long) {
+            std::size_t index = 0;
+            for (auto it = container.begin(); it != container.end(); ++it, ++index) {
+                if (*it == item) {
+                    return index;
+                }
+            }
+            return std::size_t(-1);
+        }
+
+        template<typename C, typename ITEM>
+        static auto remove(C & container, const ITEM * item, int)
+            -> decltype(bool(container.remove(item))) {
+            return container.remove(item);
+        }
+
+        template<typename C, typename ITEM>
+        static bool remove(C & container, const ITEM * item, long) {
+            const std::size_t index = indexOf(container, item);
+            if (index == std::size_t(-1)) {
+                return false;
+            }
+            container.erase(index);
+            return true;
+        }
+
+        template<typename C, typename PREDICATE>
+        static auto removeIf(C & container, PREDICATE predicate, int)
+            -> decltype(container.remove_if(predicate), void()) {
+            container.remove_if(predicate);
+        }
+
+        template<typename C, typename PREDICATE>
+        static void removeIf(C & container, PREDICATE predicate, long) {
+            for (std::size_t i = 0; i < container.size();) {
+                if (predicate(container[i])) {
+                    container.erase(i);
+                }
+                else {
+                    ++i;
+                }
+            }
+        }
+
+        template<typename C, typename ITERATOR>
+        static auto insert(C & container, const std::size_t index, ITERATOR first, ITERATOR last, int)
+            -> decltype(container.insert(index, first, last), void()) {
+            container.insert(index, first, last);
+        }
+
+        template<typename C, typename ITERATOR>
+        static void insert(C & container, std::size_t index, ITERATOR first, ITERATOR last, long) {
+            for (; first != last; ++first, ++index) {
+                container.insert(index, *first);
+            }
+        }
+
+        template<typename C>
+        static auto reserve(C & container, const std::size_t count, int)
+            -> decltype(container.reserve(count), void()) {
+            container.reserve(count);
+        }
+
+        template<typename C>
+        static void reserve(C &, const std::size_t, long) {}
+
+    };
+
+    /**************************************************************************************************/
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /**************************************************************************************************/
+
     /*!
      * \details This class is using as a container for the TreeItem.
      */
@@ -47,6 +210,8 @@ namespace tree {
         typedef std::vector<TYPE *> Container;
     public:
 
+        typedef TreeItemNoHook Hook;
+
         //--------------------------------------------
 
         TYPE * operator[](const std::size_t index) {
@@ -76,6 +241,11 @@ namespace tree {
             Container::insert(Container::begin() + index, val);
         }
 
+        template<typename ITERATOR>
+        void insert(const std::size_t index, ITERATOR first, ITERATOR last) {
+            Container::insert(Container::begin() + index, first, last);
+        }
+
         //--------------------------------------------
 
         void push_front(TYPE * val) {
@@ -84,6 +254,32 @@ namespace tree {
 
         //--------------------------------------------
 
+        std::size_t indexOf(const TYPE * item) const {
+            for (std::size_t i = 0; i < Container::size(); ++i) {
+                if (Container::operator[](i) == item) {
+                    return i;
+                }
+            }
+            return std::size_t(-1);
+        }
+
+        bool remove(const TYPE * item) {
+            for (auto it = Container::begin(); it != Container::end(); ++it) {
+                if (*it == item) {
+                    Container::erase(it);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        template<typename PREDICATE>
+        void remove_if(PREDICATE predicate) {
+            Container::erase(std::remove_if(Container::begin(), Container::end(), predicate), Container::end());
+        }
+
+        //--------------------------------------------
+
     };
 
     /**************************************************************************************************/
@@ -98,6 +294,8 @@ namespace tree {
         typedef std::list<TYPE *> Container;
     public:
 
+        typedef TreeItemNoHook Hook;
+
         //--------------------------------------------
 
         TYPE * operator[](const std::size_t index) {
@@ -134,8 +332,1096 @@ namespace tree {
             Container::insert(it, val);
         }
 
+        template<typename ITERATOR>
+        void insert(const std::size_t index, ITERATOR first, ITERATOR last) {
+            auto it = Container::begin();
+            for (std::size_t i = 0; i < index; ++i, ++it);
+            Container::insert(it, first, last);
+        }
+
+        //--------------------------------------------
+
+        void reserve(const std::size_t) {}
+
+        //--------------------------------------------
+
+        std::size_t indexOf(const TYPE * item) const {
+            std::size_t index = 0;
+            for (auto it = Container::begin(); it != Container::end(); ++it, ++index) {
+                if (*it == item) {
+                    return index;
+                }
+            }
+            return std::size_t(-1);
+        }
+
+        bool remove(const TYPE * item) {
+            for (auto it = Container::begin(); it != Container::end(); ++it) {
+                if (*it == item) {
+                    Container::erase(it);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        //--------------------------------------------
+
+    };
+
+    /**************************************************************************************************/
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details This class is using as a container for the TreeItem.
+     *          Each child keeps its index in the container (slot),
+     *          so indexOf and finding a child for removing are O(1) instead of the linear scan.
+     * \note Inserting and erasing in the middle still shift the vector's tail.
+     *       The slots of the shifted children aren't updated at once, a lookup searches
+     *       around the slot not further than the count of the shifts since the last slots update.
+     *       All slots are updated when those searches have cost as much as one update.
+     * \warning Change the content with methods of this class only,
+     *          the std::vector methods don't take care about children's slots.
+     */
+    template<typename TYPE>
+    class TreeItemContainerSlotVector : public std::vector<TYPE *> {
+        typedef std::vector<TYPE *> Container;
+    public:
+
+        class Hook {
+            friend class TreeItemContainerSlotVector;
+            mutable std::size_t mTreeItemSlot = 0;
+        };
+
+        //--------------------------------------------
+
+        TYPE * operator[](const std::size_t index) {
+            return Container::operator[](index);
+        }
+
+        const TYPE * operator[](const std::size_t index) const {
+            return Container::operator[](index);
+        }
+
+        //--------------------------------------------
+
+        TYPE * erase(const std::size_t index) {
+            auto it = Container::begin() + index;
+            TYPE * out = (*it);
+            if (index + 1 != Container::size()) {
+                ++mShifts;
+            }
+            Container::erase(it);
+            return out;
+        }
+
+        //--------------------------------------------
+
+        void insert(const std::size_t index, TYPE * val) {
+            if (index == Container::size()) {
+                push_back(val);
+                return;
+            }
+            Container::insert(Container::begin() + index, val);
+            slot(val) = index;
+            ++mShifts;
+        }
+
+        template<typename ITERATOR>
+        void insert(const std::size_t index, ITERATOR first, ITERATOR last) {
+            const std::size_t size = Container::size();
+            Container::insert(Container::begin() + index, first, last);
+            const std::size_t count = Container::size() - size;
+            for (std::size_t i = index; i < index + count; ++i) {
+                slot(Container::operator[](i)) = i;
+            }
+            if (index != size) {
+                mShifts += count;
+            }
+        }
+
+        //--------------------------------------------
+
+        void push_front(TYPE * val) {
+            insert(0, val);
+        }
+
+        void push_back(TYPE * val) {
+            slot(val) = Container::size();
+            Container::push_back(val);
+        }
+
+        void clear() {
+            Container::clear();
+            mShifts = 0;
+            mSearched = 0;
+        }
+
+        //--------------------------------------------
+
+        std::size_t indexOf(const TYPE * item) const {
+            const std::size_t size = Container::size();
+            const std::size_t hint = slot(item);
+            if (hint < size && Container::operator[](hint) == item) {
+                return hint;
+            }
+            if (size == 0) {
+                return std::size_t(-1);
+            }
+            // The item is moved from its slot not further than the count of shifts.
+            const std::size_t from = hint > mShifts ? hint - mShifts : 0;
+            const std::size_t to = hint + mShifts < size ? hint + mShifts : size - 1;
+            const std::size_t center = hint < to ? hint : to;
+            std::size_t index = std::size_t(-1);
+            std::size_t distance = 0;
+            for (; center >= from + distance || center + distance <= to; ++distance) {
+                if (center >= from + distance && Container::operator[](center - distance) == item) {
+                    index = center - distance;
+                    break;
+                }
+                if (center + distance <= to && Container::operator[](center + distance) == item) {
+                    index = center + distance;
+                    break;
+                }
+            }
+            if (index != std::size_t(-1)) {
+                slot(item) = index;
+            }
+            mSearched += distance;
+            if (mSearched > size) {
+                updateSlots();
+            }
+            return index;
+        }
+
+        bool remove(const TYPE * item) {
+            const std::size_t index = indexOf(item);
+            if (index == std::size_t(-1)) {
+                return false;
+            }
+            erase(index);
+            return true;
+        }
+
+        template<typename PREDICATE>
+        void remove_if(PREDICATE predicate) {
+            Container::erase(std::remove_if(Container::begin(), Container::end(), predicate), Container::end());
+            updateSlots();
+        }
+
+        //--------------------------------------------
+
+    private:
+
+        /*! \details Count of shifts after the last slots update, no slot is further from its item. */
+        mutable std::size_t mShifts = 0;
+        /*! \details Count of items checked by the lookups after the last slots update. */
+        mutable std::size_t mSearched = 0;
+
+        static std::size_t & slot(const TYPE * item) {
+            return static_cast<const Hook*>(item)->mTreeItemSlot;
+        }
+
+        void updateSlots() const {
+            const std::size_t size = Container::size();
+            for (std::size_t i = 0; i < size; ++i) {
+                slot(Container::operator[](i)) = i;
+            }
+            mShifts = 0;
+            mSearched = 0;
+        }
+
+    };
+
+    /**************************************************************************************************/
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details This class is using as a container for the TreeItem.
+     *          Each child keeps its iterator in the list (slot),
+     *          so removing a child from its parent is O(1).
+     * \note indexOf is still linear as the list doesn't know positions of its items.
+     * \warning Change the content with methods of this class only,
+     *          the std::list methods don't take care about children's slots.
+     */
+    template<typename TYPE>
+    class TreeItemContainerSlotList : public std::list<TYPE *> {
+        typedef std::list<TYPE *> Container;
+    public:
+
+        class Hook {
+            friend class TreeItemContainerSlotList;
+            typename std::list<TYPE *>::iterator mTreeItemSlot;
+        };
+
+        //--------------------------------------------
+
+        TYPE * operator[](const std::size_t index) {
+            auto it = Container::begin();
+            for (std::size_t i = 0; i < index; ++i, ++it);
+            return (*it);
+        }
+
+        const TYPE * operator[](const std::size_t index) const {
+            auto it = Container::begin();
+            for (std::size_t i = 0; i < index; ++i, ++it);
+            return (*it);
+        }
+
+        //--------------------------------------------
+
+        using Container::erase;
+
+        TYPE * erase(const std::size_t index) {
+            auto it = Container::begin();
+            for (std::size_t i = 0; i < index; ++i, ++it);
+            TYPE * out = (*it);
+            Container::erase(it);
+            return out;
+        }
+
+        //--------------------------------------------
+
+        void insert(const std::size_t index, TYPE * val) {
+            auto it = Container::begin();
+            for (std::size_t i = 0; i < index; ++i, ++it);
+            slot(val) = Container::insert(it, val);
+        }
+
+        template<typename ITERATOR>
+        void insert(const std::size_t index, ITERATOR first, ITERATOR last) {
+            auto it = Container::begin();
+            for (std::size_t i = 0; i < index; ++i, ++it);
+            for (; first != last; ++first) {
+                slot(*first) = Container::insert(it, *first);
+            }
+        }
+
+        //--------------------------------------------
+
+        void push_front(TYPE * val) {
+            Container::push_front(val);
+            slot(val) = Container::begin();
+        }
+
+        void push_back(TYPE * val) {
+            Container::push_back(val);
+            slot(val) = std::prev(Container::end());
+        }
+
+        void reserve(const std::size_t) {}
+
+        //--------------------------------------------
+
+        std::size_t indexOf(const TYPE * item) const {
+            std::size_t index = 0;
+            for (auto it = Container::begin(); it != Container::end(); ++it, ++index) {
+                if (*it == item) {
+                    return index;
+                }
+            }
+            return std::size_t(-1);
+        }
+
+        /*!
+         * \pre The item must be in this container.
+         */
+        bool remove(const TYPE * item) {
+            auto it = static_cast<const Hook*>(item)->mTreeItemSlot;
+            assert(*it == item);
+            Container::erase(it);
+            return true;
+        }
+
+        //--------------------------------------------
+
+    private:
+
+        static typename Container::iterator & slot(TYPE * item) {
+            return static_cast<Hook*>(item)->mTreeItemSlot;
+        }
+
+    };
+
+    /**************************************************************************************************/
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details This class is using as a container for the TreeItem.
+     *          The children are linked with the previous and next sibling pointers which each child keeps inside itself,
+     *          so linking and unlinking a child don't allocate memory and prepending, appending,
+     *          removing a child from its parent and stepping to a sibling are O(1).
+     * \note indexOf is linear, operator[], erase(index) and insert(index) walk from the nearest end of the list.
+     * \warning A tree item can be in one container only, it is unlinked from its previous container
+     *          by TreeItem before it is linked to another one.
+     *          The container can be moved but can't be copied.
+     */
+    template<typename TYPE>
+    class TreeItemContainerIntrusiveList {
+    public:
+
+        class Hook {
+            friend class TreeItemContainerIntrusiveList;
+            TYPE * mTreeItemPrevious = nullptr;
+            TYPE * mTreeItemNext = nullptr;
+        };
+
+        /*!
+         * \details Forward iterator, the pointed values can't be changed through it.
+         */
+        class Iterator {
+        public:
+
+            typedef std::forward_iterator_tag iterator_category;
+            typedef TYPE * value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef TYPE * const * pointer;
+            typedef TYPE * const & reference;
+
+            Iterator()
+                : mItem(nullptr) {}
+
+            explicit Iterator(TYPE * item)
+                : mItem(item) {}
+
+            reference operator*() const {
+                return mItem;
+            }
+
+            pointer operator->() const {
+                return &mItem;
+            }
+
+            Iterator & operator++() {
+                mItem = TreeItemContainerIntrusiveList::next(mItem);
+                return *this;
+            }
+
+            Iterator operator++(int) {
+                Iterator out(*this);
+                ++(*this);
+                return out;
+            }
+
+            bool operator==(const Iterator & other) const {
+                return mItem == other.mItem;
+            }
+
+            bool operator!=(const Iterator & other) const {
+                return mItem != other.mItem;
+            }
+
+        private:
+
+            TYPE * mItem;
+
+        };
+
+        typedef TYPE * value_type;
+        typedef std::size_t size_type;
+        typedef Iterator iterator;
+        typedef Iterator const_iterator;
+
+        //--------------------------------------------
+
+        TreeItemContainerIntrusiveList() = default;
+
+        TreeItemContainerIntrusiveList(TreeItemContainerIntrusiveList && other)
+            : mFirst(other.mFirst),
+              mLast(other.mLast),
+              mSize(other.mSize) {
+            other.clear();
+        }
+
+        TreeItemContainerIntrusiveList & operator =(TreeItemContainerIntrusiveList && other) {
+            if (this != &other) {
+                mFirst = other.mFirst;
+                mLast = other.mLast;
+                mSize = other.mSize;
+                other.clear();
+            }
+            return *this;
+        }
+
+        TreeItemContainerIntrusiveList(const TreeItemContainerIntrusiveList &) = delete;
+        TreeItemContainerIntrusiveList & operator =(const TreeItemContainerIntrusiveList &) = delete;
+
+        //--------------------------------------------
+
+        Iterator begin() const {
+            return Iterator(mFirst);
+        }
+
+        Iterator end() const {
+            return Iterator();
+        }
+
+        std::size_t size() const {
+            return mSize;
+        }
+
+        bool empty() const {
+            return mSize == 0;
+        }
+
+        /*!
+         * \details Forgets all the items, the items themselves aren't changed.
+         */
+        void clear() {
+            mFirst = nullptr;
+            mLast = nullptr;
+            mSize = 0;
+        }
+
+        TYPE * front() const {
+            return mFirst;
+        }
+
+        TYPE * back() const {
+            return mLast;
+        }
+
+        //--------------------------------------------
+
+        TYPE * operator[](const std::size_t index) const {
+            return at(index);
+        }
+
+        //--------------------------------------------
+
+        TYPE * erase(const std::size_t index) {
+            TYPE * out = at(index);
+            unlink(out);
+            return out;
+        }
+
         //--------------------------------------------
 
+        void insert(const std::size_t index, TYPE * val) {
+            if (index == mSize) {
+                push_back(val);
+            }
+            else {
+                linkBefore(at(index), val);
+            }
+        }
+
+        template<typename ITERATOR>
+        void insert(const std::size_t index, ITERATOR first, ITERATOR last) {
+            if (index == mSize) {
+                for (; first != last; ++first) {
+                    push_back(*first);
+                }
+            }
+            else {
+                TYPE * position = at(index);
+                for (; first != last; ++first) {
+                    linkBefore(position, *first);
+                }
+            }
+        }
+
+        //--------------------------------------------
+
+        void push_front(TYPE * val) {
+            if (mFirst) {
+                linkBefore(mFirst, val);
+            }
+            else {
+                push_back(val);
+            }
+        }
+
+        void push_back(TYPE * val) {
+            hook(val).mTreeItemPrevious = mLast;
+            hook(val).mTreeItemNext = nullptr;
+            if (mLast) {
+                hook(mLast).mTreeItemNext = val;
+            }
+            else {
+                mFirst = val;
+            }
+            mLast = val;
+            ++mSize;
+        }
+
+        void reserve(const std::size_t) {}
+
+        //--------------------------------------------
+
+        std::size_t indexOf(const TYPE * item) const {
+            std::size_t index = 0;
+            for (TYPE * it = mFirst; it; it = next(it), ++index) {
+                if (it == item) {
+                    return index;
+                }
+            }
+            return std::size_t(-1);
+        }
+
+        /*!
+         * \pre The item must be in this container.
+         */
+        bool remove(const TYPE * item) {
+            unlink(const_cast<TYPE*>(item));
+            return true;
+        }
+
+        template<typename PREDICATE>
+        void remove_if(PREDICATE predicate) {
+            for (TYPE * it = mFirst; it;) {
+                TYPE * item = it;
+                it = next(it);
+                if (predicate(item)) {
+                    unlink(item);
+                }
+            }
+        }
+
+        //--------------------------------------------
+
+        /*!
+         * \param [in] item an item in a container.
+         * \return The next sibling or nullptr if the item is the last one.
+         */
+        static TYPE * next(const TYPE * item) {
+            return hook(item).mTreeItemNext;
+        }
+
+        /*!
+         * \param [in] item an item in a container.
+         * \return The previous sibling or nullptr if the item is the first one.
+         */
+        static TYPE * previous(const TYPE * item) {
+            return hook(item).mTreeItemPrevious;
+        }
+
+        //--------------------------------------------
+
+    private:
+
+        TYPE * mFirst = nullptr;
+        TYPE * mLast = nullptr;
+        std::size_t mSize = 0;
+
+        static Hook & hook(TYPE * item) {
+            return *static_cast<Hook*>(item);
+        }
+
+        static const Hook & hook(const TYPE * item) {
+            return *static_cast<const Hook*>(item);
+        }
+
+        TYPE * at(const std::size_t index) const {
+            assert(index < mSize);
+            TYPE * item;
+            if (index < mSize / 2) {
+                item = mFirst;
+                for (std::size_t i = 0; i < index; ++i, item = next(item));
+            }
+            else {
+                item = mLast;
+                for (std::size_t i = mSize - 1; i > index; --i, item = previous(item));
+            }
+            return item;
+        }
+
+        void linkBefore(TYPE * position, TYPE * val) {
+            TYPE * prev = previous(position);
+            hook(val).mTreeItemPrevious = prev;
+            hook(val).mTreeItemNext = position;
+            hook(position).mTreeItemPrevious = val;
+            if (prev) {
+                hook(prev).mTreeItemNext = val;
+            }
+            else {
+                mFirst = val;
+            }
+            ++mSize;
+        }
+
+        void unlink(TYPE * item) {
+            TYPE * prev = previous(item);
+            TYPE * nextItem = next(item);
+            if (prev) {
+                hook(prev).mTreeItemNext = nextItem;
+            }
+            else {
+                assert(mFirst == item);
+                mFirst = nextItem;
+            }
+            if (nextItem) {
+                hook(nextItem).mTreeItemPrevious = prev;
+            }
+            else {
+                assert(mLast == item);
+                mLast = prev;
+            }
+            hook(item).mTreeItemPrevious = nullptr;
+            hook(item).mTreeItemNext = nullptr;
+            --mSize;
+        }
+
+    };
+
+    /**************************************************************************************************/
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details This class is using as a container for the TreeItem.
+     *          The first N children pointers are kept inside the container itself,
+     *          the memory is allocated only when there are more children.
+     *          It fits the trees where most of the items have a few children,
+     *          with N = 2 the container has the same size as std::vector and an item with up to 2 children
+     *          needs no more allocations than the item itself.
+     * \note The children count is limited by 2^32 - 1.
+     * \warning The container can be moved but can't be copied.
+     * \tparam TYPE your tree item type.
+     * \tparam N count of the children which are kept without allocation.
+     */
+    template<typename TYPE, std::size_t N = 2>
+    class TreeItemContainerSmallVector {
+    public:
+
+        static_assert(N > 0 && N < 0xFFFFFFFF, "The inline capacity is out of range");
+
+        typedef TreeItemNoHook Hook;
+        typedef TYPE * value_type;
+        typedef std::size_t size_type;
+        typedef TYPE ** iterator;
+        typedef TYPE * const * const_iterator;
+
+        //--------------------------------------------
+
+        TreeItemContainerSmallVector() = default;
+
+        TreeItemContainerSmallVector(TreeItemContainerSmallVector && other) {
+            moveFrom(other);
+        }
+
+        TreeItemContainerSmallVector & operator =(TreeItemContainerSmallVector && other) {
+            if (this != &other) {
+                release();
+                moveFrom(other);
+            }
+            return *this;
+        }
+
+        TreeItemContainerSmallVector(const TreeItemContainerSmallVector &) = delete;
+        TreeItemContainerSmallVector & operator =(const TreeItemContainerSmallVector &) = delete;
+
+        ~TreeItemContainerSmallVector() {
+            release();
+        }
+
+        //--------------------------------------------
+
+        iterator begin() {
+            return data();
+        }
+
+        iterator end() {
+            return data() + mSize;
+        }
+
+        const_iterator begin() const {
+            return data();
+        }
+
+        const_iterator end() const {
+            return data() + mSize;
+        }
+
+        std::size_t size() const {
+            return mSize;
+        }
+
+        bool empty() const {
+            return mSize == 0;
+        }
+
+        /*!
+         * \details Removes all the items and releases the allocated memory.
+         */
+        void clear() {
+            release();
+        }
+
+        //--------------------------------------------
+
+        TYPE * operator[](const std::size_t index) {
+            return data()[index];
+        }
+
+        const TYPE * operator[](const std::size_t index) const {
+            return data()[index];
+        }
+
+        //--------------------------------------------
+
+        TYPE * erase(const std::size_t index) {
+            TYPE ** items = data();
+            TYPE * out = items[index];
+            std::copy(items + index + 1, items + mSize, items + index);
+            --mSize;
+            return out;
+        }
+
+        //--------------------------------------------
+
+        void insert(const std::size_t index, TYPE * val) {
+            reserve(mSize + 1);
+            TYPE ** items = data();
+            std::copy_backward(items + index, items + mSize, items + mSize + 1);
+            items[index] = val;
+            ++mSize;
+        }
+
+        template<typename ITERATOR>
+        void insert(const std::size_t index, ITERATOR first, ITERATOR last) {
+            const std::size_t count = std::size_t(std::distance(first, last));
+            reserve(mSize + count);
+            TYPE ** items = data();
+            std::copy_backward(items + index, items + mSize, items + mSize + count);
+            std::copy(first, last, items + index);
+            mSize = std::uint32_t(mSize + count);
+        }
+
+        //--------------------------------------------
+
+        void push_front(TYPE * val) {
+            insert(0, val);
+        }
+
+        void push_back(TYPE * val) {
+            reserve(mSize + 1);
+            data()[mSize++] = val;
+        }
+
+        /*!
+         * \details Makes the capacity at least as the specified count,
+         *          it grows twice at least, so adding items one by one is amortized O(1).
+         */
+        void reserve(const std::size_t count) {
+            if (count <= mCapacity) {
+                return;
+            }
+            assert(count < 0xFFFFFFFF);
+            std::size_t capacity = std::size_t(mCapacity) * 2;
+            if (capacity < count) {
+                capacity = count;
+            }
+            if (capacity > 0xFFFFFFFF) {
+                capacity = 0xFFFFFFFF;
+            }
+            TYPE ** items = new TYPE *[capacity];
+            std::copy(data(), data() + mSize, items);
+            if (isAllocated()) {
+                delete[] mAllocated;
+            }
+            mAllocated = items;
+            mCapacity = std::uint32_t(capacity);
+        }
+
+        //--------------------------------------------
+
+        std::size_t indexOf(const TYPE * item) const {
+            const auto it = std::find(begin(), end(), item);
+            return it != end() ? std::size_t(it - begin()) : std::size_t(-1);
+        }
+
+        bool remove(const TYPE * item) {
+            const std::size_t index = indexOf(item);
+            if (index == std::size_t(-1)) {
+                return false;
+            }
+            erase(index);
+            return true;
+        }
+
+        template<typename PREDICATE>
+        void remove_if(PREDICATE predicate) {
+            mSize = std::uint32_t(std::remove_if(begin(), end(), predicate) - begin());
+        }
+
+        //--------------------------------------------
+
+    private:
+
+        std::uint32_t mSize = 0;
+        std::uint32_t mCapacity = N;
+
+        union {
+            TYPE * mInline[N];
+            TYPE ** mAllocated;
+        };
+
+        bool isAllocated() const {
+            return mCapacity > N;
+        }
+
+        TYPE ** data() {
+            return isAllocated() ? mAllocated : mInline;
+        }
+
+        TYPE * const * data() const {
+            return isAllocated() ? mAllocated : mInline;
+        }
+
+        void release() {
+            if (isAllocated()) {
+                delete[] mAllocated;
+            }
+            mSize = 0;
+            mCapacity = N;
+        }
+
+        void moveFrom(TreeItemContainerSmallVector & other) {
+            if (other.isAllocated()) {
+                mAllocated = other.mAllocated;
+            }
+            else {
+                // the size is not greater than N here, the explicit bound is for the compiler's bounds checking.
+                std::copy(other.mInline, other.mInline + std::min<std::size_t>(other.mSize, N), mInline);
+            }
+            mSize = other.mSize;
+            mCapacity = other.mCapacity;
+            other.mSize = 0;
+            other.mCapacity = N;
+        }
+
+    };
+
+    /**************************************************************************************************/
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details This class is using as a container for the TreeItem.
+     *          The children are kept contiguously like in the std::vector
+     *          but there is free space in front of them as well as behind them.
+     *          So adding a child to the front and to the back are amortized O(1),
+     *          inserting and erasing in the middle move the shorter part only,
+     *          operator[] is O(1).
+     *          When one side runs out of the space the children are moved into a new memory
+     *          with the free space divided between both sides.
+     * \warning The container can be moved but can't be copied.
+     */
+    template<typename TYPE>
+    class TreeItemContainerGapVector {
+    public:
+
+        typedef TreeItemNoHook Hook;
+        typedef TYPE * value_type;
+        typedef std::size_t size_type;
+        typedef TYPE ** iterator;
+        typedef TYPE * const * const_iterator;
+
+        //--------------------------------------------
+
+        TreeItemContainerGapVector() = default;
+
+        TreeItemContainerGapVector(TreeItemContainerGapVector && other)
+            : mBuffer(other.mBuffer),
+              mFirst(other.mFirst),
+              mLast(other.mLast),
+              mEnd(other.mEnd) {
+            other.mBuffer = other.mFirst = other.mLast = other.mEnd = nullptr;
+        }
+
+        TreeItemContainerGapVector & operator =(TreeItemContainerGapVector && other) {
+            if (this != &other) {
+                delete[] mBuffer;
+                mBuffer = other.mBuffer;
+                mFirst = other.mFirst;
+                mLast = other.mLast;
+                mEnd = other.mEnd;
+                other.mBuffer = other.mFirst = other.mLast = other.mEnd = nullptr;
+            }
+            return *this;
+        }
+
+        TreeItemContainerGapVector(const TreeItemContainerGapVector &) = delete;
+        TreeItemContainerGapVector & operator =(const TreeItemContainerGapVector &) = delete;
+
+        ~TreeItemContainerGapVector() {
+            delete[] mBuffer;
+        }
+
+        //--------------------------------------------
+
+        iterator begin() {
+            return mFirst;
+        }
+
+        iterator end() {
+            return mLast;
+        }
+
+        const_iterator begin() const {
+            return mFirst;
+        }
+
+        const_iterator end() const {
+            return mLast;
+        }
+
+        std::size_t size() const {
+            return std::size_t(mLast - mFirst);
+        }
+
+        bool empty() const {
+            return mFirst == mLast;
+        }
+
+        /*!
+         * \details Removes all the items, the memory is kept.
+         */
+        void clear() {
+            mFirst = mLast = mBuffer + (mEnd - mBuffer) / 2;
+        }
+
+        //--------------------------------------------
+
+        TYPE * operator[](const std::size_t index) {
+            return mFirst[index];
+        }
+
+        const TYPE * operator[](const std::size_t index) const {
+            return mFirst[index];
+        }
+
+        //--------------------------------------------
+
+        TYPE * erase(const std::size_t index) {
+            TYPE * out = mFirst[index];
+            if (index < size() / 2) {
+                std::copy_backward(mFirst, mFirst + index, mFirst + index + 1);
+                ++mFirst;
+            }
+            else {
+                std::copy(mFirst + index + 1, mLast, mFirst + index);
+                --mLast;
+            }
+            return out;
+        }
+
+        //--------------------------------------------
+
+        void insert(const std::size_t index, TYPE * val) {
+            *makeRoom(index, 1) = val;
+        }
+
+        template<typename ITERATOR>
+        void insert(const std::size_t index, ITERATOR first, ITERATOR last) {
+            std::copy(first, last, makeRoom(index, std::size_t(std::distance(first, last))));
+        }
+
+        //--------------------------------------------
+
+        void push_front(TYPE * val) {
+            if (mFirst != mBuffer) {
+                *--mFirst = val;
+                return;
+            }
+            insert(0, val);
+        }
+
+        void push_back(TYPE * val) {
+            if (mLast != mEnd) {
+                *mLast++ = val;
+                return;
+            }
+            insert(size(), val);
+        }
+
+        /*!
+         * \details Makes the space behind the items enough for the specified items count like std::vector does.
+         */
+        void reserve(const std::size_t count) {
+            const std::size_t currSize = size();
+            if (count <= currSize || std::size_t(mEnd - mFirst) >= count) {
+                return;
+            }
+            TYPE ** buffer = new TYPE *[count];
+            std::copy(mFirst, mLast, buffer);
+            delete[] mBuffer;
+            mBuffer = mFirst = buffer;
+            mLast = buffer + currSize;
+            mEnd = buffer + count;
+        }
+
+        //--------------------------------------------
+
+        std::size_t indexOf(const TYPE * item) const {
+            const auto it = std::find(begin(), end(), item);
+            return it != end() ? std::size_t(it - begin()) : std::size_t(-1);
+        }
+
+        bool remove(const TYPE * item) {
+            const std::size_t index = indexOf(item);
+            if (index == std::size_t(-1)) {
+                return false;
+            }
+            erase(index);
+            return true;
+        }
+
+        template<typename PREDICATE>
+        void remove_if(PREDICATE predicate) {
+            mLast = std::remove_if(mFirst, mLast, predicate);
+        }
+
+        //--------------------------------------------
+
+    private:
+
+        TYPE ** mBuffer = nullptr;
+        TYPE ** mFirst = nullptr;
+        TYPE ** mLast = nullptr;
+        TYPE ** mEnd = nullptr;
+
+        /*!
+         * \details Makes the hole for the specified items count at the specified position.
+         *          The items in front of the position are moved forward if they are fewer than the ones behind it,
+         *          otherwise the items behind it are moved backward.
+         *          If there is no space on the chosen side all the items are moved into a new memory
+         *          which has as much free space as the items take, half of it is in front of the items.
+         * \return The hole's begin.
+         */
+        TYPE ** makeRoom(const std::size_t index, const std::size_t count) {
+            const std::size_t currSize = size();
+            if (index < currSize - index) {
+                if (std::size_t(mFirst - mBuffer) >= count) {
+                    std::copy(mFirst, mFirst + index, mFirst - count);
+                    mFirst -= count;
+                    return mFirst + index;
+                }
+            }
+            else if (std::size_t(mEnd - mLast) >= count) {
+                std::copy_backward(mFirst + index, mLast, mLast + count);
+                mLast += count;
+                return mFirst + index;
+            }
+
+            const std::size_t newSize = currSize + count;
+            const std::size_t capacity = newSize < 2 ? 4 : newSize * 2;
+            TYPE ** buffer = new TYPE *[capacity];
+            TYPE ** first = buffer + (capacity - newSize) / 2;
+            std::copy(mFirst, mFirst + index, first);
+            std::copy(mFirst + index, mLast, first + index + count);
+            delete[] mBuffer;
+            mBuffer = buffer;
+            mFirst = first;
+            mLast = first + newSize;
+            mEnd = buffer + capacity;
+            return mFirst + index;
+        }
+
     };
 
     /**************************************************************************************************/
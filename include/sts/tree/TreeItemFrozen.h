@@ -0,0 +1,153 @@
+#pragma once
+
+/*
+**  Copyright(C) 2018, StepToSky
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  1.Redistributions of source code must retain the above copyright notice, this
+**    list of conditions and the following disclaimer.
+**  2.Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and / or other materials provided with the distribution.
+**  3.Neither the name of StepToSky nor the names of its contributors
+**    may be used to endorse or promote products derived from this software
+**    without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**  DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**  Contacts: www.steptosky.com
+*/
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace sts {
+namespace tree {
+
+    /********************************************************************************************************/
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /********************************************************************************************************/
+
+    /*!
+     * \details Read only flat snapshot of a hierarchy for the read-heavy phases.
+     * \details The items are numbered in pre-order and their data is kept in the arrays (struct of arrays):
+     *          the items, the parents' numbers, the subtree sizes, the depths and the user's payload.
+     *          So each subtree is a continuous numbers range which starts with its root,
+     *          the first child of an item is the next number and the next sibling is after the item's subtree.
+     *          The traversals, \link TreeItemFrozen::isChildOf \endlink and the subtree queries become
+     *          the linear scans of the arrays without the virtual calls and the pointers chasing.
+     * \code
+     *      auto frozen = freeze(root, [](const YourType * item) { return item->weight(); });
+     *      for (TreeItemFrozen<YourType, float>::Index i = 0; i < frozen.size(); ++i) { ... frozen.payload(i) ... }
+     * \endcode
+     * \warning The snapshot doesn't track the hierarchy changes, you must call \link TreeItemFrozen::build \endlink
+     *          after any change of the hierarchy if you need the actual data.
+     * \tparam TYPE your tree item type.
+     * \tparam PAYLOAD the data which is copied from each item.
+     */
+    template<typename TYPE, typename PAYLOAD>
+    class TreeItemFrozen {
+    public:
+
+        typedef std::size_t Index;           /*!< \details Item's pre-order number. */
+        static const Index npos = Index(-1); /*!< \details Means no item. */
+
+        //---------------------------------------------------------------
+        /// @{
+
+        TreeItemFrozen() = default;
+        template<typename FUNCTION>
+        TreeItemFrozen(const TYPE * root, FUNCTION payloadOf);
+
+        /// @}
+        //---------------------------------------------------------------
+        /// @{
+
+        template<typename FUNCTION>
+        void build(const TYPE * root, FUNCTION payloadOf);
+        void clear();
+
+        Index size() const;
+        bool empty() const;
+
+        /// @}
+        //---------------------------------------------------------------
+        /// @{
+
+        const TYPE * item(Index index) const;
+        const PAYLOAD & payload(Index index) const;
+        PAYLOAD & payload(Index index);
+
+        /// @}
+        //---------------------------------------------------------------
+        /// @{
+
+        Index parent(Index index) const;
+        Index firstChild(Index index) const;
+        Index nextSibling(Index index) const;
+        Index subtreeSize(Index index) const;
+        Index subtreeEnd(Index index) const;
+        Index depth(Index index) const;
+        bool isLeaf(Index index) const;
+        bool isChildOf(Index index, Index parent) const;
+
+        /// @}
+        //---------------------------------------------------------------
+        /// @{
+
+        const std::vector<const TYPE*> & items() const;
+        const std::vector<PAYLOAD> & payloads() const;
+        const std::vector<Index> & parents() const;
+        const std::vector<Index> & subtreeSizes() const;
+        const std::vector<Index> & depths() const;
+
+        /// @}
+        //---------------------------------------------------------------
+
+    private:
+
+        std::vector<const TYPE*> mItems;
+        std::vector<PAYLOAD> mPayloads;
+        std::vector<Index> mParents;
+        std::vector<Index> mSubtreeSizes;
+        std::vector<Index> mDepths;
+
+    };
+
+    /********************************************************************************************************/
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /********************************************************************************************************/
+
+    /*!
+     * \details Makes the flat snapshot of the subtree,
+     *          see \link sts::tree::TreeItemFrozen \endlink for details.
+     * \param [in] root subtree root.
+     * \param [in] payloadOf it is called for each item as PAYLOAD payloadOf(const TYPE *).
+     * \return The snapshot, its payload type is the one returned by the function.
+     */
+    template<typename TYPE, typename FUNCTION>
+    auto freeze(const TYPE * root, FUNCTION payloadOf)
+    -> TreeItemFrozen<TYPE, typename std::decay<decltype(payloadOf(root))>::type> {
+        return TreeItemFrozen<TYPE, typename std::decay<decltype(payloadOf(root))>::type>(root, payloadOf);
+    }
+
+    /********************************************************************************************************/
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /********************************************************************************************************/
+}
+}
+
+#include "TreeItemFrozen.inl.h"
@@ -0,0 +1,317 @@
+#pragma once
+
+/*
+**  Copyright(C) 2018, StepToSky
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  1.Redistributions of source code must retain the above copyright notice, this
+**    list of conditions and the following disclaimer.
+**  2.Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and / or other materials provided with the distribution.
+**  3.Neither the name of StepToSky nor the names of its contributors
+**    may be used to endorse or promote products derived from this software
+**    without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**  DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**  Contacts: www.steptosky.com
+*/
+
+#include <cassert>
+#include <algorithm>
+
+namespace sts {
+namespace tree {
+
+    /**************************************************************************************************/
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    template<typename TYPE, typename PAYLOAD>
+    const typename TreeItemFrozen<TYPE, PAYLOAD>::Index TreeItemFrozen<TYPE, PAYLOAD>::npos;
+
+    /*!
+     * \details Constructor init, makes the snapshot of the specified hierarchy.
+     * \param [in] root root of the hierarchy or of its part.
+     * \param [in] payloadOf it is called for each item as PAYLOAD payloadOf(const TYPE *).
+     */
+    template<typename TYPE, typename PAYLOAD>
+    template<typename FUNCTION>
+    TreeItemFrozen<TYPE, PAYLOAD>::TreeItemFrozen(const TYPE * root, FUNCTION payloadOf) {
+        build(root, payloadOf);
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Makes the snapshot of the specified item and all its descendants without recursion.
+     * \details The item isn't necessarily the hierarchy root, then the snapshot knows nothing about the item's ancestors.
+     * \param [in] root root of the hierarchy or of its part.
+     * \param [in] payloadOf it is called for each item in pre-order as PAYLOAD payloadOf(const TYPE *).
+     */
+    template<typename TYPE, typename PAYLOAD>
+    template<typename FUNCTION>
+    void TreeItemFrozen<TYPE, PAYLOAD>::build(const TYPE * root, FUNCTION payloadOf) {
+        assert(root);
+        clear();
+        std::vector<std::pair<const TYPE*, Index>> stack;
+        stack.emplace_back(root, npos);
+        while (!stack.empty()) {
+            const TYPE * item = stack.back().first;
+            const Index parent = stack.back().second;
+            stack.pop_back();
+
+            const Index index = mItems.size();
+            mItems.push_back(item);
+            mPayloads.push_back(payloadOf(item));
+            mParents.push_back(parent);
+            mDepths.push_back(parent == npos ? 0 : mDepths[parent] + 1);
+
+            const std::size_t first = stack.size();
+            for (auto & it : item->children()) {
+                stack.emplace_back(it, index);
+            }
+            std::reverse(stack.begin() + std::ptrdiff_t(first), stack.end());
+        }
+
+        const Index count = mItems.size();
+        mSubtreeSizes.assign(count, 1);
+        for (Index i = count - 1; i > 0; --i) {
+            mSubtreeSizes[mParents[i]] += mSubtreeSizes[i];
+        }
+    }
+
+    /*!
+     * \details Clears the snapshot.
+     */
+    template<typename TYPE, typename PAYLOAD>
+    void TreeItemFrozen<TYPE, PAYLOAD>::clear() {
+        mItems.clear();
+        mPayloads.clear();
+        mParents.clear();
+        mSubtreeSizes.clear();
+        mDepths.clear();
+    }
+
+    /*!
+     * \details Gets count of the items in the snapshot.
+     * \return Items count.
+     */
+    template<typename TYPE, typename PAYLOAD>
+    typename TreeItemFrozen<TYPE, PAYLOAD>::Index TreeItemFrozen<TYPE, PAYLOAD>::size() const {
+        return mItems.size();
+    }
+
+    /*!
+     * \details Checks whether the snapshot has no items.
+     * \return True if the snapshot is empty otherwise false.
+     */
+    template<typename TYPE, typename PAYLOAD>
+    bool TreeItemFrozen<TYPE, PAYLOAD>::empty() const {
+        return mItems.empty();
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Gets the item by its pre-order number.
+     * \param [in] index
+     * \return The item.
+     */
+    template<typename TYPE, typename PAYLOAD>
+    const TYPE * TreeItemFrozen<TYPE, PAYLOAD>::item(const Index index) const {
+        assert(index < mItems.size());
+        return mItems[index];
+    }
+
+    /*!
+     * \details Gets the item's payload.
+     * \param [in] index
+     * \return The payload.
+     */
+    template<typename TYPE, typename PAYLOAD>
+    const PAYLOAD & TreeItemFrozen<TYPE, PAYLOAD>::payload(const Index index) const {
+        assert(index < mPayloads.size());
+        return mPayloads[index];
+    }
+
+    /*!
+     * \details Gets the item's payload, it may be changed, the items aren't changed.
+     * \param [in] index
+     * \return The payload.
+     */
+    template<typename TYPE, typename PAYLOAD>
+    PAYLOAD & TreeItemFrozen<TYPE, PAYLOAD>::payload(const Index index) {
+        assert(index < mPayloads.size());
+        return mPayloads[index];
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Gets the item's parent.
+     * \param [in] index
+     * \return Parent's number or \link TreeItemFrozen::npos \endlink for the snapshot's root.
+     */
+    template<typename TYPE, typename PAYLOAD>
+    typename TreeItemFrozen<TYPE, PAYLOAD>::Index TreeItemFrozen<TYPE, PAYLOAD>::parent(const Index index) const {
+        assert(index < mParents.size());
+        return mParents[index];
+    }
+
+    /*!
+     * \details Gets the item's first child.
+     * \param [in] index
+     * \return First child's number or \link TreeItemFrozen::npos \endlink if the item has no children.
+     */
+    template<typename TYPE, typename PAYLOAD>
+    typename TreeItemFrozen<TYPE, PAYLOAD>::Index TreeItemFrozen<TYPE, PAYLOAD>::firstChild(const Index index) const {
+        assert(index < mSubtreeSizes.size());
+        return mSubtreeSizes[index] > 1 ? index + 1 : npos;
+    }
+
+    /*!
+     * \details Gets the item's next sibling.
+     * \param [in] index
+     * \return Next sibling's number or \link TreeItemFrozen::npos \endlink if the item is the last child or the root.
+     */
+    template<typename TYPE, typename PAYLOAD>
+    typename TreeItemFrozen<TYPE, PAYLOAD>::Index TreeItemFrozen<TYPE, PAYLOAD>::nextSibling(const Index index) const {
+        assert(index < mParents.size());
+        const Index parent = mParents[index];
+        if (parent == npos) {
+            return npos;
+        }
+        const Index next = index + mSubtreeSizes[index];
+        return next < parent + mSubtreeSizes[parent] ? next : npos;
+    }
+
+    /*!
+     * \details Gets the items count in the item's subtree including the item.
+     * \param [in] index
+     * \return Subtree size, the subtree is the range [index, index + size).
+     */
+    template<typename TYPE, typename PAYLOAD>
+    typename TreeItemFrozen<TYPE, PAYLOAD>::Index TreeItemFrozen<TYPE, PAYLOAD>::subtreeSize(const Index index) const {
+        assert(index < mSubtreeSizes.size());
+        return mSubtreeSizes[index];
+    }
+
+    /*!
+     * \details Gets the number after the item's subtree.
+     * \param [in] index
+     * \return The end of the subtree range.
+     */
+    template<typename TYPE, typename PAYLOAD>
+    typename TreeItemFrozen<TYPE, PAYLOAD>::Index TreeItemFrozen<TYPE, PAYLOAD>::subtreeEnd(const Index index) const {
+        assert(index < mSubtreeSizes.size());
+        return index + mSubtreeSizes[index];
+    }
+
+    /*!
+     * \details Gets the item's depth, the snapshot's root has depth 0.
+     * \param [in] index
+     * \return Item's depth.
+     */
+    template<typename TYPE, typename PAYLOAD>
+    typename TreeItemFrozen<TYPE, PAYLOAD>::Index TreeItemFrozen<TYPE, PAYLOAD>::depth(const Index index) const {
+        assert(index < mDepths.size());
+        return mDepths[index];
+    }
+
+    /*!
+     * \details Checks whether the item has no children.
+     * \param [in] index
+     * \return True if the item has no children otherwise false.
+     */
+    template<typename TYPE, typename PAYLOAD>
+    bool TreeItemFrozen<TYPE, PAYLOAD>::isLeaf(const Index index) const {
+        assert(index < mSubtreeSizes.size());
+        return mSubtreeSizes[index] == 1;
+    }
+
+    /*!
+     * \details Check whether the item is one of the descendants of specified parent,
+     *          it is the same as \link TreeItem::isChildOf \endlink but it takes O(1) time.
+     * \param [in] index
+     * \param [in] parent
+     * \return True if the item has specified item as a parent otherwise false.
+     */
+    template<typename TYPE, typename PAYLOAD>
+    bool TreeItemFrozen<TYPE, PAYLOAD>::isChildOf(const Index index, const Index parent) const {
+        assert(index < mItems.size() && parent < mItems.size());
+        return parent < index && index < parent + mSubtreeSizes[parent];
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Gets the items column.
+     * \return Items in pre-order.
+     */
+    template<typename TYPE, typename PAYLOAD>
+    const std::vector<const TYPE*> & TreeItemFrozen<TYPE, PAYLOAD>::items() const {
+        return mItems;
+    }
+
+    /*!
+     * \details Gets the payloads column.
+     * \return Payloads in pre-order.
+     */
+    template<typename TYPE, typename PAYLOAD>
+    const std::vector<PAYLOAD> & TreeItemFrozen<TYPE, PAYLOAD>::payloads() const {
+        return mPayloads;
+    }
+
+    /*!
+     * \details Gets the parents column.
+     * \return Parents' numbers in pre-order, the root's parent is \link TreeItemFrozen::npos \endlink.
+     */
+    template<typename TYPE, typename PAYLOAD>
+    const std::vector<typename TreeItemFrozen<TYPE, PAYLOAD>::Index> & TreeItemFrozen<TYPE, PAYLOAD>::parents() const {
+        return mParents;
+    }
+
+    /*!
+     * \details Gets the subtree sizes column.
+     * \return Subtree sizes in pre-order.
+     */
+    template<typename TYPE, typename PAYLOAD>
+    const std::vector<typename TreeItemFrozen<TYPE, PAYLOAD>::Index> & TreeItemFrozen<TYPE, PAYLOAD>::subtreeSizes() const {
+        return mSubtreeSizes;
+    }
+
+    /*!
+     * \details Gets the depths column.
+     * \return Depths in pre-order.
+     */
+    template<typename TYPE, typename PAYLOAD>
+    const std::vector<typename TreeItemFrozen<TYPE, PAYLOAD>::Index> & TreeItemFrozen<TYPE, PAYLOAD>::depths() const {
+        return mDepths;
+    }
+
+    /**************************************************************************************************/
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /**************************************************************************************************/
+}
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+/*
+**  Copyright(C) 2018, StepToSky
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  1.Redistributions of source code must retain the above copyright notice, this
+**    list of conditions and the following disclaimer.
+**  2.Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and / or other materials provided with the distribution.
+**  3.Neither the name of StepToSky nor the names of its contributors
+**    may be used to endorse or promote products derived from this software
+**    without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**  DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**  Contacts: www.steptosky.com
+*/
+
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include "TreeItem.h"
+
+namespace sts {
+namespace tree {
+
+    /********************************************************************************************************/
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /********************************************************************************************************/
+
+    /*!
+     * \details Tree item layer which finds a child by its key in O(1), for example a file by its name.
+     * \details The key is extracted by the KEY_OF type which must provide the Key type
+     *          and the static function key(const TYPE *) which returns the item's key.
+     *          The children's hash table is made by the first \link TreeItemKeyIndex::childByKey \endlink call,
+     *          then it is updated by each added and removed child (including \link TreeItem::setParent \endlink,
+     *          taking and deleting), the items which are never asked for a child have no table.
+     * \details Use the layer instead of the TreeItem:
+     * \code
+     *      class YourType;
+     *      struct YourTypeName {
+     *          typedef std::string Key;
+     *          static const Key & key(const YourType * item);
+     *      };
+     *      class YourType : public TreeItemKeyIndex<YourType, YourTypeName> { ... };
+     *
+     *      const char * path[] = {"a", "b", "c"};
+     *      YourType * item = root->childByPath(std::begin(path), std::end(path));
+     * \endcode
+     * \note If several children have the same key any of them may be found.
+     * \note Use \link sts::tree::TreeItemContainerSlotVector \endlink if you need \link TreeItem::indexOf \endlink in O(1) too.
+     * \warning If an item's key is changed while it has a parent you must call \link TreeItemKeyIndex::keyChanged \endlink.
+     * \warning The layer has no constructor with the parent because the key isn't available until your type is constructed,
+     *          add the item to the parent after that.
+     * \warning The lookup methods make the table even though they are constant,
+     *          so they must not be called concurrently for one item before the table is made.
+     * \warning If you override \link TreeItem::childAdded \endlink or \link TreeItem::childRemoved \endlink
+     *          you must call the layer's implementation too.
+     * \tparam TYPE your type.
+     * \tparam KEY_OF key extractor type.
+     * \tparam BASE the tree item type or another layer.
+     * \tparam HASH hash of the key.
+     */
+    template<typename TYPE, typename KEY_OF, typename BASE = TreeItem<TYPE>, typename HASH = std::hash<typename KEY_OF::Key>>
+    class TreeItemKeyIndex : public BASE {
+    protected:
+
+        TreeItemKeyIndex(const TreeItemKeyIndex & copy);
+        TreeItemKeyIndex & operator =(const TreeItemKeyIndex & copy);
+        TreeItemKeyIndex(TreeItemKeyIndex && other);
+        TreeItemKeyIndex & operator =(TreeItemKeyIndex && other);
+
+    public:
+
+        typedef typename KEY_OF::Key Key;
+
+        //---------------------------------------------------------------
+        /// @{
+
+        TreeItemKeyIndex();
+        virtual ~TreeItemKeyIndex();
+
+        /// @}
+        //---------------------------------------------------------------
+        /// @{
+
+        TYPE * childByKey(const Key & key);
+        const TYPE * childByKey(const Key & key) const;
+        template<typename ITERATOR>
+        TYPE * childByPath(ITERATOR first, ITERATOR last);
+        template<typename ITERATOR>
+        const TYPE * childByPath(ITERATOR first, ITERATOR last) const;
+
+        /// @}
+        //---------------------------------------------------------------
+        /// @{
+
+        void keyChanged();
+
+        /// @}
+        //---------------------------------------------------------------
+
+    protected:
+
+        void childAdded(TYPE * child) override;
+        void childRemoved(TYPE * child) override;
+
+    private:
+
+        typedef std::unordered_multimap<Key, TYPE*, HASH> Table;
+
+        mutable std::unique_ptr<Table> mTable;
+        Key mIndexedKey;
+
+        const Table & table() const;
+        void addToTable(TYPE * child) const;
+        void removeFromTable(TYPE * child) const;
+
+    };
+
+    /********************************************************************************************************/
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /********************************************************************************************************/
+}
+}
+
+#include "TreeItemKeyIndex.inl.h"
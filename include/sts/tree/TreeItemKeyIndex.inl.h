@@ -0,0 +1,253 @@
+#pragma once
+
+/*
+**  Copyright(C) 2018, StepToSky
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  1.Redistributions of source code must retain the above copyright notice, this
+**    list of conditions and the following disclaimer.
+**  2.Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and / or other materials provided with the distribution.
+**  3.Neither the name of StepToSky nor the names of its contributors
+**    may be used to endorse or promote products derived from this software
+**    without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**  DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**  Contacts: www.steptosky.com
+*/
+
+namespace sts {
+namespace tree {
+
+    /**************************************************************************************************/
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Constructor default.
+     */
+    template<typename TYPE, typename KEY_OF, typename BASE, typename HASH>
+    TreeItemKeyIndex<TYPE, KEY_OF, BASE, HASH>::TreeItemKeyIndex() {}
+
+    /*!
+     * \details Destructor, removes the item from its parent while its indexed key is still available.
+     */
+    template<typename TYPE, typename KEY_OF, typename BASE, typename HASH>
+    TreeItemKeyIndex<TYPE, KEY_OF, BASE, HASH>::~TreeItemKeyIndex() {
+        if (BASE::parent() != nullptr) {
+            BASE::setParent(nullptr);
+        }
+    }
+
+    /*!
+     * \details Constructor copy.
+     * \note The table isn't copied, the copy makes its own one at the first lookup.
+     * \param [in] copy
+     */
+    template<typename TYPE, typename KEY_OF, typename BASE, typename HASH>
+    TreeItemKeyIndex<TYPE, KEY_OF, BASE, HASH>::TreeItemKeyIndex(const TreeItemKeyIndex & copy)
+        : BASE(copy),
+          mIndexedKey(copy.mIndexedKey) {}
+
+    /*!
+     * \details Operator copy.
+     * \note The table is updated by the replaced children.
+     * \param [in] copy
+     */
+    template<typename TYPE, typename KEY_OF, typename BASE, typename HASH>
+    TreeItemKeyIndex<TYPE, KEY_OF, BASE, HASH> & TreeItemKeyIndex<TYPE, KEY_OF, BASE, HASH>::operator =(const TreeItemKeyIndex & copy) {
+        BASE::operator=(copy);
+        return *this;
+    }
+
+    /*!
+     * \details Constructor move.
+     * \note The table isn't moved, the constructed item makes its own one at the first lookup.
+     * \param [in, out] other
+     */
+    template<typename TYPE, typename KEY_OF, typename BASE, typename HASH>
+    TreeItemKeyIndex<TYPE, KEY_OF, BASE, HASH>::TreeItemKeyIndex(TreeItemKeyIndex && other)
+        : BASE(std::move(other)),
+          mIndexedKey(other.mIndexedKey) {}
+
+    /*!
+     * \details Operator move.
+     * \note The tables of the both items are updated by the moved children.
+     * \param [in, out] other
+     */
+    template<typename TYPE, typename KEY_OF, typename BASE, typename HASH>
+    TreeItemKeyIndex<TYPE, KEY_OF, BASE, HASH> & TreeItemKeyIndex<TYPE, KEY_OF, BASE, HASH>::operator =(TreeItemKeyIndex && other) {
+        BASE::operator=(std::move(other));
+        return *this;
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Finds the child by its key.
+     * \param [in] key
+     * \return The child or nullptr if there is no child with the key.
+     */
+    template<typename TYPE, typename KEY_OF, typename BASE, typename HASH>
+    TYPE * TreeItemKeyIndex<TYPE, KEY_OF, BASE, HASH>::childByKey(const Key & key) {
+        const Table & children = table();
+        const auto it = children.find(key);
+        return it != children.end() ? it->second : nullptr;
+    }
+
+    /*!
+     * \details Finds the child by its key.
+     * \param [in] key
+     * \return The child or nullptr if there is no child with the key.
+     */
+    template<typename TYPE, typename KEY_OF, typename BASE, typename HASH>
+    const TYPE * TreeItemKeyIndex<TYPE, KEY_OF, BASE, HASH>::childByKey(const Key & key) const {
+        const Table & children = table();
+        const auto it = children.find(key);
+        return it != children.end() ? it->second : nullptr;
+    }
+
+    /*!
+     * \details Finds the descendant by the keys of the items on the way to it.
+     * \param [in] first forward iterator to the first key, it is the key of this item's child.
+     * \param [in] last forward iterator to the position after the last key.
+     * \return The descendant, this item if the path is empty or nullptr if there is no item with one of the keys.
+     */
+    template<typename TYPE, typename KEY_OF, typename BASE, typename HASH>
+    template<typename ITERATOR>
+    TYPE * TreeItemKeyIndex<TYPE, KEY_OF, BASE, HASH>::childByPath(ITERATOR first, ITERATOR last) {
+        TYPE * item = static_cast<TYPE*>(this);
+        for (; first != last && item != nullptr; ++first) {
+            item = item->childByKey(*first);
+        }
+        return item;
+    }
+
+    /*!
+     * \details Finds the descendant by the keys of the items on the way to it.
+     * \param [in] first forward iterator to the first key, it is the key of this item's child.
+     * \param [in] last forward iterator to the position after the last key.
+     * \return The descendant, this item if the path is empty or nullptr if there is no item with one of the keys.
+     */
+    template<typename TYPE, typename KEY_OF, typename BASE, typename HASH>
+    template<typename ITERATOR>
+    const TYPE * TreeItemKeyIndex<TYPE, KEY_OF, BASE, HASH>::childByPath(ITERATOR first, ITERATOR last) const {
+        const TYPE * item = static_cast<const TYPE*>(this);
+        for (; first != last && item != nullptr; ++first) {
+            item = item->childByKey(*first);
+        }
+        return item;
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Updates the parent's table after the item's key is changed.
+     */
+    template<typename TYPE, typename KEY_OF, typename BASE, typename HASH>
+    void TreeItemKeyIndex<TYPE, KEY_OF, BASE, HASH>::keyChanged() {
+        const TreeItemKeyIndex * parent = BASE::parent();
+        if (parent != nullptr && parent->mTable) {
+            parent->removeFromTable(static_cast<TYPE*>(this));
+            parent->addToTable(static_cast<TYPE*>(this));
+        }
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Adds the child to the table if it is made.
+     * \param [in] child
+     */
+    template<typename TYPE, typename KEY_OF, typename BASE, typename HASH>
+    void TreeItemKeyIndex<TYPE, KEY_OF, BASE, HASH>::childAdded(TYPE * child) {
+        if (mTable) {
+            addToTable(child);
+        }
+        BASE::childAdded(child);
+    }
+
+    /*!
+     * \details Removes the child from the table if it is made.
+     * \param [in] child
+     */
+    template<typename TYPE, typename KEY_OF, typename BASE, typename HASH>
+    void TreeItemKeyIndex<TYPE, KEY_OF, BASE, HASH>::childRemoved(TYPE * child) {
+        if (mTable) {
+            removeFromTable(child);
+        }
+        BASE::childRemoved(child);
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Gets the table, it is made from the children at the first call.
+     * \return The children's table.
+     */
+    template<typename TYPE, typename KEY_OF, typename BASE, typename HASH>
+    const typename TreeItemKeyIndex<TYPE, KEY_OF, BASE, HASH>::Table & TreeItemKeyIndex<TYPE, KEY_OF, BASE, HASH>::table() const {
+        if (!mTable) {
+            // the layers below may make the children at the first access, so the table is made after that.
+            const auto & children = this->children();
+            mTable.reset(new Table(children.size()));
+            for (auto & it : children) {
+                addToTable(it);
+            }
+        }
+        return *mTable;
+    }
+
+    /*!
+     * \details Remembers the child's key and adds the child to the table.
+     * \param [in] child
+     */
+    template<typename TYPE, typename KEY_OF, typename BASE, typename HASH>
+    void TreeItemKeyIndex<TYPE, KEY_OF, BASE, HASH>::addToTable(TYPE * child) const {
+        TreeItemKeyIndex * item = child;
+        item->mIndexedKey = KEY_OF::key(child);
+        mTable->emplace(item->mIndexedKey, child);
+    }
+
+    /*!
+     * \details Removes the child from the table by the key it was added with.
+     * \param [in] child
+     */
+    template<typename TYPE, typename KEY_OF, typename BASE, typename HASH>
+    void TreeItemKeyIndex<TYPE, KEY_OF, BASE, HASH>::removeFromTable(TYPE * child) const {
+        const TreeItemKeyIndex * item = child;
+        const auto range = mTable->equal_range(item->mIndexedKey);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second == child) {
+                mTable->erase(it);
+                return;
+            }
+        }
+    }
+
+    /**************************************************************************************************/
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /**************************************************************************************************/
+}
+}
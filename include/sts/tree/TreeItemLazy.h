@@ -0,0 +1,177 @@
+#pragma once
+
+/*
+**  Copyright(C) 2018, StepToSky
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  1.Redistributions of source code must retain the above copyright notice, this
+**    list of conditions and the following disclaimer.
+**  2.Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and / or other materials provided with the distribution.
+**  3.Neither the name of StepToSky nor the names of its contributors
+**    may be used to endorse or promote products derived from this software
+**    without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**  DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**  Contacts: www.steptosky.com
+*/
+
+#include <cstddef>
+#include <utility>
+#include "TreeItem.h"
+
+namespace sts {
+namespace tree {
+
+    /********************************************************************************************************/
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /********************************************************************************************************/
+
+    /*!
+     * \details Tree item layer which makes the children on demand.
+     * \details An item may be marked as unloaded, then its children are made by the \link TreeItemLazy::loadChildren \endlink
+     *          method at the first access through the children methods (count, access by index, the children list,
+     *          adding and removing), so only the visited part of a huge hierarchy is in the memory.
+     *          The loaded children may be returned to the unloaded state with \link TreeItemLazy::unload \endlink
+     *          or \link TreeItemLazy::unloadIf \endlink to free the memory of the cold subtrees.
+     * \details Use the layer instead of the TreeItem:
+     * \code
+     *      class YourType : public TreeItemLazy<YourType> {
+     *      public:
+     *          explicit YourType(const std::string & path) : mPath(path) { markUnloaded(); }
+     *      protected:
+     *          void loadChildren() override {
+     *              for (auto & name : listDirectory(mPath)) { appendChild(new YourType(mPath + "/" + name)); }
+     *          }
+     *      private:
+     *          std::string mPath;
+     *      };
+     * \endcode
+     * \note The copy of an unloaded item is unloaded too, the copy of a loaded item has the clones of its children.
+     * \details The traversals (\link sts::tree::preorder \endlink, \link sts::tree::levelorder \endlink,
+     *          \link sts::tree::parallelForEach \endlink and the others) load the visited items too,
+     *          they get the children with \link TreeItemLazy::loadedChildren \endlink.
+     * \warning The children methods load the children even though they are constant,
+     *          so they must not be called concurrently for the unloaded items of one tree
+     *          unless the loadChildren method is thread safe (see \link sts::tree::TreeItemParallelVisitor \endlink).
+     * \warning The non-virtual TreeItem methods which are used by the layer's type directly don't load the children.
+     * \tparam TYPE your type.
+     * \tparam BASE the tree item type or another layer.
+     */
+    template<typename TYPE, typename BASE = TreeItem<TYPE>>
+    class TreeItemLazy : public BASE {
+    protected:
+
+        TreeItemLazy(const TreeItemLazy & copy);
+        TreeItemLazy & operator =(const TreeItemLazy & copy);
+        TreeItemLazy(TreeItemLazy && other);
+        TreeItemLazy & operator =(TreeItemLazy && other);
+
+    public:
+
+        typedef typename BASE::Index Index;
+        typedef typename BASE::Children Children;
+
+        //---------------------------------------------------------------
+        /// @{
+
+        TreeItemLazy();
+        explicit TreeItemLazy(TYPE * inOutParent);
+        virtual ~TreeItemLazy() = default;
+
+        /// @}
+        //---------------------------------------------------------------
+        /// @{
+
+        bool isLoaded() const;
+        void load() const;
+        void markUnloaded();
+        void unload();
+        template<typename PREDICATE>
+        Index unloadIf(PREDICATE isCold);
+
+        /// @}
+        //---------------------------------------------------------------
+        /// @{
+
+        Index childrenCount() const override;
+        TYPE * childAt(Index index) override;
+        const TYPE * childAt(Index index) const override;
+        TYPE * takeChildAt(Index index) override;
+        const Children & children() const override;
+        const Children & loadedChildren() const;
+
+        /// @}
+        //---------------------------------------------------------------
+        /// @{
+
+        TYPE * prependChild(TYPE * inOutItem) override;
+        TYPE * insertChild(Index where, TYPE * inOutItem) override;
+        TYPE * appendChild(TYPE * inOutItem) override;
+
+        /// @}
+        //---------------------------------------------------------------
+        /// @{
+
+        template<typename ITERATOR>
+        void insertChildren(Index where, ITERATOR first, ITERATOR last);
+        template<typename ITERATOR>
+        void appendChildren(ITERATOR first, ITERATOR last);
+        void reserveChildren(Index count) override;
+
+        /// @}
+        //---------------------------------------------------------------
+        /// @{
+
+        void deleteChild(Index index) override;
+        using BASE::deleteChild;
+        void deleteChildren() override;
+
+        /// @}
+        //---------------------------------------------------------------
+        /// @{
+
+        bool hasChildren() const override;
+        bool isLeaf() const override;
+        bool isBranch() const override;
+
+        /// @}
+        //---------------------------------------------------------------
+
+    protected:
+
+        using BASE::children;
+
+        /*!
+         * \details Makes the children of the unloaded item, usually with \link TreeItem::appendChild \endlink.
+         * \details It is called once after the item is marked as unloaded, the item is already loaded during the call.
+         *          If it throws the added children are deleted and the item stays unloaded.
+         */
+        virtual void loadChildren() = 0;
+
+    private:
+
+        mutable bool mUnloaded = false;
+
+    };
+
+    /********************************************************************************************************/
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /********************************************************************************************************/
+}
+}
+
+#include "TreeItemLazy.inl.h"
@@ -0,0 +1,379 @@
+#pragma once
+
+/*
+**  Copyright(C) 2018, StepToSky
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  1.Redistributions of source code must retain the above copyright notice, this
+**    list of conditions and the following disclaimer.
+**  2.Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and / or other materials provided with the distribution.
+**  3.Neither the name of StepToSky nor the names of its contributors
+**    may be used to endorse or promote products derived from this software
+**    without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**  DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**  Contacts: www.steptosky.com
+*/
+
+#include <cassert>
+#include <vector>
+
+namespace sts {
+namespace tree {
+
+    /**************************************************************************************************/
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Constructor default, the item is loaded and has no children.
+     */
+    template<typename TYPE, typename BASE>
+    TreeItemLazy<TYPE, BASE>::TreeItemLazy() {}
+
+    /*!
+     * \details Constructor init.
+     * \param [in, out] inOutParent parent of this item, the item will be appended to its children list.
+     */
+    template<typename TYPE, typename BASE>
+    TreeItemLazy<TYPE, BASE>::TreeItemLazy(TYPE * inOutParent)
+        : BASE(inOutParent) {}
+
+    /*!
+     * \details Constructor copy.
+     * \note The copy of an unloaded item is unloaded too.
+     * \param [in] copy
+     */
+    template<typename TYPE, typename BASE>
+    TreeItemLazy<TYPE, BASE>::TreeItemLazy(const TreeItemLazy & copy)
+        : BASE(copy),
+          mUnloaded(copy.mUnloaded) {}
+
+    /*!
+     * \details Operator copy.
+     * \note The item becomes unloaded if the copy is unloaded.
+     * \param [in] copy
+     */
+    template<typename TYPE, typename BASE>
+    TreeItemLazy<TYPE, BASE> & TreeItemLazy<TYPE, BASE>::operator =(const TreeItemLazy & copy) {
+        BASE::operator=(copy);
+        mUnloaded = copy.mUnloaded;
+        return *this;
+    }
+
+    /*!
+     * \details Constructor move.
+     * \note The unloaded state is moved with the children, the other item is loaded and has no children.
+     * \param [in, out] other
+     */
+    template<typename TYPE, typename BASE>
+    TreeItemLazy<TYPE, BASE>::TreeItemLazy(TreeItemLazy && other)
+        : BASE(std::move(other)),
+          mUnloaded(other.mUnloaded) {
+        other.mUnloaded = false;
+    }
+
+    /*!
+     * \details Operator move.
+     * \note The unloaded state is moved with the children, the other item is loaded and has no children.
+     * \param [in, out] other
+     */
+    template<typename TYPE, typename BASE>
+    TreeItemLazy<TYPE, BASE> & TreeItemLazy<TYPE, BASE>::operator =(TreeItemLazy && other) {
+        BASE::operator=(std::move(other));
+        mUnloaded = other.mUnloaded;
+        other.mUnloaded = false;
+        return *this;
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Checks whether the children are made.
+     * \return True if the item is loaded otherwise false.
+     */
+    template<typename TYPE, typename BASE>
+    bool TreeItemLazy<TYPE, BASE>::isLoaded() const {
+        return !mUnloaded;
+    }
+
+    /*!
+     * \details Makes the children if the item is unloaded.
+     * \details If \link TreeItemLazy::loadChildren \endlink throws the added children are deleted,
+     *          the item stays unloaded and the exception is passed to the caller.
+     */
+    template<typename TYPE, typename BASE>
+    void TreeItemLazy<TYPE, BASE>::load() const {
+        if (!mUnloaded) {
+            return;
+        }
+        TreeItemLazy * self = const_cast<TreeItemLazy*>(this);
+        // the loader adds the children through the same methods.
+        mUnloaded = false;
+        try {
+            self->loadChildren();
+        }
+        catch (...) {
+            self->BASE::deleteChildren();
+            mUnloaded = true;
+            throw;
+        }
+    }
+
+    /*!
+     * \details Marks the item as unloaded, its children will be made at the first access.
+     * \pre The item must have no children.
+     */
+    template<typename TYPE, typename BASE>
+    void TreeItemLazy<TYPE, BASE>::markUnloaded() {
+        assert(!BASE::hasChildren());
+        mUnloaded = true;
+    }
+
+    /*!
+     * \details Deletes the children and marks the item as unloaded,
+     *          so the children will be made again at the next access.
+     * \details The unloaded item is left as is.
+     * \warning The pointers to the deleted children and their descendants are invalid after the call.
+     */
+    template<typename TYPE, typename BASE>
+    void TreeItemLazy<TYPE, BASE>::unload() {
+        if (mUnloaded) {
+            return;
+        }
+        BASE::deleteChildren();
+        mUnloaded = true;
+    }
+
+    /*!
+     * \details Unloads the cold items of the loaded part of the hierarchy.
+     * \details The loaded descendants are visited in the depth-first order without loading anything,
+     *          each item which is accepted by the predicate is unloaded and its children aren't visited.
+     *          The item itself isn't checked.
+     * \param [in] isCold function <code>bool(const TYPE *)</code>, for example it may compare the last access time
+     *                    that your type keeps.
+     * \return Count of the unloaded items.
+     */
+    template<typename TYPE, typename BASE>
+    template<typename PREDICATE>
+    typename TreeItemLazy<TYPE, BASE>::Index TreeItemLazy<TYPE, BASE>::unloadIf(PREDICATE isCold) {
+        Index count = 0;
+        std::vector<TreeItemLazy*> stack(1, this);
+        while (!stack.empty()) {
+            TreeItemLazy * item = stack.back();
+            stack.pop_back();
+            for (auto & it : item->BASE::children()) {
+                TreeItemLazy * child = it;
+                if (child->mUnloaded) {
+                    continue;
+                }
+                if (isCold(static_cast<const TYPE*>(it))) {
+                    child->unload();
+                    ++count;
+                }
+                else {
+                    stack.push_back(child);
+                }
+            }
+        }
+        return count;
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Loads the children and calls \link TreeItem::childrenCount \endlink.
+     */
+    template<typename TYPE, typename BASE>
+    typename TreeItemLazy<TYPE, BASE>::Index TreeItemLazy<TYPE, BASE>::childrenCount() const {
+        load();
+        return BASE::childrenCount();
+    }
+
+    /*!
+     * \details Loads the children and calls \link TreeItem::childAt \endlink.
+     */
+    template<typename TYPE, typename BASE>
+    TYPE * TreeItemLazy<TYPE, BASE>::childAt(const Index index) {
+        load();
+        return BASE::childAt(index);
+    }
+
+    /*!
+     * \details Loads the children and calls \link TreeItem::childAt \endlink.
+     */
+    template<typename TYPE, typename BASE>
+    const TYPE * TreeItemLazy<TYPE, BASE>::childAt(const Index index) const {
+        load();
+        return BASE::childAt(index);
+    }
+
+    /*!
+     * \details Loads the children and calls \link TreeItem::takeChildAt \endlink.
+     */
+    template<typename TYPE, typename BASE>
+    TYPE * TreeItemLazy<TYPE, BASE>::takeChildAt(const Index index) {
+        load();
+        return BASE::takeChildAt(index);
+    }
+
+    /*!
+     * \details Loads the children and calls \link TreeItem::children \endlink.
+     */
+    template<typename TYPE, typename BASE>
+    const typename TreeItemLazy<TYPE, BASE>::Children & TreeItemLazy<TYPE, BASE>::children() const {
+        load();
+        return BASE::children();
+    }
+
+    /*!
+     * \details Loads the children and calls \link TreeItem::loadedChildren \endlink.
+     *          It hides the TreeItem's method, so the traversals load the items which they visit.
+     */
+    template<typename TYPE, typename BASE>
+    const typename TreeItemLazy<TYPE, BASE>::Children & TreeItemLazy<TYPE, BASE>::loadedChildren() const {
+        load();
+        return BASE::loadedChildren();
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Loads the children and calls \link TreeItem::prependChild \endlink, so the new child is added to the loaded ones.
+     */
+    template<typename TYPE, typename BASE>
+    TYPE * TreeItemLazy<TYPE, BASE>::prependChild(TYPE * inOutItem) {
+        load();
+        return BASE::prependChild(inOutItem);
+    }
+
+    /*!
+     * \details Loads the children and calls \link TreeItem::insertChild \endlink, so the new child is added to the loaded ones.
+     */
+    template<typename TYPE, typename BASE>
+    TYPE * TreeItemLazy<TYPE, BASE>::insertChild(const Index where, TYPE * inOutItem) {
+        load();
+        return BASE::insertChild(where, inOutItem);
+    }
+
+    /*!
+     * \details Loads the children and calls \link TreeItem::appendChild \endlink, so the new child is added to the loaded ones.
+     */
+    template<typename TYPE, typename BASE>
+    TYPE * TreeItemLazy<TYPE, BASE>::appendChild(TYPE * inOutItem) {
+        load();
+        return BASE::appendChild(inOutItem);
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Loads the children and calls \link TreeItem::insertChildren \endlink, so the new children are added to the loaded ones.
+     */
+    template<typename TYPE, typename BASE>
+    template<typename ITERATOR>
+    void TreeItemLazy<TYPE, BASE>::insertChildren(const Index where, ITERATOR first, ITERATOR last) {
+        load();
+        BASE::insertChildren(where, first, last);
+    }
+
+    /*!
+     * \details Loads the children and calls \link TreeItem::appendChildren \endlink, so the new children are added to the loaded ones.
+     */
+    template<typename TYPE, typename BASE>
+    template<typename ITERATOR>
+    void TreeItemLazy<TYPE, BASE>::appendChildren(ITERATOR first, ITERATOR last) {
+        load();
+        BASE::appendChildren(first, last);
+    }
+
+    /*!
+     * \details Loads the children and calls \link TreeItem::reserveChildren \endlink.
+     */
+    template<typename TYPE, typename BASE>
+    void TreeItemLazy<TYPE, BASE>::reserveChildren(const Index count) {
+        load();
+        BASE::reserveChildren(count);
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Loads the children and calls \link TreeItem::deleteChild \endlink.
+     */
+    template<typename TYPE, typename BASE>
+    void TreeItemLazy<TYPE, BASE>::deleteChild(const Index index) {
+        load();
+        BASE::deleteChild(index);
+    }
+
+    /*!
+     * \details Deletes the children without loading them, then the item is loaded and has no children.
+     */
+    template<typename TYPE, typename BASE>
+    void TreeItemLazy<TYPE, BASE>::deleteChildren() {
+        mUnloaded = false;
+        BASE::deleteChildren();
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Loads the children and calls \link TreeItem::hasChildren \endlink.
+     * \note Use \link TreeItemLazy::isLoaded \endlink to check the item without loading.
+     */
+    template<typename TYPE, typename BASE>
+    bool TreeItemLazy<TYPE, BASE>::hasChildren() const {
+        load();
+        return BASE::hasChildren();
+    }
+
+    /*!
+     * \details Loads the children and calls \link TreeItem::isLeaf \endlink.
+     */
+    template<typename TYPE, typename BASE>
+    bool TreeItemLazy<TYPE, BASE>::isLeaf() const {
+        load();
+        return BASE::isLeaf();
+    }
+
+    /*!
+     * \details Loads the children and calls \link TreeItem::isBranch \endlink.
+     */
+    template<typename TYPE, typename BASE>
+    bool TreeItemLazy<TYPE, BASE>::isBranch() const {
+        load();
+        return BASE::isBranch();
+    }
+
+    /**************************************************************************************************/
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /**************************************************************************************************/
+}
+}
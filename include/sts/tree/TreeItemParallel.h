@@ -0,0 +1,210 @@
+#pragma once
+
+/*
+**  Copyright(C) 2018, StepToSky
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  1.Redistributions of source code must retain the above copyright notice, this
+**    list of conditions and the following disclaimer.
+**  2.Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and / or other materials provided with the distribution.
+**  3.Neither the name of StepToSky nor the names of its contributors
+**    may be used to endorse or promote products derived from this software
+**    without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**  DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**  Contacts: www.steptosky.com
+*/
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+#include "TreeItem.h"
+
+namespace sts {
+namespace tree {
+
+    /********************************************************************************************************/
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /********************************************************************************************************/
+
+    /*!
+     * \details Work-stealing scheduler of the parallel hierarchy processing,
+     *          it is the base of \link sts::tree::TreeItemParallelVisitor \endlink and \link sts::tree::TreeItemParallelCloner \endlink.
+     * \details The work is split by subtrees. Each thread processes its tasks depth-first with a local stack,
+     *          after each grain of the processed items it moves the bottom half of the stack (the biggest pending subtrees)
+     *          to its shared tasks queue if the queue is empty. The threads without work steal the tasks
+     *          from the other threads' queues, so the skewed hierarchies (one huge branch) are processed by all the threads too.
+     *          A thread which finds no tasks to steal sleeps until some thread shares its tasks or all the work is done.
+     * \details The calling thread is one of the working threads.
+     */
+    class TreeItemParallelScheduler {
+    public:
+
+        //---------------------------------------------------------------
+        /// @{
+
+        explicit TreeItemParallelScheduler(std::size_t threadsCount = 0, std::size_t grainSize = 256);
+
+        /// @}
+        //---------------------------------------------------------------
+        /// @{
+
+        void setThreadsCount(std::size_t count);
+        std::size_t threadsCount() const;
+
+        void setGrainSize(std::size_t size);
+        std::size_t grainSize() const;
+
+        /// @}
+        //---------------------------------------------------------------
+
+    protected:
+
+        template<typename TASK, typename PROCESS>
+        void run(const TASK & root, PROCESS process) const;
+
+    private:
+
+        std::size_t mThreadsCount;
+        std::size_t mGrainSize;
+
+    };
+
+    /********************************************************************************************************/
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /********************************************************************************************************/
+
+    /*!
+     * \details Visits all the items of a subtree with several threads,
+     *          the work is balanced by \link sts::tree::TreeItemParallelScheduler \endlink.
+     * \code
+     *      TreeItemParallelVisitor<YourType> visitor(8);
+     *      visitor.visit(root, [](YourType * item) { item->update(); });
+     * \endcode
+     * \note The visiting order isn't specified.
+     * \warning The function is called concurrently for the different items, it must be thread safe.
+     *          The hierarchy must not be changed while it is being visited.
+     *          The unloaded items of \link sts::tree::TreeItemLazy \endlink are loaded by the visiting threads,
+     *          so the loadChildren method is called concurrently for the different items, it must be thread safe too.
+     * \tparam ITEM your type, it may be const.
+     */
+    template<typename ITEM>
+    class TreeItemParallelVisitor : public TreeItemParallelScheduler {
+    public:
+
+        //---------------------------------------------------------------
+        /// @{
+
+        explicit TreeItemParallelVisitor(std::size_t threadsCount = 0, std::size_t grainSize = 256);
+
+        /// @}
+        //---------------------------------------------------------------
+        /// @{
+
+        template<typename FUNCTION>
+        void visit(ITEM * root, FUNCTION function) const;
+
+        /// @}
+        //---------------------------------------------------------------
+
+    private:
+
+        typedef typename std::remove_const<ITEM>::type Type;
+
+    };
+
+    /********************************************************************************************************/
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /********************************************************************************************************/
+
+    /*!
+     * \details Clones a subtree with several threads, the work is balanced by \link sts::tree::TreeItemParallelScheduler \endlink.
+     * \details Each task fills the children list of one clone, the copy constructors which are called
+     *          meanwhile put the children lists of the new clones into the thread's stack
+     *          instead of cloning them, so the independent subtrees are cloned by the different threads.
+     *          The result is the same as the one of the serial \link TreeItem::clone \endlink:
+     *          the same items in the same order, each children list is reserved once.
+     * \code
+     *      TreeItemParallelCloner<YourType> cloner(8);
+     *      YourType * copy = cloner.clone(root);
+     * \endcode
+     * \warning The clone method is called concurrently for the different items, it must be thread safe,
+     *          for example \link sts::tree::TreeItemPool \endlink isn't.
+     *          The hierarchy must not be changed while it is being cloned.
+     * \tparam ITEM your type, \link sts::tree::TreeItem \endlink or \link sts::tree::TreeItemStatic \endlink based one.
+     */
+    template<typename ITEM>
+    class TreeItemParallelCloner : public TreeItemParallelScheduler {
+    public:
+
+        //---------------------------------------------------------------
+        /// @{
+
+        explicit TreeItemParallelCloner(std::size_t threadsCount = 0, std::size_t grainSize = 256);
+
+        /// @}
+        //---------------------------------------------------------------
+        /// @{
+
+        ITEM * clone(const ITEM * root) const;
+
+        /// @}
+        //---------------------------------------------------------------
+
+    private:
+
+        typedef typename ITEM::TreeBase Base;
+
+    };
+
+    /********************************************************************************************************/
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /********************************************************************************************************/
+
+    /*!
+     * \details Visits all the items of the subtree with several threads,
+     *          see \link sts::tree::TreeItemParallelVisitor \endlink for details.
+     * \param [in] root subtree root.
+     * \param [in] function it is called for each item.
+     * \param [in] threadsCount threads count, 0 means the hardware concurrency.
+     * \param [in] grainSize items count that a thread visits before sharing its work.
+     */
+    template<typename ITEM, typename FUNCTION>
+    void parallelForEach(ITEM * root, FUNCTION function, const std::size_t threadsCount = 0, const std::size_t grainSize = 256) {
+        TreeItemParallelVisitor<ITEM>(threadsCount, grainSize).visit(root, function);
+    }
+
+    /*!
+     * \details Clones the subtree with several threads,
+     *          see \link sts::tree::TreeItemParallelCloner \endlink for details.
+     * \param [in] root subtree root.
+     * \param [in] threadsCount threads count, 0 means the hardware concurrency.
+     * \param [in] grainSize items count that a thread clones before sharing its work.
+     * \return Pointer to the cloned subtree root, it has no parent.
+     */
+    template<typename ITEM>
+    ITEM * parallelClone(const ITEM * root, const std::size_t threadsCount = 0, const std::size_t grainSize = 256) {
+        return TreeItemParallelCloner<ITEM>(threadsCount, grainSize).clone(root);
+    }
+
+    /********************************************************************************************************/
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /********************************************************************************************************/
+}
+}
+
+#include "TreeItemParallel.inl.h"
@@ -0,0 +1,332 @@
+#pragma once
+
+/*
+**  Copyright(C) 2018, StepToSky
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  1.Redistributions of source code must retain the above copyright notice, this
+**    list of conditions and the following disclaimer.
+**  2.Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and / or other materials provided with the distribution.
+**  3.Neither the name of StepToSky nor the names of its contributors
+**    may be used to endorse or promote products derived from this software
+**    without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**  DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**  Contacts: www.steptosky.com
+*/
+
+#include <cassert>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sts {
+namespace tree {
+
+    /**************************************************************************************************/
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Constructor init.
+     * \param [in] threadsCount threads count, 0 means the hardware concurrency.
+     * \param [in] grainSize items count that a thread processes before sharing its work.
+     */
+    inline TreeItemParallelScheduler::TreeItemParallelScheduler(const std::size_t threadsCount, const std::size_t grainSize)
+        : mThreadsCount(0),
+          mGrainSize(0) {
+        setThreadsCount(threadsCount);
+        setGrainSize(grainSize);
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Sets the threads count.
+     * \param [in] count threads count, 0 means the hardware concurrency.
+     */
+    inline void TreeItemParallelScheduler::setThreadsCount(const std::size_t count) {
+        mThreadsCount = count != 0 ? count : std::thread::hardware_concurrency();
+        if (mThreadsCount == 0) {
+            mThreadsCount = 1;
+        }
+    }
+
+    /*!
+     * \details Gets the threads count.
+     * \return Threads count.
+     */
+    inline std::size_t TreeItemParallelScheduler::threadsCount() const {
+        return mThreadsCount;
+    }
+
+    /*!
+     * \details Sets the grain size, it is the items count that a thread processes before sharing its pending work.
+     *          Smaller grain gives better balancing, bigger one gives less synchronization.
+     * \param [in] size grain size, 0 is considered as 1.
+     */
+    inline void TreeItemParallelScheduler::setGrainSize(const std::size_t size) {
+        mGrainSize = size != 0 ? size : 1;
+    }
+
+    /*!
+     * \details Gets the grain size.
+     * \return Grain size.
+     */
+    inline std::size_t TreeItemParallelScheduler::grainSize() const {
+        return mGrainSize;
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Processes the root task and all the tasks which are produced by it.
+     * \details If the processing throws an exception it is stopped as soon as possible
+     *          and the first exception is re-thrown in the calling thread.
+     *          If a thread can't be started the already started ones are stopped and joined
+     *          and the exception is re-thrown.
+     * \param [in] root the first task.
+     * \param [in] process it is called for each task as process(TASK, std::vector<TASK> & stack),
+     *                     it pushes the new tasks into the stack and returns the processed items count.
+     */
+    template<typename TASK, typename PROCESS>
+    void TreeItemParallelScheduler::run(const TASK & root, PROCESS process) const {
+        struct Queue {
+            std::mutex mMutex;
+            std::deque<TASK> mTasks;
+        };
+
+        const std::size_t threadsCount = mThreadsCount;
+        const std::size_t grainSize = mGrainSize;
+        std::vector<Queue> queues(threadsCount);
+        std::atomic<std::size_t> pending(1);
+        std::atomic<bool> stopped(false);
+        std::atomic<std::size_t> shares(0);
+        std::mutex idleMutex;
+        std::condition_variable idle;
+        std::exception_ptr exception;
+        std::mutex exceptionMutex;
+        queues[0].mTasks.push_back(root);
+
+        auto takeTask = [&](const std::size_t thread, TASK & outTask) -> bool {
+            {
+                Queue & own = queues[thread];
+                std::lock_guard<std::mutex> lock(own.mMutex);
+                if (!own.mTasks.empty()) {
+                    outTask = own.mTasks.back();
+                    own.mTasks.pop_back();
+                    return true;
+                }
+            }
+            for (std::size_t i = 1; i < threadsCount; ++i) {
+                Queue & other = queues[(thread + i) % threadsCount];
+                std::lock_guard<std::mutex> lock(other.mMutex);
+                if (!other.mTasks.empty()) {
+                    outTask = other.mTasks.front();
+                    other.mTasks.pop_front();
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        auto work = [&](const std::size_t thread) {
+            Queue & own = queues[thread];
+            std::vector<TASK> stack;
+            TASK task = root;
+            while (pending.load(std::memory_order_acquire) != 0) {
+                const std::size_t seenShares = shares.load(std::memory_order_acquire);
+                if (!takeTask(thread, task)) {
+                    // sleeps until new tasks are shared or all the work is done.
+                    std::unique_lock<std::mutex> lock(idleMutex);
+                    idle.wait(lock, [&]() {
+                        return shares.load(std::memory_order_acquire) != seenShares ||
+                               pending.load(std::memory_order_acquire) == 0;
+                    });
+                    continue;
+                }
+                try {
+                    std::size_t processed = 0;
+                    stack.push_back(task);
+                    while (!stack.empty() && !stopped.load(std::memory_order_relaxed)) {
+                        const TASK current = stack.back();
+                        stack.pop_back();
+                        processed += process(current, stack);
+                        if (processed < grainSize || stack.size() < 2) {
+                            continue;
+                        }
+                        processed = 0;
+                        {
+                            std::lock_guard<std::mutex> lock(own.mMutex);
+                            if (!own.mTasks.empty()) {
+                                continue;
+                            }
+                            const std::size_t shared = stack.size() / 2;
+                            pending.fetch_add(shared, std::memory_order_relaxed);
+                            own.mTasks.insert(own.mTasks.end(), stack.begin(), stack.begin() + shared);
+                            stack.erase(stack.begin(), stack.begin() + shared);
+                        }
+                        {
+                            std::lock_guard<std::mutex> lock(idleMutex);
+                            shares.fetch_add(1, std::memory_order_release);
+                        }
+                        idle.notify_all();
+                    }
+                }
+                catch (...) {
+                    std::lock_guard<std::mutex> lock(exceptionMutex);
+                    if (!exception) {
+                        exception = std::current_exception();
+                    }
+                    stopped.store(true, std::memory_order_relaxed);
+                }
+                if (stopped.load(std::memory_order_relaxed)) {
+                    // drops the rest of the work, each dropped task is one pending task.
+                    stack.clear();
+                    std::lock_guard<std::mutex> lock(own.mMutex);
+                    pending.fetch_sub(own.mTasks.size(), std::memory_order_release);
+                    own.mTasks.clear();
+                }
+                if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    std::lock_guard<std::mutex> lock(idleMutex);
+                    idle.notify_all();
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(threadsCount - 1);
+        try {
+            for (std::size_t i = 1; i < threadsCount; ++i) {
+                threads.emplace_back(work, i);
+            }
+        }
+        catch (...) {
+            // the stopped work just drops the tasks, so the started threads finish soon.
+            stopped.store(true, std::memory_order_relaxed);
+            work(0);
+            for (auto & it : threads) {
+                it.join();
+            }
+            throw;
+        }
+        work(0);
+        for (auto & it : threads) {
+            it.join();
+        }
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+
+    /**************************************************************************************************/
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Constructor init.
+     * \param [in] threadsCount threads count, 0 means the hardware concurrency.
+     * \param [in] grainSize items count that a thread visits before sharing its work.
+     */
+    template<typename ITEM>
+    TreeItemParallelVisitor<ITEM>::TreeItemParallelVisitor(const std::size_t threadsCount, const std::size_t grainSize)
+        : TreeItemParallelScheduler(threadsCount, grainSize) {}
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Calls the function for the item and all its descendants.
+     * \details If the function throws an exception the visiting is stopped as soon as possible
+     *          and the first exception is re-thrown in the calling thread.
+     * \param [in] root subtree root.
+     * \param [in] function it is called for each item as function(ITEM *).
+     */
+    template<typename ITEM>
+    template<typename FUNCTION>
+    void TreeItemParallelVisitor<ITEM>::visit(ITEM * root, FUNCTION function) const {
+        assert(root);
+        run(root, [&function](ITEM * item, std::vector<ITEM*> & stack) -> std::size_t {
+            function(item);
+            for (auto & it : static_cast<const Type *>(item)->loadedChildren()) {
+                stack.push_back(it);
+            }
+            return 1;
+        });
+    }
+
+    /**************************************************************************************************/
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Constructor init.
+     * \param [in] threadsCount threads count, 0 means the hardware concurrency.
+     * \param [in] grainSize items count that a thread clones before sharing its work.
+     */
+    template<typename ITEM>
+    TreeItemParallelCloner<ITEM>::TreeItemParallelCloner(const std::size_t threadsCount, const std::size_t grainSize)
+        : TreeItemParallelScheduler(threadsCount, grainSize) {}
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Clones the item and all its descendants.
+     * \details If a clone method throws an exception the cloning is stopped as soon as possible,
+     *          the already cloned items are deleted and the first exception is re-thrown in the calling thread.
+     * \param [in] root subtree root.
+     * \return Pointer to the cloned subtree root, it has no parent.
+     */
+    template<typename ITEM>
+    ITEM * TreeItemParallelCloner<ITEM>::clone(const ITEM * root) const {
+        assert(root);
+        typedef typename Base::CloningList CloningList;
+        CloningList pending;
+        ITEM * copy = Base::cloneItem(root, pending);
+        if (pending.empty()) {
+            return copy;
+        }
+        assert(pending.size() == 1);
+        try {
+            run(pending.front(), [](const typename CloningList::value_type & task, CloningList & stack) -> std::size_t {
+                Base::cloneChildren(task.first, task.second, stack);
+                return task.second->size();
+            });
+        }
+        catch (...) {
+            delete copy;
+            throw;
+        }
+        return copy;
+    }
+
+    /**************************************************************************************************/
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /**************************************************************************************************/
+}
+}
@@ -0,0 +1,171 @@
+#pragma once
+
+/*
+**  Copyright(C) 2018, StepToSky
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  1.Redistributions of source code must retain the above copyright notice, this
+**    list of conditions and the following disclaimer.
+**  2.Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and / or other materials provided with the distribution.
+**  3.Neither the name of StepToSky nor the names of its contributors
+**    may be used to endorse or promote products derived from this software
+**    without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**  DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**  Contacts: www.steptosky.com
+*/
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace sts {
+namespace tree {
+
+    /********************************************************************************************************/
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /********************************************************************************************************/
+
+    /*!
+     * \details Persistent tree of values with the copy-on-write structural sharing.
+     * \details A copy of the tree (a snapshot) costs O(1), it shares all the nodes with the original.
+     *          A change copies the shared nodes on the path from the root to the changed node,
+     *          the rest of the structure stays shared between the versions. The nodes which aren't shared
+     *          are changed in place, so a tree without snapshots is changed without copying.
+     * \details A copied node gets the copy of its children vector, so the change after a snapshot costs
+     *          O(fan-out) per node on the path: an allocation of the vector and an atomic reference count
+     *          increment for each child. A change of a node with many children or under such a node is
+     *          therefore much more expensive than the path length suggests, e.g. 10000 children cost
+     *          about 15% of the deep copy of the whole tree.
+     * \details The nodes are addressed by the path of the children indices from the root.
+     *          They have no parent pointers, it is what makes the sharing possible,
+     *          that is why the hierarchy of \link sts::tree::TreeItem \endlink can't be shared this way.
+     *          Use \link TreeItemPersistent::build \endlink to make a persistent tree from a tree items hierarchy.
+     * \code
+     *      TreeItemPersistent<int> tree(0);
+     *      tree.appendChild({}, 1);
+     *      TreeItemPersistent<int> snapshot = tree.snapshot(); // O(1)
+     *      tree.setValue({0}, 2);                               // copies the root and the changed node only
+     * \endcode
+     * \note A snapshot may be given to another thread and read there while the tree it was taken from is changed,
+     *       the node which was shared with the snapshot is changed in place only after the snapshot has released it.
+     *       One tree object must not be used by several threads at the same time.
+     * \note The nodes are released without recursion, so the hierarchy may be as deep as the memory allows.
+     * \tparam VALUE value type, it must be copy constructible.
+     */
+    template<typename VALUE>
+    class TreeItemPersistent {
+    public:
+
+        typedef std::size_t Index;    /*!< \details Child index. */
+        typedef std::vector<Index> Path; /*!< \details Children indices from the root to a node, the empty path is the root. */
+
+        /*!
+         * \details Node of the tree, it may be shared by several versions of the tree, so it is read only.
+         */
+        class Node {
+        public:
+
+            //---------------------------------------------------------------
+            /// @{
+
+            explicit Node(const VALUE & value);
+            Node(const Node & copy) = default;
+            ~Node();
+
+            Node & operator =(const Node &) = delete;
+
+            /// @}
+            //---------------------------------------------------------------
+            /// @{
+
+            const VALUE & value() const;
+            Index childrenCount() const;
+            const Node * childAt(Index index) const;
+            bool isLeaf() const;
+
+            /// @}
+            //---------------------------------------------------------------
+
+        private:
+
+            friend class TreeItemPersistent;
+
+            VALUE mValue;
+            std::vector<std::shared_ptr<Node>> mChildren;
+
+        };
+
+        //---------------------------------------------------------------
+        /// @{
+
+        explicit TreeItemPersistent(const VALUE & rootValue = VALUE());
+        TreeItemPersistent(const TreeItemPersistent & copy) = default;
+        TreeItemPersistent(TreeItemPersistent && other);
+        ~TreeItemPersistent() = default;
+
+        TreeItemPersistent & operator =(const TreeItemPersistent & copy) = default;
+        TreeItemPersistent & operator =(TreeItemPersistent && other);
+
+        template<typename ITEM, typename FUNCTION>
+        static TreeItemPersistent build(const ITEM * root, FUNCTION valueOf);
+
+        /// @}
+        //---------------------------------------------------------------
+        /// @{
+
+        TreeItemPersistent snapshot() const;
+        bool isSharedWith(const TreeItemPersistent & other) const;
+
+        /// @}
+        //---------------------------------------------------------------
+        /// @{
+
+        const Node & root() const;
+        const Node * node(const Path & path) const;
+        const VALUE & value(const Path & path) const;
+
+        /// @}
+        //---------------------------------------------------------------
+        /// @{
+
+        void setValue(const Path & path, const VALUE & value);
+        void insertChild(const Path & parent, Index where, const VALUE & value);
+        void appendChild(const Path & parent, const VALUE & value);
+        void removeChild(const Path & parent, Index index);
+
+        /// @}
+        //---------------------------------------------------------------
+
+    private:
+
+        std::shared_ptr<Node> mRoot;
+
+        Node * unshare(const Path & path);
+        static void unshare(std::shared_ptr<Node> & node);
+        static bool isShared(const std::shared_ptr<Node> & node);
+
+    };
+
+    /********************************************************************************************************/
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /********************************************************************************************************/
+}
+}
+
+#include "TreeItemPersistent.inl.h"
@@ -0,0 +1,355 @@
+#pragma once
+
+/*
+**  Copyright(C) 2018, StepToSky
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  1.Redistributions of source code must retain the above copyright notice, this
+**    list of conditions and the following disclaimer.
+**  2.Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and / or other materials provided with the distribution.
+**  3.Neither the name of StepToSky nor the names of its contributors
+**    may be used to endorse or promote products derived from this software
+**    without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**  DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**  Contacts: www.steptosky.com
+*/
+
+#include <cassert>
+#include <utility>
+
+namespace sts {
+namespace tree {
+
+    /**************************************************************************************************/
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Constructor init.
+     * \param [in] value
+     */
+    template<typename VALUE>
+    TreeItemPersistent<VALUE>::Node::Node(const VALUE & value)
+        : mValue(value) {}
+
+    /*!
+     * \details Destructor.
+     * \details Releases the children without recursion, the children which are shared
+     *          with other nodes are just released, the other ones give their children to this destructor.
+     */
+    template<typename VALUE>
+    TreeItemPersistent<VALUE>::Node::~Node() {
+        std::vector<std::shared_ptr<Node>> stack(std::move(mChildren));
+        while (!stack.empty()) {
+            std::shared_ptr<Node> node = std::move(stack.back());
+            stack.pop_back();
+            if (!isShared(node)) {
+                for (auto & it : node->mChildren) {
+                    stack.push_back(std::move(it));
+                }
+                node->mChildren.clear();
+            }
+        }
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Gets the node's value.
+     * \return Value.
+     */
+    template<typename VALUE>
+    const VALUE & TreeItemPersistent<VALUE>::Node::value() const {
+        return mValue;
+    }
+
+    /*!
+     * \details Gets the node's children count.
+     * \return Children count.
+     */
+    template<typename VALUE>
+    typename TreeItemPersistent<VALUE>::Index TreeItemPersistent<VALUE>::Node::childrenCount() const {
+        return mChildren.size();
+    }
+
+    /*!
+     * \details Gets the child by its index.
+     * \param [in] index
+     * \return Pointer to the child, it is valid while the node is.
+     */
+    template<typename VALUE>
+    const typename TreeItemPersistent<VALUE>::Node * TreeItemPersistent<VALUE>::Node::childAt(const Index index) const {
+        assert(index < mChildren.size());
+        return mChildren[index].get();
+    }
+
+    /*!
+     * \details Checks whether the node has no children.
+     * \return True if the node has no children otherwise false.
+     */
+    template<typename VALUE>
+    bool TreeItemPersistent<VALUE>::Node::isLeaf() const {
+        return mChildren.empty();
+    }
+
+    /**************************************************************************************************/
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Constructor init, the tree has the root only.
+     * \param [in] rootValue
+     */
+    template<typename VALUE>
+    TreeItemPersistent<VALUE>::TreeItemPersistent(const VALUE & rootValue)
+        : mRoot(std::make_shared<Node>(rootValue)) {}
+
+    /*!
+     * \details Move constructor, the moved-from tree has the root with the default value.
+     * \param [in, out] other
+     */
+    template<typename VALUE>
+    TreeItemPersistent<VALUE>::TreeItemPersistent(TreeItemPersistent && other)
+        : mRoot(std::make_shared<Node>(VALUE())) {
+        std::swap(mRoot, other.mRoot);
+    }
+
+    /*!
+     * \details Move operator, the moved-from tree gets the previous nodes of this tree.
+     * \param [in, out] other
+     */
+    template<typename VALUE>
+    TreeItemPersistent<VALUE> & TreeItemPersistent<VALUE>::operator =(TreeItemPersistent && other) {
+        std::swap(mRoot, other.mRoot);
+        return *this;
+    }
+
+    /*!
+     * \details Makes the tree from the tree items hierarchy without recursion.
+     * \param [in] root root of the hierarchy or of its part.
+     * \param [in] valueOf it is called for each item as VALUE valueOf(const ITEM *).
+     * \return The tree with the same structure as the hierarchy.
+     */
+    template<typename VALUE>
+    template<typename ITEM, typename FUNCTION>
+    TreeItemPersistent<VALUE> TreeItemPersistent<VALUE>::build(const ITEM * root, FUNCTION valueOf) {
+        assert(root);
+        TreeItemPersistent tree(valueOf(root));
+        std::vector<std::pair<const ITEM*, Node*>> stack;
+        stack.emplace_back(root, tree.mRoot.get());
+        while (!stack.empty()) {
+            const ITEM * item = stack.back().first;
+            Node * node = stack.back().second;
+            stack.pop_back();
+            node->mChildren.reserve(item->childrenCount());
+            for (auto & it : item->children()) {
+                node->mChildren.push_back(std::make_shared<Node>(valueOf(it)));
+                stack.emplace_back(it, node->mChildren.back().get());
+            }
+        }
+        return tree;
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Makes the snapshot in O(1), it is the same as the copy.
+     * \return The tree which shares all the nodes with this one.
+     */
+    template<typename VALUE>
+    TreeItemPersistent<VALUE> TreeItemPersistent<VALUE>::snapshot() const {
+        return *this;
+    }
+
+    /*!
+     * \details Checks whether the trees share the root, it means there were no changes of them since the snapshot.
+     * \param [in] other
+     * \return True if the root is shared otherwise false.
+     */
+    template<typename VALUE>
+    bool TreeItemPersistent<VALUE>::isSharedWith(const TreeItemPersistent & other) const {
+        return mRoot == other.mRoot;
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Gets the root node.
+     * \return Root node, it is valid till the next change of the tree.
+     */
+    template<typename VALUE>
+    const typename TreeItemPersistent<VALUE>::Node & TreeItemPersistent<VALUE>::root() const {
+        return *mRoot;
+    }
+
+    /*!
+     * \details Gets the node by its path.
+     * \param [in] path
+     * \return Pointer to the node or nullptr if there is no node with the path,
+     *         it is valid till the next change of the tree.
+     */
+    template<typename VALUE>
+    const typename TreeItemPersistent<VALUE>::Node * TreeItemPersistent<VALUE>::node(const Path & path) const {
+        const Node * node = mRoot.get();
+        for (auto index : path) {
+            if (index >= node->mChildren.size()) {
+                return nullptr;
+            }
+            node = node->mChildren[index].get();
+        }
+        return node;
+    }
+
+    /*!
+     * \details Gets the node's value by the node's path.
+     * \pre The node must exist.
+     * \param [in] path
+     * \return Value.
+     */
+    template<typename VALUE>
+    const VALUE & TreeItemPersistent<VALUE>::value(const Path & path) const {
+        const Node * n = node(path);
+        assert(n);
+        return n->mValue;
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Sets the node's value, the shared nodes of the path are copied.
+     *          Each copied node copies its children vector, it is O(fan-out) per node of the path.
+     * \pre The node must exist.
+     * \param [in] path
+     * \param [in] value
+     */
+    template<typename VALUE>
+    void TreeItemPersistent<VALUE>::setValue(const Path & path, const VALUE & value) {
+        unshare(path)->mValue = value;
+    }
+
+    /*!
+     * \details Inserts the new node into the children of the specified one, the shared nodes of the parent's path are copied.
+     *          Each copied node copies its children vector, it is O(fan-out) per node of the path.
+     * \pre The parent must exist.
+     * \param [in] parent parent's path.
+     * \param [in] where index of the new child, it must not be bigger than the children count.
+     * \param [in] value new node's value.
+     */
+    template<typename VALUE>
+    void TreeItemPersistent<VALUE>::insertChild(const Path & parent, const Index where, const VALUE & value) {
+        std::shared_ptr<Node> child = std::make_shared<Node>(value);
+        Node * node = unshare(parent);
+        assert(where <= node->mChildren.size());
+        node->mChildren.insert(node->mChildren.begin() + std::ptrdiff_t(where), std::move(child));
+    }
+
+    /*!
+     * \details Appends the new node to the children of the specified one, the shared nodes of the parent's path are copied.
+     *          Each copied node copies its children vector, it is O(fan-out) per node of the path.
+     * \pre The parent must exist.
+     * \param [in] parent parent's path.
+     * \param [in] value new node's value.
+     */
+    template<typename VALUE>
+    void TreeItemPersistent<VALUE>::appendChild(const Path & parent, const VALUE & value) {
+        std::shared_ptr<Node> child = std::make_shared<Node>(value);
+        unshare(parent)->mChildren.push_back(std::move(child));
+    }
+
+    /*!
+     * \details Removes the child with its descendants, the shared nodes of the parent's path are copied.
+     *          Each copied node copies its children vector, it is O(fan-out) per node of the path.
+     *          The removed nodes are released if they aren't shared with the snapshots.
+     * \pre The parent and the child must exist.
+     * \param [in] parent parent's path.
+     * \param [in] index child's index.
+     */
+    template<typename VALUE>
+    void TreeItemPersistent<VALUE>::removeChild(const Path & parent, const Index index) {
+        Node * node = unshare(parent);
+        assert(index < node->mChildren.size());
+        node->mChildren.erase(node->mChildren.begin() + std::ptrdiff_t(index));
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Makes the nodes of the path owned by this tree only, the shared ones are copied.
+     *          The copy shares the children with the original node, but it has its own children vector,
+     *          so copying costs an allocation and an atomic reference count increment per child.
+     * \pre The node must exist.
+     * \param [in] path
+     * \return The node of the path which can be changed.
+     */
+    template<typename VALUE>
+    typename TreeItemPersistent<VALUE>::Node * TreeItemPersistent<VALUE>::unshare(const Path & path) {
+        unshare(mRoot);
+        Node * node = mRoot.get();
+        for (auto index : path) {
+            assert(index < node->mChildren.size());
+            std::shared_ptr<Node> & child = node->mChildren[index];
+            unshare(child);
+            node = child.get();
+        }
+        return node;
+    }
+
+    /*!
+     * \details Copies the node if it is shared.
+     * \param [in, out] node
+     */
+    template<typename VALUE>
+    void TreeItemPersistent<VALUE>::unshare(std::shared_ptr<Node> & node) {
+        if (isShared(node)) {
+            node = std::make_shared<Node>(*node);
+        }
+    }
+
+    /*!
+     * \details Checks whether the node is referenced by other nodes or trees.
+     * \details If the reference is the only one the node may be changed in place. The snapshots which shared it
+     *          may have been released by other threads just now, use_count() doesn't synchronize with them,
+     *          so the acquire fence makes their reading of the node happen before the change
+     *          (the same way as std::shared_ptr does before it deletes the object).
+     * \param [in] node
+     * \return True if the node is shared otherwise false.
+     */
+    template<typename VALUE>
+    bool TreeItemPersistent<VALUE>::isShared(const std::shared_ptr<Node> & node) {
+        if (node.use_count() != 1) {
+            return true;
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return false;
+    }
+
+    /**************************************************************************************************/
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /**************************************************************************************************/
+}
+}
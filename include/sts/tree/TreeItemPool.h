@@ -0,0 +1,205 @@
+#pragma once
+
+
+/*
+**  Copyright(C) 2018, StepToSky
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  1.Redistributions of source code must retain the above copyright notice, this
+**    list of conditions and the following disclaimer.
+**  2.Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and / or other materials provided with the distribution.
+**  3.Neither the name of StepToSky nor the names of its contributors
+**    may be used to endorse or promote products derived from this software
+**    without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**  DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**  Contacts: www.steptosky.com
+*/
+
+#include <cstddef>
+#include <cassert>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace sts {
+namespace tree {
+
+    /********************************************************************************************************/
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /********************************************************************************************************/
+
+    /*!
+     * \details Memory pool for the tree items of one tree.
+     * \details The pool allocates the items' memory from big blocks (slabs),
+     *          memory of deleted items is reused by next allocations.
+     *          The slabs are released all together when the pool is destroyed,
+     *          so deleting a tree doesn't make a call of the memory allocator for each item.
+     *          \link TreeItemPool::release \endlink deletes a whole tree without returning the items' memory one by one,
+     *          the pool becomes empty and the next items are allocated from the beginning of its slabs again.
+     * \pre Your type must inherit \link sts::tree::TreeItemPoolAllocated \endlink
+     *      then the items are allocated in the pool with the placement new:
+     * \code
+     *      TreeItemPool<YourType> pool;
+     *      YourType * root = new(pool) YourType();
+     *      root->appendChild(new(pool) YourType());
+     *      ...
+     *      delete root; // before the pool is destroyed,
+     *      // or pool.release(root) if all the pool's items are in the root's hierarchy.
+     * \endcode
+     * \warning The pool must outlive all the items allocated in it.
+     * \warning The pool isn't thread safe.
+     * \note Each item has a pointer to its pool before the item's memory.
+     *       Items of types derived from TYPE which are bigger than TYPE are allocated with the global operator new,
+     *       their alignment must not be bigger than TYPE's one.
+     *       The memory is allocated with the global operator new, so TYPE's alignment must not be bigger
+     *       than the one of std::max_align_t.
+     * \tparam TYPE your type.
+     */
+    template<typename TYPE>
+    class TreeItemPool {
+    public:
+
+        //---------------------------------------------------------------
+        /// @{
+
+        explicit TreeItemPool(std::size_t slabItems = 1024);
+        ~TreeItemPool();
+
+        TreeItemPool(const TreeItemPool &) = delete;
+        TreeItemPool & operator =(const TreeItemPool &) = delete;
+
+        /// @}
+        //---------------------------------------------------------------
+        /// @{
+
+        void reserve(std::size_t count);
+        void release(TYPE * root);
+        std::size_t itemsCount() const;
+        std::size_t slabsCount() const;
+
+        /// @}
+        //---------------------------------------------------------------
+        /// @{
+
+        void * allocate(std::size_t size);
+        static void * allocateOutside(std::size_t size);
+        static void deallocate(void * ptr);
+        static TreeItemPool * poolOf(const void * ptr);
+
+        /// @}
+        //---------------------------------------------------------------
+
+    private:
+
+        struct FreeBlock {
+            FreeBlock * mNext;
+        };
+
+        struct Slab {
+            char * mBegin;
+            std::size_t mItems;
+        };
+
+        static const std::size_t HeaderSize = alignof(TYPE) > sizeof(void*) ? alignof(TYPE) : sizeof(void*);
+        static const std::size_t BlockAlignment = alignof(TYPE) > alignof(void*) ? alignof(TYPE) : alignof(void*);
+        static const std::size_t BlockSize = (HeaderSize + sizeof(TYPE) + BlockAlignment - 1) / BlockAlignment * BlockAlignment;
+
+        static_assert(BlockAlignment <= alignof(std::max_align_t),
+                      "The global operator new doesn't align the memory for TYPE, it is over-aligned.");
+
+        std::vector<Slab> mSlabs;
+        std::size_t mSlabsUsed = 0; /*!< \details The slabs before this index have the allocated items, the rest are free. */
+        FreeBlock * mFree = nullptr;
+        char * mSlabCurr = nullptr;
+        char * mSlabEnd = nullptr;
+        std::size_t mSlabItems;
+        std::size_t mReserved = 0;
+        std::size_t mItemsCount = 0;
+        bool mReleasing = false;
+
+        void nextSlab(std::size_t items);
+        static TreeItemPool *& header(void * ptr);
+
+    };
+
+    /********************************************************************************************************/
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /********************************************************************************************************/
+
+    /*!
+     * \details Allocation policy for the tree items which use \link sts::tree::TreeItemPool \endlink.
+     * \details Inherit it in your type in addition to the TreeItem:
+     * \code
+     *      class YourType : public TreeItem<YourType>, public TreeItemPoolAllocated<YourType> { ... };
+     * \endcode
+     *          The class-specific operators new and delete make the TreeItem's
+     *          deleting of children return their memory to the pool they were allocated in.
+     *          Items created with usual new are allocated with the global operator new.
+     *          The items without the virtual methods like \link sts::tree::TreeItemStatic \endlink ones can use it as well,
+     *          TYPE must be the final type of such items.
+     * \tparam TYPE your type.
+     */
+    template<typename TYPE>
+    class TreeItemPoolAllocated {
+    public:
+
+        static void * operator new(const std::size_t size) {
+            return TreeItemPool<TYPE>::allocateOutside(size);
+        }
+
+        static void * operator new(const std::size_t size, TreeItemPool<TYPE> & pool) {
+            return pool.allocate(size);
+        }
+
+        static void operator delete(void * ptr) {
+            TreeItemPool<TYPE>::deallocate(ptr);
+        }
+
+        static void operator delete(void * ptr, TreeItemPool<TYPE> &) {
+            TreeItemPool<TYPE>::deallocate(ptr);
+        }
+
+        /*!
+         * \details Gets the pool the item is allocated in, it is useful for implementing the clone method.
+         * \return Pointer to the pool or nullptr if the item isn't allocated in a pool.
+         */
+        TreeItemPool<TYPE> * itemPool() const {
+            return TreeItemPool<TYPE>::poolOf(objectOf(static_cast<const TYPE*>(this), std::is_polymorphic<TYPE>()));
+        }
+
+    private:
+
+        /*! \details The polymorphic item may be a part of a bigger object, its memory starts with the most derived one. */
+        static const void * objectOf(const TYPE * item, std::true_type) {
+            return dynamic_cast<const void*>(item);
+        }
+
+        /*! \details The item without the virtual methods must be TYPE itself. */
+        static const void * objectOf(const TYPE * item, std::false_type) {
+            return item;
+        }
+
+    };
+
+    /********************************************************************************************************/
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /********************************************************************************************************/
+}
+}
+
+#include "TreeItemPool.inl.h"
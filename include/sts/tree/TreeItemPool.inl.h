@@ -0,0 +1,235 @@
+#pragma once
+
+
+/*
+**  Copyright(C) 2018, StepToSky
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  1.Redistributions of source code must retain the above copyright notice, this
+**    list of conditions and the following disclaimer.
+**  2.Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and / or other materials provided with the distribution.
+**  3.Neither the name of StepToSky nor the names of its contributors
+**    may be used to endorse or promote products derived from this software
+**    without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**  DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**  Contacts: www.steptosky.com
+*/
+
+namespace sts {
+namespace tree {
+
+    /**************************************************************************************************/
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Constructor.
+     * \param [in] slabItems items count in one slab.
+     */
+    template<typename TYPE>
+    TreeItemPool<TYPE>::TreeItemPool(const std::size_t slabItems)
+        : mSlabItems(slabItems) {
+        assert(slabItems != 0);
+    }
+
+    /*!
+     * \details Destructor.
+     * \warning All the items allocated in the pool must be deleted before.
+     */
+    template<typename TYPE>
+    TreeItemPool<TYPE>::~TreeItemPool() {
+        assert(mItemsCount == 0);
+        for (auto & it : mSlabs) {
+            ::operator delete(it.mBegin);
+        }
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Makes the next slab big enough for the specified items count,
+     *          so those items will be allocated in one memory block.
+     * \param [in] count
+     */
+    template<typename TYPE>
+    void TreeItemPool<TYPE>::reserve(const std::size_t count) {
+        mReserved = count;
+    }
+
+    /*!
+     * \details Deletes the tree and makes the pool empty, the slabs are kept for the next allocations.
+     *          The items' destructors are called as usual but their memory isn't put to the free list,
+     *          the next items are allocated from the beginning of the first slab again.
+     * \pre All the items which are allocated in the pool are in the root's hierarchy.
+     *      The root's parent, if it has one, isn't allocated in the pool.
+     * \param [in] root
+     */
+    template<typename TYPE>
+    void TreeItemPool<TYPE>::release(TYPE * root) {
+        mReleasing = true;
+        delete root;
+        mReleasing = false;
+        assert(mItemsCount == 0);
+        mFree = nullptr;
+        mSlabsUsed = 0;
+        mSlabCurr = nullptr;
+        mSlabEnd = nullptr;
+    }
+
+    /*!
+     * \details Gets count of the items which are allocated in the pool at the moment.
+     * \return Items count.
+     */
+    template<typename TYPE>
+    std::size_t TreeItemPool<TYPE>::itemsCount() const {
+        return mItemsCount;
+    }
+
+    /*!
+     * \details Gets count of the allocated slabs.
+     * \return Slabs count.
+     */
+    template<typename TYPE>
+    std::size_t TreeItemPool<TYPE>::slabsCount() const {
+        return mSlabs.size();
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Allocates memory for one item.
+     * \param [in] size requested size, if it is bigger than TYPE the memory is allocated outside the pool.
+     * \return Pointer to the memory.
+     */
+    template<typename TYPE>
+    void * TreeItemPool<TYPE>::allocate(const std::size_t size) {
+        if (size > sizeof(TYPE)) {
+            return allocateOutside(size);
+        }
+        char * block;
+        if (mFree != nullptr) {
+            block = reinterpret_cast<char*>(mFree);
+            mFree = mFree->mNext;
+        }
+        else {
+            if (mSlabCurr == mSlabEnd) {
+                nextSlab(mReserved > mSlabItems ? mReserved : mSlabItems);
+                mReserved = 0;
+            }
+            block = mSlabCurr;
+            mSlabCurr += BlockSize;
+        }
+        ++mItemsCount;
+        void * ptr = block + HeaderSize;
+        header(ptr) = this;
+        return ptr;
+    }
+
+    /*!
+     * \details Allocates memory for one item with the global operator new.
+     * \param [in] size
+     * \return Pointer to the memory.
+     */
+    template<typename TYPE>
+    void * TreeItemPool<TYPE>::allocateOutside(const std::size_t size) {
+        void * ptr = static_cast<char*>(::operator new(HeaderSize + size)) + HeaderSize;
+        header(ptr) = nullptr;
+        return ptr;
+    }
+
+    /*!
+     * \details Returns the item's memory to its pool or deletes it with the global operator delete.
+     * \param [in] ptr memory which is allocated by \link TreeItemPool::allocate \endlink or \link TreeItemPool::allocateOutside \endlink.
+     */
+    template<typename TYPE>
+    void TreeItemPool<TYPE>::deallocate(void * ptr) {
+        if (ptr == nullptr) {
+            return;
+        }
+        TreeItemPool * pool = header(ptr);
+        char * block = static_cast<char*>(ptr) - HeaderSize;
+        if (pool == nullptr) {
+            ::operator delete(block);
+            return;
+        }
+        assert(pool->mItemsCount != 0);
+        --pool->mItemsCount;
+        if (pool->mReleasing) {
+            return;
+        }
+        FreeBlock * freeBlock = reinterpret_cast<FreeBlock*>(block);
+        freeBlock->mNext = pool->mFree;
+        pool->mFree = freeBlock;
+    }
+
+    /*!
+     * \details Gets the pool of the memory.
+     * \param [in] ptr memory which is allocated by \link TreeItemPool::allocate \endlink or \link TreeItemPool::allocateOutside \endlink.
+     * \return Pointer to the pool or nullptr if the memory isn't allocated in a pool.
+     */
+    template<typename TYPE>
+    TreeItemPool<TYPE> * TreeItemPool<TYPE>::poolOf(const void * ptr) {
+        return header(const_cast<void*>(ptr));
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Makes the next free slab current one, a new slab is allocated if there is no free one
+     *          which is big enough. The slabs list grows geometrically.
+     * \param [in] items
+     */
+    template<typename TYPE>
+    void TreeItemPool<TYPE>::nextSlab(const std::size_t items) {
+        if (mSlabsUsed == mSlabs.size() || mSlabs[mSlabsUsed].mItems < items) {
+            // the list is extended before the allocation, so the slab can't be lost.
+            mSlabs.insert(mSlabs.begin() + std::ptrdiff_t(mSlabsUsed), Slab{nullptr, items});
+            try {
+                mSlabs[mSlabsUsed].mBegin = static_cast<char*>(::operator new(items * BlockSize));
+            }
+            catch (...) {
+                mSlabs.erase(mSlabs.begin() + std::ptrdiff_t(mSlabsUsed));
+                throw;
+            }
+        }
+        const Slab & slab = mSlabs[mSlabsUsed++];
+        mSlabCurr = slab.mBegin;
+        mSlabEnd = slab.mBegin + slab.mItems * BlockSize;
+    }
+
+    /*!
+     * \details Access to the pool pointer which is stored before the item's memory.
+     * \param [in] ptr
+     * \return Reference to the pool pointer.
+     */
+    template<typename TYPE>
+    TreeItemPool<TYPE> *& TreeItemPool<TYPE>::header(void * ptr) {
+        return *reinterpret_cast<TreeItemPool**>(static_cast<char*>(ptr) - sizeof(TreeItemPool*));
+    }
+
+    /**************************************************************************************************/
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /**************************************************************************************************/
+}
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+/*
+**  Copyright(C) 2018, StepToSky
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  1.Redistributions of source code must retain the above copyright notice, this
+**    list of conditions and the following disclaimer.
+**  2.Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and / or other materials provided with the distribution.
+**  3.Neither the name of StepToSky nor the names of its contributors
+**    may be used to endorse or promote products derived from this software
+**    without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**  DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**  Contacts: www.steptosky.com
+*/
+
+#include <utility>
+#include <vector>
+#include "TreeItem.h"
+
+namespace sts {
+namespace tree {
+
+    /********************************************************************************************************/
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /********************************************************************************************************/
+
+    /*!
+     * \details Tree item layer which makes the \link TreeItem::root \endlink O(1) amortized.
+     * \details Each item caches its root, the caches are filled along the whole path to the root
+     *          by the first call of the root method (path compression), so the next calls for the item and
+     *          its ancestors return the cached root at once.
+     *          Adding or removing a child clears the caches of the child's subtree only,
+     *          the other items keep their roots, so the root is always correct and the cached roots are never dangling pointers.
+     *          An item is cached only if its parent is cached too, so the clearing stops at the items without the cache
+     *          and it takes O(cached items of the subtree) time, each of them has been cached by a root call before.
+     * \details Use the layer instead of the TreeItem:
+     * \code
+     *      class YourType : public TreeItemRootCache<YourType> { ... };
+     *      class YourListType : public TreeItemRootCache<YourListType, TreeItem<YourListType, TreeItemContainerList<YourListType>>> { ... };
+     * \endcode
+     * \note The root cache fits the trees that are asked for the root much more often than they are changed.
+     * \warning The root method writes the caches, so it must not be called concurrently for the items of one tree
+     *          even though the method is constant. Changing and asking different trees in different threads is allowed.
+     * \warning If you override \link TreeItem::childAdded \endlink or \link TreeItem::childRemoved \endlink
+     *          you must call the layer's implementation too.
+     * \tparam TYPE your type.
+     * \tparam BASE the tree item type or another layer.
+     */
+    template<typename TYPE, typename BASE = TreeItem<TYPE>>
+    class TreeItemRootCache : public BASE {
+    protected:
+
+        TreeItemRootCache(const TreeItemRootCache & copy);
+        TreeItemRootCache & operator =(const TreeItemRootCache & copy);
+        TreeItemRootCache(TreeItemRootCache && other);
+        TreeItemRootCache & operator =(TreeItemRootCache && other);
+
+    public:
+
+        //---------------------------------------------------------------
+        /// @{
+
+        TreeItemRootCache();
+        explicit TreeItemRootCache(TYPE * inOutParent);
+        virtual ~TreeItemRootCache();
+
+        /// @}
+        //---------------------------------------------------------------
+        /// @{
+
+        TYPE * root() override;
+        const TYPE * root() const override;
+
+        /// @}
+        //---------------------------------------------------------------
+
+    protected:
+
+        void childAdded(TYPE * child) override;
+        void childRemoved(TYPE * child) override;
+
+    private:
+
+        mutable TYPE * mCachedRoot = nullptr; /*!< \details nullptr if the cache is cleared. */
+
+        TYPE * cachedRoot() const;
+        void clearCaches();
+
+    };
+
+    /********************************************************************************************************/
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /********************************************************************************************************/
+}
+}
+
+#include "TreeItemRootCache.inl.h"
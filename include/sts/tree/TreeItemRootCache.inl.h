@@ -0,0 +1,220 @@
+#pragma once
+
+/*
+**  Copyright(C) 2018, StepToSky
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  1.Redistributions of source code must retain the above copyright notice, this
+**    list of conditions and the following disclaimer.
+**  2.Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and / or other materials provided with the distribution.
+**  3.Neither the name of StepToSky nor the names of its contributors
+**    may be used to endorse or promote products derived from this software
+**    without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**  DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**  Contacts: www.steptosky.com
+*/
+
+#include <cassert>
+
+namespace sts {
+namespace tree {
+
+    /**************************************************************************************************/
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Constructor default.
+     */
+    template<typename TYPE, typename BASE>
+    TreeItemRootCache<TYPE, BASE>::TreeItemRootCache() {}
+
+    /*!
+     * \details Constructor init.
+     * \note The item is appended to the parent after the layer is initialized,
+     *       so the parent's notification finds the item's cache cleared.
+     * \param [in, out] inOutParent parent of this item, the item will be appended to its children list.
+     */
+    template<typename TYPE, typename BASE>
+    TreeItemRootCache<TYPE, BASE>::TreeItemRootCache(TYPE * inOutParent) {
+        assert(inOutParent);
+        BASE::setParent(inOutParent);
+    }
+
+    /*!
+     * \details Destructor, removes the item from its parent while its cache is still available,
+     *          so the caches of its subtree are cleared.
+     */
+    template<typename TYPE, typename BASE>
+    TreeItemRootCache<TYPE, BASE>::~TreeItemRootCache() {
+        if (BASE::parent() != nullptr) {
+            BASE::setParent(nullptr);
+        }
+    }
+
+    /*!
+     * \details Constructor copy.
+     * \note The cache isn't copied, the copy has another root.
+     * \param [in] copy
+     */
+    template<typename TYPE, typename BASE>
+    TreeItemRootCache<TYPE, BASE>::TreeItemRootCache(const TreeItemRootCache & copy)
+        : BASE(copy) {}
+
+    /*!
+     * \details Operator copy.
+     * \note The cache isn't copied, the item's position in the hierarchy isn't changed by the operator.
+     * \param [in] copy
+     */
+    template<typename TYPE, typename BASE>
+    TreeItemRootCache<TYPE, BASE> & TreeItemRootCache<TYPE, BASE>::operator =(const TreeItemRootCache & copy) {
+        BASE::operator=(copy);
+        return *this;
+    }
+
+    /*!
+     * \details Constructor move.
+     * \note The cache isn't moved, the moved children clear their caches when they leave the other item.
+     * \param [in, out] other
+     */
+    template<typename TYPE, typename BASE>
+    TreeItemRootCache<TYPE, BASE>::TreeItemRootCache(TreeItemRootCache && other)
+        : BASE(std::move(other)) {}
+
+    /*!
+     * \details Operator move.
+     * \note The cache isn't moved, the item's position in the hierarchy isn't changed by the operator.
+     * \param [in, out] other
+     */
+    template<typename TYPE, typename BASE>
+    TreeItemRootCache<TYPE, BASE> & TreeItemRootCache<TYPE, BASE>::operator =(TreeItemRootCache && other) {
+        BASE::operator=(std::move(other));
+        return *this;
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Gets the tree hierarchy root from the cache.
+     * \return Root of the tree hierarchy.
+     */
+    template<typename TYPE, typename BASE>
+    TYPE * TreeItemRootCache<TYPE, BASE>::root() {
+        return cachedRoot();
+    }
+
+    /*!
+     * \details Gets the tree hierarchy root from the cache.
+     * \return Root of the tree hierarchy.
+     */
+    template<typename TYPE, typename BASE>
+    const TYPE * TreeItemRootCache<TYPE, BASE>::root() const {
+        return cachedRoot();
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Clears the root caches of the child's subtree.
+     * \param [in] child
+     */
+    template<typename TYPE, typename BASE>
+    void TreeItemRootCache<TYPE, BASE>::childAdded(TYPE * child) {
+        static_cast<TreeItemRootCache *>(child)->clearCaches();
+        BASE::childAdded(child);
+    }
+
+    /*!
+     * \details Clears the root caches of the child's subtree.
+     * \param [in] child
+     */
+    template<typename TYPE, typename BASE>
+    void TreeItemRootCache<TYPE, BASE>::childRemoved(TYPE * child) {
+        static_cast<TreeItemRootCache *>(child)->clearCaches();
+        BASE::childRemoved(child);
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Functions *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Gets the root from the cache, if the cache is cleared
+     *          it walks up to the root or to the first ancestor with the cache
+     *          and then fills the caches of all the items on the way.
+     * \return Root of the tree hierarchy.
+     */
+    template<typename TYPE, typename BASE>
+    TYPE * TreeItemRootCache<TYPE, BASE>::cachedRoot() const {
+        if (mCachedRoot != nullptr) {
+            return mCachedRoot;
+        }
+        const TreeItemRootCache * item = this;
+        TYPE * root = nullptr;
+        for (;;) {
+            if (item->mCachedRoot != nullptr) {
+                root = item->mCachedRoot;
+                break;
+            }
+            const TreeItemRootCache * parent = item->BASE::parent();
+            if (parent == nullptr) {
+                root = const_cast<TYPE*>(static_cast<const TYPE*>(item));
+                break;
+            }
+            item = parent;
+        }
+        for (item = this; item != nullptr && item->mCachedRoot == nullptr; item = item->BASE::parent()) {
+            item->mCachedRoot = root;
+        }
+        return root;
+    }
+
+    /*!
+     * \details Clears the caches of the item and its descendants without recursion.
+     *          The descendants of an item without the cache have no cache too, so they are skipped.
+     */
+    template<typename TYPE, typename BASE>
+    void TreeItemRootCache<TYPE, BASE>::clearCaches() {
+        if (mCachedRoot == nullptr) {
+            return;
+        }
+        mCachedRoot = nullptr;
+        std::vector<TreeItemRootCache *> items(1, this);
+        while (!items.empty()) {
+            TreeItemRootCache * item = items.back();
+            items.pop_back();
+            // the layers' children methods may load the children, the loaded ones only may have the caches.
+            for (auto & it : item->BASE::TreeBase::children()) {
+                TreeItemRootCache * child = it;
+                if (child->mCachedRoot != nullptr) {
+                    child->mCachedRoot = nullptr;
+                    items.push_back(child);
+                }
+            }
+        }
+    }
+
+    /**************************************************************************************************/
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /**************************************************************************************************/
+}
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+/*
+**  Copyright(C) 2018, StepToSky
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  1.Redistributions of source code must retain the above copyright notice, this
+**    list of conditions and the following disclaimer.
+**  2.Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and / or other materials provided with the distribution.
+**  3.Neither the name of StepToSky nor the names of its contributors
+**    may be used to endorse or promote products derived from this software
+**    without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**  DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**  Contacts: www.steptosky.com
+*/
+
+#include <type_traits>
+#include "TreeItem.h"
+
+namespace sts {
+namespace tree {
+
+    /********************************************************************************************************/
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /********************************************************************************************************/
+
+    /*!
+     * \details The dispatch of \link sts::tree::TreeItem \endlink without the virtual methods.
+     *          The hooks and the clone method are called through TYPE, so TYPE may hide them with its own methods.
+     * \see \link sts::tree::TreeItemStatic \endlink
+     * \tparam TYPE your type.
+     * \tparam CONTAINER container type.
+     */
+    template<typename TYPE, typename CONTAINER>
+    class TreeItemStaticDispatch : public TreeItemContainerTraits<CONTAINER>::Hook {
+    protected:
+
+        /*! \details The default clone uses TYPE's copy constructor. */
+        typedef std::true_type CopyByDefault;
+
+        template<typename ITEM>
+        static TYPE * dispatch(ITEM * item) {
+            return static_cast<TYPE*>(item);
+        }
+
+        template<typename ITEM>
+        static const TYPE * dispatch(const ITEM * item) {
+            return static_cast<const TYPE*>(item);
+        }
+
+    };
+
+    /********************************************************************************************************/
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /********************************************************************************************************/
+
+    /*!
+     * \details Tree Item without the virtual methods.
+     *          It is \link sts::tree::TreeItem \endlink with \link sts::tree::TreeItemStaticDispatch \endlink,
+     *          so it has the same interface and behaviour but all the calls are resolved while compilation,
+     *          the item has no pointer to the virtual table
+     *          and the compiler can inline the accessors into the loops which walk the hierarchy.
+     * \pre
+     *      - TYPE must be the final type of the items, the children are deleted and cloned as TYPE.
+     *      - All the containers of \link sts::tree::TreeItem \endlink can be used.
+     *      - TYPE may hide \link TreeItem::childAdded \endlink, \link TreeItem::childRemoved \endlink
+     *  and \link TreeItem::clone \endlink with its own methods, they are called through TYPE.
+     *  If the methods are not public TYPE must declare TreeItemStatic as a friend.
+     *      - The default \link TreeItem::clone \endlink uses TYPE's copy constructor.
+     *  The copy constructor doesn't call \link TreeItem::childAdded \endlink for the cloned children
+     *  because TYPE isn't constructed at that moment, the move constructor doesn't call it as well.
+     *      - The move constructor and operator transfer the children without cloning,
+     *  the moved-from item keeps its parent and has no children.
+     *      - The destructor isn't virtual, so the items must be deleted as TYPE.
+     *      - The layers which override the virtual methods like \link sts::tree::TreeItemRootCache \endlink
+     *  can't be used with this class. The traversal iterators, \link sts::tree::TreeItemParallelVisitor \endlink,
+     *  \link sts::tree::TreeItemParallelCloner \endlink,
+     *  \link sts::tree::TreeItemAncestorIndex \endlink and \link sts::tree::TreeItemPool \endlink can.
+     * \code
+     *      class YourType : public TreeItemStatic<YourType> { ... };
+     * \endcode
+     * \tparam TYPE your type.
+     * \tparam CONTAINER container type.
+     */
+    template<typename TYPE, typename CONTAINER = TreeItemContainerVector<TYPE>>
+    using TreeItemStatic = TreeItem<TYPE, CONTAINER, TreeItemStaticDispatch<TYPE, CONTAINER>>;
+
+    /********************************************************************************************************/
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /********************************************************************************************************/
+}
+}
@@ -0,0 +1,340 @@
+#pragma once
+
+/*
+**  Copyright(C) 2018, StepToSky
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  1.Redistributions of source code must retain the above copyright notice, this
+**    list of conditions and the following disclaimer.
+**  2.Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and / or other materials provided with the distribution.
+**  3.Neither the name of StepToSky nor the names of its contributors
+**    may be used to endorse or promote products derived from this software
+**    without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**  DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**  Contacts: www.steptosky.com
+*/
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+#include "TreeItem.h"
+
+namespace sts {
+namespace tree {
+
+    /********************************************************************************************************/
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /********************************************************************************************************/
+
+    /*!
+     * \details Walking state which is common for the traversal iterators.
+     * \details The walker moves by the children containers' iterators, each step takes O(1) time at any depth.
+     *          The positions of the current item and its ancestors in their parents' containers are kept
+     *          in the walker, the first \link TreeItemWalker::InlineLevels \endlink of them inside the walker itself,
+     *          so walking and copying the iterators don't allocate memory unless the hierarchy is deeper than that.
+     *          The parent is got by the item's parent pointer, so going back doesn't need more data.
+     * \details The items are accessed with the non-virtual calls of the \link TreeItem \endlink or \link TreeItemStatic \endlink methods,
+     *          the children are got with \link TreeItem::loadedChildren \endlink, so the unloaded
+     *          \link sts::tree::TreeItemLazy \endlink items are loaded when they are visited.
+     * \tparam ITEM your type, it may be const.
+     */
+    template<typename ITEM>
+    class TreeItemWalker {
+    public:
+
+        typedef typename std::remove_const<ITEM>::type Type;
+        typedef typename Type::TreeBase Base;
+        typedef typename Type::Children::const_iterator Position;
+
+        static const std::size_t InlineLevels = 16; /*!< \details Depth which is walked without the memory allocation. */
+
+        bool operator ==(const TreeItemWalker & other) const { return mCurrent == other.mCurrent; }
+        bool operator !=(const TreeItemWalker & other) const { return mCurrent != other.mCurrent; }
+
+    protected:
+
+        TreeItemWalker() = default;
+        explicit TreeItemWalker(ITEM * root);
+        TreeItemWalker(const TreeItemWalker & copy);
+        TreeItemWalker & operator =(const TreeItemWalker & copy);
+
+        struct Level {
+            Position mPosition;
+            Position mEnd;
+        };
+
+        ITEM * mCurrent = nullptr;
+        std::size_t mDepth = 0; /*!< \details Depth of the current item, the walking root is 0. */
+
+        bool toFirstChild();
+        bool toNextSibling();
+        bool toParent();
+        bool isLastChild() const;
+
+    private:
+
+        Level mLevels[InlineLevels];
+        std::vector<Level> mDeepLevels;
+
+        Level & level();
+        const Level & level() const;
+
+    };
+
+    /********************************************************************************************************/
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /********************************************************************************************************/
+
+    /*!
+     * \details Forward iterator which visits an item and then its children (depth-first, pre-order).
+     * \note The hierarchy must not be changed while it is being iterated.
+     * \tparam ITEM your type, it may be const.
+     */
+    template<typename ITEM>
+    class TreeItemPreorderIterator : public TreeItemWalker<ITEM> {
+    public:
+
+        typedef std::forward_iterator_tag iterator_category;
+        typedef ITEM * value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef ITEM * const * pointer;
+        typedef ITEM * const & reference;
+
+        TreeItemPreorderIterator() = default;
+        explicit TreeItemPreorderIterator(ITEM * root);
+
+        reference operator *() const { return this->mCurrent; }
+        pointer operator ->() const { return &this->mCurrent; }
+
+        TreeItemPreorderIterator & operator ++();
+        TreeItemPreorderIterator operator ++(int);
+
+    };
+
+    /*!
+     * \details Forward iterator which visits an item's children and then the item (depth-first, post-order).
+     * \note The hierarchy must not be changed while it is being iterated.
+     * \tparam ITEM your type, it may be const.
+     */
+    template<typename ITEM>
+    class TreeItemPostorderIterator : public TreeItemWalker<ITEM> {
+    public:
+
+        typedef std::forward_iterator_tag iterator_category;
+        typedef ITEM * value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef ITEM * const * pointer;
+        typedef ITEM * const & reference;
+
+        TreeItemPostorderIterator() = default;
+        explicit TreeItemPostorderIterator(ITEM * root);
+
+        reference operator *() const { return this->mCurrent; }
+        pointer operator ->() const { return &this->mCurrent; }
+
+        TreeItemPostorderIterator & operator ++();
+        TreeItemPostorderIterator operator ++(int);
+
+    private:
+
+        void toFirstLeaf();
+
+    };
+
+    /*!
+     * \details Forward iterator which visits the items level by level (breadth-first).
+     * \details The iterator keeps the items of the current level and the children of the visited ones
+     *          in two buffers which are swapped at each level, so the iteration takes O(items count) time
+     *          and the memory for the two widest levels. The buffers keep their capacity from level to level,
+     *          so they are allocated only while they grow, they may be reserved at once for the expected width.
+     *          Use \link sts::tree::TreeItemLevelorderInPlaceIterator \endlink if the memory must not be allocated.
+     * \details The children are got with \link TreeItem::loadedChildren \endlink like the other traversals do.
+     * \note The hierarchy must not be changed while it is being iterated.
+     *       Copying the iterator copies the buffers.
+     * \tparam ITEM your type, it may be const.
+     */
+    template<typename ITEM>
+    class TreeItemLevelorderIterator {
+    public:
+
+        typedef std::forward_iterator_tag iterator_category;
+        typedef ITEM * value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef ITEM * const * pointer;
+        typedef ITEM * const & reference;
+
+        TreeItemLevelorderIterator() = default;
+        explicit TreeItemLevelorderIterator(ITEM * root, std::size_t levelWidth = 0);
+
+        reference operator *() const { return mCurrent; }
+        pointer operator ->() const { return &mCurrent; }
+
+        bool operator ==(const TreeItemLevelorderIterator & other) const { return mCurrent == other.mCurrent; }
+        bool operator !=(const TreeItemLevelorderIterator & other) const { return mCurrent != other.mCurrent; }
+
+        TreeItemLevelorderIterator & operator ++();
+        TreeItemLevelorderIterator operator ++(int);
+
+    private:
+
+        typedef typename std::remove_const<ITEM>::type Type;
+
+        ITEM * mCurrent = nullptr;
+        std::vector<ITEM*> mLevel;     /*!< \details Items of the current level after the current one. */
+        std::vector<ITEM*> mNextLevel; /*!< \details Children of the current level's visited items. */
+        std::size_t mPosition = 0;     /*!< \details Position of the next item in the current level. */
+
+    };
+
+    /*!
+     * \details Forward iterator which visits the items level by level (breadth-first) without the memory allocation.
+     * \details The iterator doesn't keep the items of the levels, it goes from an item to the next one of its level
+     *          through their nearest common ancestor, and for each next level it walks again all the items
+     *          below the common ancestor of the previous level, including the leaves which can't reach the level.
+     *          So the iteration takes O(items count * height) time, it is superlinear for the random hierarchies.
+     *          Use it only if the memory must not be allocated, \link sts::tree::TreeItemLevelorderInPlaceIterator \endlink
+     *          takes O(items count) time.
+     * \note The hierarchy must not be changed while it is being iterated.
+     * \tparam ITEM your type, it may be const.
+     */
+    template<typename ITEM>
+    class TreeItemLevelorderInPlaceIterator : public TreeItemWalker<ITEM> {
+    public:
+
+        typedef std::forward_iterator_tag iterator_category;
+        typedef ITEM * value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef ITEM * const * pointer;
+        typedef ITEM * const & reference;
+
+        TreeItemLevelorderInPlaceIterator() = default;
+        explicit TreeItemLevelorderInPlaceIterator(ITEM * root);
+
+        reference operator *() const { return this->mCurrent; }
+        pointer operator ->() const { return &this->mCurrent; }
+
+        TreeItemLevelorderInPlaceIterator & operator ++();
+        TreeItemLevelorderInPlaceIterator operator ++(int);
+
+    private:
+
+        std::size_t mLevelTop = 0;        /*!< \details Depth of the common ancestor of the current level's visited items. */
+        ITEM * mLevelLastParent = nullptr; /*!< \details Parent of the current level's last item. */
+        ITEM * mLastParent = nullptr;      /*!< \details The current level's last visited item which has children. */
+
+        bool isLevelEnd() const;
+        bool toNext(std::size_t depth, std::size_t top, bool descend);
+
+    };
+
+    /********************************************************************************************************/
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /********************************************************************************************************/
+
+    /*!
+     * \details Range of the traversal iterators, it can be used with the range-based for loop.
+     * \tparam ITERATOR iterator type.
+     */
+    template<typename ITERATOR>
+    class TreeItemRange {
+    public:
+
+        typedef ITERATOR iterator;
+        typedef ITERATOR const_iterator;
+
+        explicit TreeItemRange(const ITERATOR & begin)
+            : mBegin(begin) {}
+
+        ITERATOR begin() const { return mBegin; }
+        ITERATOR end() const { return ITERATOR(); }
+
+    private:
+
+        ITERATOR mBegin;
+
+    };
+
+    /********************************************************************************************************/
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /********************************************************************************************************/
+
+    /*!
+     * \details Pre-order range of the item and all its descendants.
+     * \code
+     *      for (YourType * item : preorder(root)) { ... }
+     * \endcode
+     * \param [in] root
+     * \return Range.
+     */
+    template<typename ITEM>
+    TreeItemRange<TreeItemPreorderIterator<ITEM>> preorder(ITEM * root) {
+        return TreeItemRange<TreeItemPreorderIterator<ITEM>>(TreeItemPreorderIterator<ITEM>(root));
+    }
+
+    /*!
+     * \details Post-order range of the item and all its descendants.
+     * \param [in] root
+     * \return Range.
+     */
+    template<typename ITEM>
+    TreeItemRange<TreeItemPostorderIterator<ITEM>> postorder(ITEM * root) {
+        return TreeItemRange<TreeItemPostorderIterator<ITEM>>(TreeItemPostorderIterator<ITEM>(root));
+    }
+
+    /*!
+     * \details Level-order (breadth-first) range of the item and all its descendants.
+     * \param [in] root
+     * \return Range.
+     */
+    template<typename ITEM>
+    TreeItemRange<TreeItemLevelorderIterator<ITEM>> levelorder(ITEM * root) {
+        return TreeItemRange<TreeItemLevelorderIterator<ITEM>>(TreeItemLevelorderIterator<ITEM>(root));
+    }
+
+    /*!
+     * \details Level-order (breadth-first) range of the item and all its descendants
+     *          with the level buffers reserved for the specified width.
+     * \param [in] root
+     * \param [in] levelWidth expected items count of the widest level.
+     * \return Range.
+     */
+    template<typename ITEM>
+    TreeItemRange<TreeItemLevelorderIterator<ITEM>> levelorder(ITEM * root, const std::size_t levelWidth) {
+        return TreeItemRange<TreeItemLevelorderIterator<ITEM>>(TreeItemLevelorderIterator<ITEM>(root, levelWidth));
+    }
+
+    /*!
+     * \details Level-order (breadth-first) range of the item and all its descendants without the memory allocation,
+     *          it takes O(items count * height) time, see \link sts::tree::TreeItemLevelorderInPlaceIterator \endlink.
+     * \param [in] root
+     * \return Range.
+     */
+    template<typename ITEM>
+    TreeItemRange<TreeItemLevelorderInPlaceIterator<ITEM>> levelorderInPlace(ITEM * root) {
+        return TreeItemRange<TreeItemLevelorderInPlaceIterator<ITEM>>(TreeItemLevelorderInPlaceIterator<ITEM>(root));
+    }
+
+    /********************************************************************************************************/
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /********************************************************************************************************/
+}
+}
+
+#include "TreeItemTraversal.inl.h"
@@ -0,0 +1,423 @@
+#pragma once
+
+/*
+**  Copyright(C) 2018, StepToSky
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  1.Redistributions of source code must retain the above copyright notice, this
+**    list of conditions and the following disclaimer.
+**  2.Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and / or other materials provided with the distribution.
+**  3.Neither the name of StepToSky nor the names of its contributors
+**    may be used to endorse or promote products derived from this software
+**    without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**  DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**  Contacts: www.steptosky.com
+*/
+
+#include <cassert>
+#include <utility>
+
+namespace sts {
+namespace tree {
+
+    /**************************************************************************************************/
+    /////////////////////////////////////////////* Walker */////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    template<typename ITEM>
+    const std::size_t TreeItemWalker<ITEM>::InlineLevels;
+
+    /*!
+     * \details Constructor init.
+     * \param [in] root the walking root, the walker doesn't go above it.
+     */
+    template<typename ITEM>
+    TreeItemWalker<ITEM>::TreeItemWalker(ITEM * root)
+        : mCurrent(root) {
+        assert(root);
+    }
+
+    /*!
+     * \details Constructor copy, only the used levels are copied.
+     * \param [in] copy
+     */
+    template<typename ITEM>
+    TreeItemWalker<ITEM>::TreeItemWalker(const TreeItemWalker & copy)
+        : mCurrent(copy.mCurrent),
+          mDepth(copy.mDepth),
+          mDeepLevels(copy.mDeepLevels) {
+        std::copy(copy.mLevels, copy.mLevels + std::min(mDepth, InlineLevels + 0), mLevels);
+    }
+
+    /*!
+     * \details Operator copy, only the used levels are copied.
+     * \param [in] copy
+     */
+    template<typename ITEM>
+    TreeItemWalker<ITEM> & TreeItemWalker<ITEM>::operator =(const TreeItemWalker & copy) {
+        if (this != &copy) {
+            mCurrent = copy.mCurrent;
+            mDepth = copy.mDepth;
+            mDeepLevels = copy.mDeepLevels;
+            std::copy(copy.mLevels, copy.mLevels + std::min(mDepth, InlineLevels + 0), mLevels);
+        }
+        return *this;
+    }
+
+    /*!
+     * \details Moves to the current item's first child.
+     * \return False if the item doesn't have children.
+     */
+    template<typename ITEM>
+    bool TreeItemWalker<ITEM>::toFirstChild() {
+        const auto & children = static_cast<const Type *>(mCurrent)->loadedChildren();
+        if (children.empty()) {
+            return false;
+        }
+        if (mDepth < InlineLevels) {
+            mLevels[mDepth] = Level{children.begin(), children.end()};
+        }
+        else {
+            mDeepLevels.push_back(Level{children.begin(), children.end()});
+        }
+        ++mDepth;
+        mCurrent = *children.begin();
+        return true;
+    }
+
+    /*!
+     * \details Moves to the current item's next sibling.
+     * \return False if the item is the walking root or it is the last child.
+     */
+    template<typename ITEM>
+    bool TreeItemWalker<ITEM>::toNextSibling() {
+        if (mDepth == 0) {
+            return false;
+        }
+        Level & current = level();
+        assert(*current.mPosition == mCurrent);
+        if (++current.mPosition == current.mEnd) {
+            return false;
+        }
+        mCurrent = *current.mPosition;
+        return true;
+    }
+
+    /*!
+     * \details Moves to the current item's parent.
+     * \return False if the item is the walking root.
+     */
+    template<typename ITEM>
+    bool TreeItemWalker<ITEM>::toParent() {
+        if (mDepth == 0) {
+            return false;
+        }
+        --mDepth;
+        if (mDepth >= InlineLevels) {
+            mDeepLevels.pop_back();
+        }
+        mCurrent = mCurrent->Base::parent();
+        return true;
+    }
+
+    /*!
+     * \details Checks whether the current item is the last child of its parent.
+     * \pre The current item must not be the walking root.
+     * \return True if the item is the last child otherwise false.
+     */
+    template<typename ITEM>
+    bool TreeItemWalker<ITEM>::isLastChild() const {
+        assert(mDepth != 0);
+        Position next = level().mPosition;
+        return ++next == level().mEnd;
+    }
+
+    /*!
+     * \details Position of the current item in its parent's children container.
+     * \return Reference to the level.
+     */
+    template<typename ITEM>
+    typename TreeItemWalker<ITEM>::Level & TreeItemWalker<ITEM>::level() {
+        assert(mDepth != 0);
+        return mDepth > InlineLevels ? mDeepLevels.back() : mLevels[mDepth - 1];
+    }
+
+    /*!
+     * \details Position of the current item in its parent's children container.
+     * \return Reference to the level.
+     */
+    template<typename ITEM>
+    const typename TreeItemWalker<ITEM>::Level & TreeItemWalker<ITEM>::level() const {
+        assert(mDepth != 0);
+        return mDepth > InlineLevels ? mDeepLevels.back() : mLevels[mDepth - 1];
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Pre-order *////////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Constructor init.
+     * \param [in] root the first item.
+     */
+    template<typename ITEM>
+    TreeItemPreorderIterator<ITEM>::TreeItemPreorderIterator(ITEM * root)
+        : TreeItemWalker<ITEM>(root) {}
+
+    /*!
+     * \details Moves to the next item.
+     * \return Reference to this iterator.
+     */
+    template<typename ITEM>
+    TreeItemPreorderIterator<ITEM> & TreeItemPreorderIterator<ITEM>::operator ++() {
+        assert(this->mCurrent);
+        if (this->toFirstChild()) {
+            return *this;
+        }
+        while (!this->toNextSibling()) {
+            if (!this->toParent()) {
+                this->mCurrent = nullptr;
+                break;
+            }
+        }
+        return *this;
+    }
+
+    /*!
+     * \details Moves to the next item.
+     * \return Iterator to the previous item.
+     */
+    template<typename ITEM>
+    TreeItemPreorderIterator<ITEM> TreeItemPreorderIterator<ITEM>::operator ++(int) {
+        TreeItemPreorderIterator tmp(*this);
+        ++*this;
+        return tmp;
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////////* Post-order *///////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Constructor init.
+     * \param [in] root the last item.
+     */
+    template<typename ITEM>
+    TreeItemPostorderIterator<ITEM>::TreeItemPostorderIterator(ITEM * root)
+        : TreeItemWalker<ITEM>(root) {
+        toFirstLeaf();
+    }
+
+    /*!
+     * \details Moves to the next item.
+     * \return Reference to this iterator.
+     */
+    template<typename ITEM>
+    TreeItemPostorderIterator<ITEM> & TreeItemPostorderIterator<ITEM>::operator ++() {
+        assert(this->mCurrent);
+        if (this->toNextSibling()) {
+            toFirstLeaf();
+        }
+        else if (!this->toParent()) {
+            this->mCurrent = nullptr;
+        }
+        return *this;
+    }
+
+    /*!
+     * \details Moves to the next item.
+     * \return Iterator to the previous item.
+     */
+    template<typename ITEM>
+    TreeItemPostorderIterator<ITEM> TreeItemPostorderIterator<ITEM>::operator ++(int) {
+        TreeItemPostorderIterator tmp(*this);
+        ++*this;
+        return tmp;
+    }
+
+    /*!
+     * \details Moves down by the first children to the leaf.
+     */
+    template<typename ITEM>
+    void TreeItemPostorderIterator<ITEM>::toFirstLeaf() {
+        while (this->toFirstChild()) {}
+    }
+
+    /**************************************************************************************************/
+    //////////////////////////////////////////* Level-order *///////////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Constructor init.
+     * \param [in] root the first item.
+     * \param [in] levelWidth expected items count of the widest level, the buffers are reserved for it.
+     */
+    template<typename ITEM>
+    TreeItemLevelorderIterator<ITEM>::TreeItemLevelorderIterator(ITEM * root, const std::size_t levelWidth)
+        : mCurrent(root) {
+        assert(root);
+        mLevel.reserve(levelWidth);
+        mNextLevel.reserve(levelWidth);
+    }
+
+    /*!
+     * \details Moves to the next item.
+     * \return Reference to this iterator.
+     */
+    template<typename ITEM>
+    TreeItemLevelorderIterator<ITEM> & TreeItemLevelorderIterator<ITEM>::operator ++() {
+        assert(mCurrent);
+        for (auto & it : static_cast<const Type *>(mCurrent)->loadedChildren()) {
+            mNextLevel.push_back(it);
+        }
+        if (mPosition == mLevel.size()) {
+            if (mNextLevel.empty()) {
+                mCurrent = nullptr;
+                return *this;
+            }
+            std::swap(mLevel, mNextLevel);
+            mNextLevel.clear();
+            mPosition = 0;
+        }
+        mCurrent = mLevel[mPosition++];
+        return *this;
+    }
+
+    /*!
+     * \details Moves to the next item.
+     * \return Iterator to the previous item.
+     */
+    template<typename ITEM>
+    TreeItemLevelorderIterator<ITEM> TreeItemLevelorderIterator<ITEM>::operator ++(int) {
+        TreeItemLevelorderIterator tmp(*this);
+        ++*this;
+        return tmp;
+    }
+
+    /**************************************************************************************************/
+    ///////////////////////////////////////* Level-order in place */////////////////////////////////////
+    /**************************************************************************************************/
+
+    /*!
+     * \details Constructor init.
+     * \param [in] root the first item.
+     */
+    template<typename ITEM>
+    TreeItemLevelorderInPlaceIterator<ITEM>::TreeItemLevelorderInPlaceIterator(ITEM * root)
+        : TreeItemWalker<ITEM>(root) {}
+
+    /*!
+     * \details Moves to the next item.
+     * \details The next item of the level is found by going up to the nearest ancestor which has the next child
+     *          and down to the level again. After the last item of the level the walker goes up to the common ancestor
+     *          of the level's items and finds the first item of the next level in the same way.
+     * \return Reference to this iterator.
+     */
+    template<typename ITEM>
+    TreeItemLevelorderInPlaceIterator<ITEM> & TreeItemLevelorderInPlaceIterator<ITEM>::operator ++() {
+        typedef typename TreeItemWalker<ITEM>::Type Type;
+        assert(this->mCurrent);
+        if (!static_cast<const Type *>(this->mCurrent)->loadedChildren().empty()) {
+            mLastParent = this->mCurrent;
+        }
+        if (!isLevelEnd()) {
+            const bool found = toNext(this->mDepth, 0, false);
+            assert(found);
+            (void)found;
+            return *this;
+        }
+        if (mLastParent == nullptr) {
+            this->mCurrent = nullptr;
+            return *this;
+        }
+        const std::size_t depth = this->mDepth + 1;
+        while (this->mDepth > mLevelTop) {
+            this->toParent();
+        }
+        const bool found = toNext(depth, mLevelTop, true);
+        assert(found);
+        (void)found;
+        mLevelTop = depth;
+        mLevelLastParent = mLastParent;
+        mLastParent = nullptr;
+        return *this;
+    }
+
+    /*!
+     * \details Moves to the next item.
+     * \return Iterator to the previous item.
+     */
+    template<typename ITEM>
+    TreeItemLevelorderInPlaceIterator<ITEM> TreeItemLevelorderInPlaceIterator<ITEM>::operator ++(int) {
+        TreeItemLevelorderInPlaceIterator tmp(*this);
+        ++*this;
+        return tmp;
+    }
+
+    /*!
+     * \details Checks whether the current item is the last one of its level.
+     * \return True if the item is the last one otherwise false.
+     */
+    template<typename ITEM>
+    bool TreeItemLevelorderInPlaceIterator<ITEM>::isLevelEnd() const {
+        typedef typename TreeItemWalker<ITEM>::Base Base;
+        if (this->mDepth == 0) {
+            return true;
+        }
+        return this->mCurrent->Base::parent() == mLevelLastParent && this->isLastChild();
+    }
+
+    /*!
+     * \details Moves to the next item of the specified depth in pre-order.
+     * \param [in] depth the items' depth, it must not be less than the current depth.
+     * \param [in] top the walker doesn't go above this depth.
+     * \param [in] descend whether the current item's children are walked.
+     * \return False if there is no such item, the current item is at the top depth then.
+     */
+    template<typename ITEM>
+    bool TreeItemLevelorderInPlaceIterator<ITEM>::toNext(const std::size_t depth, const std::size_t top, bool descend) {
+        for (;;) {
+            if (descend) {
+                if (this->mDepth == depth) {
+                    return true;
+                }
+                if (this->toFirstChild()) {
+                    continue;
+                }
+            }
+            descend = true;
+            for (;;) {
+                if (this->mDepth <= top) {
+                    return false;
+                }
+                if (this->toNextSibling()) {
+                    break;
+                }
+                this->toParent();
+            }
+            if (this->mDepth - 1 < mLevelTop) {
+                mLevelTop = this->mDepth - 1;
+            }
+        }
+    }
+
+    /**************************************************************************************************/
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /**************************************************************************************************/
+}
+}
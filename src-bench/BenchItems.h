@@ -0,0 +1,211 @@
+#pragma once
+
+/*
+**  Copyright(C) 2018, StepToSky
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  1.Redistributions of source code must retain the above copyright notice, this
+**    list of conditions and the following disclaimer.
+**  2.Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and / or other materials provided with the distribution.
+**  3.Neither the name of StepToSky nor the names of its contributors
+**    may be used to endorse or promote products derived from this software
+**    without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**  DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**  Contacts: www.steptosky.com
+*/
+
+#include <cstddef>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "sts/tree/TreeItem.h"
+#include "sts/tree/TreeItemContainerBTree.h"
+#include "sts/tree/TreeItemStatic.h"
+#include "Benchmark.h"
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+template<typename TYPE>
+using BenchContainerSmallVector = sts::tree::TreeItemContainerSmallVector<TYPE, 2>;
+
+template<template<typename> class CONTAINER>
+class BenchItem : public sts::tree::TreeItem<BenchItem<CONTAINER>, CONTAINER<BenchItem<CONTAINER>>> {
+    typedef sts::tree::TreeItem<BenchItem<CONTAINER>, CONTAINER<BenchItem<CONTAINER>>> Base;
+public:
+
+    std::size_t mMark;
+
+    explicit BenchItem(const std::size_t inMark = 0)
+        : mMark(inMark) {}
+
+    BenchItem(const BenchItem & copy)
+        : Base(copy),
+          mMark(copy.mMark) {}
+
+    BenchItem(BenchItem && other)
+        : Base(std::move(other)),
+          mMark(other.mMark) {}
+
+    BenchItem * clone() const override {
+        return new BenchItem(*this);
+    }
+
+private:
+
+    BenchItem & operator =(const BenchItem &) = delete;
+
+};
+
+/*!
+ * \details The same item without the virtual methods.
+ */
+template<template<typename> class CONTAINER>
+class BenchStaticItem : public sts::tree::TreeItemStatic<BenchStaticItem<CONTAINER>, CONTAINER<BenchStaticItem<CONTAINER>>> {
+    typedef sts::tree::TreeItemStatic<BenchStaticItem<CONTAINER>, CONTAINER<BenchStaticItem<CONTAINER>>> Base;
+public:
+
+    std::size_t mMark;
+
+    explicit BenchStaticItem(const std::size_t inMark = 0)
+        : mMark(inMark) {}
+
+    BenchStaticItem(const BenchStaticItem & copy)
+        : Base(copy),
+          mMark(copy.mMark) {}
+
+    BenchStaticItem(BenchStaticItem && other)
+        : Base(std::move(other)),
+          mMark(other.mMark) {}
+
+private:
+
+    BenchStaticItem & operator =(const BenchStaticItem &) = delete;
+
+};
+
+typedef BenchItem<sts::tree::TreeItemContainerVector> BenchVectorItem;
+typedef BenchItem<sts::tree::TreeItemContainerList> BenchListItem;
+typedef BenchItem<sts::tree::TreeItemContainerSlotVector> BenchSlotVectorItem;
+typedef BenchItem<sts::tree::TreeItemContainerSlotList> BenchSlotListItem;
+typedef BenchItem<sts::tree::TreeItemContainerIntrusiveList> BenchIntrusiveListItem;
+typedef BenchItem<sts::tree::TreeItemContainerBTree> BenchBTreeItem;
+typedef BenchItem<BenchContainerSmallVector> BenchSmallVectorItem;
+typedef BenchItem<sts::tree::TreeItemContainerGapVector> BenchGapVectorItem;
+typedef BenchStaticItem<sts::tree::TreeItemContainerVector> BenchStaticVectorItem;
+
+/*!
+ * \details Registers the case template for each container and for the item without the virtual methods.
+ */
+#define BENCH_CONTAINERS(NAME, FUNCTION) \
+    static BenchRegistrar FUNCTION##Vector(NAME, "vector", &FUNCTION<BenchVectorItem>); \
+    static BenchRegistrar FUNCTION##List(NAME, "list", &FUNCTION<BenchListItem>); \
+    static BenchRegistrar FUNCTION##SlotVector(NAME, "slot-vector", &FUNCTION<BenchSlotVectorItem>); \
+    static BenchRegistrar FUNCTION##SlotList(NAME, "slot-list", &FUNCTION<BenchSlotListItem>); \
+    static BenchRegistrar FUNCTION##IntrusiveList(NAME, "intrusive-list", &FUNCTION<BenchIntrusiveListItem>); \
+    static BenchRegistrar FUNCTION##BTree(NAME, "btree", &FUNCTION<BenchBTreeItem>); \
+    static BenchRegistrar FUNCTION##SmallVector(NAME, "small-vector", &FUNCTION<BenchSmallVectorItem>); \
+    static BenchRegistrar FUNCTION##GapVector(NAME, "gap-vector", &FUNCTION<BenchGapVectorItem>); \
+    static BenchRegistrar FUNCTION##StaticVector(NAME, "static-vector", &FUNCTION<BenchStaticVectorItem>)
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+/*!
+ * \details Random numbers with the fixed seed, so each run uses the same hierarchies.
+ */
+class BenchRandom {
+public:
+
+    explicit BenchRandom(const unsigned seed = 42)
+        : mEngine(seed) {}
+
+    std::size_t operator()(const std::size_t count) {
+        return std::uniform_int_distribution<std::size_t>(0, count - 1)(mEngine);
+    }
+
+private:
+
+    std::mt19937 mEngine;
+
+};
+
+enum class BenchInsertion {
+    Append,
+    Prepend,
+    Middle,
+};
+
+/*!
+ * \details Makes the hierarchy of the specified shape.
+ * \details wide - all the items are the root's children.
+ * \details deep - each item is the previous item's child.
+ * \details random - each item is a child of a random previous item.
+ * \param [in] params
+ * \param [out] outItems all the items in the creation order, each item is created after its parent.
+ * \param [in] insertion how the items are added to their parents.
+ * \param [in] create function which creates an item by its number.
+ * \return Root.
+ */
+template<typename ITEM, typename CREATE>
+ITEM * benchMakeTree(const BenchParams & params, std::vector<ITEM*> & outItems,
+                     const BenchInsertion insertion, CREATE create) {
+    outItems.clear();
+    outItems.reserve(params.mItems);
+    outItems.push_back(create(0));
+    BenchRandom random;
+    for (std::size_t i = 1; i < params.mItems; ++i) {
+        ITEM * parent = nullptr;
+        if (params.mShape == "wide") {
+            parent = outItems.front();
+        }
+        else if (params.mShape == "deep") {
+            parent = outItems.back();
+        }
+        else if (params.mShape == "random") {
+            parent = outItems[random(outItems.size())];
+        }
+        else {
+            throw std::invalid_argument("unknown shape: " + params.mShape);
+        }
+        ITEM * item = create(i);
+        switch (insertion) {
+            case BenchInsertion::Append: parent->appendChild(item);
+                break;
+            case BenchInsertion::Prepend: parent->prependChild(item);
+                break;
+            case BenchInsertion::Middle: parent->insertChild(parent->childrenCount() / 2, item);
+                break;
+        }
+        outItems.push_back(item);
+    }
+    return outItems.front();
+}
+
+template<typename ITEM>
+ITEM * benchMakeTree(const BenchParams & params, std::vector<ITEM*> & outItems,
+                     const BenchInsertion insertion = BenchInsertion::Append) {
+    return benchMakeTree(params, outItems, insertion, [](const std::size_t mark) { return new ITEM(mark); });
+}
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
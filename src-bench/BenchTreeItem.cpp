@@ -0,0 +1,448 @@
+/*
+**  Copyright(C) 2018, StepToSky
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  1.Redistributions of source code must retain the above copyright notice, this
+**    list of conditions and the following disclaimer.
+**  2.Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and / or other materials provided with the distribution.
+**  3.Neither the name of StepToSky nor the names of its contributors
+**    may be used to endorse or promote products derived from this software
+**    without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**  DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**  Contacts: www.steptosky.com
+*/
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include "sts/tree/TreeItemTraversal.h"
+#include "BenchItems.h"
+
+using namespace sts::tree;
+
+/**************************************************************************************************/
+////////////////////////////////////////////* Building *////////////////////////////////////////////
+/**************************************************************************************************/
+
+template<typename ITEM, BenchInsertion INSERTION>
+void benchBuild(BenchTimer & timer, const BenchParams & params) {
+    std::vector<ITEM*> items;
+    // the items list isn't a part of the hierarchy's memory.
+    items.reserve(params.mItems);
+    timer.start();
+    ITEM * root = benchMakeTree<ITEM>(params, items, INSERTION);
+    timer.stop();
+    delete root;
+}
+
+template<typename ITEM>
+void benchAppend(BenchTimer & timer, const BenchParams & params) {
+    benchBuild<ITEM, BenchInsertion::Append>(timer, params);
+}
+
+template<typename ITEM>
+void benchPrepend(BenchTimer & timer, const BenchParams & params) {
+    benchBuild<ITEM, BenchInsertion::Prepend>(timer, params);
+}
+
+template<typename ITEM>
+void benchInsert(BenchTimer & timer, const BenchParams & params) {
+    benchBuild<ITEM, BenchInsertion::Middle>(timer, params);
+}
+
+BENCH_CONTAINERS("build-append", benchAppend);
+BENCH_CONTAINERS("build-prepend", benchPrepend);
+BENCH_CONTAINERS("build-insert", benchInsert);
+
+/*
+ * Half of the items are inserted into the middle of the root's children of the hierarchy
+ * built from the other half, one by one or with one insertChildren call.
+ */
+template<typename ITEM, bool BULK>
+void benchInsertChildren(BenchTimer & timer, const BenchParams & params) {
+    BenchParams half = params;
+    half.mItems = params.mItems / 2;
+    std::vector<ITEM*> items;
+    ITEM * root = benchMakeTree<ITEM>(half, items);
+    std::vector<ITEM*> children;
+    for (std::size_t i = half.mItems; i < params.mItems; ++i) {
+        children.push_back(new ITEM(i));
+    }
+    const typename ITEM::Index where = root->childrenCount() / 2;
+    timer.setOperations(children.size());
+    timer.start();
+    if (BULK) {
+        root->insertChildren(where, children.begin(), children.end());
+    }
+    else {
+        for (std::size_t i = 0; i < children.size(); ++i) {
+            root->insertChild(where + i, children[i]);
+        }
+    }
+    timer.stop();
+    delete root;
+}
+
+/*
+ * All items are moved from their parents to a new root, one by one or with one appendChildren call.
+ */
+template<typename ITEM, bool BULK>
+void benchAppendChildren(BenchTimer & timer, const BenchParams & params) {
+    std::vector<ITEM*> items;
+    ITEM * root = benchMakeTree<ITEM>(params, items);
+    ITEM * newRoot = new ITEM(0);
+    timer.setOperations(items.size() - 1);
+    timer.start();
+    if (BULK) {
+        newRoot->appendChildren(items.begin() + 1, items.end());
+    }
+    else {
+        for (auto it = items.begin() + 1; it != items.end(); ++it) {
+            newRoot->appendChild(*it);
+        }
+    }
+    timer.stop();
+    delete root;
+    delete newRoot;
+}
+
+template<typename ITEM>
+void benchInsertEach(BenchTimer & timer, const BenchParams & params) {
+    benchInsertChildren<ITEM, false>(timer, params);
+}
+
+template<typename ITEM>
+void benchInsertBulk(BenchTimer & timer, const BenchParams & params) {
+    benchInsertChildren<ITEM, true>(timer, params);
+}
+
+template<typename ITEM>
+void benchMoveEach(BenchTimer & timer, const BenchParams & params) {
+    benchAppendChildren<ITEM, false>(timer, params);
+}
+
+template<typename ITEM>
+void benchMoveBulk(BenchTimer & timer, const BenchParams & params) {
+    benchAppendChildren<ITEM, true>(timer, params);
+}
+
+BENCH_CONTAINERS("insert-children-each", benchInsertEach);
+BENCH_CONTAINERS("insert-children-bulk", benchInsertBulk);
+BENCH_CONTAINERS("move-children-each", benchMoveEach);
+BENCH_CONTAINERS("move-children-bulk", benchMoveBulk);
+
+/**************************************************************************************************/
+////////////////////////////////////////////* Deleting *////////////////////////////////////////////
+/**************************************************************************************************/
+
+template<typename ITEM>
+void benchDeleteRoot(BenchTimer & timer, const BenchParams & params) {
+    std::vector<ITEM*> items;
+    ITEM * root = benchMakeTree<ITEM>(params, items);
+    timer.start();
+    delete root;
+    timer.stop();
+}
+
+/*
+ * Each item is deleted separately, so it is removed from its parent.
+ * The items are deleted in the reverse creation order, so each item is a leaf while deleting.
+ */
+template<typename ITEM>
+void benchDeleteEach(BenchTimer & timer, const BenchParams & params) {
+    std::vector<ITEM*> items;
+    benchMakeTree<ITEM>(params, items);
+    timer.start();
+    for (auto it = items.rbegin(); it != items.rend(); ++it) {
+        delete *it;
+    }
+    timer.stop();
+}
+
+template<typename ITEM>
+void benchDeleteChildren(BenchTimer & timer, const BenchParams & params) {
+    std::vector<ITEM*> items;
+    ITEM * root = benchMakeTree<ITEM>(params, items);
+    timer.start();
+    root->deleteChildren();
+    timer.stop();
+    delete root;
+}
+
+BENCH_CONTAINERS("delete-root", benchDeleteRoot);
+BENCH_CONTAINERS("delete-each", benchDeleteEach);
+BENCH_CONTAINERS("delete-children", benchDeleteChildren);
+
+/**************************************************************************************************/
+///////////////////////////////////////////* Hierarchy *////////////////////////////////////////////
+/**************************************************************************************************/
+
+/*
+ * Each item in random order is moved to the root and back to its parent.
+ */
+template<typename ITEM>
+void benchReparent(BenchTimer & timer, const BenchParams & params) {
+    std::vector<ITEM*> items;
+    ITEM * root = benchMakeTree<ITEM>(params, items);
+    std::vector<ITEM*> order(items.begin() + 1, items.end());
+    std::shuffle(order.begin(), order.end(), std::mt19937(7));
+    timer.setOperations(order.size() * 2);
+    timer.start();
+    for (auto & it : order) {
+        ITEM * parent = it->parent();
+        if (parent != root) {
+            root->appendChild(it);
+            parent->appendChild(it);
+        }
+        else {
+            it->setParent(nullptr);
+            root->appendChild(it);
+        }
+    }
+    timer.stop();
+    delete root;
+}
+
+template<typename ITEM>
+void benchIndexOf(BenchTimer & timer, const BenchParams & params) {
+    std::vector<ITEM*> items;
+    ITEM * root = benchMakeTree<ITEM>(params, items);
+    std::size_t sum = 0;
+    timer.setOperations(items.size() - 1);
+    timer.start();
+    for (std::size_t i = 1; i < items.size(); ++i) {
+        sum += items[i]->parent()->indexOf(items[i]);
+    }
+    timer.stop();
+    benchUse(sum);
+    delete root;
+}
+
+template<typename ITEM>
+void benchRoot(BenchTimer & timer, const BenchParams & params) {
+    std::vector<ITEM*> items;
+    ITEM * root = benchMakeTree<ITEM>(params, items);
+    std::size_t found = 0;
+    timer.start();
+    for (auto & it : items) {
+        found += it->root() == root ? 1 : 0;
+    }
+    timer.stop();
+    benchUse(found);
+    delete root;
+}
+
+template<typename ITEM>
+void benchIsChildOf(BenchTimer & timer, const BenchParams & params) {
+    std::vector<ITEM*> items;
+    ITEM * root = benchMakeTree<ITEM>(params, items);
+    BenchRandom random(3);
+    std::vector<ITEM*> parents(items.size());
+    for (auto & it : parents) {
+        it = items[random(items.size())];
+    }
+    std::size_t found = 0;
+    timer.start();
+    for (std::size_t i = 0; i < items.size(); ++i) {
+        found += items[i]->isChildOf(parents[i]) ? 1 : 0;
+    }
+    timer.stop();
+    benchUse(found);
+    delete root;
+}
+
+/*
+ * Each item's parent is asked for a child at a random index.
+ */
+template<typename ITEM>
+void benchChildAt(BenchTimer & timer, const BenchParams & params) {
+    std::vector<ITEM*> items;
+    ITEM * root = benchMakeTree<ITEM>(params, items);
+    BenchRandom random(5);
+    std::vector<typename ITEM::Index> indexes(items.size());
+    for (std::size_t i = 1; i < items.size(); ++i) {
+        indexes[i] = random(items[i]->parent()->childrenCount());
+    }
+    std::size_t sum = 0;
+    timer.setOperations(items.size() - 1);
+    timer.start();
+    for (std::size_t i = 1; i < items.size(); ++i) {
+        sum += items[i]->parent()->childAt(indexes[i])->mMark;
+    }
+    timer.stop();
+    benchUse(sum);
+    delete root;
+}
+
+/*
+ * Each item's parent takes a child at a random index and inserts it back at another random index.
+ */
+template<typename ITEM>
+void benchTakeInsert(BenchTimer & timer, const BenchParams & params) {
+    std::vector<ITEM*> items;
+    ITEM * root = benchMakeTree<ITEM>(params, items);
+    std::vector<ITEM*> parents;
+    for (std::size_t i = 1; i < items.size(); ++i) {
+        parents.push_back(items[i]->parent());
+    }
+    BenchRandom random(6);
+    timer.setOperations(parents.size() * 2);
+    timer.start();
+    for (auto & parent : parents) {
+        ITEM * child = parent->takeChildAt(random(parent->childrenCount()));
+        parent->insertChild(random(parent->childrenCount() + 1), child);
+    }
+    timer.stop();
+    delete root;
+}
+
+BENCH_CONTAINERS("reparent", benchReparent);
+BENCH_CONTAINERS("child-at", benchChildAt);
+BENCH_CONTAINERS("take-insert", benchTakeInsert);
+BENCH_CONTAINERS("index-of", benchIndexOf);
+BENCH_CONTAINERS("root", benchRoot);
+BENCH_CONTAINERS("is-child-of", benchIsChildOf);
+
+/**************************************************************************************************/
+////////////////////////////////////////////* Cloning */////////////////////////////////////////////
+/**************************************************************************************************/
+
+template<typename ITEM>
+void benchClone(BenchTimer & timer, const BenchParams & params) {
+    std::vector<ITEM*> items;
+    ITEM * root = benchMakeTree<ITEM>(params, items);
+    timer.start();
+    ITEM * copy = root->clone();
+    timer.stop();
+    delete copy;
+    delete root;
+}
+
+/*
+ * The whole hierarchy is handed to a new root.
+ */
+template<typename ITEM>
+void benchMoveRoot(BenchTimer & timer, const BenchParams & params) {
+    std::vector<ITEM*> items;
+    ITEM * root = benchMakeTree<ITEM>(params, items);
+    timer.start();
+    ITEM * moved = new ITEM(std::move(*root));
+    timer.stop();
+    delete moved;
+    delete root;
+}
+
+BENCH_CONTAINERS("clone", benchClone);
+BENCH_CONTAINERS("move-root", benchMoveRoot);
+
+/**************************************************************************************************/
+///////////////////////////////////////////* Traversal *////////////////////////////////////////////
+/**************************************************************************************************/
+
+template<typename ITEM>
+std::size_t benchSumRecursive(const ITEM * item) {
+    std::size_t sum = item->mMark;
+    for (std::size_t i = 0; i < item->childrenCount(); ++i) {
+        sum += benchSumRecursive(item->childAt(i));
+    }
+    return sum;
+}
+
+template<typename ITEM>
+void benchTraverseRecursive(BenchTimer & timer, const BenchParams & params) {
+    std::vector<ITEM*> items;
+    ITEM * root = benchMakeTree<ITEM>(params, items);
+    timer.start();
+    benchUse(benchSumRecursive<ITEM>(root));
+    timer.stop();
+    delete root;
+}
+
+template<typename ITEM>
+void benchTraverseStack(BenchTimer & timer, const BenchParams & params) {
+    std::vector<ITEM*> items;
+    ITEM * root = benchMakeTree<ITEM>(params, items);
+    timer.start();
+    std::size_t sum = 0;
+    std::vector<const ITEM*> stack(1, root);
+    while (!stack.empty()) {
+        const ITEM * item = stack.back();
+        stack.pop_back();
+        sum += item->mMark;
+        for (auto & it : item->children()) {
+            stack.push_back(it);
+        }
+    }
+    timer.stop();
+    benchUse(sum);
+    delete root;
+}
+
+template<typename ITEM, typename RANGE>
+void benchTraverseRange(BenchTimer & timer, ITEM * root, RANGE (*range)(const ITEM *)) {
+    timer.start();
+    std::size_t sum = 0;
+    for (auto item : range(root)) {
+        sum += item->mMark;
+    }
+    timer.stop();
+    benchUse(sum);
+}
+
+template<typename ITEM>
+void benchPreorder(BenchTimer & timer, const BenchParams & params) {
+    std::vector<ITEM*> items;
+    ITEM * root = benchMakeTree<ITEM>(params, items);
+    benchTraverseRange(timer, root, &preorder<const ITEM>);
+    delete root;
+}
+
+template<typename ITEM>
+void benchPostorder(BenchTimer & timer, const BenchParams & params) {
+    std::vector<ITEM*> items;
+    ITEM * root = benchMakeTree<ITEM>(params, items);
+    benchTraverseRange(timer, root, &postorder<const ITEM>);
+    delete root;
+}
+
+template<typename ITEM>
+void benchLevelorder(BenchTimer & timer, const BenchParams & params) {
+    std::vector<ITEM*> items;
+    ITEM * root = benchMakeTree<ITEM>(params, items);
+    benchTraverseRange(timer, root, &levelorder<const ITEM>);
+    delete root;
+}
+
+template<typename ITEM>
+void benchLevelorderInPlace(BenchTimer & timer, const BenchParams & params) {
+    std::vector<ITEM*> items;
+    ITEM * root = benchMakeTree<ITEM>(params, items);
+    benchTraverseRange(timer, root, &levelorderInPlace<const ITEM>);
+    delete root;
+}
+
+BENCH_CONTAINERS("traverse-recursive", benchTraverseRecursive);
+BENCH_CONTAINERS("traverse-stack", benchTraverseStack);
+BENCH_CONTAINERS("traverse-preorder", benchPreorder);
+BENCH_CONTAINERS("traverse-postorder", benchPostorder);
+BENCH_CONTAINERS("traverse-levelorder", benchLevelorder);
+BENCH_CONTAINERS("traverse-levelorder-inplace", benchLevelorderInPlace);
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
@@ -0,0 +1,856 @@
+/*
+**  Copyright(C) 2018, StepToSky
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  1.Redistributions of source code must retain the above copyright notice, this
+**    list of conditions and the following disclaimer.
+**  2.Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and / or other materials provided with the distribution.
+**  3.Neither the name of StepToSky nor the names of its contributors
+**    may be used to endorse or promote products derived from this software
+**    without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**  DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**  Contacts: www.steptosky.com
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "sts/tree/TreeItemAggregate.h"
+#include "sts/tree/TreeItemAncestorIndex.h"
+#include "sts/tree/TreeItemBinary.h"
+#include "sts/tree/TreeItemBuilder.h"
+#include "sts/tree/TreeItemFrozen.h"
+#include "sts/tree/TreeItemKeyIndex.h"
+#include "sts/tree/TreeItemLazy.h"
+#include "sts/tree/TreeItemParallel.h"
+#include "sts/tree/TreeItemPersistent.h"
+#include "sts/tree/TreeItemPool.h"
+#include "sts/tree/TreeItemRootCache.h"
+#include "BenchItems.h"
+
+using namespace sts::tree;
+
+/**************************************************************************************************/
+//////////////////////////////////////////////* Pool *//////////////////////////////////////////////
+/**************************************************************************************************/
+
+class BenchPoolItem : public TreeItem<BenchPoolItem>, public TreeItemPoolAllocated<BenchPoolItem> {
+public:
+
+    std::size_t mMark;
+
+    explicit BenchPoolItem(const std::size_t inMark = 0)
+        : mMark(inMark) {}
+
+};
+
+/*
+ * Building and deleting with the global operator new.
+ */
+void benchPoolGlobal(BenchTimer & timer, const BenchParams & params) {
+    std::vector<BenchPoolItem*> items;
+    timer.start();
+    BenchPoolItem * root = benchMakeTree<BenchPoolItem>(params, items);
+    delete root;
+    timer.stop();
+}
+
+/*
+ * Building in the pool and releasing the whole tree.
+ */
+void benchPool(BenchTimer & timer, const BenchParams & params) {
+    std::vector<BenchPoolItem*> items;
+    timer.start();
+    {
+        TreeItemPool<BenchPoolItem> pool;
+        pool.reserve(params.mItems);
+        BenchPoolItem * root = benchMakeTree<BenchPoolItem>(params, items, BenchInsertion::Append,
+                                                            [&pool](const std::size_t mark) {
+                                                                return new(pool) BenchPoolItem(mark);
+                                                            });
+        pool.release(root);
+    }
+    timer.stop();
+}
+
+static BenchRegistrar benchPoolGlobalRegistrar("build-delete-global-new", "vector", &benchPoolGlobal);
+static BenchRegistrar benchPoolRegistrar("build-release-pool", "vector", &benchPool);
+
+/**************************************************************************************************/
+////////////////////////////////////////* Ancestor queries *////////////////////////////////////////
+/**************************************************************************************************/
+
+class BenchRootCacheItem : public TreeItemRootCache<BenchRootCacheItem> {
+public:
+
+    std::size_t mMark;
+
+    explicit BenchRootCacheItem(const std::size_t inMark = 0)
+        : mMark(inMark) {}
+
+};
+
+void benchRootCached(BenchTimer & timer, const BenchParams & params) {
+    std::vector<BenchRootCacheItem*> items;
+    BenchRootCacheItem * root = benchMakeTree<BenchRootCacheItem>(params, items);
+    std::size_t found = 0;
+    timer.start();
+    for (auto & it : items) {
+        found += it->root() == root ? 1 : 0;
+    }
+    timer.stop();
+    benchUse(found);
+    delete root;
+}
+
+void benchIsChildOfIndex(BenchTimer & timer, const BenchParams & params) {
+    std::vector<BenchVectorItem*> items;
+    BenchVectorItem * root = benchMakeTree<BenchVectorItem>(params, items);
+    BenchRandom random(3);
+    std::vector<BenchVectorItem*> parents(items.size());
+    for (auto & it : parents) {
+        it = items[random(items.size())];
+    }
+    std::size_t found = 0;
+    timer.start();
+    TreeItemAncestorIndex<BenchVectorItem> index(root);
+    for (std::size_t i = 0; i < items.size(); ++i) {
+        found += index.isChildOf(items[i], parents[i]) ? 1 : 0;
+    }
+    timer.stop();
+    benchUse(found);
+    delete root;
+}
+
+/*
+ * Random pairs of the items, the operations are the pairs.
+ */
+std::vector<std::pair<const BenchVectorItem*, const BenchVectorItem*>> benchRandomPairs(const std::vector<BenchVectorItem*> & items) {
+    BenchRandom random(9);
+    std::vector<std::pair<const BenchVectorItem*, const BenchVectorItem*>> pairs(items.size());
+    for (auto & it : pairs) {
+        it.first = items[random(items.size())];
+        it.second = items[random(items.size())];
+    }
+    return pairs;
+}
+
+/*
+ * Walking up from the both items after the depths are found by walking to the root.
+ */
+void benchCommonAncestorWalk(BenchTimer & timer, const BenchParams & params) {
+    std::vector<BenchVectorItem*> items;
+    BenchVectorItem * root = benchMakeTree<BenchVectorItem>(params, items);
+    const auto pairs = benchRandomPairs(items);
+    const auto depthOf = [](const BenchVectorItem * item) {
+        std::size_t depth = 0;
+        for (; !item->isRoot(); item = item->parent()) {
+            ++depth;
+        }
+        return depth;
+    };
+    std::size_t found = 0;
+    timer.start();
+    for (auto & pair : pairs) {
+        const BenchVectorItem * item1 = pair.first;
+        const BenchVectorItem * item2 = pair.second;
+        std::size_t depth1 = depthOf(item1);
+        std::size_t depth2 = depthOf(item2);
+        for (; depth1 > depth2; --depth1) {
+            item1 = item1->parent();
+        }
+        for (; depth2 > depth1; --depth2) {
+            item2 = item2->parent();
+        }
+        while (item1 != item2) {
+            item1 = item1->parent();
+            item2 = item2->parent();
+        }
+        found += item1->mMark;
+    }
+    timer.stop();
+    benchUse(found);
+    delete root;
+}
+
+/*
+ * The separate queries, the index is built before, it takes about the same time as the is-child-of-index case.
+ */
+void benchCommonAncestorIndex(BenchTimer & timer, const BenchParams & params) {
+    std::vector<BenchVectorItem*> items;
+    BenchVectorItem * root = benchMakeTree<BenchVectorItem>(params, items);
+    const auto pairs = benchRandomPairs(items);
+    std::size_t found = 0;
+    const TreeItemAncestorIndex<BenchVectorItem> index(root);
+    timer.start();
+    for (auto & pair : pairs) {
+        found += index.commonAncestor(pair.first, pair.second)->mMark;
+    }
+    timer.stop();
+    benchUse(found);
+    delete root;
+}
+
+/*
+ * All the pairs in one call.
+ */
+void benchCommonAncestorsIndex(BenchTimer & timer, const BenchParams & params) {
+    std::vector<BenchVectorItem*> items;
+    BenchVectorItem * root = benchMakeTree<BenchVectorItem>(params, items);
+    const auto pairs = benchRandomPairs(items);
+    std::vector<const BenchVectorItem*> ancestors;
+    const TreeItemAncestorIndex<BenchVectorItem> index(root);
+    timer.start();
+    index.commonAncestors(pairs.begin(), pairs.end(), ancestors);
+    timer.stop();
+    benchUse(ancestors.back()->mMark);
+    delete root;
+}
+
+static BenchRegistrar benchRootCachedRegistrar("root-cached", "vector", &benchRootCached);
+static BenchRegistrar benchIsChildOfIndexRegistrar("is-child-of-index", "vector", &benchIsChildOfIndex);
+static BenchRegistrar benchCommonAncestorWalkRegistrar("common-ancestor-walk", "vector", &benchCommonAncestorWalk);
+static BenchRegistrar benchCommonAncestorIndexRegistrar("common-ancestor-index", "vector", &benchCommonAncestorIndex);
+static BenchRegistrar benchCommonAncestorsIndexRegistrar("common-ancestors-index", "vector", &benchCommonAncestorsIndex);
+
+/**************************************************************************************************/
+////////////////////////////////////////////* Parallel *////////////////////////////////////////////
+/**************************************************************************************************/
+
+template<std::size_t THREADS>
+void benchParallelVisit(BenchTimer & timer, const BenchParams & params) {
+    std::vector<BenchVectorItem*> items;
+    BenchVectorItem * root = benchMakeTree<BenchVectorItem>(params, items);
+    std::atomic<std::size_t> sum(0);
+    timer.start();
+    parallelForEach(root, [&sum](const BenchVectorItem * item) {
+        // some work for each item
+        std::size_t value = item->mMark;
+        for (int i = 0; i < 100; ++i) {
+            value = value * 2862933555777941757ull + 3037000493ull;
+        }
+        sum.fetch_add(value & 1, std::memory_order_relaxed);
+    }, THREADS);
+    timer.stop();
+    benchUse(sum);
+    delete root;
+}
+
+static BenchRegistrar benchParallelVisit1Registrar("parallel-visit-1", "vector", &benchParallelVisit<1>);
+static BenchRegistrar benchParallelVisit2Registrar("parallel-visit-2", "vector", &benchParallelVisit<2>);
+static BenchRegistrar benchParallelVisit4Registrar("parallel-visit-4", "vector", &benchParallelVisit<4>);
+static BenchRegistrar benchParallelVisit8Registrar("parallel-visit-8", "vector", &benchParallelVisit<8>);
+static BenchRegistrar benchParallelVisit16Registrar("parallel-visit-16", "vector", &benchParallelVisit<16>);
+static BenchRegistrar benchParallelVisit32Registrar("parallel-visit-32", "vector", &benchParallelVisit<32>);
+
+template<std::size_t THREADS>
+void benchParallelClone(BenchTimer & timer, const BenchParams & params) {
+    std::vector<BenchVectorItem*> items;
+    BenchVectorItem * root = benchMakeTree<BenchVectorItem>(params, items);
+    timer.start();
+    BenchVectorItem * copy = parallelClone(root, THREADS);
+    timer.stop();
+    delete copy;
+    delete root;
+}
+
+static BenchRegistrar benchParallelClone1Registrar("parallel-clone-1", "vector", &benchParallelClone<1>);
+static BenchRegistrar benchParallelClone2Registrar("parallel-clone-2", "vector", &benchParallelClone<2>);
+static BenchRegistrar benchParallelClone4Registrar("parallel-clone-4", "vector", &benchParallelClone<4>);
+static BenchRegistrar benchParallelClone8Registrar("parallel-clone-8", "vector", &benchParallelClone<8>);
+static BenchRegistrar benchParallelClone16Registrar("parallel-clone-16", "vector", &benchParallelClone<16>);
+static BenchRegistrar benchParallelClone32Registrar("parallel-clone-32", "vector", &benchParallelClone<32>);
+
+/**************************************************************************************************/
+/////////////////////////////////////////////* Frozen */////////////////////////////////////////////
+/**************************************************************************************************/
+
+typedef TreeItemFrozen<BenchVectorItem, std::size_t> BenchFrozen;
+
+BenchFrozen benchFreeze(const BenchVectorItem * root) {
+    return freeze(root, [](const BenchVectorItem * item) { return item->mMark; });
+}
+
+void benchFrozenBuild(BenchTimer & timer, const BenchParams & params) {
+    std::vector<BenchVectorItem*> items;
+    BenchVectorItem * root = benchMakeTree<BenchVectorItem>(params, items);
+    timer.start();
+    BenchFrozen frozen = benchFreeze(root);
+    timer.stop();
+    benchUse(frozen.size());
+    delete root;
+}
+
+void benchFrozenTraverse(BenchTimer & timer, const BenchParams & params) {
+    std::vector<BenchVectorItem*> items;
+    BenchVectorItem * root = benchMakeTree<BenchVectorItem>(params, items);
+    const BenchFrozen frozen = benchFreeze(root);
+    delete root;
+    timer.start();
+    std::size_t sum = 0;
+    for (auto & it : frozen.payloads()) {
+        sum += it;
+    }
+    timer.stop();
+    benchUse(sum);
+}
+
+/*
+ * The same queries as the is-child-of case.
+ */
+void benchFrozenIsChildOf(BenchTimer & timer, const BenchParams & params) {
+    std::vector<BenchVectorItem*> items;
+    BenchVectorItem * root = benchMakeTree<BenchVectorItem>(params, items);
+    const BenchFrozen frozen = benchFreeze(root);
+    std::unordered_map<const BenchVectorItem*, BenchFrozen::Index> indexes;
+    for (BenchFrozen::Index i = 0; i < frozen.size(); ++i) {
+        indexes.emplace(frozen.item(i), i);
+    }
+    BenchRandom random(3);
+    std::vector<BenchFrozen::Index> itemIndexes(items.size());
+    std::vector<BenchFrozen::Index> parentIndexes(items.size());
+    for (std::size_t i = 0; i < items.size(); ++i) {
+        itemIndexes[i] = indexes[items[i]];
+        parentIndexes[i] = indexes[items[random(items.size())]];
+    }
+    delete root;
+    std::size_t found = 0;
+    timer.start();
+    for (std::size_t i = 0; i < itemIndexes.size(); ++i) {
+        found += frozen.isChildOf(itemIndexes[i], parentIndexes[i]) ? 1 : 0;
+    }
+    timer.stop();
+    benchUse(found);
+}
+
+/*
+ * Sums the marks of the subtrees of 100 random items from the first created ones (they have bigger subtrees),
+ * the operations are the summed items.
+ */
+void benchSubtreeSumStack(BenchTimer & timer, const BenchParams & params) {
+    std::vector<BenchVectorItem*> items;
+    BenchVectorItem * root = benchMakeTree<BenchVectorItem>(params, items);
+    BenchRandom random(7);
+    std::vector<const BenchVectorItem*> subtrees(100);
+    for (auto & it : subtrees) {
+        it = items[random(items.size() / 100 + 1)];
+    }
+    std::size_t sum = 0;
+    std::size_t count = 0;
+    std::vector<const BenchVectorItem*> stack;
+    timer.start();
+    for (auto & subtree : subtrees) {
+        stack.push_back(subtree);
+        while (!stack.empty()) {
+            const BenchVectorItem * item = stack.back();
+            stack.pop_back();
+            sum += item->mMark;
+            ++count;
+            for (auto & it : item->children()) {
+                stack.push_back(it);
+            }
+        }
+    }
+    timer.stop();
+    timer.setOperations(count);
+    benchUse(sum);
+    delete root;
+}
+
+void benchSubtreeSumFrozen(BenchTimer & timer, const BenchParams & params) {
+    std::vector<BenchVectorItem*> items;
+    BenchVectorItem * root = benchMakeTree<BenchVectorItem>(params, items);
+    const BenchFrozen frozen = benchFreeze(root);
+    std::unordered_map<const BenchVectorItem*, BenchFrozen::Index> indexes;
+    for (BenchFrozen::Index i = 0; i < frozen.size(); ++i) {
+        indexes.emplace(frozen.item(i), i);
+    }
+    BenchRandom random(7);
+    std::vector<BenchFrozen::Index> subtrees(100);
+    for (auto & it : subtrees) {
+        it = indexes[items[random(items.size() / 100 + 1)]];
+    }
+    delete root;
+    std::size_t sum = 0;
+    std::size_t count = 0;
+    const std::vector<std::size_t> & payloads = frozen.payloads();
+    timer.start();
+    for (auto & subtree : subtrees) {
+        const BenchFrozen::Index end = frozen.subtreeEnd(subtree);
+        for (BenchFrozen::Index i = subtree; i < end; ++i) {
+            sum += payloads[i];
+        }
+        count += end - subtree;
+    }
+    timer.stop();
+    timer.setOperations(count);
+    benchUse(sum);
+}
+
+static BenchRegistrar benchFrozenBuildRegistrar("freeze", "frozen", &benchFrozenBuild);
+static BenchRegistrar benchFrozenTraverseRegistrar("traverse-preorder", "frozen", &benchFrozenTraverse);
+static BenchRegistrar benchFrozenIsChildOfRegistrar("is-child-of", "frozen", &benchFrozenIsChildOf);
+static BenchRegistrar benchSubtreeSumStackRegistrar("subtree-sum", "vector", &benchSubtreeSumStack);
+static BenchRegistrar benchSubtreeSumFrozenRegistrar("subtree-sum", "frozen", &benchSubtreeSumFrozen);
+
+/**************************************************************************************************/
+/////////////////////////////////////////////* Binary */////////////////////////////////////////////
+/**************************************************************************************************/
+
+typedef TreeItemBinary<std::size_t> BenchBinary;
+
+/*
+ * The data is in the memory which is aligned as a mapped file.
+ */
+std::vector<std::uint64_t> benchBinaryData(const BenchVectorItem * root, std::size_t & outSize) {
+    std::ostringstream stream(std::ios::binary);
+    BenchBinary::write(stream, root, [](const BenchVectorItem * item) { return item->mMark; });
+    const std::string bytes = stream.str();
+    outSize = bytes.size();
+    std::vector<std::uint64_t> data((bytes.size() + 7) / 8);
+    std::memcpy(data.data(), bytes.data(), bytes.size());
+    return data;
+}
+
+void benchBinaryWrite(BenchTimer & timer, const BenchParams & params) {
+    std::vector<BenchVectorItem*> items;
+    BenchVectorItem * root = benchMakeTree<BenchVectorItem>(params, items);
+    std::ostringstream stream(std::ios::binary);
+    timer.start();
+    BenchBinary::write(stream, root, [](const BenchVectorItem * item) { return item->mMark; });
+    timer.stop();
+    benchUse(stream.tellp());
+    delete root;
+}
+
+/*
+ * Opening and reading of all the payloads, it is what a mapped file costs.
+ */
+void benchBinaryOpenTraverse(BenchTimer & timer, const BenchParams & params) {
+    std::vector<BenchVectorItem*> items;
+    BenchVectorItem * root = benchMakeTree<BenchVectorItem>(params, items);
+    std::size_t size = 0;
+    const std::vector<std::uint64_t> data = benchBinaryData(root, size);
+    delete root;
+    timer.start();
+    const BenchBinary binary(data.data(), size);
+    std::size_t sum = 0;
+    for (BenchBinary::Index i = 0; i < binary.size(); ++i) {
+        sum += binary.payload(i);
+    }
+    timer.stop();
+    benchUse(sum);
+}
+
+/*
+ * Making of the tree items from the data, compare with the build-append case.
+ */
+void benchBinaryMaterialize(BenchTimer & timer, const BenchParams & params) {
+    std::vector<BenchVectorItem*> items;
+    BenchVectorItem * root = benchMakeTree<BenchVectorItem>(params, items);
+    std::size_t size = 0;
+    const std::vector<std::uint64_t> data = benchBinaryData(root, size);
+    delete root;
+    const BenchBinary binary(data.data(), size);
+    timer.start();
+    root = binary.materialize<BenchVectorItem>([](const std::size_t mark) { return new BenchVectorItem(mark); });
+    timer.stop();
+    delete root;
+}
+
+static BenchRegistrar benchBinaryWriteRegistrar("binary-write", "vector", &benchBinaryWrite);
+static BenchRegistrar benchBinaryOpenTraverseRegistrar("binary-open-traverse", "binary", &benchBinaryOpenTraverse);
+static BenchRegistrar benchBinaryMaterializeRegistrar("binary-materialize", "vector", &benchBinaryMaterialize);
+
+/**************************************************************************************************/
+///////////////////////////////////////////* Aggregate *////////////////////////////////////////////
+/**************************************************************************************************/
+
+class BenchAggregateItem : public TreeItemAggregate<BenchAggregateItem, TreeItemAggregateSum<std::size_t>> {
+public:
+
+    explicit BenchAggregateItem(const std::size_t inMark = 0)
+        : TreeItemAggregate<BenchAggregateItem, TreeItemAggregateSum<std::size_t>>(inMark) {}
+
+};
+
+/*
+ * The same subtrees as the subtree-sum case of the vector, the operations are the summed items.
+ */
+void benchSubtreeSumAggregate(BenchTimer & timer, const BenchParams & params) {
+    std::vector<BenchAggregateItem*> items;
+    BenchAggregateItem * root = benchMakeTree<BenchAggregateItem>(params, items);
+    BenchRandom random(7);
+    std::vector<const BenchAggregateItem*> subtrees(100);
+    for (auto & it : subtrees) {
+        it = items[random(items.size() / 100 + 1)];
+    }
+    std::size_t sum = 0;
+    std::size_t count = 0;
+    timer.start();
+    for (auto & subtree : subtrees) {
+        sum += subtree->aggregate();
+        count += subtree->subtreeSize();
+    }
+    timer.stop();
+    timer.setOperations(count);
+    benchUse(sum);
+    delete root;
+}
+
+/*
+ * The adding cost of a layer, compare with the build-append case of the vector.
+ */
+template<typename ITEM>
+void benchBuildItems(BenchTimer & timer, const BenchParams & params) {
+    std::vector<ITEM*> items;
+    items.reserve(params.mItems);
+    timer.start();
+    ITEM * root = benchMakeTree<ITEM>(params, items);
+    timer.stop();
+    delete root;
+}
+
+/*
+ * Changing of the random items' values, each change updates the ancestors.
+ */
+void benchAggregateSetValue(BenchTimer & timer, const BenchParams & params) {
+    std::vector<BenchAggregateItem*> items;
+    BenchAggregateItem * root = benchMakeTree<BenchAggregateItem>(params, items);
+    BenchRandom random(7);
+    timer.setOperations(items.size());
+    timer.start();
+    for (std::size_t i = 0; i < items.size(); ++i) {
+        items[random(items.size())]->setAggregateValue(i);
+    }
+    timer.stop();
+    benchUse(root->aggregate());
+    delete root;
+}
+
+static BenchRegistrar benchSubtreeSumAggregateRegistrar("subtree-sum", "aggregate", &benchSubtreeSumAggregate);
+static BenchRegistrar benchAggregateBuildRegistrar("build-append", "aggregate", &benchBuildItems<BenchAggregateItem>);
+static BenchRegistrar benchAggregateSetValueRegistrar("set-value", "aggregate", &benchAggregateSetValue);
+
+/**************************************************************************************************/
+//////////////////////////////////////////////* Lazy *//////////////////////////////////////////////
+/**************************************************************************************************/
+
+/*
+ * The item of the stored hierarchy, its children are made from the data at the first access.
+ */
+class BenchLazyItem : public TreeItemLazy<BenchLazyItem> {
+public:
+
+    const BenchBinary * mBinary;
+    BenchBinary::Index mIndex;
+
+    BenchLazyItem(const BenchBinary * binary, const BenchBinary::Index index)
+        : mBinary(binary),
+          mIndex(index) {
+        if (!binary->isLeaf(index)) {
+            markUnloaded();
+        }
+    }
+
+protected:
+
+    void loadChildren() override {
+        reserveChildren(mBinary->childrenCount(mIndex));
+        for (auto i = mBinary->firstChild(mIndex); i != BenchBinary::npos; i = mBinary->nextSibling(i)) {
+            appendChild(new BenchLazyItem(mBinary, i));
+        }
+    }
+
+};
+
+/*
+ * A session visits a few random paths from the root to the leaves.
+ */
+template<typename ITEM>
+std::size_t benchVisitPaths(ITEM * root) {
+    BenchRandom random(7);
+    std::size_t visited = 0;
+    for (std::size_t i = 0; i < 100; ++i) {
+        const ITEM * item = root;
+        for (std::size_t count = item->childrenCount(); count != 0; count = item->childrenCount()) {
+            item = item->childAt(random(count));
+            ++visited;
+        }
+    }
+    return visited;
+}
+
+/*
+ * All the items are made from the stored hierarchy before the visiting.
+ */
+void benchVisitPathsEager(BenchTimer & timer, const BenchParams & params) {
+    std::vector<BenchVectorItem*> items;
+    BenchVectorItem * root = benchMakeTree<BenchVectorItem>(params, items);
+    std::size_t size = 0;
+    const std::vector<std::uint64_t> data = benchBinaryData(root, size);
+    delete root;
+    const BenchBinary binary(data.data(), size);
+    timer.start();
+    root = binary.materialize<BenchVectorItem>([](const std::size_t mark) { return new BenchVectorItem(mark); });
+    benchUse(benchVisitPaths(root));
+    timer.stop();
+    delete root;
+}
+
+/*
+ * Only the visited items and their siblings are made.
+ */
+void benchVisitPathsLazy(BenchTimer & timer, const BenchParams & params) {
+    std::vector<BenchVectorItem*> items;
+    BenchVectorItem * root = benchMakeTree<BenchVectorItem>(params, items);
+    std::size_t size = 0;
+    const std::vector<std::uint64_t> data = benchBinaryData(root, size);
+    delete root;
+    const BenchBinary binary(data.data(), size);
+    timer.start();
+    BenchLazyItem * lazyRoot = new BenchLazyItem(&binary, 0);
+    benchUse(benchVisitPaths(lazyRoot));
+    timer.stop();
+    delete lazyRoot;
+}
+
+static BenchRegistrar benchVisitPathsEagerRegistrar("visit-paths", "vector", &benchVisitPathsEager);
+static BenchRegistrar benchVisitPathsLazyRegistrar("visit-paths", "lazy", &benchVisitPathsLazy);
+
+/**************************************************************************************************/
+///////////////////////////////////////////* Snapshots *////////////////////////////////////////////
+/**************************************************************************************************/
+
+typedef TreeItemPersistent<std::size_t> BenchPersistentTree;
+
+/*
+ * Paths of the random items, the snapshots are taken between the changes of those items.
+ */
+std::vector<BenchPersistentTree::Path> benchRandomPaths(const std::vector<BenchVectorItem*> & items, const std::size_t count) {
+    BenchRandom random(5);
+    std::vector<BenchPersistentTree::Path> paths(count);
+    for (auto & path : paths) {
+        const BenchVectorItem * item = items[random(items.size())];
+        while (!item->isRoot()) {
+            path.push_back(item->parent()->indexOf(item));
+            item = item->parent();
+        }
+        std::reverse(path.begin(), path.end());
+    }
+    return paths;
+}
+
+/*
+ * A snapshot is kept before each change, so the bytes/op are the memory of one snapshot.
+ */
+void benchSnapshotPersistent(BenchTimer & timer, const BenchParams & params) {
+    std::vector<BenchVectorItem*> items;
+    BenchVectorItem * root = benchMakeTree<BenchVectorItem>(params, items);
+    const std::vector<BenchPersistentTree::Path> paths = benchRandomPaths(items, std::min<std::size_t>(items.size(), 1000));
+    BenchPersistentTree tree = BenchPersistentTree::build(root, [](const BenchVectorItem * item) { return item->mMark; });
+    delete root;
+    std::vector<BenchPersistentTree> snapshots;
+    snapshots.reserve(paths.size());
+    timer.setOperations(paths.size());
+    timer.start();
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+        snapshots.push_back(tree.snapshot());
+        tree.setValue(paths[i], i);
+    }
+    timer.stop();
+}
+
+/*
+ * The same with the deep copies.
+ */
+void benchSnapshotClone(BenchTimer & timer, const BenchParams & params) {
+    BenchRandom random(5);
+    std::vector<BenchVectorItem*> items;
+    BenchVectorItem * root = benchMakeTree<BenchVectorItem>(params, items);
+    const std::size_t count = 10;
+    std::vector<BenchVectorItem*> snapshots;
+    snapshots.reserve(count);
+    timer.setOperations(count);
+    timer.start();
+    for (std::size_t i = 0; i < count; ++i) {
+        snapshots.push_back(root->clone());
+        items[random(items.size())]->mMark = i;
+    }
+    timer.stop();
+    for (auto & it : snapshots) {
+        delete it;
+    }
+    delete root;
+}
+
+static BenchRegistrar benchSnapshotPersistentRegistrar("snapshot-change", "persistent", &benchSnapshotPersistent);
+static BenchRegistrar benchSnapshotCloneRegistrar("snapshot-change", "vector", &benchSnapshotClone);
+
+/**************************************************************************************************/
+////////////////////////////////////////////* Builder */////////////////////////////////////////////
+/**************************************************************************************************/
+
+/*
+ * Depths of the items in the pre-order, it is the stream of the enter events like a parser makes.
+ */
+std::vector<std::size_t> benchStreamDepths(const BenchParams & params) {
+    std::vector<BenchVectorItem*> items;
+    BenchVectorItem * root = benchMakeTree<BenchVectorItem>(params, items);
+    std::vector<std::size_t> depths;
+    depths.reserve(items.size());
+    std::vector<std::pair<const BenchVectorItem*, std::size_t>> stack(1, std::make_pair(root, std::size_t(0)));
+    while (!stack.empty()) {
+        const auto current = stack.back();
+        stack.pop_back();
+        depths.push_back(current.second);
+        for (std::size_t i = current.first->childrenCount(); i != 0; --i) {
+            stack.emplace_back(current.first->childAt(i - 1), current.second + 1);
+        }
+    }
+    delete root;
+    return depths;
+}
+
+template<typename BUILDER>
+void benchStream(BUILDER & builder, const std::vector<std::size_t> & depths) {
+    for (std::size_t i = 0; i < depths.size(); ++i) {
+        while (builder.depth() > depths[i]) {
+            builder.leave();
+        }
+        builder.enter(new BenchVectorItem(i));
+    }
+    while (builder.depth() != 0) {
+        builder.leave();
+    }
+}
+
+/*
+ * Building of the whole hierarchy from the events, compare with the build-append case.
+ */
+void benchBuilderStream(BenchTimer & timer, const BenchParams & params) {
+    const std::vector<std::size_t> depths = benchStreamDepths(params);
+    TreeItemBuilder<BenchVectorItem> builder;
+    timer.start();
+    benchStream(builder, depths);
+    BenchVectorItem * root = builder.take();
+    timer.stop();
+    delete root;
+}
+
+/*
+ * The root's children are deleted as soon as they are built, so only one branch is in the memory.
+ */
+void benchBuilderStreamEmit(BenchTimer & timer, const BenchParams & params) {
+    const std::vector<std::size_t> depths = benchStreamDepths(params);
+    std::size_t emitted = 0;
+    TreeItemBuilder<BenchVectorItem> builder(1, [&emitted](BenchVectorItem * subtree, BenchVectorItem *) {
+        ++emitted;
+        delete subtree;
+    });
+    timer.start();
+    benchStream(builder, depths);
+    delete builder.take();
+    timer.stop();
+    benchUse(emitted);
+}
+
+static BenchRegistrar benchBuilderStreamRegistrar("build-stream", "vector", &benchBuilderStream);
+static BenchRegistrar benchBuilderStreamEmitRegistrar("build-stream-emit", "vector", &benchBuilderStreamEmit);
+
+/**************************************************************************************************/
+////////////////////////////////////////////* Key index *///////////////////////////////////////////
+/**************************************************************************************************/
+
+class BenchKeyItem;
+
+struct BenchKeyItemMark {
+    typedef std::size_t Key;
+    static Key key(const BenchKeyItem * item);
+};
+
+class BenchKeyItem : public TreeItemKeyIndex<BenchKeyItem, BenchKeyItemMark> {
+public:
+
+    std::size_t mMark;
+
+    explicit BenchKeyItem(const std::size_t inMark = 0)
+        : mMark(inMark) {}
+
+};
+
+BenchKeyItemMark::Key BenchKeyItemMark::key(const BenchKeyItem * item) {
+    return item->mMark;
+}
+
+/*
+ * Each item is found by its mark in its parent's children with the linear search.
+ */
+void benchChildByKeyScan(BenchTimer & timer, const BenchParams & params) {
+    std::vector<BenchVectorItem*> items;
+    BenchVectorItem * root = benchMakeTree<BenchVectorItem>(params, items);
+    std::size_t found = 0;
+    timer.start();
+    for (auto & item : items) {
+        if (item->isRoot()) {
+            continue;
+        }
+        for (auto & it : static_cast<const BenchVectorItem*>(item->parent())->children()) {
+            if (it->mMark == item->mMark) {
+                ++found;
+                break;
+            }
+        }
+    }
+    timer.stop();
+    benchUse(found);
+    delete root;
+}
+
+/*
+ * The same with the key index, the tables are made by the first lookups.
+ */
+void benchChildByKeyIndex(BenchTimer & timer, const BenchParams & params) {
+    std::vector<BenchKeyItem*> items;
+    BenchKeyItem * root = benchMakeTree<BenchKeyItem>(params, items);
+    std::size_t found = 0;
+    timer.start();
+    for (auto & item : items) {
+        if (!item->isRoot() && item->parent()->childByKey(item->mMark) == item) {
+            ++found;
+        }
+    }
+    timer.stop();
+    benchUse(found);
+    delete root;
+}
+
+static BenchRegistrar benchChildByKeyScanRegistrar("child-by-key", "vector", &benchChildByKeyScan);
+static BenchRegistrar benchChildByKeyIndexRegistrar("child-by-key", "key-index", &benchChildByKeyIndex);
+static BenchRegistrar benchKeyIndexBuildRegistrar("build-append", "key-index", &benchBuildItems<BenchKeyItem>);
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
@@ -0,0 +1,338 @@
+/*
+**  Copyright(C) 2018, StepToSky
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  1.Redistributions of source code must retain the above copyright notice, this
+**    list of conditions and the following disclaimer.
+**  2.Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and / or other materials provided with the distribution.
+**  3.Neither the name of StepToSky nor the names of its contributors
+**    may be used to endorse or promote products derived from this software
+**    without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**  DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**  Contacts: www.steptosky.com
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <numeric>
+#include <sstream>
+#include "Benchmark.h"
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+/*
+ * The global operators new and delete count the heap usage for the BenchTimer.
+ * Each block keeps its size in front of the returned memory, so the freed bytes are known too.
+ */
+namespace {
+    std::atomic<std::size_t> gAllocations(0);
+    std::atomic<std::int64_t> gBytes(0);
+
+    const std::size_t gHeaderSize = alignof(std::max_align_t) > sizeof(std::size_t)
+                                        ? alignof(std::max_align_t)
+                                        : sizeof(std::size_t);
+
+    void * benchAllocate(const std::size_t size) noexcept {
+        void * block = std::malloc(gHeaderSize + size);
+        if (!block) {
+            return nullptr;
+        }
+        *static_cast<std::size_t*>(block) = size;
+        gAllocations.fetch_add(1, std::memory_order_relaxed);
+        gBytes.fetch_add(std::int64_t(size), std::memory_order_relaxed);
+        return static_cast<char*>(block) + gHeaderSize;
+    }
+
+    void * benchAllocateOrThrow(const std::size_t size) {
+        void * ptr = benchAllocate(size);
+        if (!ptr) {
+            throw std::bad_alloc();
+        }
+        return ptr;
+    }
+
+    void benchFree(void * ptr) noexcept {
+        if (!ptr) {
+            return;
+        }
+        void * block = static_cast<char*>(ptr) - gHeaderSize;
+        gBytes.fetch_sub(std::int64_t(*static_cast<std::size_t*>(block)), std::memory_order_relaxed);
+        std::free(block);
+    }
+}
+
+void * operator new(const std::size_t size) {
+    return benchAllocateOrThrow(size);
+}
+
+void * operator new[](const std::size_t size) {
+    return benchAllocateOrThrow(size);
+}
+
+void * operator new(const std::size_t size, const std::nothrow_t &) noexcept {
+    return benchAllocate(size);
+}
+
+void * operator new[](const std::size_t size, const std::nothrow_t &) noexcept {
+    return benchAllocate(size);
+}
+
+void operator delete(void * ptr) noexcept {
+    benchFree(ptr);
+}
+
+void operator delete[](void * ptr) noexcept {
+    benchFree(ptr);
+}
+
+void operator delete(void * ptr, const std::nothrow_t &) noexcept {
+    benchFree(ptr);
+}
+
+void operator delete[](void * ptr, const std::nothrow_t &) noexcept {
+    benchFree(ptr);
+}
+
+#if defined(__cpp_sized_deallocation)
+void operator delete(void * ptr, std::size_t) noexcept {
+    benchFree(ptr);
+}
+
+void operator delete[](void * ptr, std::size_t) noexcept {
+    benchFree(ptr);
+}
+#endif
+
+BenchMemory BenchMemory::current() {
+    BenchMemory memory;
+    memory.mAllocations = gAllocations.load(std::memory_order_relaxed);
+    memory.mBytes = gBytes.load(std::memory_order_relaxed);
+    return memory;
+}
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+BenchRegistry & BenchRegistry::instance() {
+    static BenchRegistry registry;
+    return registry;
+}
+
+void BenchRegistry::add(const std::string & name, const std::string & container, const BenchFunction function) {
+    mCases.push_back(BenchCase{name, container, function});
+}
+
+const std::vector<BenchCase> & BenchRegistry::cases() const {
+    return mCases;
+}
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+namespace {
+    volatile std::size_t gSink = 0;
+
+    std::string compilerName() {
+#if defined(_MSC_VER)
+        return "msvc " + std::to_string(_MSC_VER);
+#elif defined(__clang__)
+        return std::string("clang ") + __clang_version__;
+#elif defined(__GNUC__)
+        return std::string("gcc ") + __VERSION__;
+#else
+        return "unknown";
+#endif
+    }
+
+    std::string currentDate() {
+        const std::time_t time = std::time(nullptr);
+        char buffer[32] = {0};
+        std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&time));
+        return buffer;
+    }
+
+    std::string jsonString(const std::string & str) {
+        std::string out("\"");
+        for (auto c : str) {
+            if (c == '"' || c == '\\') {
+                out.push_back('\\');
+            }
+            out.push_back(c);
+        }
+        out.push_back('"');
+        return out;
+    }
+}
+
+void benchUse(const std::size_t value) {
+    gSink = gSink + value;
+}
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+bool benchMatches(const BenchCase & benchCase, const BenchSettings & settings) {
+    if (settings.mFilters.empty()) {
+        return true;
+    }
+    const std::string fullName = benchCase.mName + "/" + benchCase.mContainer;
+    for (auto & it : settings.mFilters) {
+        if (fullName.find(it) != std::string::npos) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<BenchResult> benchRun(const BenchSettings & settings) {
+    std::vector<BenchResult> results;
+    for (auto & benchCase : BenchRegistry::instance().cases()) {
+        if (!benchMatches(benchCase, settings)) {
+            continue;
+        }
+        for (auto & shape : settings.mShapes) {
+            for (auto & items : settings.mItems) {
+                BenchParams params;
+                params.mShape = shape;
+                params.mItems = items;
+
+                std::vector<double> times;
+                std::size_t operations = items;
+                BenchMemory memory;
+                // the first run is warming up.
+                for (std::size_t i = 0; i <= settings.mRepetitions; ++i) {
+                    BenchTimer timer;
+                    timer.setOperations(items);
+                    benchCase.mFunction(timer, params);
+                    if (i != 0) {
+                        times.push_back(timer.elapsedNs());
+                        operations = timer.operations();
+                        memory.mAllocations = timer.allocations();
+                        memory.mBytes = timer.bytes();
+                    }
+                }
+                std::sort(times.begin(), times.end());
+
+                BenchResult result;
+                result.mName = benchCase.mName;
+                result.mContainer = benchCase.mContainer;
+                result.mParams = params;
+                result.mRepetitions = times.size();
+                result.mOperations = operations;
+                result.mMinNs = times.front();
+                result.mMedianNs = times[times.size() / 2];
+                result.mMeanNs = std::accumulate(times.begin(), times.end(), 0.0) / double(times.size());
+                result.mAllocations = memory.mAllocations;
+                result.mBytes = memory.mBytes;
+                results.push_back(result);
+
+                if (!settings.mOutput.empty()) {
+                    std::cerr << result.mName << "/" << result.mContainer << "/" << shape << "/" << items << " done" << std::endl;
+                }
+            }
+        }
+    }
+    return results;
+}
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+void benchWrite(const std::vector<BenchResult> & results, const BenchSettings & settings, std::ostream & stream) {
+    auto perOperation = [](const BenchResult & result, const double value) {
+        return result.mOperations != 0 ? value / double(result.mOperations) : value;
+    };
+    auto nsPerOperation = [&](const BenchResult & result) {
+        return perOperation(result, result.mMedianNs);
+    };
+
+    if (settings.mFormat == "json") {
+        stream << "{\n";
+        stream << "  \"context\": {\n";
+        stream << "    \"date\": " << jsonString(currentDate()) << ",\n";
+        stream << "    \"compiler\": " << jsonString(compilerName()) << ",\n";
+#ifdef NDEBUG
+        stream << "    \"build\": \"release\",\n";
+#else
+        stream << "    \"build\": \"debug\",\n";
+#endif
+        stream << "    \"repetitions\": " << settings.mRepetitions << "\n";
+        stream << "  },\n";
+        stream << "  \"benchmarks\": [";
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            const BenchResult & r = results[i];
+            stream << (i == 0 ? "\n" : ",\n");
+            stream << "    {\"name\": " << jsonString(r.mName)
+                    << ", \"container\": " << jsonString(r.mContainer)
+                    << ", \"shape\": " << jsonString(r.mParams.mShape)
+                    << ", \"items\": " << r.mParams.mItems
+                    << ", \"repetitions\": " << r.mRepetitions
+                    << ", \"operations\": " << r.mOperations
+                    << std::fixed << std::setprecision(1)
+                    << ", \"min_ns\": " << r.mMinNs
+                    << ", \"median_ns\": " << r.mMedianNs
+                    << ", \"mean_ns\": " << r.mMeanNs
+                    << std::setprecision(3)
+                    << ", \"ns_per_op\": " << nsPerOperation(r)
+                    << ", \"allocations\": " << r.mAllocations
+                    << ", \"bytes\": " << r.mBytes
+                    << ", \"allocations_per_op\": " << perOperation(r, double(r.mAllocations))
+                    << ", \"bytes_per_op\": " << perOperation(r, double(r.mBytes)) << "}";
+        }
+        stream << "\n  ]\n}\n";
+    }
+    else if (settings.mFormat == "csv") {
+        stream << "name,container,shape,items,repetitions,operations,min_ns,median_ns,mean_ns,ns_per_op,"
+                "allocations,bytes,allocations_per_op,bytes_per_op\n";
+        for (auto & r : results) {
+            stream << r.mName << "," << r.mContainer << "," << r.mParams.mShape << "," << r.mParams.mItems << ","
+                    << r.mRepetitions << "," << r.mOperations << std::fixed << std::setprecision(1) << ","
+                    << r.mMinNs << "," << r.mMedianNs << "," << r.mMeanNs << std::setprecision(3) << ","
+                    << nsPerOperation(r) << "," << r.mAllocations << "," << r.mBytes << ","
+                    << perOperation(r, double(r.mAllocations)) << "," << perOperation(r, double(r.mBytes)) << "\n";
+        }
+    }
+    else {
+        stream << std::left << std::setw(28) << "name" << std::setw(16) << "container" << std::setw(8) << "shape"
+                << std::right << std::setw(10) << "items" << std::setw(14) << "median ms" << std::setw(14) << "ns/op"
+                << std::setw(12) << "allocs/op" << std::setw(12) << "bytes/op" << "\n";
+        for (auto & r : results) {
+            stream << std::left << std::setw(28) << r.mName << std::setw(16) << r.mContainer << std::setw(8) << r.mParams.mShape
+                    << std::right << std::setw(10) << r.mParams.mItems
+                    << std::fixed << std::setprecision(3) << std::setw(14) << r.mMedianNs / 1e6
+                    << std::setw(14) << nsPerOperation(r)
+                    << std::setw(12) << perOperation(r, double(r.mAllocations))
+                    << std::setprecision(1) << std::setw(12) << perOperation(r, double(r.mBytes)) << "\n";
+        }
+    }
+}
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
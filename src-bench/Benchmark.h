@@ -0,0 +1,211 @@
+#pragma once
+
+/*
+**  Copyright(C) 2018, StepToSky
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  1.Redistributions of source code must retain the above copyright notice, this
+**    list of conditions and the following disclaimer.
+**  2.Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and / or other materials provided with the distribution.
+**  3.Neither the name of StepToSky nor the names of its contributors
+**    may be used to endorse or promote products derived from this software
+**    without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**  DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**  Contacts: www.steptosky.com
+*/
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+/*!
+ * \details Parameters of one benchmark run.
+ */
+struct BenchParams {
+    std::string mShape;     /*!< \details Hierarchy shape: wide, deep or random. */
+    std::size_t mItems = 0; /*!< \details Items count in the hierarchy. */
+};
+
+/*!
+ * \details Heap usage, the benchmark executable replaces the global operators new and delete to count it.
+ */
+struct BenchMemory {
+    std::size_t mAllocations = 0; /*!< \details Allocations count. */
+    std::int64_t mBytes = 0;      /*!< \details Allocated bytes minus the freed ones. */
+
+    static BenchMemory current();
+};
+
+/*!
+ * \details Measures the time and the heap usage of the benchmark's part which must be measured,
+ *          so the preparing and cleaning aren't measured.
+ */
+class BenchTimer {
+public:
+
+    void start() {
+        mStartMemory = BenchMemory::current();
+        mStart = Clock::now();
+    }
+
+    void stop() {
+        mElapsed += Clock::now() - mStart;
+        const BenchMemory memory = BenchMemory::current();
+        mAllocations += memory.mAllocations - mStartMemory.mAllocations;
+        mBytes += memory.mBytes - mStartMemory.mBytes;
+    }
+
+    /*!
+     * \details Sets count of the measured operations, it is the items count by default.
+     */
+    void setOperations(const std::size_t count) {
+        mOperations = count;
+    }
+
+    std::size_t operations() const {
+        return mOperations;
+    }
+
+    double elapsedNs() const {
+        return double(std::chrono::duration_cast<std::chrono::nanoseconds>(mElapsed).count());
+    }
+
+    /*!
+     * \return Allocations count while the measured parts.
+     */
+    std::size_t allocations() const {
+        return mAllocations;
+    }
+
+    /*!
+     * \return Bytes which were allocated and not freed while the measured parts, it is negative if more is freed.
+     */
+    std::int64_t bytes() const {
+        return mBytes;
+    }
+
+private:
+
+    typedef std::chrono::steady_clock Clock;
+
+    Clock::time_point mStart;
+    Clock::duration mElapsed = Clock::duration::zero();
+    std::size_t mOperations = 0;
+    BenchMemory mStartMemory;
+    std::size_t mAllocations = 0;
+    std::int64_t mBytes = 0;
+
+};
+
+typedef void (*BenchFunction)(BenchTimer & timer, const BenchParams & params);
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+/*!
+ * \details Benchmark case.
+ */
+struct BenchCase {
+    std::string mName;
+    std::string mContainer;
+    BenchFunction mFunction;
+};
+
+/*!
+ * \details Result of a benchmark case for one parameters set.
+ */
+struct BenchResult {
+    std::string mName;
+    std::string mContainer;
+    BenchParams mParams;
+    std::size_t mRepetitions = 0;
+    std::size_t mOperations = 0;
+    double mMinNs = 0.0;
+    double mMedianNs = 0.0;
+    double mMeanNs = 0.0;
+    std::size_t mAllocations = 0; /*!< \details Allocations count of the last run. */
+    std::int64_t mBytes = 0;      /*!< \details Not freed bytes of the last run. */
+};
+
+/*!
+ * \details Runner settings, see the main.cpp for the command line.
+ */
+struct BenchSettings {
+    std::vector<std::string> mFilters;
+    std::vector<std::string> mShapes = {"wide", "deep", "random"};
+    std::vector<std::size_t> mItems = {10000};
+    std::size_t mRepetitions = 5;
+    std::string mFormat = "text";
+    std::string mOutput;
+    bool mList = false;
+};
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+/*!
+ * \details Registered benchmark cases.
+ */
+class BenchRegistry {
+public:
+
+    static BenchRegistry & instance();
+
+    void add(const std::string & name, const std::string & container, BenchFunction function);
+    const std::vector<BenchCase> & cases() const;
+
+private:
+
+    std::vector<BenchCase> mCases;
+
+};
+
+/*!
+ * \details Registers a benchmark case while static initialization.
+ */
+struct BenchRegistrar {
+    BenchRegistrar(const std::string & name, const std::string & container, const BenchFunction function) {
+        BenchRegistry::instance().add(name, container, function);
+    }
+};
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+bool benchMatches(const BenchCase & benchCase, const BenchSettings & settings);
+std::vector<BenchResult> benchRun(const BenchSettings & settings);
+void benchWrite(const std::vector<BenchResult> & results, const BenchSettings & settings, std::ostream & stream);
+
+/*!
+ * \details Prevents the compiler from removing the calculation whose result isn't used.
+ */
+void benchUse(std::size_t value);
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
@@ -0,0 +1,155 @@
+/*
+**  Copyright(C) 2018, StepToSky
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  1.Redistributions of source code must retain the above copyright notice, this
+**    list of conditions and the following disclaimer.
+**  2.Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and / or other materials provided with the distribution.
+**  3.Neither the name of StepToSky nor the names of its contributors
+**    may be used to endorse or promote products derived from this software
+**    without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**  DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**  Contacts: www.steptosky.com
+*/
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include "Benchmark.h"
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+namespace {
+    const char * const gHelp =
+            "Usage: bench-sts-tree [options]\n"
+            "  --filter=a,b         runs the cases whose 'name/container' contains one of the strings.\n"
+            "  --shapes=a,b         hierarchy shapes: wide, deep, random (default all).\n"
+            "  --items=n,m          items counts (default 10000).\n"
+            "  --repetitions=n      measured runs of each case (default 5).\n"
+            "  --format=f           text, json or csv (default text).\n"
+            "  --output=path        writes the results to the file instead of stdout.\n"
+            "  --quick              small hierarchies and one run, it is for checking that the cases work.\n"
+            "  --list               prints the cases.\n";
+
+    std::vector<std::string> split(const std::string & str) {
+        std::vector<std::string> out;
+        std::istringstream stream(str);
+        std::string item;
+        while (std::getline(stream, item, ',')) {
+            if (!item.empty()) {
+                out.push_back(item);
+            }
+        }
+        return out;
+    }
+
+    bool option(const std::string & arg, const std::string & name, std::string & outValue) {
+        const std::string prefix = "--" + name + "=";
+        if (arg.compare(0, prefix.size(), prefix) != 0) {
+            return false;
+        }
+        outValue = arg.substr(prefix.size());
+        return true;
+    }
+}
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+int main(int argc, char ** argv) {
+    BenchSettings settings;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg(argv[i]);
+        std::string value;
+        if (arg == "--help" || arg == "-h") {
+            std::cout << gHelp;
+            return EXIT_SUCCESS;
+        }
+        if (arg == "--list") {
+            settings.mList = true;
+        }
+        else if (arg == "--quick") {
+            settings.mItems = {200};
+            settings.mRepetitions = 1;
+        }
+        else if (option(arg, "filter", value)) {
+            settings.mFilters = split(value);
+        }
+        else if (option(arg, "shapes", value)) {
+            settings.mShapes = split(value);
+        }
+        else if (option(arg, "items", value)) {
+            settings.mItems.clear();
+            for (auto & it : split(value)) {
+                settings.mItems.push_back(std::size_t(std::stoull(it)));
+            }
+        }
+        else if (option(arg, "repetitions", value)) {
+            settings.mRepetitions = std::size_t(std::stoull(value));
+        }
+        else if (option(arg, "format", value)) {
+            settings.mFormat = value;
+        }
+        else if (option(arg, "output", value)) {
+            settings.mOutput = value;
+        }
+        else {
+            std::cerr << "Unknown argument: " << arg << "\n" << gHelp;
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (settings.mFormat != "text" && settings.mFormat != "json" && settings.mFormat != "csv") {
+        std::cerr << "Unknown format: " << settings.mFormat << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (settings.mShapes.empty() || settings.mItems.empty() || settings.mRepetitions == 0) {
+        std::cerr << "Shapes, items and repetitions must not be empty" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (settings.mList) {
+        for (auto & it : BenchRegistry::instance().cases()) {
+            if (benchMatches(it, settings)) {
+                std::cout << it.mName << "/" << it.mContainer << "\n";
+            }
+        }
+        return EXIT_SUCCESS;
+    }
+
+    const std::vector<BenchResult> results = benchRun(settings);
+    if (settings.mOutput.empty()) {
+        benchWrite(results, settings, std::cout);
+        return EXIT_SUCCESS;
+    }
+    std::ofstream file(settings.mOutput);
+    if (!file) {
+        std::cerr << "Can't open the file: " << settings.mOutput << std::endl;
+        return EXIT_FAILURE;
+    }
+    benchWrite(results, settings, file);
+    return file ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
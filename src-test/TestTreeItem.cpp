@@ -27,15 +27,12 @@
 **  Contacts: www.steptosky.com
 */
 
+#include <stdexcept>
+#include <utility>
+#include <vector>
 #include "gtest/gtest.h"
 #include "sts/tree/TreeItem.h"
-
-//#define PERFORMANCE_TEST
-#ifdef _DEBUG
-#define TEST_COUNT 2000
-#else
-#define TEST_COUNT 50000
-#endif // _DEBUG
+#include "sts/tree/TreeItemRootCache.h"
 
 using namespace sts::tree;
 
@@ -56,6 +53,12 @@ public:
         return *this;
     }
 
+    TestTreeItem & operator =(TestTreeItem && input) {
+        Base::operator=(std::move(input));
+        mMark = input.mMark;
+        return *this;
+    }
+
     TestTreeItem * clone() const override {
         return new TestTreeItem(*this);
     }
@@ -77,6 +80,12 @@ public:
         ++instanceCreated;
     }
 
+    TestTreeItem(TestTreeItem && inTreeItem)
+        : Base(std::move(inTreeItem)),
+          mMark(inTreeItem.mMark) {
+        ++instanceCreated;
+    }
+
     ~TestTreeItem() {
         --instanceCreated;
     }
@@ -85,109 +94,6 @@ public:
 
 int TestTreeItem::instanceCreated = 0;
 
-/**************************************************************************************************/
-////////////////////////////////////////////////////////////////////////////////////////////////////
-/**************************************************************************************************/
-#ifdef PERFORMANCE_TEST
-
-TEST(TestTreeItem, prependPerformance){
-//---------------------------------
-    TestTreeItem *treeRoot = new TestTreeItem();
-    for (size_t i = 0; i < TEST_COUNT; ++i)
-        treeRoot->prependChild(new TestTreeItem());
-//---------------------------------
-    ASSERT_EQ(TEST_COUNT + 1, TestTreeItem::instanceCreated);
-    delete treeRoot;
-    ASSERT_EQ(0, TestTreeItem::instanceCreated);
-}
-
-TEST(TestTreeItem, appendPerformance){
-//---------------------------------
-    TestTreeItem *treeRoot = new TestTreeItem();
-    for (size_t i = 0; i < TEST_COUNT; ++i)
-        treeRoot->appendChild(new TestTreeItem());
-//---------------------------------
-    ASSERT_EQ(TEST_COUNT + 1, TestTreeItem::instanceCreated);
-    delete treeRoot;
-    ASSERT_EQ(0, TestTreeItem::instanceCreated);
-}
-
-TEST(TestTreeItem, insertPerformance){
-    TestTreeItem *treeRoot = new TestTreeItem();
-    for (size_t i = 0; i < TEST_COUNT / 2; ++i)
-        treeRoot->appendChild(new TestTreeItem());
-//---------------------------------
-    for (size_t i = 0; i < TEST_COUNT; ++i)
-        treeRoot->insertChild(TEST_COUNT / 2, new TestTreeItem());
-//---------------------------------
-    ASSERT_EQ(TEST_COUNT + 1 + (TEST_COUNT / 2), TestTreeItem::instanceCreated);
-    delete treeRoot;
-    ASSERT_EQ(0, TestTreeItem::instanceCreated);
-}
-
-TEST(TestTreeItem, deleteRootPerformance){
-//---------------------------------
-    TestTreeItem *treeRoot = new TestTreeItem();
-    for (size_t i = 0; i < TEST_COUNT; ++i)
-        treeRoot->appendChild(new TestTreeItem());
-//---------------------------------
-    ASSERT_EQ(TEST_COUNT + 1, TestTreeItem::instanceCreated);
-    delete treeRoot;
-    ASSERT_EQ(0, TestTreeItem::instanceCreated);
-}
-
-
-TEST(TestTreeItem, deleteChildrenByPerformance){
-//---------------------------------
-    TestTreeItem *treeRoot = new TestTreeItem();
-    for (size_t i = 0; i < TEST_COUNT; ++i)
-        treeRoot->appendChild(new TestTreeItem());
-//---------------------------------
-    ASSERT_EQ(TEST_COUNT + 1, TestTreeItem::instanceCreated);
-    const TestTreeItem::Children &children = treeRoot->children();
-    for (size_t i = 0; i < children.size(); ++i){
-        delete treeRoot->childAt(i);
-        --i;
-    }
-    ASSERT_EQ(1, TestTreeItem::instanceCreated);
-    delete treeRoot;
-    ASSERT_EQ(0, TestTreeItem::instanceCreated);
-}
-
-TEST(TestTreeItem, deleteAllChildrenPerformance){
-//---------------------------------
-    TestTreeItem *treeRoot = new TestTreeItem();
-    for (size_t i = 0; i < TEST_COUNT; ++i)
-        treeRoot->appendChild(new TestTreeItem());
-//---------------------------------
-    ASSERT_EQ(TEST_COUNT + 1, TestTreeItem::instanceCreated);
-    treeRoot->deleteChildren();
-    ASSERT_EQ(1, TestTreeItem::instanceCreated);
-    delete treeRoot;
-    ASSERT_EQ(0, TestTreeItem::instanceCreated);
-}
-
-TEST(TestTreeItem, iteratePerformance){
-//---------------------------------
-    TestTreeItem *treeRoot = new TestTreeItem();
-    for (size_t i = 0; i < TEST_COUNT; ++i)
-        treeRoot->appendChild(new TestTreeItem());
-//---------------------------------
-    int i = 0;
-//---------------------------------
-    for (auto &item : treeRoot->children()){
-        if (item == nullptr)
-            continue;
-        item->mMark = i;
-        ++i;
-    }
-//---------------------------------
-    ASSERT_EQ(TEST_COUNT + 1, TestTreeItem::instanceCreated);
-    delete treeRoot;
-    ASSERT_EQ(0, TestTreeItem::instanceCreated);
-}
-
-#endif // PERFORMANCE_TEST
 /**************************************************************************************************/
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 /**************************************************************************************************/
@@ -264,6 +170,47 @@ TEST(TestTreeItem, insert) {
     ASSERT_EQ(0, TestTreeItem::instanceCreated);
 }
 
+TEST(TestTreeItem, insertChildren) {
+    TestTreeItem * treeRoot0 = new TestTreeItem();
+    TestTreeItem * treeRoot1 = new TestTreeItem();
+    TestTreeItem * tree0 = treeRoot0->appendChild(new TestTreeItem);
+    TestTreeItem * tree1 = treeRoot0->appendChild(new TestTreeItem);
+    TestTreeItem * tree2 = treeRoot1->appendChild(new TestTreeItem);
+    TestTreeItem * tree3 = treeRoot1->appendChild(new TestTreeItem);
+    TestTreeItem * tree4 = treeRoot1->appendChild(new TestTreeItem);
+    TestTreeItem * tree5 = new TestTreeItem;
+    //---------------------------------
+    std::vector<TestTreeItem*> items({tree4, tree5, tree2});
+    treeRoot0->reserveChildren(5);
+    treeRoot0->insertChildren(1, items.begin(), items.end());
+    ASSERT_EQ(5, treeRoot0->childrenCount());
+    ASSERT_TRUE(treeRoot0->childAt(0) == tree0);
+    ASSERT_TRUE(treeRoot0->childAt(1) == tree4);
+    ASSERT_TRUE(treeRoot0->childAt(2) == tree5);
+    ASSERT_TRUE(treeRoot0->childAt(3) == tree2);
+    ASSERT_TRUE(treeRoot0->childAt(4) == tree1);
+    ASSERT_TRUE(tree2->parent() == treeRoot0);
+    ASSERT_TRUE(tree4->parent() == treeRoot0);
+    ASSERT_TRUE(tree5->parent() == treeRoot0);
+    ASSERT_EQ(1, treeRoot1->childrenCount());
+    ASSERT_TRUE(treeRoot1->childAt(0) == tree3);
+    //---------------------------------
+    items = {tree0, tree1, tree3};
+    tree5->appendChildren(items.begin(), items.end());
+    ASSERT_EQ(3, treeRoot0->childrenCount());
+    ASSERT_EQ(0, treeRoot1->childrenCount());
+    ASSERT_EQ(3, tree5->childrenCount());
+    ASSERT_TRUE(tree5->childAt(0) == tree0);
+    ASSERT_TRUE(tree5->childAt(1) == tree1);
+    ASSERT_TRUE(tree5->childAt(2) == tree3);
+    ASSERT_TRUE(tree3->parent() == tree5);
+    ASSERT_TRUE(tree3->root() == treeRoot0);
+    ASSERT_EQ(8, TestTreeItem::instanceCreated);
+    delete treeRoot0;
+    delete treeRoot1;
+    ASSERT_EQ(0, TestTreeItem::instanceCreated);
+}
+
 TEST(TestTreeItem, taking) {
     TestTreeItem * treeRoot = new TestTreeItem();
     TestTreeItem * tree0 = treeRoot->appendChild(new TestTreeItem);
@@ -349,6 +296,56 @@ TEST(TestTreeItem, deleteChildren) {
     ASSERT_EQ(0, TestTreeItem::instanceCreated);
 }
 
+TEST(TestTreeItem, deleteDeep) {
+    // the depth is enough for the stack overflow if the children are deleted recursively.
+    const int depth = 500000;
+    TestTreeItem * treeRoot = new TestTreeItem();
+    TestTreeItem * last = treeRoot;
+    for (int i = 0; i < depth; ++i) {
+        last = last->appendChild(new TestTreeItem);
+    }
+    ASSERT_EQ(depth + 1, TestTreeItem::instanceCreated);
+    treeRoot->childAt(0)->appendChild(new TestTreeItem);
+    treeRoot->deleteChildren();
+    ASSERT_EQ(1, TestTreeItem::instanceCreated);
+    //---------------------------------
+    last = treeRoot;
+    for (int i = 0; i < depth; ++i) {
+        last = last->appendChild(new TestTreeItem);
+    }
+    delete treeRoot;
+    ASSERT_EQ(0, TestTreeItem::instanceCreated);
+}
+
+class TestTreeItemDeleting : public TestTreeItem {
+public:
+
+    static std::vector<int> deleted;
+
+    TestTreeItemDeleting(int inMark)
+        : TestTreeItem(inMark) {}
+
+    ~TestTreeItemDeleting() {
+        // the children are still available here.
+        deleted.push_back(mMark * 10 + int(childrenCount()));
+    }
+
+};
+
+std::vector<int> TestTreeItemDeleting::deleted;
+
+TEST(TestTreeItem, deletingOrder) {
+    TestTreeItem * treeRoot = new TestTreeItemDeleting(0);
+    TestTreeItem * tree1 = treeRoot->appendChild(new TestTreeItemDeleting(1));
+    tree1->appendChild(new TestTreeItemDeleting(2));
+    tree1->appendChild(new TestTreeItemDeleting(3))->appendChild(new TestTreeItemDeleting(4));
+    treeRoot->appendChild(new TestTreeItemDeleting(5));
+    ASSERT_EQ(6, TestTreeItem::instanceCreated);
+    delete treeRoot;
+    ASSERT_EQ(0, TestTreeItem::instanceCreated);
+    ASSERT_EQ(std::vector<int>({2, 12, 20, 31, 40, 50}), TestTreeItemDeleting::deleted);
+}
+
 TEST(TestTreeItem, deleteChildByChild) {
     TestTreeItem * treeRoot = new TestTreeItem();
     treeRoot->appendChild(new TestTreeItem);
@@ -402,6 +399,260 @@ TEST(TestTreeItem, getRoot) {
     ASSERT_EQ(0, TestTreeItem::instanceCreated);
 }
 
+class TestTreeItemRootCache : public TreeItemRootCache<TestTreeItemRootCache> {
+public:
+
+    static int instanceCreated;
+
+    TestTreeItemRootCache() {
+        ++instanceCreated;
+    }
+
+    explicit TestTreeItemRootCache(TestTreeItemRootCache * inTreeItem)
+        : TreeItemRootCache<TestTreeItemRootCache>(inTreeItem) {
+        ++instanceCreated;
+    }
+
+    TestTreeItemRootCache(TestTreeItemRootCache && other)
+        : TreeItemRootCache<TestTreeItemRootCache>(std::move(other)) {
+        ++instanceCreated;
+    }
+
+    TestTreeItemRootCache & operator =(TestTreeItemRootCache && other) {
+        TreeItemRootCache<TestTreeItemRootCache>::operator=(std::move(other));
+        return *this;
+    }
+
+    ~TestTreeItemRootCache() {
+        --instanceCreated;
+    }
+
+};
+
+int TestTreeItemRootCache::instanceCreated = 0;
+
+TEST(TestTreeItem, rootCache_setParent) {
+    TestTreeItemRootCache * treeRoot0 = new TestTreeItemRootCache();
+    TestTreeItemRootCache * tree1 = new TestTreeItemRootCache(treeRoot0);
+    TestTreeItemRootCache * tree2 = new TestTreeItemRootCache(tree1);
+    TestTreeItemRootCache * tree3 = new TestTreeItemRootCache(tree2);
+    TestTreeItemRootCache * treeRoot1 = new TestTreeItemRootCache();
+    ASSERT_TRUE(tree3->root() == treeRoot0);
+    ASSERT_TRUE(tree2->root() == treeRoot0);
+    ASSERT_TRUE(treeRoot0->root() == treeRoot0);
+    ASSERT_TRUE(treeRoot1->root() == treeRoot1);
+
+    tree2->setParent(treeRoot1);
+    ASSERT_TRUE(tree3->root() == treeRoot1);
+    ASSERT_TRUE(tree2->root() == treeRoot1);
+    ASSERT_TRUE(tree1->root() == treeRoot0);
+
+    tree2->setParent(nullptr);
+    ASSERT_TRUE(tree3->root() == tree2);
+    ASSERT_TRUE(tree2->root() == tree2);
+    ASSERT_TRUE(treeRoot1->root() == treeRoot1);
+
+    treeRoot1->setParent(tree3);
+    ASSERT_TRUE(treeRoot1->root() == tree2);
+    ASSERT_TRUE(static_cast<const TestTreeItemRootCache *>(treeRoot1)->root() == tree2);
+
+    delete treeRoot0;
+    delete tree2;
+    ASSERT_EQ(0, TestTreeItemRootCache::instanceCreated);
+}
+
+TEST(TestTreeItem, rootCache_takeChildAt) {
+    TestTreeItemRootCache * treeRoot = new TestTreeItemRootCache();
+    TestTreeItemRootCache * tree1 = new TestTreeItemRootCache(treeRoot);
+    TestTreeItemRootCache * tree2 = new TestTreeItemRootCache(tree1);
+    TestTreeItemRootCache * tree3 = new TestTreeItemRootCache(tree2);
+    ASSERT_TRUE(tree3->root() == treeRoot);
+
+    ASSERT_TRUE(tree1->takeChildAt(0) == tree2);
+    ASSERT_TRUE(tree3->root() == tree2);
+    ASSERT_TRUE(tree1->root() == treeRoot);
+
+    ASSERT_TRUE(treeRoot->takeChildAt(0) == tree1);
+    ASSERT_TRUE(tree1->root() == tree1);
+    ASSERT_TRUE(tree3->root() == tree2);
+
+    delete treeRoot;
+    delete tree1;
+    delete tree2;
+    ASSERT_EQ(0, TestTreeItemRootCache::instanceCreated);
+}
+
+TEST(TestTreeItem, rootCache_insertChild) {
+    TestTreeItemRootCache * treeRoot = new TestTreeItemRootCache();
+    TestTreeItemRootCache * tree1 = new TestTreeItemRootCache(treeRoot);
+    TestTreeItemRootCache * tree2 = new TestTreeItemRootCache();
+    TestTreeItemRootCache * tree3 = new TestTreeItemRootCache(tree2);
+    ASSERT_TRUE(tree3->root() == tree2);
+    ASSERT_TRUE(tree1->root() == treeRoot);
+
+    treeRoot->insertChild(0, tree2);
+    ASSERT_TRUE(tree3->root() == treeRoot);
+    ASSERT_TRUE(tree2->root() == treeRoot);
+
+    tree1->insertChild(0, tree3);
+    ASSERT_TRUE(tree3->root() == treeRoot);
+    ASSERT_TRUE(tree3->parent() == tree1);
+
+    ASSERT_TRUE(treeRoot->takeChildAt(0) == tree2);
+    ASSERT_TRUE(tree3->root() == treeRoot);
+    tree2->insertChild(0, treeRoot->takeChildAt(0));
+    ASSERT_TRUE(tree1->root() == tree2);
+    ASSERT_TRUE(tree3->root() == tree2);
+    ASSERT_TRUE(treeRoot->root() == treeRoot);
+
+    delete treeRoot;
+    delete tree2;
+    ASSERT_EQ(0, TestTreeItemRootCache::instanceCreated);
+}
+
+TEST(TestTreeItem, rootCache_deleteChild) {
+    TestTreeItemRootCache * treeRoot = new TestTreeItemRootCache();
+    TestTreeItemRootCache * tree1 = new TestTreeItemRootCache(treeRoot);
+    TestTreeItemRootCache * tree2 = new TestTreeItemRootCache(tree1);
+    TestTreeItemRootCache * tree3 = new TestTreeItemRootCache(tree2);
+    ASSERT_TRUE(tree3->root() == treeRoot);
+
+    tree3->setParent(treeRoot);
+    treeRoot->deleteChild(tree1);
+    ASSERT_EQ(2, TestTreeItemRootCache::instanceCreated);
+    ASSERT_TRUE(tree3->root() == treeRoot);
+
+    treeRoot->appendChild(new TestTreeItemRootCache)->appendChild(new TestTreeItemRootCache);
+    ASSERT_TRUE(tree3->root() == treeRoot);
+    treeRoot->deleteChildren();
+    ASSERT_TRUE(treeRoot->root() == treeRoot);
+
+    delete treeRoot;
+    ASSERT_EQ(0, TestTreeItemRootCache::instanceCreated);
+}
+
+TEST(TestTreeItem, rootCache_move) {
+    TestTreeItemRootCache * treeRoot0 = new TestTreeItemRootCache();
+    TestTreeItemRootCache * tree1 = new TestTreeItemRootCache(treeRoot0);
+    TestTreeItemRootCache * tree2 = new TestTreeItemRootCache(tree1);
+    TestTreeItemRootCache * treeRoot1 = new TestTreeItemRootCache();
+    TestTreeItemRootCache * tree3 = new TestTreeItemRootCache(treeRoot1);
+    ASSERT_TRUE(tree2->root() == treeRoot0);
+    ASSERT_TRUE(tree3->root() == treeRoot1);
+
+    TestTreeItemRootCache * moved = new TestTreeItemRootCache(std::move(*tree1));
+    ASSERT_TRUE(tree2->root() == moved);
+    ASSERT_TRUE(tree1->root() == treeRoot0);
+
+    *treeRoot1 = std::move(*moved);
+    ASSERT_TRUE(tree2->root() == treeRoot1);
+    ASSERT_TRUE(moved->root() == moved);
+    ASSERT_EQ(5, TestTreeItemRootCache::instanceCreated); // tree3 is deleted
+
+    delete treeRoot0;
+    delete treeRoot1;
+    delete moved;
+    ASSERT_EQ(0, TestTreeItemRootCache::instanceCreated);
+}
+
+TEST(TestTreeItem, rootCache_deep) {
+    TestTreeItemRootCache * treeRoot0 = new TestTreeItemRootCache();
+    TestTreeItemRootCache * treeRoot1 = new TestTreeItemRootCache();
+    TestTreeItemRootCache * tree1 = new TestTreeItemRootCache(treeRoot0);
+    TestTreeItemRootCache * sibling = new TestTreeItemRootCache(treeRoot0);
+    TestTreeItemRootCache * last = tree1;
+    for (int i = 0; i < 100000; ++i) {
+        last = new TestTreeItemRootCache(last);
+    }
+    ASSERT_TRUE(last->root() == treeRoot0);
+    ASSERT_TRUE(sibling->root() == treeRoot0);
+
+    // the caches of the moved subtree are cleared without recursion
+    tree1->setParent(treeRoot1);
+    ASSERT_TRUE(last->root() == treeRoot1);
+    ASSERT_TRUE(tree1->root() == treeRoot1);
+    ASSERT_TRUE(sibling->root() == treeRoot0);
+
+    delete treeRoot1;
+    ASSERT_TRUE(sibling->root() == treeRoot0);
+    delete treeRoot0;
+    ASSERT_EQ(0, TestTreeItemRootCache::instanceCreated);
+}
+
+class TestTreeItemNotified : public TreeItem<TestTreeItemNotified> {
+public:
+
+    std::vector<int> mNotifications;
+
+    explicit TestTreeItemNotified(int inMark = -1)
+        : mMark(inMark) {}
+
+    int mMark;
+
+protected:
+
+    void childAdded(TestTreeItemNotified * child) override {
+        mNotifications.push_back(child->mMark);
+        ASSERT_TRUE(child->parent() == this);
+    }
+
+    void childRemoved(TestTreeItemNotified * child) override {
+        mNotifications.push_back(-child->mMark);
+        ASSERT_TRUE(child->parent() == nullptr);
+        ASSERT_TRUE(indexOf(child) == npos);
+    }
+
+};
+
+TEST(TestTreeItem, childNotifications) {
+    TestTreeItemNotified treeRoot0;
+    TestTreeItemNotified treeRoot1;
+    TestTreeItemNotified * tree1 = treeRoot0.appendChild(new TestTreeItemNotified(1));
+    TestTreeItemNotified * tree2 = treeRoot0.prependChild(new TestTreeItemNotified(2));
+    TestTreeItemNotified * tree3 = treeRoot0.insertChild(1, new TestTreeItemNotified(3));
+    tree2->setParent(&treeRoot1);
+    delete treeRoot0.takeChildAt(0);
+    treeRoot0.deleteChild(tree1);
+    tree2->appendChild(new TestTreeItemNotified(4));
+    treeRoot1.deleteChildren();
+    ASSERT_EQ(std::vector<int>({1, 2, 3, -2, -3, -1}), treeRoot0.mNotifications);
+    ASSERT_EQ(std::vector<int>({2, -2}), treeRoot1.mNotifications);
+    (void)tree3;
+}
+
+TEST(TestTreeItem, childNotifications_bulk) {
+    TestTreeItemNotified treeRoot0;
+    TestTreeItemNotified treeRoot1;
+    TestTreeItemNotified * tree1 = treeRoot1.appendChild(new TestTreeItemNotified(1));
+    TestTreeItemNotified * tree2 = treeRoot1.appendChild(new TestTreeItemNotified(2));
+    TestTreeItemNotified * tree3 = new TestTreeItemNotified(3);
+    std::vector<TestTreeItemNotified*> items({tree2, tree3, tree1});
+    treeRoot0.appendChildren(items.begin(), items.end());
+    ASSERT_EQ(std::vector<int>({2, 3, 1}), treeRoot0.mNotifications);
+    ASSERT_EQ(std::vector<int>({1, 2, -2, -1}), treeRoot1.mNotifications);
+    ASSERT_FALSE(treeRoot1.hasChildren());
+    ASSERT_EQ(3, treeRoot0.childrenCount());
+}
+
+TEST(TestTreeItem, constructorParent) {
+    TestTreeItem * treeRoot = new TestTreeItem(0);
+    TestTreeItem * tree1 = new TestTreeItem(treeRoot, 1);
+    TestTreeItem * tree2 = new TestTreeItem(treeRoot, 2);
+    TestTreeItem * tree3 = new TestTreeItem(tree1, 3);
+    ASSERT_TRUE(tree1->parent() == treeRoot);
+    ASSERT_TRUE(tree3->parent() == tree1);
+    ASSERT_EQ(1, treeRoot->indexOf(tree2));
+    // the destructor removes the item from its parent
+    delete tree1;
+    ASSERT_EQ(1, treeRoot->childrenCount());
+    ASSERT_EQ(0, treeRoot->indexOf(tree2));
+    ASSERT_EQ(2, TestTreeItem::instanceCreated);
+    delete tree2;
+    ASSERT_FALSE(treeRoot->hasChildren());
+    delete treeRoot;
+    ASSERT_EQ(0, TestTreeItem::instanceCreated);
+}
+
 TEST(TestTreeItem, isChildOf) {
     TestTreeItem * treeRoot0 = new TestTreeItem();
     TestTreeItem * tree1 = treeRoot0->appendChild(new TestTreeItem);
@@ -484,6 +735,171 @@ TEST(TestTreeItem, copyConstructor_inNew) {
     ASSERT_EQ(0, TestTreeItem::instanceCreated);
 }
 
+TEST(TestTreeItem, copyConstructor_deep) {
+    // the depth is enough for the stack overflow if the children are cloned recursively.
+    const int depth = 500000;
+    TestTreeItem * treeRoot = new TestTreeItem(0);
+    TestTreeItem * last = treeRoot;
+    for (int i = 1; i <= depth; ++i) {
+        last = last->appendChild(new TestTreeItem(i));
+    }
+    last->appendChild(new TestTreeItem(-2));
+    treeRoot->appendChild(new TestTreeItem(-3));
+
+    TestTreeItem * treeForCopy = new TestTreeItem(*treeRoot);
+    ASSERT_EQ(2 * (depth + 3), TestTreeItem::instanceCreated);
+    ASSERT_EQ(2, treeForCopy->childrenCount());
+    ASSERT_EQ(-3, treeForCopy->childAt(1)->mMark);
+    const TestTreeItem * item = treeForCopy;
+    for (int i = 0; i < depth; ++i) {
+        ASSERT_EQ(i, item->mMark);
+        item = item->childAt(0);
+    }
+    ASSERT_EQ(depth, item->mMark);
+    ASSERT_EQ(1, item->childrenCount());
+    ASSERT_EQ(-2, item->childAt(0)->mMark);
+    ASSERT_TRUE(item->root() == treeForCopy);
+
+    delete treeRoot;
+    delete treeForCopy;
+    ASSERT_EQ(0, TestTreeItem::instanceCreated);
+}
+
+class TestTreeItemThrowing : public TreeItem<TestTreeItemThrowing> {
+public:
+
+    static int instanceCreated;
+    static int throwingAfter;
+
+    TestTreeItemThrowing() {
+        ++instanceCreated;
+    }
+
+    TestTreeItemThrowing(const TestTreeItemThrowing & copy)
+        : TreeItem<TestTreeItemThrowing>(copy) {
+        ++instanceCreated;
+    }
+
+    ~TestTreeItemThrowing() {
+        --instanceCreated;
+    }
+
+    TestTreeItemThrowing & operator =(const TestTreeItemThrowing & copy) {
+        TreeItem<TestTreeItemThrowing>::operator=(copy);
+        return *this;
+    }
+
+    TestTreeItemThrowing * clone() const override {
+        if (throwingAfter-- == 0) {
+            throw std::runtime_error("can't clone");
+        }
+        return new TestTreeItemThrowing(*this);
+    }
+
+};
+
+int TestTreeItemThrowing::instanceCreated = 0;
+int TestTreeItemThrowing::throwingAfter = -1;
+
+TEST(TestTreeItem, copyConstructor_throwingClone) {
+    // root -> (a -> (c, d), b), the copy clones a, b, c, d.
+    TestTreeItemThrowing * treeRoot = new TestTreeItemThrowing();
+    TestTreeItemThrowing * a = treeRoot->appendChild(new TestTreeItemThrowing());
+    treeRoot->appendChild(new TestTreeItemThrowing());
+    a->appendChild(new TestTreeItemThrowing());
+    a->appendChild(new TestTreeItemThrowing());
+    ASSERT_EQ(5, TestTreeItemThrowing::instanceCreated);
+
+    // the fourth clone throws, the three made clones must be deleted.
+    TestTreeItemThrowing::throwingAfter = 3;
+    ASSERT_THROW(TestTreeItemThrowing copy(*treeRoot), std::runtime_error);
+    ASSERT_EQ(5, TestTreeItemThrowing::instanceCreated);
+
+    // the item keeps its children if the copy operator throws.
+    TestTreeItemThrowing * target = new TestTreeItemThrowing();
+    target->appendChild(new TestTreeItemThrowing());
+    TestTreeItemThrowing::throwingAfter = 3;
+    ASSERT_THROW(*target = *treeRoot, std::runtime_error);
+    ASSERT_EQ(7, TestTreeItemThrowing::instanceCreated);
+    ASSERT_EQ(1, target->childrenCount());
+
+    TestTreeItemThrowing::throwingAfter = -1;
+    *target = *treeRoot;
+    ASSERT_EQ(10, TestTreeItemThrowing::instanceCreated);
+    ASSERT_EQ(2, target->childrenCount());
+    ASSERT_EQ(2, target->childAt(0)->childrenCount());
+
+    delete target;
+    delete treeRoot;
+    ASSERT_EQ(0, TestTreeItemThrowing::instanceCreated);
+}
+
+class TestTreeItemTemporary : public TreeItem<TestTreeItemTemporary> {
+    typedef TreeItem<TestTreeItemTemporary> Base;
+public:
+
+    enum Mode {
+        Move,
+        Copy,
+        Assign,
+    };
+
+    static Mode mode;
+    int mMark;
+
+    explicit TestTreeItemTemporary(int inMark = -1)
+        : mMark(inMark) {}
+
+    TestTreeItemTemporary(const TestTreeItemTemporary & inTreeItem)
+        : Base(inTreeItem),
+          mMark(inTreeItem.mMark) {}
+
+    TestTreeItemTemporary(TestTreeItemTemporary && inTreeItem)
+        : Base(std::move(inTreeItem)),
+          mMark(inTreeItem.mMark) {}
+
+    TestTreeItemTemporary * clone() const override {
+        // the temporary copy waits for its children and is destroyed before they are cloned.
+        TestTreeItemTemporary tmp(*this);
+        switch (mode) {
+            case Move: return new TestTreeItemTemporary(std::move(tmp));
+            case Copy: return new TestTreeItemTemporary(tmp);
+            case Assign: {
+                TestTreeItemTemporary * out = new TestTreeItemTemporary(tmp.mMark);
+                out->Base::operator=(tmp);
+                return out;
+            }
+        }
+        return nullptr;
+    }
+
+};
+
+TestTreeItemTemporary::Mode TestTreeItemTemporary::mode = TestTreeItemTemporary::Move;
+
+TEST(TestTreeItem, copyConstructor_temporaryClones) {
+    TestTreeItemTemporary treeRoot(0);
+    TestTreeItemTemporary * tree1 = treeRoot.appendChild(new TestTreeItemTemporary(1));
+    tree1->appendChild(new TestTreeItemTemporary(2))->appendChild(new TestTreeItemTemporary(3));
+    tree1->appendChild(new TestTreeItemTemporary(4));
+    treeRoot.appendChild(new TestTreeItemTemporary(5));
+
+    for (auto mode : {TestTreeItemTemporary::Move, TestTreeItemTemporary::Copy, TestTreeItemTemporary::Assign}) {
+        TestTreeItemTemporary::mode = mode;
+        TestTreeItemTemporary copy(treeRoot);
+        ASSERT_EQ(2, copy.childrenCount());
+        const TestTreeItemTemporary * copy1 = copy.childAt(0);
+        ASSERT_EQ(1, copy1->mMark);
+        ASSERT_EQ(2, copy1->childrenCount());
+        ASSERT_EQ(2, copy1->childAt(0)->mMark);
+        ASSERT_EQ(3, copy1->childAt(0)->childAt(0)->mMark);
+        ASSERT_TRUE(copy1->childAt(0)->childAt(0)->parent() == copy1->childAt(0));
+        ASSERT_EQ(4, copy1->childAt(1)->mMark);
+        ASSERT_EQ(5, copy.childAt(1)->mMark);
+        ASSERT_TRUE(copy.childAt(1)->isLeaf());
+    }
+}
+
 //----------------------------------------------
 //                    +root
 //  +root                 tree0   
@@ -542,6 +958,67 @@ TEST(TestTreeItem, copyOperator_inExist) {
     ASSERT_EQ(0, TestTreeItem::instanceCreated);
 }
 
+TEST(TestTreeItem, moveConstructor) {
+    TestTreeItem * treeRoot = new TestTreeItem();
+    TestTreeItem * tree0 = treeRoot->appendChild(new TestTreeItem(0));
+    TestTreeItem * tree1 = tree0->appendChild(new TestTreeItem(1));
+    TestTreeItem * tree2 = tree0->appendChild(new TestTreeItem(2));
+    TestTreeItem * tree3 = tree2->appendChild(new TestTreeItem(3));
+    ASSERT_EQ(5, TestTreeItem::instanceCreated);
+
+    TestTreeItem * moved = new TestTreeItem(std::move(*tree0));
+    ASSERT_EQ(6, TestTreeItem::instanceCreated); // nothing is cloned
+    ASSERT_TRUE(moved->isRoot());
+    ASSERT_EQ(0, moved->mMark);
+    ASSERT_EQ(2, moved->childrenCount());
+    ASSERT_TRUE(moved->childAt(0) == tree1);
+    ASSERT_TRUE(moved->childAt(1) == tree2);
+    ASSERT_TRUE(tree1->parent() == moved);
+    ASSERT_TRUE(tree3->root() == moved);
+    ASSERT_TRUE(tree0->parent() == treeRoot);
+    ASSERT_FALSE(tree0->hasChildren());
+
+    delete treeRoot;
+    ASSERT_EQ(4, TestTreeItem::instanceCreated);
+    delete moved;
+    ASSERT_EQ(0, TestTreeItem::instanceCreated);
+}
+
+TEST(TestTreeItem, moveOperator) {
+    TestTreeItem * treeRoot0 = new TestTreeItem();
+    TestTreeItem * tree0 = treeRoot0->appendChild(new TestTreeItem(0));
+    tree0->appendChild(new TestTreeItem(1));
+    TestTreeItem * treeRoot1 = new TestTreeItem();
+    TestTreeItem * tree2 = treeRoot1->appendChild(new TestTreeItem(2));
+    TestTreeItem * tree3 = tree2->appendChild(new TestTreeItem(3));
+    TestTreeItem * tree4 = tree2->appendChild(new TestTreeItem(4));
+    ASSERT_EQ(7, TestTreeItem::instanceCreated);
+    //---------------------------------
+    *tree0 = std::move(*tree2);
+    ASSERT_EQ(6, TestTreeItem::instanceCreated); // the old child is deleted
+    ASSERT_TRUE(tree0->parent() == treeRoot0);
+    ASSERT_EQ(2, tree0->mMark);
+    ASSERT_EQ(2, tree0->childrenCount());
+    ASSERT_TRUE(tree0->childAt(0) == tree3);
+    ASSERT_TRUE(tree0->childAt(1) == tree4);
+    ASSERT_TRUE(tree4->root() == treeRoot0);
+    ASSERT_TRUE(tree2->parent() == treeRoot1);
+    ASSERT_FALSE(tree2->hasChildren());
+    //---------------------------------
+    // a descendant must be detached before its children replace this item's ones.
+    tree0->setParent(nullptr);
+    *treeRoot0 = std::move(*tree0);
+    ASSERT_EQ(6, TestTreeItem::instanceCreated);
+    ASSERT_EQ(2, treeRoot0->childrenCount());
+    ASSERT_TRUE(treeRoot0->childAt(0) == tree3);
+    ASSERT_TRUE(tree3->parent() == treeRoot0);
+    delete tree0;
+    //---------------------------------
+    delete treeRoot0;
+    delete treeRoot1;
+    ASSERT_EQ(0, TestTreeItem::instanceCreated);
+}
+
 //-------------------------------------------------------------------------------------------
 //
 //  +root         | +root      | +root            | +root              | +root    
@@ -608,3 +1085,84 @@ TEST(TestTreeItem, parenting) {
 /**************************************************************************************************/
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 /**************************************************************************************************/
+
+/*!
+ * \details The container which has the required members only, like the ones written for the first versions.
+ */
+template<typename TYPE>
+class TestMinimalContainer : public std::vector<TYPE *> {
+    typedef std::vector<TYPE *> Container;
+public:
+
+    TYPE * operator[](const std::size_t index) {
+        return Container::operator[](index);
+    }
+
+    const TYPE * operator[](const std::size_t index) const {
+        return Container::operator[](index);
+    }
+
+    using Container::erase;
+
+    TYPE * erase(const std::size_t index) {
+        auto it = Container::begin() + index;
+        TYPE * out = (*it);
+        Container::erase(it);
+        return out;
+    }
+
+    using Container::insert;
+
+    void insert(const std::size_t index, TYPE * val) {
+        Container::insert(Container::begin() + index, val);
+    }
+
+    void push_front(TYPE * val) {
+        Container::insert(Container::begin(), val);
+    }
+
+};
+
+class TestTreeItemMinimal : public TreeItem<TestTreeItemMinimal, TestMinimalContainer<TestTreeItemMinimal>> {
+public:
+
+    explicit TestTreeItemMinimal(int inMark = -1)
+        : mMark(inMark) {}
+
+    int mMark;
+
+};
+
+TEST(TestTreeItem, minimalContainer) {
+    TestTreeItemMinimal * treeRoot = new TestTreeItemMinimal(0);
+    TestTreeItemMinimal * tree1 = treeRoot->appendChild(new TestTreeItemMinimal(1));
+    TestTreeItemMinimal * tree2 = treeRoot->appendChild(new TestTreeItemMinimal(2));
+    treeRoot->prependChild(new TestTreeItemMinimal(3));
+    ASSERT_EQ(2, treeRoot->indexOf(tree2));
+    tree1->setParent(tree2);
+    ASSERT_EQ(treeRoot->npos, treeRoot->indexOf(tree1));
+    ASSERT_EQ(0, tree2->indexOf(tree1));
+    //---------------------------------
+    std::vector<TestTreeItemMinimal *> items = {new TestTreeItemMinimal(4), tree1, new TestTreeItemMinimal(5)};
+    treeRoot->reserveChildren(5);
+    treeRoot->insertChildren(1, items.begin(), items.end());
+    ASSERT_EQ(5, treeRoot->childrenCount());
+    ASSERT_EQ(3, treeRoot->childAt(0)->mMark);
+    ASSERT_EQ(4, treeRoot->childAt(1)->mMark);
+    ASSERT_EQ(1, treeRoot->childAt(2)->mMark);
+    ASSERT_EQ(5, treeRoot->childAt(3)->mMark);
+    ASSERT_EQ(2, treeRoot->childAt(4)->mMark);
+    ASSERT_TRUE(tree2->isLeaf());
+    //---------------------------------
+    std::vector<TestTreeItemMinimal *> children = {treeRoot->childAt(1), treeRoot->childAt(3)};
+    tree2->appendChildren(children.begin(), children.end());
+    ASSERT_EQ(3, treeRoot->childrenCount());
+    ASSERT_EQ(2, tree2->childrenCount());
+    ASSERT_TRUE(treeRoot->deleteChild(tree1));
+    ASSERT_EQ(2, treeRoot->childrenCount());
+    delete treeRoot;
+}
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
@@ -0,0 +1,341 @@
+/*
+**  Copyright(C) 2018, StepToSky
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  1.Redistributions of source code must retain the above copyright notice, this
+**    list of conditions and the following disclaimer.
+**  2.Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and / or other materials provided with the distribution.
+**  3.Neither the name of StepToSky nor the names of its contributors
+**    may be used to endorse or promote products derived from this software
+**    without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**  DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**  Contacts: www.steptosky.com
+*/
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+#include "sts/tree/TreeItem.h"
+#include "sts/tree/TreeItemAggregate.h"
+
+using namespace sts::tree;
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+class TestSumItem : public TreeItemAggregate<TestSumItem, TreeItemAggregateSum<int>> {
+    typedef TreeItemAggregate<TestSumItem, TreeItemAggregateSum<int>> Base;
+public:
+
+    static int instanceCreated;
+
+    explicit TestSumItem(const int inValue = 0)
+        : Base(inValue) {
+        ++instanceCreated;
+    }
+
+    TestSumItem(TestSumItem * inOutParent, const int inValue)
+        : Base(inOutParent, inValue) {
+        ++instanceCreated;
+    }
+
+    TestSumItem(const TestSumItem & copy)
+        : Base(copy) {
+        ++instanceCreated;
+    }
+
+    TestSumItem(TestSumItem && other)
+        : Base(std::move(other)) {
+        ++instanceCreated;
+    }
+
+    TestSumItem & operator =(const TestSumItem & copy) {
+        Base::operator=(copy);
+        return *this;
+    }
+
+    ~TestSumItem() {
+        --instanceCreated;
+    }
+
+    TestSumItem * clone() const override {
+        return new TestSumItem(*this);
+    }
+
+};
+
+int TestSumItem::instanceCreated = 0;
+
+class TestMinItem : public TreeItemAggregate<TestMinItem, TreeItemAggregateMin<int>> {
+public:
+
+    explicit TestMinItem(const int inValue)
+        : TreeItemAggregate<TestMinItem, TreeItemAggregateMin<int>>(inValue) {}
+
+};
+
+class TestCountItem : public TreeItemAggregate<TestCountItem> {};
+
+/*
+ * Several aggregates in one value.
+ */
+struct TestStats {
+    int mSum;
+    int mMin;
+    int mMax;
+
+    TestStats(const int value = 0)
+        : mSum(value),
+          mMin(value),
+          mMax(value) {}
+};
+
+struct TestStatsAggregate {
+    typedef TestStats Value;
+
+    static Value combine(const Value & a, const Value & b) {
+        Value out;
+        out.mSum = a.mSum + b.mSum;
+        out.mMin = std::min(a.mMin, b.mMin);
+        out.mMax = std::max(a.mMax, b.mMax);
+        return out;
+    }
+
+    static bool subtract(Value & inOutTotal, const Value & part) {
+        inOutTotal.mSum -= part.mSum;
+        return inOutTotal.mMin < part.mMin && part.mMax < inOutTotal.mMax;
+    }
+};
+
+class TestStatsItem : public TreeItemAggregate<TestStatsItem, TestStatsAggregate> {
+public:
+
+    explicit TestStatsItem(const int inValue)
+        : TreeItemAggregate<TestStatsItem, TestStatsAggregate>(inValue) {}
+
+};
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+/*
+ * Combines the aggregate by walking the subtree.
+ */
+void walkStats(const TestStatsItem * item, TestStats & outStats, std::size_t & outCount) {
+    outStats = TestStatsAggregate::combine(outStats, item->aggregateValue());
+    ++outCount;
+    for (std::size_t i = 0; i < item->childrenCount(); ++i) {
+        walkStats(item->childAt(i), outStats, outCount);
+    }
+}
+
+::testing::AssertionResult checkStats(const std::vector<TestStatsItem*> & items) {
+    for (auto & item : items) {
+        TestStats stats = item->aggregateValue();
+        std::size_t count = 0;
+        walkStats(item, stats, count);
+        const TestStats & aggregate = item->aggregate();
+        if (count != item->subtreeSize() || stats.mSum - item->aggregateValue().mSum != aggregate.mSum ||
+            stats.mMin != aggregate.mMin || stats.mMax != aggregate.mMax) {
+            return ::testing::AssertionFailure() << "the aggregate of the item " << item->aggregateValue().mSum << " is wrong";
+        }
+    }
+    return ::testing::AssertionSuccess();
+}
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+//----------------------------------------------
+//  +root (1)
+//      child0 (2)
+//          child00 (4)
+//          child01 (8)
+//      child1 (16)
+//----------------------------------------------
+TEST(TestTreeItemAggregate, sum) {
+    TestSumItem * root = new TestSumItem(1);
+    TestSumItem * child0 = root->appendChild(new TestSumItem(2));
+    TestSumItem * child1 = new TestSumItem(root, 16);
+    TestSumItem * child00 = child0->appendChild(new TestSumItem(4));
+    TestSumItem * child01 = child0->insertChild(1, new TestSumItem(8));
+    ASSERT_EQ(31, root->aggregate());
+    ASSERT_EQ(5, root->subtreeSize());
+    ASSERT_EQ(14, child0->aggregate());
+    ASSERT_EQ(3, child0->subtreeSize());
+    ASSERT_EQ(16, child1->aggregate());
+    ASSERT_EQ(1, child1->subtreeSize());
+
+    child00->setAggregateValue(32);
+    ASSERT_EQ(32, child00->aggregateValue());
+    ASSERT_EQ(59, root->aggregate());
+    ASSERT_EQ(42, child0->aggregate());
+
+    child0->setParent(child1);
+    ASSERT_EQ(59, root->aggregate());
+    ASSERT_EQ(58, child1->aggregate());
+    ASSERT_EQ(4, child1->subtreeSize());
+
+    TestSumItem * taken = child1->takeChildAt(0);
+    ASSERT_EQ(child0, taken);
+    ASSERT_EQ(17, root->aggregate());
+    ASSERT_EQ(2, root->subtreeSize());
+
+    root->prependChild(child0);
+    child0->deleteChild(child01);
+    ASSERT_EQ(51, root->aggregate());
+    ASSERT_EQ(4, root->subtreeSize());
+
+    // the directly deleted item removes itself from the aggregates.
+    delete child00;
+    ASSERT_EQ(19, root->aggregate());
+    ASSERT_EQ(3, root->subtreeSize());
+
+    root->deleteChildren();
+    ASSERT_EQ(1, root->aggregate());
+    ASSERT_EQ(1, root->subtreeSize());
+
+    delete root;
+    ASSERT_EQ(0, TestSumItem::instanceCreated);
+}
+
+TEST(TestTreeItemAggregate, min) {
+    TestMinItem root(5);
+    TestMinItem * child0 = root.appendChild(new TestMinItem(7));
+    TestMinItem * child00 = child0->appendChild(new TestMinItem(2));
+    TestMinItem * child1 = root.appendChild(new TestMinItem(3));
+    ASSERT_EQ(2, root.aggregate());
+
+    // the minimum is removed, so the aggregate is combined again.
+    child0->deleteChild(child00);
+    ASSERT_EQ(3, root.aggregate());
+    ASSERT_EQ(7, child0->aggregate());
+
+    child1->setAggregateValue(9);
+    ASSERT_EQ(5, root.aggregate());
+    child0->setAggregateValue(-1);
+    ASSERT_EQ(-1, root.aggregate());
+}
+
+TEST(TestTreeItemAggregate, count) {
+    TestCountItem root;
+    TestCountItem * item = &root;
+    for (int i = 0; i < 100; ++i) {
+        item = item->appendChild(new TestCountItem);
+        item->appendChild(new TestCountItem);
+    }
+    ASSERT_EQ(201, root.subtreeSize());
+    ASSERT_EQ(2, item->subtreeSize());
+    delete root.childAt(0)->childAt(1);
+    ASSERT_EQ(3, root.subtreeSize());
+}
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+TEST(TestTreeItemAggregate, randomChanges) {
+    std::srand(23);
+    std::vector<TestStatsItem*> items(1, new TestStatsItem(0));
+    TestStatsItem * root = items.front();
+    for (int i = 0; i < 3000; ++i) {
+        TestStatsItem * item = items[std::size_t(std::rand()) % items.size()];
+        switch (std::rand() % 5) {
+            case 0:
+            case 1: {
+                items.push_back(item->appendChild(new TestStatsItem(std::rand() % 1000 - 500)));
+                break;
+            }
+            case 2: {
+                item->setAggregateValue(std::rand() % 1000 - 500);
+                break;
+            }
+            case 3: {
+                // moves the subtree to another item which isn't in it.
+                TestStatsItem * parent = items[std::size_t(std::rand()) % items.size()];
+                if (item != root && parent != item && !parent->isChildOf(item)) {
+                    item->setParent(parent);
+                }
+                break;
+            }
+            default: {
+                if (item != root) {
+                    std::vector<TestStatsItem*> removed(1, item);
+                    for (auto & it : items) {
+                        if (it->isChildOf(item)) {
+                            removed.push_back(it);
+                        }
+                    }
+                    delete item;
+                    items.erase(std::remove_if(items.begin(), items.end(), [&](TestStatsItem * it) {
+                        return std::find(removed.begin(), removed.end(), it) != removed.end();
+                    }), items.end());
+                }
+                break;
+            }
+        }
+        if (i % 100 == 0) {
+            ASSERT_TRUE(checkStats(items));
+        }
+    }
+    ASSERT_TRUE(checkStats(items));
+    ASSERT_EQ(items.size(), root->subtreeSize());
+    delete root;
+}
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+TEST(TestTreeItemAggregate, copy) {
+    TestSumItem * root = new TestSumItem(1);
+    TestSumItem * child = root->appendChild(new TestSumItem(2));
+    child->appendChild(new TestSumItem(4));
+    child->appendChild(new TestSumItem(8));
+
+    TestSumItem * copy = child->clone();
+    ASSERT_TRUE(copy->isRoot());
+    ASSERT_EQ(14, copy->aggregate());
+    ASSERT_EQ(3, copy->subtreeSize());
+    root->appendChild(copy);
+    ASSERT_EQ(29, root->aggregate());
+    ASSERT_EQ(7, root->subtreeSize());
+
+    // the copy operator replaces the children and the value.
+    *copy = *root->childAt(0)->childAt(1);
+    ASSERT_EQ(8, copy->aggregate());
+    ASSERT_EQ(1, copy->subtreeSize());
+    ASSERT_EQ(23, root->aggregate());
+    ASSERT_EQ(5, root->subtreeSize());
+
+    TestSumItem moved(std::move(*child));
+    ASSERT_EQ(2 + 4 + 8, moved.aggregate());
+    ASSERT_EQ(3, moved.subtreeSize());
+    ASSERT_EQ(2, child->aggregate());
+    ASSERT_EQ(11, root->aggregate());
+    ASSERT_EQ(3, root->subtreeSize());
+
+    delete root;
+}
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
@@ -0,0 +1,271 @@
+/*
+**  Copyright(C) 2018, StepToSky
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  1.Redistributions of source code must retain the above copyright notice, this
+**    list of conditions and the following disclaimer.
+**  2.Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and / or other materials provided with the distribution.
+**  3.Neither the name of StepToSky nor the names of its contributors
+**    may be used to endorse or promote products derived from this software
+**    without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**  DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**  Contacts: www.steptosky.com
+*/
+
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+#include "sts/tree/TreeItem.h"
+#include "sts/tree/TreeItemAncestorIndex.h"
+#include "TestTreeItemRandom.h"
+
+using namespace sts::tree;
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+class TestIndexItem : public TreeItem<TestIndexItem> {
+public:
+
+    static int instanceCreated;
+    int mMark;
+
+    explicit TestIndexItem(const int inMark = 0)
+        : mMark(inMark) {
+        ++instanceCreated;
+    }
+
+    ~TestIndexItem() {
+        --instanceCreated;
+    }
+
+};
+
+int TestIndexItem::instanceCreated = 0;
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+TestIndexItem * deepTree(const std::size_t depth, std::vector<TestIndexItem*> & outItems) {
+    outItems.clear();
+    outItems.push_back(new TestIndexItem);
+    for (std::size_t i = 1; i < depth; ++i) {
+        outItems.push_back(outItems.back()->appendChild(new TestIndexItem));
+    }
+    return outItems.front();
+}
+
+std::size_t walkDepth(const TestIndexItem * item) {
+    std::size_t depth = 0;
+    for (; item->parent(); item = item->parent()) {
+        ++depth;
+    }
+    return depth;
+}
+
+/*
+ * The common ancestor by walking up to the root.
+ */
+const TestIndexItem * walkCommonAncestor(const TestIndexItem * item1, const TestIndexItem * item2) {
+    std::size_t depth1 = walkDepth(item1);
+    std::size_t depth2 = walkDepth(item2);
+    for (; depth1 > depth2; --depth1) {
+        item1 = item1->parent();
+    }
+    for (; depth2 > depth1; --depth2) {
+        item2 = item2->parent();
+    }
+    while (item1 != item2) {
+        item1 = item1->parent();
+        item2 = item2->parent();
+    }
+    return item1;
+}
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+TEST(TestTreeItemAncestorIndex, depth) {
+    std::vector<TestIndexItem*> items;
+    std::srand(5);
+    TestIndexItem * treeRoot = randomTree(500, &items);
+    TreeItemAncestorIndex<TestIndexItem> index(treeRoot);
+    ASSERT_EQ(items.size(), index.size());
+    for (auto & it : items) {
+        ASSERT_TRUE(index.contains(it));
+        ASSERT_EQ(walkDepth(it), index.depth(it));
+    }
+    ASSERT_EQ(0, index.indexOf(treeRoot));
+    delete treeRoot;
+    ASSERT_EQ(0, TestIndexItem::instanceCreated);
+}
+
+TEST(TestTreeItemAncestorIndex, isChildOf) {
+    std::vector<TestIndexItem*> items;
+    std::srand(7);
+    TestIndexItem * treeRoot = randomTree(200, &items);
+    TreeItemAncestorIndex<TestIndexItem> index(treeRoot);
+    for (auto & item : items) {
+        for (auto & parent : items) {
+            ASSERT_EQ(item->isChildOf(parent), index.isChildOf(item, parent));
+        }
+    }
+    TestIndexItem * other = new TestIndexItem;
+    ASSERT_FALSE(index.contains(other));
+    ASSERT_FALSE(index.isChildOf(other, treeRoot));
+    ASSERT_FALSE(index.isChildOf(treeRoot, other));
+    delete other;
+    delete treeRoot;
+    ASSERT_EQ(0, TestIndexItem::instanceCreated);
+}
+
+TEST(TestTreeItemAncestorIndex, ancestor) {
+    std::vector<TestIndexItem*> items;
+    std::srand(11);
+    TestIndexItem * treeRoot = randomTree(300, &items);
+    TreeItemAncestorIndex<TestIndexItem> index(treeRoot);
+    for (auto & it : items) {
+        const TestIndexItem * expected = it;
+        const std::size_t depth = walkDepth(it);
+        for (std::size_t level = 0; level <= depth; ++level) {
+            ASSERT_TRUE(index.ancestor(it, level) == expected);
+            expected = expected->parent();
+        }
+        ASSERT_TRUE(index.ancestor(it, depth + 1) == nullptr);
+    }
+    delete treeRoot;
+    ASSERT_EQ(0, TestIndexItem::instanceCreated);
+}
+
+TEST(TestTreeItemAncestorIndex, subtree) {
+    std::vector<TestIndexItem*> items;
+    TestIndexItem * treeRoot = deepTree(10, items);
+    items[3]->appendChild(new TestIndexItem);
+    TreeItemAncestorIndex<TestIndexItem> index(items[3]);
+    ASSERT_EQ(8, index.size());
+    ASSERT_FALSE(index.contains(items[2]));
+    ASSERT_EQ(0, index.depth(items[3]));
+    ASSERT_EQ(6, index.depth(items[9]));
+    ASSERT_TRUE(index.isChildOf(items[9], items[3]));
+    ASSERT_TRUE(index.ancestor(items[9], 6) == items[3]);
+    ASSERT_TRUE(index.ancestor(items[9], 7) == nullptr);
+
+    // rebuilding after the hierarchy is changed
+    items[6]->setParent(treeRoot);
+    index.build(treeRoot);
+    ASSERT_EQ(11, index.size());
+    ASSERT_EQ(4, index.depth(items[9]));
+    ASSERT_FALSE(index.isChildOf(items[9], items[3]));
+    ASSERT_TRUE(index.isChildOf(items[9], items[6]));
+
+    index.clear();
+    ASSERT_EQ(0, index.size());
+    ASSERT_FALSE(index.contains(treeRoot));
+    delete treeRoot;
+    ASSERT_EQ(0, TestIndexItem::instanceCreated);
+}
+
+TEST(TestTreeItemAncestorIndex, commonAncestor) {
+    std::vector<TestIndexItem*> items;
+    std::srand(13);
+    TestIndexItem * treeRoot = randomTree(300, &items);
+    TreeItemAncestorIndex<TestIndexItem> index(treeRoot);
+    for (auto & item1 : items) {
+        for (auto & item2 : items) {
+            ASSERT_TRUE(index.commonAncestor(item1, item2) == walkCommonAncestor(item1, item2));
+        }
+    }
+    TestIndexItem * other = new TestIndexItem;
+    ASSERT_TRUE(index.commonAncestor(other, treeRoot) == nullptr);
+    ASSERT_TRUE(index.commonAncestor(treeRoot, other) == nullptr);
+    delete other;
+    delete treeRoot;
+    ASSERT_EQ(0, TestIndexItem::instanceCreated);
+}
+
+TEST(TestTreeItemAncestorIndex, commonAncestors) {
+    std::vector<TestIndexItem*> items;
+    std::srand(17);
+    TestIndexItem * treeRoot = randomTree(1000, &items);
+    TestIndexItem * other = new TestIndexItem;
+    TreeItemAncestorIndex<TestIndexItem> index(treeRoot);
+
+    for (std::size_t count : {std::size_t(5000), std::size_t(10)}) {
+        std::vector<std::pair<const TestIndexItem*, const TestIndexItem*>> pairs(count);
+        for (auto & it : pairs) {
+            it.first = items[std::size_t(std::rand()) % items.size()];
+            it.second = items[std::size_t(std::rand()) % items.size()];
+        }
+        pairs[0].second = pairs[0].first;
+        pairs[1].second = pairs[1].first->parent();
+        pairs[2].first = other;
+        pairs[3].second = treeRoot;
+
+        std::vector<const TestIndexItem*> ancestors(3, treeRoot);
+        index.commonAncestors(pairs.begin(), pairs.end(), ancestors);
+        ASSERT_EQ(pairs.size(), ancestors.size());
+        ASSERT_TRUE(ancestors[0] == pairs[0].first);
+        ASSERT_TRUE(ancestors[2] == nullptr);
+        ASSERT_TRUE(ancestors[3] == treeRoot);
+        for (std::size_t i = 0; i < pairs.size(); ++i) {
+            if (i != 2) {
+                ASSERT_TRUE(ancestors[i] == walkCommonAncestor(pairs[i].first, pairs[i].second));
+            }
+        }
+    }
+
+    std::vector<const TestIndexItem*> ancestors(3, treeRoot);
+    std::vector<std::pair<TestIndexItem*, TestIndexItem*>> pairs;
+    index.commonAncestors(pairs.begin(), pairs.end(), ancestors);
+    ASSERT_TRUE(ancestors.empty());
+
+    delete other;
+    delete treeRoot;
+    ASSERT_EQ(0, TestIndexItem::instanceCreated);
+}
+
+TEST(TestTreeItemAncestorIndex, deep) {
+    std::vector<TestIndexItem*> items;
+    TestIndexItem * treeRoot = deepTree(200000, items);
+    TreeItemAncestorIndex<TestIndexItem> index(treeRoot);
+    ASSERT_EQ(199999, index.depth(items.back()));
+    ASSERT_TRUE(index.isChildOf(items.back(), treeRoot));
+    ASSERT_TRUE(index.ancestor(items.back(), 123456) == items[199999 - 123456]);
+    ASSERT_TRUE(index.commonAncestor(items.back(), items[123456]) == items[123456]);
+
+    std::vector<std::pair<const TestIndexItem*, const TestIndexItem*>> pairs;
+    for (std::size_t i = 0; i < items.size(); i += 2) {
+        pairs.emplace_back(items[i + 1], items[items.size() - i - 1]);
+    }
+    std::vector<const TestIndexItem*> ancestors;
+    index.commonAncestors(pairs.begin(), pairs.end(), ancestors);
+    for (std::size_t i = 0; i < pairs.size(); ++i) {
+        ASSERT_TRUE(ancestors[i] == items[std::min(i * 2 + 1, items.size() - i * 2 - 1)]);
+    }
+    delete treeRoot;
+    ASSERT_EQ(0, TestIndexItem::instanceCreated);
+}
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
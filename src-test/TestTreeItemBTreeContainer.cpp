@@ -0,0 +1,216 @@
+/*
+**  Copyright(C) 2018, StepToSky
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  1.Redistributions of source code must retain the above copyright notice, this
+**    list of conditions and the following disclaimer.
+**  2.Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and / or other materials provided with the distribution.
+**  3.Neither the name of StepToSky nor the names of its contributors
+**    may be used to endorse or promote products derived from this software
+**    without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**  DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**  Contacts: www.steptosky.com
+*/
+
+#include "gtest/gtest.h"
+#include <cstdlib>
+#include <vector>
+#include "sts/tree/TreeItem.h"
+#include "sts/tree/TreeItemContainerBTree.h"
+
+using namespace sts::tree;
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+class TestBTreeItem : public TreeItem<TestBTreeItem, TreeItemContainerBTree<TestBTreeItem>> {
+public:
+
+    static int instanceCreated;
+    int mMark;
+
+    explicit TestBTreeItem(int inMark = -1)
+        : mMark(inMark) {
+        ++instanceCreated;
+    }
+
+    ~TestBTreeItem() {
+        --instanceCreated;
+    }
+
+};
+
+int TestBTreeItem::instanceCreated = 0;
+
+/*
+ * Checks the children, their indexes and the iteration order by the model.
+ */
+static void checkChildren(const TestBTreeItem * parent, const std::vector<TestBTreeItem*> & model) {
+    ASSERT_EQ(model.size(), parent->childrenCount());
+    for (std::size_t i = 0; i < model.size(); ++i) {
+        ASSERT_TRUE(parent->childAt(i) == model[i]);
+        ASSERT_EQ(i, parent->indexOf(model[i]));
+    }
+    std::size_t i = 0;
+    for (auto & it : parent->children()) {
+        ASSERT_TRUE(it == model[i++]);
+    }
+    ASSERT_EQ(model.size(), i);
+}
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+TEST(TestTreeItemBTree, empty) {
+    TestBTreeItem * treeRoot = new TestBTreeItem();
+    TestBTreeItem * tree0 = new TestBTreeItem();
+    ASSERT_FALSE(treeRoot->hasChildren());
+    const TestBTreeItem * constRoot = treeRoot;
+    ASSERT_TRUE(constRoot->children().begin() == constRoot->children().end());
+    ASSERT_EQ(treeRoot->npos, treeRoot->indexOf(tree0));
+    //---------------------------------
+    treeRoot->appendChild(tree0);
+    ASSERT_EQ(0, treeRoot->indexOf(tree0));
+    ASSERT_TRUE(treeRoot->takeChildAt(0) == tree0);
+    ASSERT_FALSE(treeRoot->hasChildren());
+    ASSERT_EQ(treeRoot->npos, treeRoot->indexOf(tree0));
+    delete tree0;
+    delete treeRoot;
+    ASSERT_EQ(0, TestBTreeItem::instanceCreated);
+}
+
+TEST(TestTreeItemBTree, appendPrepend) {
+    TestBTreeItem * treeRoot = new TestBTreeItem();
+    std::vector<TestBTreeItem*> model;
+    for (int i = 0; i < 5000; ++i) {
+        if (i % 3 == 0) {
+            model.insert(model.begin(), treeRoot->prependChild(new TestBTreeItem(i)));
+        }
+        else {
+            model.push_back(treeRoot->appendChild(new TestBTreeItem(i)));
+        }
+    }
+    checkChildren(treeRoot, model);
+    //---------------------------------
+    while (treeRoot->childrenCount() > 10) {
+        delete treeRoot->takeChildAt(0);
+        model.erase(model.begin());
+        delete treeRoot->takeChildAt(treeRoot->childrenCount() - 1);
+        model.pop_back();
+    }
+    checkChildren(treeRoot, model);
+    delete treeRoot;
+    ASSERT_EQ(0, TestBTreeItem::instanceCreated);
+}
+
+TEST(TestTreeItemBTree, randomChanges) {
+    TestBTreeItem * treeRoots[2] = {new TestBTreeItem(), new TestBTreeItem()};
+    std::vector<TestBTreeItem*> models[2];
+    std::size_t seed = 1;
+    for (int i = 0; i < 30000; ++i) {
+        seed = seed * 1103515245 + 12345;
+        const std::size_t r = (seed >> 16) % 2;
+        TestBTreeItem * root = treeRoots[r];
+        std::vector<TestBTreeItem*> & model = models[r];
+        const std::size_t index = (seed >> 4) % (model.size() + 1);
+        const std::size_t operation = (seed >> 8) % 8;
+        if (operation < 4 || model.empty()) {
+            // growing a bit faster than shrinking, so there are splits and merges
+            model.insert(model.begin() + std::ptrdiff_t(index), root->insertChild(index, new TestBTreeItem(i)));
+        }
+        else if (operation < 6) {
+            const std::size_t taken = index % model.size();
+            ASSERT_TRUE(root->takeChildAt(taken) == model[taken]);
+            delete model[taken];
+            model.erase(model.begin() + std::ptrdiff_t(taken));
+        }
+        else {
+            // moving to the other root
+            const std::size_t taken = index % model.size();
+            TestBTreeItem * item = model[taken];
+            std::vector<TestBTreeItem*> & otherModel = models[1 - r];
+            const std::size_t where = (seed >> 12) % (otherModel.size() + 1);
+            treeRoots[1 - r]->insertChild(where, item);
+            model.erase(model.begin() + std::ptrdiff_t(taken));
+            otherModel.insert(otherModel.begin() + std::ptrdiff_t(where), item);
+            ASSERT_TRUE(item->parent() == treeRoots[1 - r]);
+            ASSERT_EQ(treeRoots[r]->npos, treeRoots[r]->indexOf(item));
+        }
+        if (i % 5000 == 0) {
+            checkChildren(treeRoots[0], models[0]);
+            checkChildren(treeRoots[1], models[1]);
+        }
+    }
+    checkChildren(treeRoots[0], models[0]);
+    checkChildren(treeRoots[1], models[1]);
+    //---------------------------------
+    while (!models[0].empty()) {
+        const std::size_t taken = models[0].size() / 2;
+        delete treeRoots[0]->takeChildAt(taken);
+        models[0].erase(models[0].begin() + std::ptrdiff_t(taken));
+    }
+    checkChildren(treeRoots[0], models[0]);
+    delete treeRoots[0];
+    delete treeRoots[1];
+    ASSERT_EQ(0, TestBTreeItem::instanceCreated);
+}
+
+TEST(TestTreeItemBTree, bulk) {
+    TestBTreeItem * treeRoots[2] = {new TestBTreeItem(), new TestBTreeItem()};
+    std::vector<TestBTreeItem*> models[2];
+    for (int i = 0; i < 3000; ++i) {
+        models[0].push_back(new TestBTreeItem(i));
+    }
+    treeRoots[0]->appendChildren(models[0].begin(), models[0].end());
+    checkChildren(treeRoots[0], models[0]);
+    //---------------------------------
+    // a few items are inserted one by one, a lot of them rebuild the tree
+    std::vector<TestBTreeItem*> items;
+    for (int i = 0; i < 10; ++i) {
+        items.push_back(new TestBTreeItem(i));
+    }
+    treeRoots[0]->insertChildren(1500, items.begin(), items.end());
+    models[0].insert(models[0].begin() + 1500, items.begin(), items.end());
+    checkChildren(treeRoots[0], models[0]);
+    //---------------------------------
+    items.clear();
+    for (std::size_t i = 0; i < models[0].size(); i += 2) {
+        items.push_back(models[0][i]);
+    }
+    treeRoots[1]->appendChildren(items.begin(), items.end());
+    models[1] = items;
+    items.clear();
+    for (std::size_t i = 1; i < models[0].size(); i += 2) {
+        items.push_back(models[0][i]);
+    }
+    models[0] = items;
+    checkChildren(treeRoots[0], models[0]);
+    checkChildren(treeRoots[1], models[1]);
+    //---------------------------------
+    treeRoots[0]->deleteChildren();
+    ASSERT_EQ(models[1].size() + 2, TestBTreeItem::instanceCreated);
+    delete treeRoots[0];
+    delete treeRoots[1];
+    ASSERT_EQ(0, TestBTreeItem::instanceCreated);
+}
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
@@ -0,0 +1,243 @@
+/*
+**  Copyright(C) 2018, StepToSky
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  1.Redistributions of source code must retain the above copyright notice, this
+**    list of conditions and the following disclaimer.
+**  2.Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and / or other materials provided with the distribution.
+**  3.Neither the name of StepToSky nor the names of its contributors
+**    may be used to endorse or promote products derived from this software
+**    without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**  DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**  Contacts: www.steptosky.com
+*/
+#include "gtest/gtest.h"
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "sts/tree/TreeItem.h"
+#include "sts/tree/TreeItemBinary.h"
+#include "TestTreeItemRandom.h"
+
+using namespace sts::tree;
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+struct TestPayload {
+    std::int32_t mMark;
+    float mWeight;
+};
+
+class TestBinaryItem : public TreeItem<TestBinaryItem> {
+public:
+
+    static int instanceCreated;
+
+    TestPayload mPayload;
+
+    explicit TestBinaryItem(const int inMark = 0) {
+        mPayload.mMark = inMark;
+        mPayload.mWeight = float(inMark) * 0.5f;
+        ++instanceCreated;
+    }
+
+    ~TestBinaryItem() {
+        --instanceCreated;
+    }
+
+};
+
+int TestBinaryItem::instanceCreated = 0;
+
+typedef TreeItemBinary<TestPayload> Binary;
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+/*
+ * The data in the memory which is aligned as a mapped file.
+ */
+std::vector<std::uint64_t> writeData(const TestBinaryItem * root, std::size_t & outSize) {
+    std::ostringstream stream(std::ios::binary);
+    const bool written = Binary::write(stream, root, [](const TestBinaryItem * item) { return item->mPayload; });
+    EXPECT_TRUE(written);
+    const std::string bytes = stream.str();
+    outSize = bytes.size();
+    std::vector<std::uint64_t> data((bytes.size() + 7) / 8);
+    std::memcpy(data.data(), bytes.data(), bytes.size());
+    return data;
+}
+
+void checkSameHierarchy(const TestBinaryItem * expected, const TestBinaryItem * actual) {
+    std::vector<std::pair<const TestBinaryItem *, const TestBinaryItem *>> stack(1, std::make_pair(expected, actual));
+    while (!stack.empty()) {
+        const TestBinaryItem * e = stack.back().first;
+        const TestBinaryItem * a = stack.back().second;
+        stack.pop_back();
+        ASSERT_EQ(e->mPayload.mMark, a->mPayload.mMark);
+        ASSERT_EQ(e->mPayload.mWeight, a->mPayload.mWeight);
+        ASSERT_EQ(e->childrenCount(), a->childrenCount());
+        for (std::size_t i = 0; i < e->childrenCount(); ++i) {
+            ASSERT_TRUE(a->childAt(i)->parent() == a);
+            stack.emplace_back(e->childAt(i), a->childAt(i));
+        }
+    }
+}
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+//----------------------------------------------
+//  +root (0)
+//      child0 (1)
+//          child00 (2)
+//          child01 (3)
+//      child1 (4)
+//----------------------------------------------
+TEST(TestTreeItemBinary, layout) {
+    TestBinaryItem * root = new TestBinaryItem(10);
+    TestBinaryItem * child0 = root->appendChild(new TestBinaryItem(11));
+    root->appendChild(new TestBinaryItem(14));
+    child0->appendChild(new TestBinaryItem(12));
+    child0->appendChild(new TestBinaryItem(13));
+
+    std::size_t size = 0;
+    const std::vector<std::uint64_t> data = writeData(root, size);
+    ASSERT_EQ(Binary::dataSize(5), size);
+    delete root;
+
+    const Binary binary(data.data(), size);
+    ASSERT_TRUE(binary.isOpen());
+    ASSERT_TRUE(binary.validate());
+    ASSERT_EQ(5, binary.size());
+    for (Binary::Index i = 0; i < 5; ++i) {
+        ASSERT_EQ(int(10 + i), binary.payload(i).mMark);
+        ASSERT_EQ(int(10 + i), binary.payloads()[i].mMark);
+    }
+    ASSERT_EQ(Binary::npos, binary.parent(0));
+    ASSERT_EQ(1, binary.parent(3));
+    ASSERT_EQ(0, binary.parent(4));
+    ASSERT_EQ(1, binary.firstChild(0));
+    ASSERT_EQ(Binary::npos, binary.firstChild(4));
+    ASSERT_EQ(4, binary.nextSibling(1));
+    ASSERT_EQ(3, binary.nextSibling(2));
+    ASSERT_EQ(Binary::npos, binary.nextSibling(3));
+    ASSERT_EQ(Binary::npos, binary.nextSibling(0));
+    ASSERT_EQ(2, binary.childrenCount(0));
+    ASSERT_EQ(0, binary.childrenCount(2));
+    ASSERT_EQ(3, binary.subtreeSize(1));
+    ASSERT_EQ(4, binary.subtreeEnd(1));
+    ASSERT_TRUE(binary.isLeaf(2));
+    ASSERT_TRUE(binary.isChildOf(3, 1));
+    ASSERT_FALSE(binary.isChildOf(4, 1));
+}
+
+TEST(TestTreeItemBinary, materialize) {
+    std::srand(31);
+    TestBinaryItem * root = randomTree<TestBinaryItem>(5000);
+    std::size_t size = 0;
+    const std::vector<std::uint64_t> data = writeData(root, size);
+    Binary binary;
+    ASSERT_TRUE(binary.open(data.data(), size));
+    ASSERT_TRUE(binary.validate());
+    ASSERT_EQ(5000, binary.size());
+
+    TestBinaryItem * loaded = binary.materialize<TestBinaryItem>([](const TestPayload & payload) {
+        TestBinaryItem * item = new TestBinaryItem(payload.mMark);
+        item->mPayload = payload;
+        return item;
+    });
+    checkSameHierarchy(root, loaded);
+    ASSERT_EQ(10000, TestBinaryItem::instanceCreated);
+    delete loaded;
+
+    // the already made items are deleted if making of an item fails.
+    ASSERT_THROW(binary.materialize<TestBinaryItem>([](const TestPayload & payload) -> TestBinaryItem * {
+                     if (payload.mMark == 4000) {
+                         throw std::runtime_error("test");
+                     }
+                     return new TestBinaryItem(payload.mMark);
+                 }), std::runtime_error);
+    ASSERT_EQ(5000, TestBinaryItem::instanceCreated);
+    delete root;
+    ASSERT_EQ(0, TestBinaryItem::instanceCreated);
+}
+
+TEST(TestTreeItemBinary, invalidData) {
+    std::srand(37);
+    TestBinaryItem * root = randomTree<TestBinaryItem>(100);
+    std::size_t size = 0;
+    std::vector<std::uint64_t> data = writeData(root, size);
+    delete root;
+
+    Binary binary;
+    ASSERT_FALSE(binary.open(nullptr, size));
+    ASSERT_FALSE(binary.open(data.data(), size - 1));
+    ASSERT_FALSE(binary.open(reinterpret_cast<const char *>(data.data()) + 4, size - 4));
+    ASSERT_FALSE(binary.isOpen());
+    ASSERT_FALSE(TreeItemBinary<std::int32_t>(data.data(), size).isOpen());
+
+    std::vector<std::uint64_t> damaged = data;
+    reinterpret_cast<char *>(damaged.data())[0] = 'X';
+    ASSERT_FALSE(binary.open(damaged.data(), size));
+
+    for (std::size_t i = 1; i < 100; ++i) {
+        damaged = data;
+        // the subtree sizes start after the 24 bytes header.
+        std::uint32_t * subtreeSizes = reinterpret_cast<std::uint32_t *>(reinterpret_cast<char *>(damaged.data()) + 24);
+        subtreeSizes[i] += 1;
+        ASSERT_TRUE(binary.open(damaged.data(), size));
+        ASSERT_FALSE(binary.validate());
+    }
+    binary.close();
+    ASSERT_FALSE(binary.isOpen());
+    ASSERT_FALSE(binary.validate());
+}
+
+TEST(TestTreeItemBinary, deep) {
+    // the depth is enough for the stack overflow if the hierarchy is walked recursively.
+    const int depth = 500000;
+    TestBinaryItem * root = new TestBinaryItem(0);
+    TestBinaryItem * last = root;
+    for (int i = 1; i <= depth; ++i) {
+        last = last->appendChild(new TestBinaryItem(i));
+    }
+    std::size_t size = 0;
+    const std::vector<std::uint64_t> data = writeData(root, size);
+    const Binary binary(data.data(), size);
+    ASSERT_TRUE(binary.validate());
+    TestBinaryItem * loaded = binary.materialize<TestBinaryItem>([](const TestPayload & payload) {
+        return new TestBinaryItem(payload.mMark);
+    });
+    checkSameHierarchy(root, loaded);
+    delete root;
+    delete loaded;
+    ASSERT_EQ(0, TestBinaryItem::instanceCreated);
+}
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
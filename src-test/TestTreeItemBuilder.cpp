@@ -0,0 +1,236 @@
+/*
+**  Copyright(C) 2018, StepToSky
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  1.Redistributions of source code must retain the above copyright notice, this
+**    list of conditions and the following disclaimer.
+**  2.Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and / or other materials provided with the distribution.
+**  3.Neither the name of StepToSky nor the names of its contributors
+**    may be used to endorse or promote products derived from this software
+**    without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**  DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**  Contacts: www.steptosky.com
+*/
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <vector>
+#include "sts/tree/TreeItem.h"
+#include "sts/tree/TreeItemBuilder.h"
+
+using namespace sts::tree;
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+class TestBuilderItem : public TreeItem<TestBuilderItem> {
+public:
+
+    static int instanceCount;
+    int mMark;
+
+    explicit TestBuilderItem(const int inMark = 0)
+        : mMark(inMark) {
+        ++instanceCount;
+    }
+
+    ~TestBuilderItem() {
+        --instanceCount;
+    }
+
+};
+
+int TestBuilderItem::instanceCount = 0;
+
+typedef TreeItemBuilder<TestBuilderItem> Builder;
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+//----------------------------------------------
+//  +root (0)
+//      child0 (1)
+//          child00 (2)
+//          child01 (3)
+//      child1 (4)
+//      child2 (5)
+//          child20 (6)
+//----------------------------------------------
+TEST(TestTreeItemBuilder, structure) {
+    Builder builder;
+    ASSERT_FALSE(builder.isFinished());
+    ASSERT_EQ(nullptr, builder.take());
+
+    builder.enter(new TestBuilderItem(0));
+    builder.enter(new TestBuilderItem(1));
+    ASSERT_EQ(2, builder.depth());
+    ASSERT_EQ(1, builder.current()->mMark);
+    builder.leaf(new TestBuilderItem(2));
+    builder.leaf(new TestBuilderItem(3));
+    builder.leave();
+    builder.leaf(new TestBuilderItem(4));
+    builder.enter(new TestBuilderItem(5));
+    builder.leaf(new TestBuilderItem(6));
+    builder.leave();
+    ASSERT_FALSE(builder.isFinished());
+    builder.leave();
+    ASSERT_EQ(0, builder.depth());
+    ASSERT_EQ(nullptr, builder.current());
+    ASSERT_TRUE(builder.isFinished());
+
+    TestBuilderItem * root = builder.take();
+    ASSERT_FALSE(builder.isFinished());
+    ASSERT_TRUE(root->isRoot());
+    ASSERT_EQ(0, root->mMark);
+    ASSERT_EQ(3, root->childrenCount());
+    ASSERT_EQ(1, root->childAt(0)->mMark);
+    ASSERT_EQ(4, root->childAt(1)->mMark);
+    ASSERT_EQ(5, root->childAt(2)->mMark);
+    ASSERT_EQ(2, root->childAt(0)->childrenCount());
+    ASSERT_EQ(2, root->childAt(0)->childAt(0)->mMark);
+    ASSERT_EQ(3, root->childAt(0)->childAt(1)->mMark);
+    ASSERT_EQ(root->childAt(0), root->childAt(0)->childAt(1)->parent());
+    ASSERT_TRUE(root->childAt(1)->isLeaf());
+    ASSERT_EQ(1, root->childAt(2)->childrenCount());
+    ASSERT_EQ(6, root->childAt(2)->childAt(0)->mMark);
+    // the children list is allocated once with the exact size.
+    ASSERT_EQ(3, static_cast<const TestBuilderItem*>(root)->children().capacity());
+
+    delete root;
+    ASSERT_EQ(0, TestBuilderItem::instanceCount);
+}
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+TEST(TestTreeItemBuilder, deep) {
+    const int count = 500000;
+    Builder builder;
+    for (int i = 0; i < count; ++i) {
+        builder.enter(new TestBuilderItem(i));
+    }
+    ASSERT_EQ(Builder::Index(count), builder.depth());
+    while (builder.depth() != 0) {
+        builder.leave();
+    }
+    TestBuilderItem * root = builder.take();
+    const TestBuilderItem * item = root;
+    int depth = 0;
+    while (item->hasChildren()) {
+        item = item->childAt(0);
+        ++depth;
+    }
+    ASSERT_EQ(count - 1, depth);
+    ASSERT_EQ(count - 1, item->mMark);
+    delete root;
+    ASSERT_EQ(0, TestBuilderItem::instanceCount);
+}
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+TEST(TestTreeItemBuilder, emit) {
+    std::vector<int> emitted;
+    int maxInstances = 0;
+    Builder builder(1, [&](TestBuilderItem * subtree, TestBuilderItem * parent) {
+        EXPECT_TRUE(subtree->isRoot());
+        EXPECT_EQ(0, parent->mMark);
+        EXPECT_EQ(10, subtree->childrenCount());
+        maxInstances = std::max(maxInstances, TestBuilderItem::instanceCount);
+        emitted.push_back(subtree->mMark);
+        delete subtree;
+    });
+    ASSERT_EQ(1, builder.emitDepth());
+
+    builder.enter(new TestBuilderItem(0));
+    for (int i = 1; i <= 100; ++i) {
+        builder.enter(new TestBuilderItem(i));
+        for (int j = 0; j < 10; ++j) {
+            builder.leaf(new TestBuilderItem(-j));
+        }
+        builder.leave();
+    }
+    builder.leave();
+    // only the root and one its child with the children are in the memory at once.
+    ASSERT_EQ(12, maxInstances);
+    ASSERT_EQ(std::size_t(100), emitted.size());
+    ASSERT_EQ(100, emitted.back());
+
+    TestBuilderItem * root = builder.take();
+    ASSERT_TRUE(root->isLeaf());
+    delete root;
+    ASSERT_EQ(0, TestBuilderItem::instanceCount);
+}
+
+TEST(TestTreeItemBuilder, emitRoots) {
+    std::vector<TestBuilderItem*> roots;
+    Builder builder(0, [&](TestBuilderItem * subtree, TestBuilderItem * parent) {
+        EXPECT_EQ(nullptr, parent);
+        roots.push_back(subtree);
+    });
+
+    builder.enter(new TestBuilderItem(0));
+    builder.leaf(new TestBuilderItem(1));
+    builder.leave();
+    builder.leaf(new TestBuilderItem(2));
+    ASSERT_FALSE(builder.isFinished());
+    ASSERT_EQ(nullptr, builder.take());
+
+    ASSERT_EQ(std::size_t(2), roots.size());
+    ASSERT_EQ(1, roots[0]->childrenCount());
+    ASSERT_TRUE(roots[1]->isLeaf());
+    for (auto & it : roots) {
+        delete it;
+    }
+    ASSERT_EQ(0, TestBuilderItem::instanceCount);
+}
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+TEST(TestTreeItemBuilder, unfinished) {
+    {
+        Builder builder;
+        builder.enter(new TestBuilderItem(0));
+        builder.enter(new TestBuilderItem(1));
+        builder.leaf(new TestBuilderItem(2));
+        builder.leave();
+        builder.enter(new TestBuilderItem(3));
+        builder.leaf(new TestBuilderItem(4));
+        ASSERT_EQ(5, TestBuilderItem::instanceCount);
+    }
+    ASSERT_EQ(0, TestBuilderItem::instanceCount);
+
+    Builder builder;
+    builder.enter(new TestBuilderItem(0));
+    builder.leaf(new TestBuilderItem(1));
+    builder.clear();
+    ASSERT_EQ(0, TestBuilderItem::instanceCount);
+    builder.leaf(new TestBuilderItem(2));
+    TestBuilderItem * root = builder.take();
+    ASSERT_EQ(2, root->mMark);
+    delete root;
+}
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
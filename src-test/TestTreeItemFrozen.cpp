@@ -0,0 +1,167 @@
+/*
+**  Copyright(C) 2018, StepToSky
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  1.Redistributions of source code must retain the above copyright notice, this
+**    list of conditions and the following disclaimer.
+**  2.Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and / or other materials provided with the distribution.
+**  3.Neither the name of StepToSky nor the names of its contributors
+**    may be used to endorse or promote products derived from this software
+**    without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**  DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**  Contacts: www.steptosky.com
+*/
+#include "gtest/gtest.h"
+#include <cstdlib>
+#include <vector>
+#include "sts/tree/TreeItem.h"
+#include "sts/tree/TreeItemFrozen.h"
+#include "TestTreeItemRandom.h"
+
+using namespace sts::tree;
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+class TestFrozenItem : public TreeItem<TestFrozenItem> {
+public:
+
+    int mMark;
+
+    explicit TestFrozenItem(const int inMark = 0)
+        : mMark(inMark) {}
+
+};
+
+typedef TreeItemFrozen<TestFrozenItem, int> Frozen;
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+//----------------------------------------------
+//  +root (0)
+//      child0 (1)
+//          child00 (2)
+//          child01 (3)
+//      child1 (4)
+//----------------------------------------------
+TEST(TestTreeItemFrozen, layout) {
+    TestFrozenItem * root = new TestFrozenItem(10);
+    TestFrozenItem * child0 = root->appendChild(new TestFrozenItem(11));
+    TestFrozenItem * child1 = root->appendChild(new TestFrozenItem(14));
+    TestFrozenItem * child00 = child0->appendChild(new TestFrozenItem(12));
+    TestFrozenItem * child01 = child0->appendChild(new TestFrozenItem(13));
+
+    const Frozen frozen = freeze(root, [](const TestFrozenItem * item) { return item->mMark; });
+    ASSERT_EQ(5, frozen.size());
+    ASSERT_EQ(std::vector<int>({10, 11, 12, 13, 14}), frozen.payloads());
+    ASSERT_EQ(std::vector<const TestFrozenItem*>({root, child0, child00, child01, child1}), frozen.items());
+    ASSERT_EQ(std::vector<Frozen::Index>({Frozen::npos, 0, 1, 1, 0}), frozen.parents());
+    ASSERT_EQ(std::vector<Frozen::Index>({5, 3, 1, 1, 1}), frozen.subtreeSizes());
+    ASSERT_EQ(std::vector<Frozen::Index>({0, 1, 2, 2, 1}), frozen.depths());
+
+    ASSERT_EQ(1, frozen.firstChild(0));
+    ASSERT_EQ(2, frozen.firstChild(1));
+    ASSERT_EQ(Frozen::npos, frozen.firstChild(2));
+    ASSERT_EQ(4, frozen.nextSibling(1));
+    ASSERT_EQ(3, frozen.nextSibling(2));
+    ASSERT_EQ(Frozen::npos, frozen.nextSibling(3));
+    ASSERT_EQ(Frozen::npos, frozen.nextSibling(4));
+    ASSERT_EQ(Frozen::npos, frozen.nextSibling(0));
+    ASSERT_EQ(4, frozen.subtreeEnd(1));
+    ASSERT_TRUE(frozen.isLeaf(4));
+    ASSERT_FALSE(frozen.isLeaf(1));
+
+    ASSERT_TRUE(frozen.isChildOf(3, 0));
+    ASSERT_TRUE(frozen.isChildOf(3, 1));
+    ASSERT_FALSE(frozen.isChildOf(4, 1));
+    ASSERT_FALSE(frozen.isChildOf(1, 1));
+    ASSERT_FALSE(frozen.isChildOf(0, 1));
+
+    // subtree only
+    Frozen subtree(child0, [](const TestFrozenItem * item) { return -item->mMark; });
+    ASSERT_EQ(3, subtree.size());
+    ASSERT_EQ(-11, subtree.payload(0));
+    ASSERT_EQ(Frozen::npos, subtree.parent(0));
+    ASSERT_EQ(child01, subtree.item(2));
+    subtree.payload(2) = 7;
+    ASSERT_EQ(7, subtree.payloads()[2]);
+    subtree.clear();
+    ASSERT_TRUE(subtree.empty());
+
+    delete root;
+}
+
+TEST(TestTreeItemFrozen, randomTree) {
+    std::srand(29);
+    std::vector<TestFrozenItem*> items;
+    TestFrozenItem * root = randomTree(3000, &items);
+    const Frozen frozen(root, [](const TestFrozenItem * item) { return item->mMark; });
+    ASSERT_EQ(items.size(), frozen.size());
+
+    for (Frozen::Index i = 0; i < frozen.size(); ++i) {
+        const TestFrozenItem * item = frozen.item(i);
+        ASSERT_EQ(item->mMark, frozen.payload(i));
+        if (i == 0) {
+            ASSERT_EQ(Frozen::npos, frozen.parent(i));
+        }
+        else {
+            ASSERT_EQ(item->parent(), frozen.item(frozen.parent(i)));
+            ASSERT_EQ(frozen.depth(frozen.parent(i)) + 1, frozen.depth(i));
+        }
+        // the children in the same order
+        std::size_t childIndex = 0;
+        for (Frozen::Index child = frozen.firstChild(i); child != Frozen::npos; child = frozen.nextSibling(child)) {
+            ASSERT_EQ(item->childAt(childIndex++), frozen.item(child));
+        }
+        ASSERT_EQ(item->childrenCount(), childIndex);
+    }
+
+    for (int i = 0; i < 20000; ++i) {
+        const Frozen::Index a = std::size_t(std::rand()) % frozen.size();
+        const Frozen::Index b = std::size_t(std::rand()) % frozen.size();
+        ASSERT_EQ(frozen.item(a)->isChildOf(frozen.item(b)), frozen.isChildOf(a, b));
+    }
+    delete root;
+}
+
+TEST(TestTreeItemFrozen, deep) {
+    // the depth is enough for the stack overflow if the hierarchy is walked recursively.
+    const int depth = 500000;
+    TestFrozenItem * root = new TestFrozenItem(0);
+    TestFrozenItem * last = root;
+    for (int i = 1; i <= depth; ++i) {
+        last = last->appendChild(new TestFrozenItem(i));
+    }
+    const Frozen frozen = freeze(root, [](const TestFrozenItem * item) { return item->mMark; });
+    ASSERT_EQ(std::size_t(depth + 1), frozen.size());
+    ASSERT_EQ(std::size_t(depth + 1), frozen.subtreeSize(0));
+    ASSERT_EQ(std::size_t(depth), frozen.depth(depth));
+    ASSERT_TRUE(frozen.isChildOf(depth, 0));
+    delete root;
+}
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
@@ -0,0 +1,264 @@
+/*
+**  Copyright(C) 2017, StepToSky
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  1.Redistributions of source code must retain the above copyright notice, this
+**    list of conditions and the following disclaimer.
+**  2.Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and / or other materials provided with the distribution.
+**  3.Neither the name of StepToSky nor the names of its contributors
+**    may be used to endorse or promote products derived from this software
+**    without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**  DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**  Contacts: www.steptosky.com
+*/
+
+#include "gtest/gtest.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <vector>
+#include "sts/tree/TreeItem.h"
+
+using namespace sts::tree;
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+/*
+ * The global operators new and delete count the allocations, so the tests can check that linking doesn't allocate.
+ * The behaviour shared with the other containers is tested in TestTreeItemSlotContainers.cpp.
+ */
+namespace {
+    std::atomic<std::size_t> gAllocations(0);
+
+    void * testAllocate(const std::size_t size) {
+        gAllocations.fetch_add(1, std::memory_order_relaxed);
+        void * ptr = std::malloc(size != 0 ? size : 1);
+        if (!ptr) {
+            throw std::bad_alloc();
+        }
+        return ptr;
+    }
+}
+
+void * operator new(const std::size_t size) {
+    return testAllocate(size);
+}
+
+void * operator new[](const std::size_t size) {
+    return testAllocate(size);
+}
+
+void operator delete(void * ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void * ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void * ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void * ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+class TestTreeItemIntrusive : public TreeItem<TestTreeItemIntrusive, TreeItemContainerIntrusiveList<TestTreeItemIntrusive>> {
+    typedef TreeItem<TestTreeItemIntrusive, TreeItemContainerIntrusiveList<TestTreeItemIntrusive>> Base;
+public:
+
+    static int instanceCreated;
+    int mMark;
+
+    TestTreeItemIntrusive & operator =(const TestTreeItemIntrusive & input) {
+        Base::operator=(input);
+        mMark = input.mMark;
+        return *this;
+    }
+
+    TestTreeItemIntrusive & operator =(TestTreeItemIntrusive && input) {
+        Base::operator=(std::move(input));
+        mMark = input.mMark;
+        return *this;
+    }
+
+    TestTreeItemIntrusive * clone() const override {
+        return new TestTreeItemIntrusive(*this);
+    }
+
+    TestTreeItemIntrusive(int inMark = -1)
+        : mMark(inMark) {
+        ++instanceCreated;
+    }
+
+    TestTreeItemIntrusive(const TestTreeItemIntrusive & inTreeItem)
+        : Base(inTreeItem),
+          mMark(inTreeItem.mMark) {
+        ++instanceCreated;
+    }
+
+    ~TestTreeItemIntrusive() {
+        --instanceCreated;
+    }
+
+};
+
+int TestTreeItemIntrusive::instanceCreated = 0;
+
+typedef TreeItemContainerIntrusiveList<TestTreeItemIntrusive> IntrusiveList;
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+/*
+ * Marks of the children from the first to the last one by the sibling links,
+ * the backward links and the parents are checked meanwhile.
+ */
+std::vector<int> siblingMarks(const TestTreeItemIntrusive * parent) {
+    std::vector<int> marks;
+    const TestTreeItemIntrusive * previous = nullptr;
+    for (const TestTreeItemIntrusive * item = parent->children().front(); item; item = IntrusiveList::next(item)) {
+        EXPECT_TRUE(IntrusiveList::previous(item) == previous);
+        EXPECT_TRUE(item->parent() == parent);
+        marks.push_back(item->mMark);
+        previous = item;
+    }
+    EXPECT_TRUE(parent->children().back() == previous);
+    EXPECT_EQ(parent->childrenCount(), marks.size());
+    return marks;
+}
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+TEST(TestTreeItemIntrusive, linkingWithoutAllocation) {
+    TestTreeItemIntrusive * treeRoot0 = new TestTreeItemIntrusive(0);
+    TestTreeItemIntrusive * treeRoot1 = new TestTreeItemIntrusive(10);
+    TestTreeItemIntrusive * treeRoot2 = new TestTreeItemIntrusive(20);
+    std::vector<TestTreeItemIntrusive*> items;
+    for (int i = 1; i <= 5; ++i) {
+        items.push_back(new TestTreeItemIntrusive(i));
+    }
+    //---------------------------------
+    std::size_t allocations = gAllocations.load();
+    treeRoot0->appendChild(items[1]);
+    treeRoot0->prependChild(items[0]);
+    treeRoot0->appendChild(items[3]);
+    treeRoot0->insertChild(2, items[2]);
+    treeRoot0->insertChild(4, items[4]);
+    ASSERT_EQ(allocations, gAllocations.load());
+    ASSERT_EQ(std::vector<int>({1, 2, 3, 4, 5}), siblingMarks(treeRoot0));
+    //---------------------------------
+    allocations = gAllocations.load();
+    items[2]->setParent(treeRoot1);
+    ASSERT_TRUE(treeRoot0->takeChildAt(0) == items[0]);
+    treeRoot1->prependChild(items[0]);
+    ASSERT_TRUE(treeRoot0->takeChildAt(treeRoot0->indexOf(items[4])) == items[4]);
+    items[2]->appendChild(items[4]);
+    *treeRoot2 = std::move(*treeRoot0);
+    ASSERT_EQ(allocations, gAllocations.load());
+    //---------------------------------
+    ASSERT_EQ(std::vector<int>({2, 4}), siblingMarks(treeRoot2));
+    ASSERT_EQ(std::vector<int>({1, 3}), siblingMarks(treeRoot1));
+    ASSERT_EQ(std::vector<int>({5}), siblingMarks(items[2]));
+    ASSERT_FALSE(treeRoot0->hasChildren());
+    ASSERT_EQ(8, TestTreeItemIntrusive::instanceCreated);
+    delete treeRoot0;
+    delete treeRoot1;
+    delete treeRoot2;
+    ASSERT_EQ(0, TestTreeItemIntrusive::instanceCreated);
+}
+
+TEST(TestTreeItemIntrusive, siblingStepping) {
+    TestTreeItemIntrusive * treeRoot = new TestTreeItemIntrusive(0);
+    std::vector<TestTreeItemIntrusive*> items;
+    for (int i = 1; i <= 5; ++i) {
+        items.push_back(treeRoot->appendChild(new TestTreeItemIntrusive(i)));
+    }
+    ASSERT_TRUE(IntrusiveList::previous(items[0]) == nullptr);
+    ASSERT_TRUE(IntrusiveList::next(items[4]) == nullptr);
+    ASSERT_TRUE(IntrusiveList::next(items[1]) == items[2]);
+    ASSERT_TRUE(IntrusiveList::previous(items[3]) == items[2]);
+    //---------------------------------
+    // the neighbours of a removed item are linked with each other
+    delete items[2];
+    ASSERT_TRUE(IntrusiveList::next(items[1]) == items[3]);
+    ASSERT_TRUE(IntrusiveList::previous(items[3]) == items[1]);
+    treeRoot->takeChildAt(0)->setParent(items[4]);
+    ASSERT_TRUE(IntrusiveList::previous(items[1]) == nullptr);
+    ASSERT_TRUE(treeRoot->childAt(0) == items[1]);
+    ASSERT_TRUE(IntrusiveList::next(items[0]) == nullptr);
+    ASSERT_TRUE(IntrusiveList::previous(items[0]) == nullptr);
+    ASSERT_EQ(std::vector<int>({2, 4, 5}), siblingMarks(treeRoot));
+    ASSERT_EQ(std::vector<int>({1}), siblingMarks(items[4]));
+    //---------------------------------
+    // a long list is stepped without indices
+    for (int i = 0; i < 100000; ++i) {
+        items[0]->appendChild(new TestTreeItemIntrusive(i));
+    }
+    int count = 0;
+    for (const TestTreeItemIntrusive * item = items[0]->childAt(0); item; item = IntrusiveList::next(item)) {
+        ASSERT_EQ(count++, item->mMark);
+    }
+    ASSERT_EQ(100000, count);
+    delete treeRoot;
+    ASSERT_EQ(0, TestTreeItemIntrusive::instanceCreated);
+}
+
+TEST(TestTreeItemIntrusive, copyOperator) {
+    TestTreeItemIntrusive * treeRoot = new TestTreeItemIntrusive(0);
+    treeRoot->appendChild(new TestTreeItemIntrusive(1))->appendChild(new TestTreeItemIntrusive(3));
+    treeRoot->appendChild(new TestTreeItemIntrusive(2));
+    TestTreeItemIntrusive * treeForCopy = new TestTreeItemIntrusive(10);
+    treeForCopy->appendChild(new TestTreeItemIntrusive(11));
+    treeForCopy->appendChild(new TestTreeItemIntrusive(12));
+    ASSERT_EQ(7, TestTreeItemIntrusive::instanceCreated);
+    //---------------------------------
+    // the clones' list is swapped in, the old children are deleted
+    *treeForCopy = *treeRoot;
+    ASSERT_EQ(8, TestTreeItemIntrusive::instanceCreated);
+    ASSERT_EQ(0, treeForCopy->mMark);
+    ASSERT_EQ(std::vector<int>({1, 2}), siblingMarks(treeForCopy));
+    ASSERT_EQ(std::vector<int>({3}), siblingMarks(treeForCopy->childAt(0)));
+    ASSERT_EQ(std::vector<int>({1, 2}), siblingMarks(treeRoot));
+    ASSERT_TRUE(treeForCopy->childAt(0) != treeRoot->childAt(0));
+    //---------------------------------
+    // the copied hierarchy contains the item
+    TestTreeItemIntrusive * tree2 = treeRoot->childAt(1);
+    *tree2 = *treeRoot;
+    ASSERT_EQ(11, TestTreeItemIntrusive::instanceCreated);
+    ASSERT_EQ(std::vector<int>({1, 0}), siblingMarks(treeRoot)); // the mark is copied from the root
+    ASSERT_EQ(std::vector<int>({1, 2}), siblingMarks(tree2));
+    ASSERT_TRUE(tree2->childAt(1)->isLeaf());
+    delete treeRoot;
+    delete treeForCopy;
+    ASSERT_EQ(0, TestTreeItemIntrusive::instanceCreated);
+}
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
@@ -0,0 +1,274 @@
+/*
+**  Copyright(C) 2018, StepToSky
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  1.Redistributions of source code must retain the above copyright notice, this
+**    list of conditions and the following disclaimer.
+**  2.Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and / or other materials provided with the distribution.
+**  3.Neither the name of StepToSky nor the names of its contributors
+**    may be used to endorse or promote products derived from this software
+**    without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**  DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**  Contacts: www.steptosky.com
+*/
+#include "gtest/gtest.h"
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "sts/tree/TreeItem.h"
+#include "sts/tree/TreeItemKeyIndex.h"
+
+using namespace sts::tree;
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+class TestKeyItem;
+
+struct TestKeyItemName {
+    typedef std::string Key;
+    static const Key & key(const TestKeyItem * item);
+};
+
+class TestKeyItem : public TreeItemKeyIndex<TestKeyItem, TestKeyItemName> {
+public:
+
+    static int instanceCreated;
+    std::string mName;
+
+    explicit TestKeyItem(const std::string & inName)
+        : mName(inName) {
+        ++instanceCreated;
+    }
+
+    TestKeyItem(const TestKeyItem & copy)
+        : TreeItemKeyIndex<TestKeyItem, TestKeyItemName>(copy),
+          mName(copy.mName) {
+        ++instanceCreated;
+    }
+
+    TestKeyItem & operator =(const TestKeyItem & copy) {
+        TreeItemKeyIndex<TestKeyItem, TestKeyItemName>::operator=(copy);
+        mName = copy.mName;
+        keyChanged();
+        return *this;
+    }
+
+    ~TestKeyItem() {
+        --instanceCreated;
+    }
+
+    TestKeyItem * clone() const override {
+        return new TestKeyItem(*this);
+    }
+
+};
+
+int TestKeyItem::instanceCreated = 0;
+
+const TestKeyItemName::Key & TestKeyItemName::key(const TestKeyItem * item) {
+    return item->mName;
+}
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+/*
+ * Finds the child by the linear search.
+ */
+const TestKeyItem * scanChild(const TestKeyItem * item, const std::string & name) {
+    for (auto & it : item->children()) {
+        if (it->mName == name) {
+            return it;
+        }
+    }
+    return nullptr;
+}
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+//----------------------------------------------
+//  +root
+//      a
+//          b
+//              c
+//      d
+//----------------------------------------------
+TEST(TestTreeItemKeyIndex, childByKey) {
+    TestKeyItem * root = new TestKeyItem("root");
+    TestKeyItem * a = root->appendChild(new TestKeyItem("a"));
+    TestKeyItem * b = a->appendChild(new TestKeyItem("b"));
+    TestKeyItem * c = b->appendChild(new TestKeyItem("c"));
+    TestKeyItem * d = root->appendChild(new TestKeyItem("d"));
+
+    ASSERT_EQ(a, root->childByKey("a"));
+    ASSERT_EQ(d, root->childByKey("d"));
+    ASSERT_EQ(nullptr, root->childByKey("b"));
+    ASSERT_EQ(nullptr, c->childByKey("a"));
+    ASSERT_EQ(b, static_cast<const TestKeyItem*>(a)->childByKey("b"));
+
+    const std::vector<std::string> path = {"a", "b", "c"};
+    ASSERT_EQ(c, root->childByPath(path.begin(), path.end()));
+    ASSERT_EQ(b, static_cast<const TestKeyItem*>(root)->childByPath(path.begin(), path.end() - 1));
+    ASSERT_EQ(root, root->childByPath(path.begin(), path.begin()));
+    const std::vector<std::string> wrongPath = {"a", "c", "b"};
+    ASSERT_EQ(nullptr, root->childByPath(wrongPath.begin(), wrongPath.end()));
+
+    delete root;
+    ASSERT_EQ(0, TestKeyItem::instanceCreated);
+}
+
+TEST(TestTreeItemKeyIndex, changes) {
+    TestKeyItem * root = new TestKeyItem("root");
+    TestKeyItem * other = new TestKeyItem("other");
+    TestKeyItem * a = root->appendChild(new TestKeyItem("a"));
+    ASSERT_EQ(a, root->childByKey("a"));
+    ASSERT_EQ(nullptr, other->childByKey("a"));
+
+    TestKeyItem * b = root->insertChild(0, new TestKeyItem("b"));
+    TestKeyItem * c = root->prependChild(new TestKeyItem("c"));
+    ASSERT_EQ(b, root->childByKey("b"));
+    ASSERT_EQ(c, root->childByKey("c"));
+
+    a->setParent(other);
+    ASSERT_EQ(nullptr, root->childByKey("a"));
+    ASSERT_EQ(a, other->childByKey("a"));
+
+    ASSERT_EQ(c, root->takeChildAt(0));
+    ASSERT_EQ(nullptr, root->childByKey("c"));
+    other->appendChild(c);
+    ASSERT_EQ(c, other->childByKey("c"));
+
+    other->deleteChild(c);
+    ASSERT_EQ(nullptr, other->childByKey("c"));
+    delete a;
+    ASSERT_EQ(nullptr, other->childByKey("a"));
+
+    a = root->appendChild(new TestKeyItem("a"));
+    a->mName = "e";
+    a->keyChanged();
+    ASSERT_EQ(nullptr, root->childByKey("a"));
+    ASSERT_EQ(a, root->childByKey("e"));
+
+    root->deleteChildren();
+    ASSERT_EQ(nullptr, root->childByKey("b"));
+    ASSERT_EQ(nullptr, root->childByKey("e"));
+
+    delete other;
+    delete root;
+    ASSERT_EQ(0, TestKeyItem::instanceCreated);
+}
+
+TEST(TestTreeItemKeyIndex, sameKeys) {
+    TestKeyItem root("root");
+    TestKeyItem * a0 = root.appendChild(new TestKeyItem("a"));
+    TestKeyItem * a1 = root.appendChild(new TestKeyItem("a"));
+    const TestKeyItem * found = root.childByKey("a");
+    ASSERT_TRUE(found == a0 || found == a1);
+    root.deleteChild(a0);
+    ASSERT_EQ(a1, root.childByKey("a"));
+    root.deleteChild(a1);
+    ASSERT_EQ(nullptr, root.childByKey("a"));
+}
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+TEST(TestTreeItemKeyIndex, randomChanges) {
+    std::srand(29);
+    std::vector<TestKeyItem*> items(1, new TestKeyItem("root"));
+    TestKeyItem * root = items.front();
+    for (int i = 0; i < 2000; ++i) {
+        TestKeyItem * item = items[std::size_t(std::rand()) % items.size()];
+        const std::string name = std::to_string(std::rand() % 50);
+        switch (std::rand() % 4) {
+            case 0:
+            case 1: {
+                items.push_back(item->appendChild(new TestKeyItem(name)));
+                break;
+            }
+            case 2: {
+                TestKeyItem * parent = items[std::size_t(std::rand()) % items.size()];
+                if (item != root && parent != item && !parent->isChildOf(item)) {
+                    item->setParent(parent);
+                }
+                break;
+            }
+            default: {
+                if (item != root) {
+                    item->mName = name;
+                    item->keyChanged();
+                }
+                break;
+            }
+        }
+        const TestKeyItem * checked = items[std::size_t(std::rand()) % items.size()];
+        for (int k = 0; k < 50; ++k) {
+            const std::string key = std::to_string(k);
+            const TestKeyItem * found = checked->childByKey(key);
+            ASSERT_EQ(scanChild(checked, key) == nullptr, found == nullptr);
+            if (found) {
+                ASSERT_EQ(key, found->mName);
+                ASSERT_EQ(checked, found->parent());
+            }
+        }
+    }
+    delete root;
+    ASSERT_EQ(0, TestKeyItem::instanceCreated);
+}
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+TEST(TestTreeItemKeyIndex, copy) {
+    TestKeyItem * root = new TestKeyItem("root");
+    root->appendChild(new TestKeyItem("a"))->appendChild(new TestKeyItem("b"));
+    root->appendChild(new TestKeyItem("c"));
+    ASSERT_TRUE(root->childByKey("a") != nullptr);
+
+    TestKeyItem * copy = root->clone();
+    const std::vector<std::string> path = {"a", "b"};
+    ASSERT_TRUE(copy->childByPath(path.begin(), path.end()) != nullptr);
+    ASSERT_NE(root->childByPath(path.begin(), path.end()), copy->childByPath(path.begin(), path.end()));
+    ASSERT_EQ(copy, copy->childByKey("c")->parent());
+
+    // the copy operator replaces the children of the item with the made table and changes the key.
+    TestKeyItem * c = root->childByKey("c");
+    *c = *root->childByKey("a");
+    ASSERT_TRUE(c->childByKey("b") != nullptr);
+    ASSERT_EQ(nullptr, root->childByKey("c"));
+    ASSERT_EQ("a", root->childByKey("a")->mName);
+    *copy = *c;
+    ASSERT_EQ(nullptr, copy->childByKey("a"));
+    ASSERT_EQ(nullptr, copy->childByKey("c"));
+    ASSERT_TRUE(copy->childByKey("b") != nullptr);
+
+    delete copy;
+    delete root;
+    ASSERT_EQ(0, TestKeyItem::instanceCreated);
+}
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
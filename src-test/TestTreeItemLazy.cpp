@@ -0,0 +1,364 @@
+/*
+**  Copyright(C) 2018, StepToSky
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  1.Redistributions of source code must retain the above copyright notice, this
+**    list of conditions and the following disclaimer.
+**  2.Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and / or other materials provided with the distribution.
+**  3.Neither the name of StepToSky nor the names of its contributors
+**    may be used to endorse or promote products derived from this software
+**    without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**  DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**  Contacts: www.steptosky.com
+*/
+#include "gtest/gtest.h"
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+#include "sts/tree/TreeItem.h"
+#include "sts/tree/TreeItemLazy.h"
+#include "sts/tree/TreeItemParallel.h"
+#include "sts/tree/TreeItemTraversal.h"
+
+using namespace sts::tree;
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+/*
+ * Each item has 3 children up to the max level like a directory tree which is read on demand.
+ * The counters are atomic because the items are loaded by several threads in the parallel test.
+ */
+class TestLazyItem : public TreeItemLazy<TestLazyItem> {
+public:
+
+    static std::atomic<int> instanceCreated;
+    static std::atomic<int> loadCalled;
+    static std::atomic<int> throwingAfter;
+    static const int maxLevel = 4;
+    static const int childrenPerItem = 3;
+
+    int mLevel;
+    int mMark;
+
+    explicit TestLazyItem(const int inLevel = 0, const int inMark = 0)
+        : mLevel(inLevel),
+          mMark(inMark) {
+        ++instanceCreated;
+        if (mLevel < maxLevel) {
+            markUnloaded();
+        }
+    }
+
+    TestLazyItem(const TestLazyItem & copy)
+        : TreeItemLazy<TestLazyItem>(copy),
+          mLevel(copy.mLevel),
+          mMark(copy.mMark) {
+        ++instanceCreated;
+    }
+
+    TestLazyItem(TestLazyItem && other)
+        : TreeItemLazy<TestLazyItem>(std::move(other)),
+          mLevel(other.mLevel),
+          mMark(other.mMark) {
+        ++instanceCreated;
+    }
+
+    ~TestLazyItem() {
+        --instanceCreated;
+    }
+
+    TestLazyItem * clone() const override {
+        return new TestLazyItem(*this);
+    }
+
+protected:
+
+    void loadChildren() override {
+        ++loadCalled;
+        for (int i = 0; i < childrenPerItem; ++i) {
+            if (throwingAfter == 0) {
+                throw std::runtime_error("can't load");
+            }
+            --throwingAfter;
+            appendChild(new TestLazyItem(mLevel + 1, mMark * 10 + i));
+        }
+    }
+
+};
+
+std::atomic<int> TestLazyItem::instanceCreated(0);
+std::atomic<int> TestLazyItem::loadCalled(0);
+std::atomic<int> TestLazyItem::throwingAfter(-1);
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+TEST(TestTreeItemLazy, load) {
+    TestLazyItem::loadCalled = 0;
+    TestLazyItem * root = new TestLazyItem(0, 1);
+    ASSERT_FALSE(root->isLoaded());
+    ASSERT_EQ(1, TestLazyItem::instanceCreated);
+
+    ASSERT_EQ(3, root->childrenCount());
+    ASSERT_TRUE(root->isLoaded());
+    ASSERT_EQ(1, TestLazyItem::loadCalled);
+    ASSERT_EQ(4, TestLazyItem::instanceCreated);
+
+    // only the visited path is loaded.
+    const TestLazyItem * item = root->childAt(1)->childAt(2)->childAt(0);
+    ASSERT_EQ(1120, item->mMark);
+    ASSERT_EQ(3, item->mLevel);
+    ASSERT_FALSE(item->isLoaded());
+    ASSERT_EQ(3, TestLazyItem::loadCalled);
+    ASSERT_EQ(10, TestLazyItem::instanceCreated);
+    ASSERT_EQ(root, item->root());
+    ASSERT_TRUE(item->isChildOf(root));
+
+    // the leaf's loader makes nothing.
+    const TestLazyItem * leaf = item->childAt(0);
+    ASSERT_EQ(4, leaf->mLevel);
+    ASSERT_TRUE(leaf->isLoaded());
+    ASSERT_TRUE(leaf->isLeaf());
+    ASSERT_FALSE(leaf->hasChildren());
+
+    delete root;
+    ASSERT_EQ(0, TestLazyItem::instanceCreated);
+}
+
+TEST(TestTreeItemLazy, loadByAccess) {
+    TestLazyItem::loadCalled = 0;
+    TestLazyItem * root = new TestLazyItem(0, 1);
+    TestLazyItem * item = new TestLazyItem(0, 1);
+    ASSERT_TRUE(item->hasChildren());
+    ASSERT_TRUE(item->isLoaded());
+    delete item;
+
+    item = new TestLazyItem(0, 1);
+    ASSERT_FALSE(item->isLeaf());
+    ASSERT_TRUE(item->isLoaded());
+    delete item;
+
+    item = new TestLazyItem(0, 1);
+    ASSERT_TRUE(item->isBranch());
+    ASSERT_TRUE(item->isLoaded());
+    delete item;
+
+    item = new TestLazyItem(0, 1);
+    int count = 0;
+    for (auto & it : static_cast<const TestLazyItem*>(item)->children()) {
+        ASSERT_EQ(item, it->parent());
+        ++count;
+    }
+    ASSERT_EQ(3, count);
+    delete item;
+
+    // the new child is added after the loaded ones.
+    item = new TestLazyItem(0, 1);
+    item->appendChild(new TestLazyItem(4, 99));
+    ASSERT_EQ(4, item->childrenCount());
+    ASSERT_EQ(99, item->childAt(3)->mMark);
+    delete item;
+
+    item = new TestLazyItem(4, 99);
+    item->setParent(root);
+    ASSERT_TRUE(root->isLoaded());
+    ASSERT_EQ(4, root->childrenCount());
+    ASSERT_EQ(item, root->childAt(3));
+
+    item = new TestLazyItem(4, 98);
+    TestLazyItem * other = new TestLazyItem(0, 2);
+    TestLazyItem * children[] = {item};
+    other->insertChildren(0, std::begin(children), std::end(children));
+    ASSERT_EQ(4, other->childrenCount());
+    ASSERT_EQ(item, other->childAt(0));
+    delete other;
+
+    ASSERT_EQ(7, TestLazyItem::loadCalled);
+    delete root;
+    ASSERT_EQ(0, TestLazyItem::instanceCreated);
+}
+
+TEST(TestTreeItemLazy, deleteChildren) {
+    TestLazyItem::loadCalled = 0;
+    TestLazyItem * root = new TestLazyItem(0, 1);
+    root->deleteChildren();
+    ASSERT_TRUE(root->isLoaded());
+    ASSERT_EQ(0, root->childrenCount());
+    ASSERT_EQ(0, TestLazyItem::loadCalled);
+    delete root;
+    ASSERT_EQ(0, TestLazyItem::instanceCreated);
+}
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+TEST(TestTreeItemLazy, traversals) {
+    // 1 + 3 + 9 + 27 + 81 items, the items of the levels 0-3 are loaded.
+    const int itemsCount = 121;
+    const int loadingCount = 40;
+    TestLazyItem::loadCalled = 0;
+    TestLazyItem * root = new TestLazyItem(0, 1);
+
+    int count = 0;
+    for (TestLazyItem * item : preorder(root)) {
+        ASSERT_TRUE(item->isRoot() || item->parent()->isLoaded());
+        ++count;
+    }
+    ASSERT_EQ(itemsCount, count);
+    ASSERT_EQ(itemsCount, TestLazyItem::instanceCreated);
+    ASSERT_EQ(loadingCount, TestLazyItem::loadCalled);
+
+    root->unload();
+    ASSERT_EQ(1, TestLazyItem::instanceCreated);
+    count = 0;
+    int level = 0;
+    for (const TestLazyItem * item : levelorder(static_cast<const TestLazyItem*>(root))) {
+        ASSERT_LE(level, item->mLevel);
+        level = item->mLevel;
+        ++count;
+    }
+    ASSERT_EQ(itemsCount, count);
+    ASSERT_EQ(int(TestLazyItem::maxLevel), level);
+    ASSERT_EQ(loadingCount * 2, TestLazyItem::loadCalled);
+
+    root->unload();
+    ASSERT_EQ(1, TestLazyItem::instanceCreated);
+    std::atomic<int> visited(0);
+    parallelForEach(root, [&visited](TestLazyItem *) { ++visited; }, 4, 4);
+    ASSERT_EQ(itemsCount, visited);
+    ASSERT_EQ(itemsCount, TestLazyItem::instanceCreated);
+    ASSERT_EQ(loadingCount * 3, TestLazyItem::loadCalled);
+
+    delete root;
+    ASSERT_EQ(0, TestLazyItem::instanceCreated);
+}
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+TEST(TestTreeItemLazy, unload) {
+    TestLazyItem::loadCalled = 0;
+    TestLazyItem * root = new TestLazyItem(0, 1);
+    TestLazyItem * child = root->childAt(0);
+    child->childAt(0)->childAt(0);
+    ASSERT_EQ(10, TestLazyItem::instanceCreated);
+
+    child->unload();
+    ASSERT_FALSE(child->isLoaded());
+    ASSERT_EQ(4, TestLazyItem::instanceCreated);
+    child->unload();
+    ASSERT_EQ(4, TestLazyItem::instanceCreated);
+
+    // the children are made again.
+    ASSERT_EQ(100, child->childAt(0)->mMark);
+    ASSERT_EQ(7, TestLazyItem::instanceCreated);
+    ASSERT_EQ(4, TestLazyItem::loadCalled);
+
+    delete root;
+    ASSERT_EQ(0, TestLazyItem::instanceCreated);
+}
+
+TEST(TestTreeItemLazy, unloadIf) {
+    TestLazyItem * root = new TestLazyItem(0, 1);
+    // loads the levels 0-2 completely, 1 + 3 + 9 + 27 items
+    for (std::size_t i = 0; i < root->childrenCount(); ++i) {
+        for (std::size_t j = 0; j < root->childAt(i)->childrenCount(); ++j) {
+            root->childAt(i)->childAt(j)->childrenCount();
+        }
+    }
+    ASSERT_EQ(40, TestLazyItem::instanceCreated);
+
+    // only the loaded items are checked, so nothing is loaded by the predicate.
+    std::vector<int> visited;
+    const std::size_t count = root->unloadIf([&](const TestLazyItem * item) {
+        visited.push_back(item->mMark);
+        return item->mLevel == 2 && item->mMark % 10 != 0;
+    });
+    ASSERT_EQ(std::size_t(6), count);
+    ASSERT_EQ(std::size_t(3 + 9), visited.size());
+    ASSERT_EQ(1 + 3 + 9 + 9, TestLazyItem::instanceCreated);
+    ASSERT_TRUE(root->childAt(0)->childAt(0)->isLoaded());
+    ASSERT_FALSE(root->childAt(0)->childAt(1)->isLoaded());
+
+    ASSERT_EQ(std::size_t(3), root->unloadIf([](const TestLazyItem *) { return true; }));
+    ASSERT_EQ(4, TestLazyItem::instanceCreated);
+
+    delete root;
+    ASSERT_EQ(0, TestLazyItem::instanceCreated);
+}
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+TEST(TestTreeItemLazy, loadingException) {
+    TestLazyItem::loadCalled = 0;
+    TestLazyItem * root = new TestLazyItem(0, 1);
+    TestLazyItem::throwingAfter = 2;
+    ASSERT_THROW(root->childrenCount(), std::runtime_error);
+    ASSERT_FALSE(root->isLoaded());
+    ASSERT_EQ(1, TestLazyItem::instanceCreated);
+
+    TestLazyItem::throwingAfter = -1;
+    ASSERT_EQ(3, root->childrenCount());
+    ASSERT_EQ(2, TestLazyItem::loadCalled);
+    delete root;
+    ASSERT_EQ(0, TestLazyItem::instanceCreated);
+}
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+TEST(TestTreeItemLazy, copy) {
+    TestLazyItem::loadCalled = 0;
+    TestLazyItem * root = new TestLazyItem(0, 1);
+    TestLazyItem * copy = root->clone();
+    ASSERT_FALSE(copy->isLoaded());
+    ASSERT_EQ(0, TestLazyItem::loadCalled);
+    ASSERT_EQ(3, copy->childrenCount());
+    ASSERT_FALSE(root->isLoaded());
+    delete copy;
+
+    root->childAt(2);
+    copy = root->clone();
+    ASSERT_TRUE(copy->isLoaded());
+    ASSERT_FALSE(copy->childAt(2)->isLoaded());
+    ASSERT_EQ(12, copy->childAt(2)->mMark);
+    ASSERT_EQ(2, TestLazyItem::loadCalled);
+    delete copy;
+
+    TestLazyItem * unloaded = new TestLazyItem(0, 2);
+    TestLazyItem moved(std::move(*unloaded));
+    ASSERT_FALSE(moved.isLoaded());
+    ASSERT_TRUE(unloaded->isLoaded());
+    ASSERT_EQ(0, unloaded->childrenCount());
+    ASSERT_EQ(20, moved.childAt(0)->mMark);
+    delete unloaded;
+
+    delete root;
+}
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
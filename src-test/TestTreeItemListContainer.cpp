@@ -27,16 +27,10 @@
 **  Contacts: www.steptosky.com
 */
 
+#include <vector>
 #include "gtest/gtest.h"
 #include "sts/tree/TreeItem.h"
 
-//#define PERFORMANCE_TEST
-#ifdef _DEBUG
-#define TEST_COUNT 2000
-#else
-#define TEST_COUNT 50000
-#endif // _DEBUG
-
 using namespace sts::tree;
 
 /**************************************************************************************************/
@@ -85,109 +79,6 @@ public:
 
 int TestTreeItemList::instanceCreated = 0;
 
-/**************************************************************************************************/
-////////////////////////////////////////////////////////////////////////////////////////////////////
-/**************************************************************************************************/
-#ifdef PERFORMANCE_TEST
-
-TEST(TestTreeItemList, prependPerformance){
-//---------------------------------
-    TestTreeItemList *treeRoot = new TestTreeItemList();
-    for (size_t i = 0; i < TEST_COUNT; ++i)
-        treeRoot->prependChild(new TestTreeItemList());
-//---------------------------------
-    ASSERT_EQ(TEST_COUNT + 1, TestTreeItemList::instanceCreated);
-    delete treeRoot;
-    ASSERT_EQ(0, TestTreeItemList::instanceCreated);
-}
-
-TEST(TestTreeItemList, appendPerformance){
-//---------------------------------
-    TestTreeItemList *treeRoot = new TestTreeItemList();
-    for (size_t i = 0; i < TEST_COUNT; ++i)
-        treeRoot->appendChild(new TestTreeItemList());
-//---------------------------------
-    ASSERT_EQ(TEST_COUNT + 1, TestTreeItemList::instanceCreated);
-    delete treeRoot;
-    ASSERT_EQ(0, TestTreeItemList::instanceCreated);
-}
-
-TEST(TestTreeItemList, insertPerformance){
-    TestTreeItemList *treeRoot = new TestTreeItemList();
-    for (size_t i = 0; i < TEST_COUNT / 2; ++i)
-        treeRoot->appendChild(new TestTreeItemList());
-//---------------------------------
-    for (size_t i = 0; i < TEST_COUNT; ++i)
-        treeRoot->insertChild(TEST_COUNT / 2, new TestTreeItemList());
-//---------------------------------
-    ASSERT_EQ(TEST_COUNT + 1 + (TEST_COUNT / 2), TestTreeItemList::instanceCreated);
-    delete treeRoot;
-    ASSERT_EQ(0, TestTreeItemList::instanceCreated);
-}
-
-TEST(TestTreeItemList, deleteRootPerformance){
-//---------------------------------
-    TestTreeItemList *treeRoot = new TestTreeItemList();
-    for (size_t i = 0; i < TEST_COUNT; ++i)
-        treeRoot->appendChild(new TestTreeItemList());
-//---------------------------------
-    ASSERT_EQ(TEST_COUNT + 1, TestTreeItemList::instanceCreated);
-    delete treeRoot;
-    ASSERT_EQ(0, TestTreeItemList::instanceCreated);
-}
-
-
-TEST(TestTreeItemList, deleteChildrenByPerformance){
-//---------------------------------
-    TestTreeItemList *treeRoot = new TestTreeItemList();
-    for (size_t i = 0; i < TEST_COUNT; ++i)
-        treeRoot->appendChild(new TestTreeItemList());
-//---------------------------------
-    ASSERT_EQ(TEST_COUNT + 1, TestTreeItemList::instanceCreated);
-    const TestTreeItemList::Children &children = treeRoot->children();
-    for (size_t i = 0; i < children.size(); ++i){
-        delete treeRoot->childAt(i);
-        --i;
-    }
-    ASSERT_EQ(1, TestTreeItemList::instanceCreated);
-    delete treeRoot;
-    ASSERT_EQ(0, TestTreeItemList::instanceCreated);
-}
-
-TEST(TestTreeItemList, deleteAllChildrenPerformance){
-//---------------------------------
-    TestTreeItemList *treeRoot = new TestTreeItemList();
-    for (size_t i = 0; i < TEST_COUNT; ++i)
-        treeRoot->appendChild(new TestTreeItemList());
-//---------------------------------
-    ASSERT_EQ(TEST_COUNT + 1, TestTreeItemList::instanceCreated);
-    treeRoot->deleteChildren();
-    ASSERT_EQ(1, TestTreeItemList::instanceCreated);
-    delete treeRoot;
-    ASSERT_EQ(0, TestTreeItemList::instanceCreated);
-}
-
-TEST(TestTreeItemList, iteratePerformance){
-//---------------------------------
-    TestTreeItemList *treeRoot = new TestTreeItemList();
-    for (size_t i = 0; i < TEST_COUNT; ++i)
-        treeRoot->appendChild(new TestTreeItemList());
-//---------------------------------
-    int i = 0;
-//---------------------------------
-    for (auto &item : treeRoot->children()){
-        if (item == nullptr)
-            continue;
-        item->mMark = i;
-        ++i;
-    }
-//---------------------------------
-    ASSERT_EQ(TEST_COUNT + 1, TestTreeItemList::instanceCreated);
-    delete treeRoot;
-    ASSERT_EQ(0, TestTreeItemList::instanceCreated);
-}
-
-#endif // PERFORMANCE_TEST
 /**************************************************************************************************/
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 /**************************************************************************************************/
@@ -264,6 +155,47 @@ TEST(TestTreeItemList, insert) {
     ASSERT_EQ(0, TestTreeItemList::instanceCreated);
 }
 
+TEST(TestTreeItemList, insertChildren) {
+    TestTreeItemList * treeRoot0 = new TestTreeItemList();
+    TestTreeItemList * treeRoot1 = new TestTreeItemList();
+    TestTreeItemList * tree0 = treeRoot0->appendChild(new TestTreeItemList);
+    TestTreeItemList * tree1 = treeRoot0->appendChild(new TestTreeItemList);
+    TestTreeItemList * tree2 = treeRoot1->appendChild(new TestTreeItemList);
+    TestTreeItemList * tree3 = treeRoot1->appendChild(new TestTreeItemList);
+    TestTreeItemList * tree4 = treeRoot1->appendChild(new TestTreeItemList);
+    TestTreeItemList * tree5 = new TestTreeItemList;
+    //---------------------------------
+    std::vector<TestTreeItemList*> items({tree4, tree5, tree2});
+    treeRoot0->reserveChildren(5);
+    treeRoot0->insertChildren(1, items.begin(), items.end());
+    ASSERT_EQ(5, treeRoot0->childrenCount());
+    ASSERT_TRUE(treeRoot0->childAt(0) == tree0);
+    ASSERT_TRUE(treeRoot0->childAt(1) == tree4);
+    ASSERT_TRUE(treeRoot0->childAt(2) == tree5);
+    ASSERT_TRUE(treeRoot0->childAt(3) == tree2);
+    ASSERT_TRUE(treeRoot0->childAt(4) == tree1);
+    ASSERT_TRUE(tree2->parent() == treeRoot0);
+    ASSERT_TRUE(tree4->parent() == treeRoot0);
+    ASSERT_TRUE(tree5->parent() == treeRoot0);
+    ASSERT_EQ(1, treeRoot1->childrenCount());
+    ASSERT_TRUE(treeRoot1->childAt(0) == tree3);
+    //---------------------------------
+    items = {tree0, tree1, tree3};
+    tree5->appendChildren(items.begin(), items.end());
+    ASSERT_EQ(3, treeRoot0->childrenCount());
+    ASSERT_EQ(0, treeRoot1->childrenCount());
+    ASSERT_EQ(3, tree5->childrenCount());
+    ASSERT_TRUE(tree5->childAt(0) == tree0);
+    ASSERT_TRUE(tree5->childAt(1) == tree1);
+    ASSERT_TRUE(tree5->childAt(2) == tree3);
+    ASSERT_TRUE(tree3->parent() == tree5);
+    ASSERT_TRUE(tree3->root() == treeRoot0);
+    ASSERT_EQ(8, TestTreeItemList::instanceCreated);
+    delete treeRoot0;
+    delete treeRoot1;
+    ASSERT_EQ(0, TestTreeItemList::instanceCreated);
+}
+
 TEST(TestTreeItemList, taking) {
     TestTreeItemList * treeRoot = new TestTreeItemList();
     TestTreeItemList * tree0 = treeRoot->appendChild(new TestTreeItemList);
@@ -349,6 +281,27 @@ TEST(TestTreeItemList, deleteChildren) {
     ASSERT_EQ(0, TestTreeItemList::instanceCreated);
 }
 
+TEST(TestTreeItemList, deleteDeep) {
+    // the depth is enough for the stack overflow if the children are deleted recursively.
+    const int depth = 500000;
+    TestTreeItemList * treeRoot = new TestTreeItemList();
+    TestTreeItemList * last = treeRoot;
+    for (int i = 0; i < depth; ++i) {
+        last = last->appendChild(new TestTreeItemList);
+    }
+    ASSERT_EQ(depth + 1, TestTreeItemList::instanceCreated);
+    treeRoot->childAt(0)->appendChild(new TestTreeItemList);
+    treeRoot->deleteChildren();
+    ASSERT_EQ(1, TestTreeItemList::instanceCreated);
+    //---------------------------------
+    last = treeRoot;
+    for (int i = 0; i < depth; ++i) {
+        last = last->appendChild(new TestTreeItemList);
+    }
+    delete treeRoot;
+    ASSERT_EQ(0, TestTreeItemList::instanceCreated);
+}
+
 TEST(TestTreeItemList, deleteChildByChild) {
     TestTreeItemList * treeRoot = new TestTreeItemList();
     treeRoot->appendChild(new TestTreeItemList);
@@ -0,0 +1,325 @@
+/*
+**  Copyright(C) 2018, StepToSky
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  1.Redistributions of source code must retain the above copyright notice, this
+**    list of conditions and the following disclaimer.
+**  2.Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and / or other materials provided with the distribution.
+**  3.Neither the name of StepToSky nor the names of its contributors
+**    may be used to endorse or promote products derived from this software
+**    without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**  DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**  Contacts: www.steptosky.com
+*/
+
+#include "gtest/gtest.h"
+#include <atomic>
+#include <cstdlib>
+#include <stdexcept>
+#include <vector>
+#include "sts/tree/TreeItem.h"
+#include "sts/tree/TreeItemParallel.h"
+#include "sts/tree/TreeItemStatic.h"
+#include "TestTreeItemRandom.h"
+
+using namespace sts::tree;
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+template<template<typename> class CONTAINER>
+class TestParallelItem : public TreeItem<TestParallelItem<CONTAINER>, CONTAINER<TestParallelItem<CONTAINER>>> {
+    typedef TreeItem<TestParallelItem<CONTAINER>, CONTAINER<TestParallelItem<CONTAINER>>> Base;
+public:
+
+    static std::atomic<int> instanceCreated;
+    static std::size_t throwingMark;
+
+    std::atomic<int> mVisited;
+    std::size_t mMark;
+
+    explicit TestParallelItem(std::size_t inMark = 0)
+        : mVisited(0),
+          mMark(inMark) {
+        ++instanceCreated;
+    }
+
+    TestParallelItem(const TestParallelItem & copy)
+        : Base(copy),
+          mVisited(0),
+          mMark(copy.mMark) {
+        if (mMark == throwingMark) {
+            throw std::runtime_error("test");
+        }
+        ++instanceCreated;
+    }
+
+    ~TestParallelItem() {
+        --instanceCreated;
+    }
+
+    TestParallelItem * clone() const override {
+        return new TestParallelItem(*this);
+    }
+
+    TestParallelItem & operator =(const TestParallelItem &) = delete;
+
+};
+
+template<template<typename> class CONTAINER>
+std::atomic<int> TestParallelItem<CONTAINER>::instanceCreated(0);
+template<template<typename> class CONTAINER>
+std::size_t TestParallelItem<CONTAINER>::throwingMark = std::size_t(-1);
+
+typedef TestParallelItem<TreeItemContainerVector> VectorItem;
+typedef TestParallelItem<TreeItemContainerList> ListItem;
+
+class StaticItem : public TreeItemStatic<StaticItem> {
+public:
+
+    std::atomic<int> mVisited;
+    std::size_t mMark;
+
+    explicit StaticItem(std::size_t inMark = 0)
+        : mVisited(0),
+          mMark(inMark) {}
+
+    StaticItem(const StaticItem & copy)
+        : TreeItemStatic<StaticItem>(copy),
+          mVisited(0),
+          mMark(copy.mMark) {}
+
+    StaticItem & operator =(const StaticItem &) = delete;
+
+};
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+/*
+ * One huge branch and a lot of small ones.
+ */
+template<typename ITEM>
+ITEM * skewedTree(const std::size_t count, std::vector<ITEM*> & outItems) {
+    outItems.clear();
+    outItems.push_back(new ITEM(0));
+    ITEM * branch = outItems.front()->appendChild(new ITEM(1));
+    outItems.push_back(branch);
+    for (std::size_t i = 2; i < count; ++i) {
+        ITEM * parent = i % 10 == 0 ? outItems.front() : outItems[1 + std::size_t(std::rand()) % (outItems.size() - 1)];
+        outItems.push_back(parent->appendChild(new ITEM(i)));
+    }
+    return outItems.front();
+}
+
+/*
+ * One long chain with a few short branches.
+ */
+template<typename ITEM>
+ITEM * deepTree(const std::size_t count, std::vector<ITEM*> & outItems) {
+    outItems.clear();
+    outItems.push_back(new ITEM(0));
+    for (std::size_t i = 1; i < count; ++i) {
+        outItems.push_back(outItems[i % 7 == 0 ? i - 2 : i - 1]->appendChild(new ITEM(i)));
+    }
+    return outItems.front();
+}
+
+template<typename ITEM>
+void checkSameHierarchy(const ITEM * expected, const ITEM * actual) {
+    ASSERT_TRUE(expected != actual);
+    ASSERT_TRUE(actual->parent() == nullptr);
+    std::vector<std::pair<const ITEM *, const ITEM *>> stack(1, std::make_pair(expected, actual));
+    while (!stack.empty()) {
+        const ITEM * e = stack.back().first;
+        const ITEM * a = stack.back().second;
+        stack.pop_back();
+        ASSERT_EQ(e->mMark, a->mMark);
+        ASSERT_EQ(e->childrenCount(), a->childrenCount());
+        for (std::size_t i = 0; i < e->childrenCount(); ++i) {
+            ASSERT_TRUE(a->childAt(i)->parent() == a);
+            stack.emplace_back(e->childAt(i), a->childAt(i));
+        }
+    }
+}
+
+template<typename ITEM>
+void checkCloning(ITEM * root) {
+    ITEM * serial = root->clone();
+    for (std::size_t threads = 1; threads <= 8; threads *= 2) {
+        for (std::size_t grain = 1; grain <= 1000; grain *= 10) {
+            ITEM * copy = parallelClone(root, threads, grain);
+            checkSameHierarchy(serial, copy);
+            delete copy;
+        }
+    }
+    delete serial;
+}
+
+template<typename ITEM>
+void checkCloning() {
+    std::vector<ITEM*> items;
+    std::srand(19);
+    ITEM * root = randomTree<ITEM>(20000, &items);
+    checkCloning(root);
+    // subtree only
+    ITEM * copy = TreeItemParallelCloner<ITEM>(4, 8).clone(items[1]);
+    checkSameHierarchy(items[1], copy);
+    delete copy;
+    delete root;
+
+    root = skewedTree<ITEM>(20000, items);
+    checkCloning(root);
+    delete root;
+
+    root = deepTree<ITEM>(100000, items);
+    checkCloning(root);
+    delete root;
+
+    // leaf
+    root = new ITEM(7);
+    copy = parallelClone(root, 4);
+    checkSameHierarchy(root, copy);
+    delete copy;
+    delete root;
+}
+
+template<typename ITEM>
+void checkVisitedOnce(const std::vector<ITEM*> & items) {
+    for (auto & it : items) {
+        ASSERT_EQ(1, it->mVisited.load());
+        it->mVisited = 0;
+    }
+}
+
+template<typename ITEM>
+void checkVisiting() {
+    std::vector<ITEM*> items;
+    std::srand(13);
+    ITEM * root = randomTree<ITEM>(20000, &items);
+    for (std::size_t threads = 1; threads <= 8; threads *= 2) {
+        for (std::size_t grain = 1; grain <= 1000; grain *= 10) {
+            parallelForEach(root, [](ITEM * item) { ++item->mVisited; }, threads, grain);
+            checkVisitedOnce(items);
+        }
+    }
+    // subtree only
+    parallelForEach(items[1], [](ITEM * item) { ++item->mVisited; }, 4, 8);
+    for (auto & it : items) {
+        ASSERT_EQ(it == items[1] || it->isChildOf(items[1]) ? 1 : 0, it->mVisited.load());
+        it->mVisited = 0;
+    }
+    delete root;
+
+    root = skewedTree<ITEM>(20000, items);
+    TreeItemParallelVisitor<const ITEM> visitor(4, 16);
+    std::atomic<std::size_t> sum(0);
+    visitor.visit(root, [&sum](const ITEM * item) { sum += item->mMark; });
+    ASSERT_EQ(std::size_t(20000) * 19999 / 2, sum.load());
+    delete root;
+}
+
+template<typename ITEM>
+void checkException() {
+    std::vector<ITEM*> items;
+    std::srand(17);
+    ITEM * root = randomTree<ITEM>(5000, &items);
+    ASSERT_THROW(parallelForEach(root, [](ITEM * item) {
+                     if (item->mMark == 4000) {
+                         throw std::runtime_error("test");
+                     }
+                 }, 4, 4), std::runtime_error);
+    ASSERT_THROW(parallelForEach(root, [](ITEM *) { throw std::logic_error("test"); }, 4, 4), std::logic_error);
+    delete root;
+}
+
+template<typename ITEM>
+void checkCloningException() {
+    std::vector<ITEM*> items;
+    std::srand(23);
+    ITEM * root = randomTree<ITEM>(5000, &items);
+    for (std::size_t mark : {std::size_t(0), std::size_t(1), std::size_t(4000)}) {
+        ITEM::throwingMark = mark;
+        ASSERT_THROW(parallelClone(root, 4, 4), std::runtime_error);
+        ASSERT_EQ(5000, ITEM::instanceCreated.load());
+    }
+    ITEM::throwingMark = std::size_t(-1);
+    delete root;
+    ASSERT_EQ(0, ITEM::instanceCreated.load());
+}
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+TEST(TestTreeItemParallel, visiting_vector) {
+    checkVisiting<VectorItem>();
+}
+
+TEST(TestTreeItemParallel, visiting_list) {
+    checkVisiting<ListItem>();
+}
+
+TEST(TestTreeItemParallel, exception) {
+    checkException<VectorItem>();
+}
+
+TEST(TestTreeItemParallel, cloning_vector) {
+    checkCloning<VectorItem>();
+    ASSERT_EQ(0, VectorItem::instanceCreated.load());
+}
+
+TEST(TestTreeItemParallel, cloning_list) {
+    checkCloning<ListItem>();
+    ASSERT_EQ(0, ListItem::instanceCreated.load());
+}
+
+TEST(TestTreeItemParallel, cloning_static) {
+    checkCloning<StaticItem>();
+}
+
+TEST(TestTreeItemParallel, cloning_exception) {
+    checkCloningException<VectorItem>();
+}
+
+TEST(TestTreeItemParallel, idle_threads) {
+    // more threads than work, most of them sleep until the tasks are shared or the work is done.
+    std::vector<VectorItem*> items;
+    VectorItem * root = deepTree<VectorItem>(500, items);
+    for (int i = 0; i < 20; ++i) {
+        parallelForEach(root, [](VectorItem * item) { ++item->mVisited; }, 32, 1);
+        checkVisitedOnce(items);
+    }
+    delete root;
+}
+
+TEST(TestTreeItemParallel, settings) {
+    TreeItemParallelVisitor<VectorItem> visitor(3, 0);
+    ASSERT_EQ(3, visitor.threadsCount());
+    ASSERT_EQ(1, visitor.grainSize());
+    visitor.setThreadsCount(0);
+    ASSERT_NE(0, visitor.threadsCount());
+    visitor.setGrainSize(100);
+    ASSERT_EQ(100, visitor.grainSize());
+}
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
@@ -0,0 +1,276 @@
+/*
+**  Copyright(C) 2018, StepToSky
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  1.Redistributions of source code must retain the above copyright notice, this
+**    list of conditions and the following disclaimer.
+**  2.Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and / or other materials provided with the distribution.
+**  3.Neither the name of StepToSky nor the names of its contributors
+**    may be used to endorse or promote products derived from this software
+**    without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**  DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**  Contacts: www.steptosky.com
+*/
+#include "gtest/gtest.h"
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "sts/tree/TreeItem.h"
+#include "sts/tree/TreeItemPersistent.h"
+
+using namespace sts::tree;
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+class TestPersistentItem : public TreeItem<TestPersistentItem> {
+public:
+
+    int mMark;
+
+    explicit TestPersistentItem(const int inMark = 0)
+        : mMark(inMark) {}
+
+};
+
+typedef TreeItemPersistent<std::string> Tree;
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+//----------------------------------------------
+//  +root
+//      child0
+//          child00
+//          child01
+//      child1
+//----------------------------------------------
+Tree makeTree() {
+    Tree tree("root");
+    tree.appendChild({}, "child0");
+    tree.appendChild({}, "child1");
+    tree.appendChild({0}, "child00");
+    tree.appendChild({0}, "child01");
+    return tree;
+}
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+TEST(TestTreeItemPersistent, access) {
+    const Tree tree = makeTree();
+    ASSERT_EQ("root", tree.root().value());
+    ASSERT_EQ(2, tree.root().childrenCount());
+    ASSERT_EQ("child1", tree.root().childAt(1)->value());
+    ASSERT_TRUE(tree.root().childAt(1)->isLeaf());
+    ASSERT_EQ("child01", tree.value({0, 1}));
+    ASSERT_EQ(tree.root().childAt(0)->childAt(0), tree.node({0, 0}));
+    ASSERT_TRUE(tree.node({2}) == nullptr);
+    ASSERT_TRUE(tree.node({1, 0}) == nullptr);
+    ASSERT_EQ(&tree.root(), tree.node({}));
+}
+
+TEST(TestTreeItemPersistent, changes) {
+    Tree tree = makeTree();
+    tree.insertChild({0}, 1, "child0x");
+    tree.setValue({1}, "child1x");
+    tree.removeChild({0}, 0);
+    ASSERT_EQ(2, tree.root().childAt(0)->childrenCount());
+    ASSERT_EQ("child0x", tree.value({0, 0}));
+    ASSERT_EQ("child01", tree.value({0, 1}));
+    ASSERT_EQ("child1x", tree.value({1}));
+    tree.removeChild({}, 0);
+    ASSERT_EQ(1, tree.root().childrenCount());
+    ASSERT_EQ("child1x", tree.value({0}));
+}
+
+TEST(TestTreeItemPersistent, snapshots) {
+    Tree tree = makeTree();
+    const Tree snapshot0 = tree.snapshot();
+    ASSERT_TRUE(tree.isSharedWith(snapshot0));
+
+    // the changed path is copied, the rest is shared.
+    tree.setValue({0, 1}, "child01x");
+    ASSERT_FALSE(tree.isSharedWith(snapshot0));
+    ASSERT_EQ("child01", snapshot0.value({0, 1}));
+    ASSERT_EQ("child01x", tree.value({0, 1}));
+    ASSERT_NE(snapshot0.node({0}), tree.node({0}));
+    ASSERT_NE(snapshot0.node({0, 1}), tree.node({0, 1}));
+    ASSERT_EQ(snapshot0.node({0, 0}), tree.node({0, 0}));
+    ASSERT_EQ(snapshot0.node({1}), tree.node({1}));
+
+    // the nodes which aren't shared any more are changed in place.
+    const Tree::Node * node01 = tree.node({0, 1});
+    tree.setValue({0, 1}, "child01y");
+    ASSERT_EQ(node01, tree.node({0, 1}));
+
+    const Tree snapshot1 = tree.snapshot();
+    tree.appendChild({1}, "child10");
+    tree.removeChild({0}, 0);
+    tree.insertChild({}, 0, "child");
+    ASSERT_EQ(3, tree.root().childrenCount());
+    ASSERT_EQ(1, tree.node({1})->childrenCount());
+    ASSERT_EQ("child10", tree.value({2, 0}));
+
+    ASSERT_EQ(2, snapshot1.root().childrenCount());
+    ASSERT_EQ(2, snapshot1.node({0})->childrenCount());
+    ASSERT_TRUE(snapshot1.node({1})->isLeaf());
+    ASSERT_EQ("child01y", snapshot1.value({0, 1}));
+    ASSERT_EQ("child01", snapshot0.value({0, 1}));
+    ASSERT_EQ(snapshot0.node({0, 0}), snapshot1.node({0, 0}));
+}
+
+TEST(TestTreeItemPersistent, copyAndMove) {
+    Tree tree = makeTree();
+    Tree copy(tree);
+    ASSERT_TRUE(copy.isSharedWith(tree));
+    Tree moved(std::move(copy));
+    ASSERT_TRUE(moved.isSharedWith(tree));
+    ASSERT_TRUE(copy.root().isLeaf());
+    copy = moved;
+    ASSERT_TRUE(copy.isSharedWith(tree));
+    moved.setValue({}, "moved");
+    copy = std::move(moved);
+    ASSERT_EQ("moved", copy.value({}));
+    ASSERT_EQ("root", tree.value({}));
+}
+
+TEST(TestTreeItemPersistent, build) {
+    TestPersistentItem * root = new TestPersistentItem(0);
+    TestPersistentItem * child0 = root->appendChild(new TestPersistentItem(1));
+    root->appendChild(new TestPersistentItem(2));
+    child0->appendChild(new TestPersistentItem(3));
+    const TreeItemPersistent<int> tree = TreeItemPersistent<int>::build(root, [](const TestPersistentItem * item) {
+        return item->mMark;
+    });
+    delete root;
+    ASSERT_EQ(0, tree.value({}));
+    ASSERT_EQ(2, tree.root().childrenCount());
+    ASSERT_EQ(1, tree.value({0}));
+    ASSERT_EQ(2, tree.value({1}));
+    ASSERT_EQ(3, tree.value({0, 0}));
+    ASSERT_TRUE(tree.node({1})->isLeaf());
+}
+
+TEST(TestTreeItemPersistent, deep) {
+    // the depth is enough for the stack overflow if the nodes are released recursively.
+    const int depth = 500000;
+    TestPersistentItem * root = new TestPersistentItem(0);
+    TestPersistentItem * last = root;
+    for (int i = 1; i <= depth; ++i) {
+        last = last->appendChild(new TestPersistentItem(i));
+    }
+    TreeItemPersistent<int> tree = TreeItemPersistent<int>::build(root, [](const TestPersistentItem * item) {
+        return item->mMark;
+    });
+    delete root;
+    const TreeItemPersistent<int>::Node * node = &tree.root();
+    for (int i = 0; i < depth; ++i) {
+        ASSERT_EQ(i, node->value());
+        node = node->childAt(0);
+    }
+    ASSERT_EQ(depth, node->value());
+
+    TreeItemPersistent<int> snapshot = tree.snapshot();
+    tree.removeChild({}, 0);
+    ASSERT_TRUE(tree.root().isLeaf());
+    ASSERT_EQ(1, snapshot.value({0}));
+    tree = snapshot;
+    snapshot = TreeItemPersistent<int>();
+    tree.removeChild({}, 0);
+    ASSERT_TRUE(tree.root().isLeaf());
+}
+
+TEST(TestTreeItemPersistent, snapshotsInThreads) {
+    // the readers check and release the snapshots while the tree is changed,
+    // the nodes which the released snapshots shared are changed in place.
+    const int width = 8;
+    const int versions = 300;
+    const int readersCount = 3;
+    TreeItemPersistent<int> tree(0);
+    std::vector<TreeItemPersistent<int>::Path> paths(1);
+    for (std::size_t i = 0; i < width; ++i) {
+        tree.appendChild({}, 0);
+        paths.push_back({i});
+        for (std::size_t j = 0; j < width; ++j) {
+            tree.appendChild({i}, 0);
+            paths.push_back({i, j});
+        }
+    }
+
+    std::mutex mutex;
+    std::deque<TreeItemPersistent<int>> snapshots;
+    bool done = false;
+    std::atomic<int> checked(0);
+    std::atomic<int> errors(0);
+    std::vector<std::thread> readers;
+    for (int r = 0; r < readersCount; ++r) {
+        readers.emplace_back([&]() {
+            for (;;) {
+                std::unique_lock<std::mutex> lock(mutex);
+                if (snapshots.empty()) {
+                    if (done) {
+                        return;
+                    }
+                    lock.unlock();
+                    std::this_thread::yield();
+                    continue;
+                }
+                TreeItemPersistent<int> snapshot(std::move(snapshots.front()));
+                snapshots.pop_front();
+                lock.unlock();
+                // all the nodes of a snapshot have the same version.
+                const int version = snapshot.root().value();
+                for (auto & path : paths) {
+                    if (snapshot.value(path) != version) {
+                        ++errors;
+                    }
+                }
+                ++checked;
+            }
+        });
+    }
+
+    for (int version = 1; version <= versions; ++version) {
+        for (auto & path : paths) {
+            tree.setValue(path, version);
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        snapshots.push_back(tree.snapshot());
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        done = true;
+    }
+    for (auto & it : readers) {
+        it.join();
+    }
+    ASSERT_EQ(0, errors);
+    ASSERT_EQ(versions, checked);
+    ASSERT_EQ(versions, tree.value({width - 1, width - 1}));
+}
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
@@ -0,0 +1,274 @@
+/*
+**  Copyright(C) 2018, StepToSky
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  1.Redistributions of source code must retain the above copyright notice, this
+**    list of conditions and the following disclaimer.
+**  2.Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and / or other materials provided with the distribution.
+**  3.Neither the name of StepToSky nor the names of its contributors
+**    may be used to endorse or promote products derived from this software
+**    without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**  DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**  Contacts: www.steptosky.com
+*/
+
+#include "gtest/gtest.h"
+#include "sts/tree/TreeItem.h"
+#include "sts/tree/TreeItemPool.h"
+#include "sts/tree/TreeItemStatic.h"
+
+using namespace sts::tree;
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+class TestPoolItem : public TreeItem<TestPoolItem>, public TreeItemPoolAllocated<TestPoolItem> {
+    typedef TreeItem<TestPoolItem> Base;
+public:
+
+    static int instanceCreated;
+    int mMark;
+
+    TestPoolItem * clone() const override {
+        TreeItemPool<TestPoolItem> * pool = itemPool();
+        if (pool) {
+            return new(*pool) TestPoolItem(*this);
+        }
+        return new TestPoolItem(*this);
+    }
+
+    TestPoolItem(int inMark = -1)
+        : mMark(inMark) {
+        ++instanceCreated;
+    }
+
+    TestPoolItem(const TestPoolItem & inTreeItem)
+        : Base(inTreeItem),
+          mMark(inTreeItem.mMark) {
+        ++instanceCreated;
+    }
+
+    ~TestPoolItem() {
+        --instanceCreated;
+    }
+
+private:
+
+    TestPoolItem & operator =(const TestPoolItem &) = delete;
+
+};
+
+int TestPoolItem::instanceCreated = 0;
+
+class TestPoolItemBig : public TestPoolItem {
+public:
+
+    char mData[256];
+
+};
+
+class TestPoolStaticItem : public TreeItemStatic<TestPoolStaticItem>, public TreeItemPoolAllocated<TestPoolStaticItem> {
+    typedef TreeItemStatic<TestPoolStaticItem> Base;
+    friend Base;
+public:
+
+    int mMark;
+
+    explicit TestPoolStaticItem(int inMark = -1)
+        : mMark(inMark) { }
+
+    TestPoolStaticItem(const TestPoolStaticItem & inTreeItem)
+        : Base(inTreeItem),
+          mMark(inTreeItem.mMark) { }
+
+private:
+
+    TestPoolStaticItem * clone() const {
+        TreeItemPool<TestPoolStaticItem> * pool = itemPool();
+        if (pool) {
+            return new(*pool) TestPoolStaticItem(*this);
+        }
+        return new TestPoolStaticItem(*this);
+    }
+
+    TestPoolStaticItem & operator =(const TestPoolStaticItem &) = delete;
+
+};
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+TEST(TestTreeItemPool, allocation) {
+    TreeItemPool<TestPoolItem> pool(4);
+    TestPoolItem * treeRoot = new(pool) TestPoolItem(0);
+    for (int i = 1; i < 10; ++i) {
+        treeRoot->appendChild(new(pool) TestPoolItem(i));
+    }
+    ASSERT_EQ(10, TestPoolItem::instanceCreated);
+    ASSERT_EQ(10, pool.itemsCount());
+    ASSERT_EQ(3, pool.slabsCount());
+    ASSERT_TRUE(treeRoot->itemPool() == &pool);
+    ASSERT_TRUE(treeRoot->childAt(5)->itemPool() == &pool);
+    //---------------------------------
+    treeRoot->deleteChild(std::size_t(0));
+    delete treeRoot->childAt(0);
+    ASSERT_EQ(8, pool.itemsCount());
+    // deleted items' memory is reused
+    treeRoot->appendChild(new(pool) TestPoolItem);
+    treeRoot->appendChild(new(pool) TestPoolItem);
+    treeRoot->appendChild(new(pool) TestPoolItem);
+    ASSERT_EQ(11, pool.itemsCount());
+    ASSERT_EQ(3, pool.slabsCount());
+    //---------------------------------
+    delete treeRoot;
+    ASSERT_EQ(0, TestPoolItem::instanceCreated);
+    ASSERT_EQ(0, pool.itemsCount());
+}
+
+TEST(TestTreeItemPool, reserve) {
+    TreeItemPool<TestPoolItem> pool(4);
+    pool.reserve(100);
+    TestPoolItem * treeRoot = new(pool) TestPoolItem;
+    for (int i = 0; i < 99; ++i) {
+        treeRoot->appendChild(new(pool) TestPoolItem);
+    }
+    ASSERT_EQ(1, pool.slabsCount());
+    treeRoot->appendChild(new(pool) TestPoolItem);
+    ASSERT_EQ(2, pool.slabsCount());
+    delete treeRoot;
+    ASSERT_EQ(0, pool.itemsCount());
+}
+
+TEST(TestTreeItemPool, release) {
+    TreeItemPool<TestPoolItem> pool(4);
+    TestPoolItem * treeRoot = new(pool) TestPoolItem(0);
+    for (int i = 1; i < 10; ++i) {
+        treeRoot->appendChild(new(pool) TestPoolItem(i))->appendChild(new TestPoolItem);
+    }
+    const TestPoolItem * first = treeRoot;
+    delete treeRoot->childAt(0);
+    pool.release(treeRoot);
+    ASSERT_EQ(0, TestPoolItem::instanceCreated);
+    ASSERT_EQ(0, pool.itemsCount());
+    ASSERT_EQ(3, pool.slabsCount());
+    //---------------------------------
+    // the slabs are reused from the beginning
+    treeRoot = new(pool) TestPoolItem(0);
+    ASSERT_TRUE(treeRoot == first);
+    for (int i = 1; i < 12; ++i) {
+        treeRoot->appendChild(new(pool) TestPoolItem(i));
+    }
+    ASSERT_EQ(3, pool.slabsCount());
+    pool.release(treeRoot);
+    //---------------------------------
+    // the reserved slab is bigger than the free ones
+    pool.reserve(10);
+    treeRoot = new(pool) TestPoolItem(0);
+    for (int i = 1; i < 14; ++i) {
+        treeRoot->appendChild(new(pool) TestPoolItem(i));
+    }
+    ASSERT_EQ(4, pool.slabsCount());
+    ASSERT_EQ(14, pool.itemsCount());
+    pool.release(treeRoot);
+    ASSERT_EQ(0, TestPoolItem::instanceCreated);
+}
+
+TEST(TestTreeItemPool, mixedAllocation) {
+    TreeItemPool<TestPoolItem> pool;
+    TestPoolItem * treeRoot = new TestPoolItem;
+    ASSERT_TRUE(treeRoot->itemPool() == nullptr);
+    TestPoolItem * tree0 = treeRoot->appendChild(new(pool) TestPoolItem);
+    TestPoolItem * tree1 = treeRoot->appendChild(new(pool) TestPoolItemBig);
+    TestPoolItem * tree2 = treeRoot->appendChild(new TestPoolItemBig);
+    ASSERT_TRUE(tree0->itemPool() == &pool);
+    ASSERT_TRUE(tree1->itemPool() == nullptr);
+    ASSERT_TRUE(tree2->itemPool() == nullptr);
+    ASSERT_EQ(1, pool.itemsCount());
+    delete treeRoot;
+    ASSERT_EQ(0, TestPoolItem::instanceCreated);
+    ASSERT_EQ(0, pool.itemsCount());
+}
+
+TEST(TestTreeItemPool, clone) {
+    TreeItemPool<TestPoolItem> pool;
+    TestPoolItem * treeRoot = new(pool) TestPoolItem(0);
+    treeRoot->appendChild(new(pool) TestPoolItem(1))->appendChild(new(pool) TestPoolItem(2));
+    treeRoot->appendChild(new(pool) TestPoolItem(3));
+    TestPoolItem * copy = treeRoot->clone();
+    ASSERT_EQ(8, pool.itemsCount());
+    ASSERT_TRUE(copy->itemPool() == &pool);
+    ASSERT_EQ(2, copy->childAt(0)->childAt(0)->mMark);
+    ASSERT_EQ(3, copy->childAt(1)->mMark);
+    delete treeRoot;
+    delete copy;
+    ASSERT_EQ(0, TestPoolItem::instanceCreated);
+    ASSERT_EQ(0, pool.itemsCount());
+}
+
+TEST(TestTreeItemPool, cloneDeep) {
+    // the depth is enough for the stack overflow if the children are cloned recursively.
+    const int depth = 500000;
+    TreeItemPool<TestPoolItem> pool;
+    TestPoolItem * treeRoot = new(pool) TestPoolItem(0);
+    TestPoolItem * last = treeRoot;
+    for (int i = 1; i <= depth; ++i) {
+        last = last->appendChild(new(pool) TestPoolItem(i));
+    }
+    // all the clones are in one slab.
+    const std::size_t slabs = pool.slabsCount();
+    pool.reserve(pool.itemsCount() * 2);
+    TestPoolItem * copy = treeRoot->clone();
+    ASSERT_EQ(slabs + 1, pool.slabsCount());
+    ASSERT_EQ(2 * (depth + 1), TestPoolItem::instanceCreated);
+    const TestPoolItem * item = copy;
+    for (int i = 0; i < depth; ++i) {
+        ASSERT_EQ(i, item->mMark);
+        ASSERT_EQ(1, item->childrenCount());
+        item = item->childAt(0);
+    }
+    ASSERT_EQ(depth, item->mMark);
+    ASSERT_TRUE(item->isLeaf());
+    delete treeRoot;
+    delete copy;
+    ASSERT_EQ(0, TestPoolItem::instanceCreated);
+}
+
+TEST(TestTreeItemPool, staticItem) {
+    TreeItemPool<TestPoolStaticItem> pool;
+    TestPoolStaticItem * treeRoot = new(pool) TestPoolStaticItem(0);
+    treeRoot->appendChild(new(pool) TestPoolStaticItem(1))->appendChild(new(pool) TestPoolStaticItem(2));
+    treeRoot->appendChild(new TestPoolStaticItem(3));
+    ASSERT_TRUE(treeRoot->itemPool() == &pool);
+    ASSERT_TRUE(treeRoot->childAt(1)->itemPool() == nullptr);
+    ASSERT_EQ(3, pool.itemsCount());
+    TestPoolStaticItem copy(*treeRoot);
+    ASSERT_EQ(5, pool.itemsCount());
+    ASSERT_TRUE(copy.childAt(0)->itemPool() == &pool);
+    ASSERT_TRUE(copy.childAt(1)->itemPool() == nullptr);
+    ASSERT_EQ(2, copy.childAt(0)->childAt(0)->mMark);
+    delete treeRoot;
+    ASSERT_EQ(2, pool.itemsCount());
+    copy.deleteChildren();
+    ASSERT_EQ(0, pool.itemsCount());
+}
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
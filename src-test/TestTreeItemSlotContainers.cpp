@@ -0,0 +1,413 @@
+/*
+**  Copyright(C) 2018, StepToSky
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  1.Redistributions of source code must retain the above copyright notice, this
+**    list of conditions and the following disclaimer.
+**  2.Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and / or other materials provided with the distribution.
+**  3.Neither the name of StepToSky nor the names of its contributors
+**    may be used to endorse or promote products derived from this software
+**    without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**  DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**  Contacts: www.steptosky.com
+*/
+
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <deque>
+#include <random>
+#include <vector>
+#include "sts/tree/TreeItem.h"
+#include "sts/tree/TreeItemContainerBTree.h"
+
+using namespace sts::tree;
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+template<typename TYPE>
+using TreeItemContainerSmallVector2 = TreeItemContainerSmallVector<TYPE, 2>;
+
+template<template<typename> class CONTAINER>
+class TestSlotItem : public TreeItem<TestSlotItem<CONTAINER>, CONTAINER<TestSlotItem<CONTAINER>>> {
+public:
+
+    static int instanceCreated;
+
+    TestSlotItem() {
+        ++instanceCreated;
+    }
+
+    ~TestSlotItem() {
+        --instanceCreated;
+    }
+
+private:
+
+    TestSlotItem & operator =(const TestSlotItem &) = delete;
+    TestSlotItem(const TestSlotItem &) = delete;
+
+};
+
+template<template<typename> class CONTAINER>
+int TestSlotItem<CONTAINER>::instanceCreated = 0;
+
+typedef TestSlotItem<TreeItemContainerVector> VectorItem;
+typedef TestSlotItem<TreeItemContainerList> ListItem;
+typedef TestSlotItem<TreeItemContainerSlotVector> SlotVectorItem;
+typedef TestSlotItem<TreeItemContainerSlotList> SlotListItem;
+typedef TestSlotItem<TreeItemContainerIntrusiveList> IntrusiveListItem;
+typedef TestSlotItem<TreeItemContainerBTree> BTreeItem;
+typedef TestSlotItem<TreeItemContainerSmallVector2> SmallVectorItem;
+typedef TestSlotItem<TreeItemContainerGapVector> GapVectorItem;
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+template<typename ITEM>
+void checkIndexes() {
+    ITEM * treeRoot = new ITEM();
+    ITEM * tree0 = treeRoot->appendChild(new ITEM);
+    ITEM * tree1 = treeRoot->appendChild(new ITEM);
+    ITEM * tree2 = treeRoot->prependChild(new ITEM);
+    ITEM * tree3 = treeRoot->insertChild(1, new ITEM);
+    ITEM * tree4 = treeRoot->appendChild(new ITEM);
+    //---------------------------------
+    ASSERT_EQ(6, ITEM::instanceCreated);
+    ASSERT_EQ(typename ITEM::Index(0), treeRoot->indexOf(tree2));
+    ASSERT_EQ(typename ITEM::Index(1), treeRoot->indexOf(tree3));
+    ASSERT_EQ(typename ITEM::Index(2), treeRoot->indexOf(tree0));
+    ASSERT_EQ(typename ITEM::Index(3), treeRoot->indexOf(tree1));
+    ASSERT_EQ(typename ITEM::Index(4), treeRoot->indexOf(tree4));
+    //---------------------------------
+    ASSERT_TRUE(treeRoot->takeChildAt(1) == tree3);
+    ASSERT_EQ(treeRoot->npos, treeRoot->indexOf(tree3));
+    ASSERT_EQ(typename ITEM::Index(1), treeRoot->indexOf(tree0));
+    ASSERT_EQ(typename ITEM::Index(3), treeRoot->indexOf(tree4));
+    ASSERT_EQ(treeRoot->npos, tree3->indexOf(tree0));
+    //---------------------------------
+    tree0->appendChild(tree3);
+    ASSERT_EQ(typename ITEM::Index(0), tree0->indexOf(tree3));
+    ASSERT_EQ(treeRoot->npos, treeRoot->indexOf(tree3));
+    //---------------------------------
+    delete tree1;
+    ASSERT_EQ(5, ITEM::instanceCreated);
+    ASSERT_EQ(typename ITEM::Index(0), treeRoot->indexOf(tree2));
+    ASSERT_EQ(typename ITEM::Index(1), treeRoot->indexOf(tree0));
+    ASSERT_EQ(typename ITEM::Index(2), treeRoot->indexOf(tree4));
+    ASSERT_EQ(3, treeRoot->childrenCount());
+    //---------------------------------
+    delete treeRoot;
+    ASSERT_EQ(0, ITEM::instanceCreated);
+}
+
+template<typename ITEM>
+void checkReparenting() {
+    ITEM * treeRoot0 = new ITEM();
+    ITEM * treeRoot1 = new ITEM();
+    for (int i = 0; i < 10; ++i) {
+        treeRoot0->appendChild(new ITEM);
+    }
+    ASSERT_EQ(12, ITEM::instanceCreated);
+    //---------------------------------
+    ITEM * tree5 = treeRoot0->childAt(5);
+    ITEM * tree9 = treeRoot0->childAt(9);
+    tree5->setParent(treeRoot1);
+    treeRoot1->prependChild(tree9);
+    treeRoot1->insertChild(1, treeRoot0->childAt(0));
+    ASSERT_EQ(7, treeRoot0->childrenCount());
+    ASSERT_EQ(3, treeRoot1->childrenCount());
+    ASSERT_EQ(typename ITEM::Index(0), treeRoot1->indexOf(tree9));
+    ASSERT_EQ(typename ITEM::Index(2), treeRoot1->indexOf(tree5));
+    ASSERT_EQ(treeRoot0->npos, treeRoot0->indexOf(tree5));
+    for (typename ITEM::Index i = 0; i < treeRoot0->childrenCount(); ++i) {
+        ASSERT_EQ(i, treeRoot0->indexOf(treeRoot0->childAt(i)));
+    }
+    //---------------------------------
+    while (treeRoot0->hasChildren()) {
+        treeRoot0->childAt(treeRoot0->childrenCount() / 2)->setParent(treeRoot1);
+    }
+    ASSERT_EQ(10, treeRoot1->childrenCount());
+    for (typename ITEM::Index i = 0; i < treeRoot1->childrenCount(); ++i) {
+        ASSERT_TRUE(treeRoot1->childAt(i)->parent() == treeRoot1);
+        ASSERT_EQ(i, treeRoot1->indexOf(treeRoot1->childAt(i)));
+    }
+    //---------------------------------
+    ASSERT_TRUE(treeRoot1->deleteChild(tree5));
+    ASSERT_FALSE(treeRoot0->deleteChild(tree9));
+    ASSERT_EQ(11, ITEM::instanceCreated);
+    delete treeRoot0;
+    delete treeRoot1;
+    ASSERT_EQ(0, ITEM::instanceCreated);
+}
+
+template<typename ITEM>
+void checkRandomChanges() {
+    ITEM * treeRoots[2] = {new ITEM(), new ITEM()};
+    for (int i = 0; i < 100; ++i) {
+        treeRoots[0]->appendChild(new ITEM);
+    }
+    std::size_t seed = 1;
+    for (int i = 0; i < 2000; ++i) {
+        seed = seed * 1103515245 + 12345;
+        ITEM * from = treeRoots[(seed >> 4) % 2];
+        ITEM * to = treeRoots[(seed >> 5) % 2];
+        if (!from->hasChildren()) {
+            from = (from == treeRoots[0]) ? treeRoots[1] : treeRoots[0];
+        }
+        ITEM * item = from->takeChildAt((seed >> 8) % from->childrenCount());
+        if ((seed >> 6) % 3 == 0) {
+            to->appendChild(item);
+        }
+        else {
+            to->insertChild((seed >> 16) % (to->childrenCount() + 1), item);
+        }
+        for (ITEM * treeRoot : treeRoots) {
+            for (typename ITEM::Index c = 0; c < treeRoot->childrenCount(); ++c) {
+                ASSERT_EQ(c, treeRoot->indexOf(treeRoot->childAt(c)));
+            }
+        }
+        ASSERT_EQ(treeRoots[0]->npos, (item->parent() == treeRoots[0] ? treeRoots[1] : treeRoots[0])->indexOf(item));
+    }
+    ASSERT_EQ(100, treeRoots[0]->childrenCount() + treeRoots[1]->childrenCount());
+    delete treeRoots[0];
+    delete treeRoots[1];
+    ASSERT_EQ(0, ITEM::instanceCreated);
+}
+
+template<typename ITEM>
+void checkBulkInsertion() {
+    ITEM * treeRoots[2] = {new ITEM(), new ITEM()};
+    std::vector<ITEM*> items;
+    for (int i = 0; i < 10; ++i) {
+        items.push_back(new ITEM);
+    }
+    treeRoots[0]->appendChildren(items.begin(), items.end());
+    items.clear();
+    for (int i = 0; i < 5; ++i) {
+        items.push_back(new ITEM);
+    }
+    treeRoots[0]->insertChildren(3, items.begin(), items.end());
+    ASSERT_EQ(15, treeRoots[0]->childrenCount());
+    ASSERT_EQ(typename ITEM::Index(3), treeRoots[0]->indexOf(items[0]));
+    //---------------------------------
+    items = {treeRoots[0]->childAt(14), treeRoots[0]->childAt(0), treeRoots[0]->childAt(7)};
+    treeRoots[1]->appendChildren(items.begin(), items.end());
+    items = {treeRoots[1]->childAt(1), treeRoots[0]->childAt(5), treeRoots[0]->childAt(6)};
+    treeRoots[1]->insertChildren(0, items.begin() + 1, items.end());
+    treeRoots[0]->insertChildren(2, items.begin(), items.begin() + 1);
+    ASSERT_EQ(11, treeRoots[0]->childrenCount());
+    ASSERT_EQ(4, treeRoots[1]->childrenCount());
+    for (ITEM * treeRoot : treeRoots) {
+        for (typename ITEM::Index c = 0; c < treeRoot->childrenCount(); ++c) {
+            ASSERT_TRUE(treeRoot->childAt(c)->parent() == treeRoot);
+            ASSERT_EQ(c, treeRoot->indexOf(treeRoot->childAt(c)));
+        }
+    }
+    ASSERT_EQ(typename ITEM::Index(2), treeRoots[0]->indexOf(items[0]));
+    ASSERT_EQ(typename ITEM::Index(0), treeRoots[1]->indexOf(items[1]));
+    ASSERT_EQ(treeRoots[0]->npos, treeRoots[0]->indexOf(items[1]));
+    ASSERT_EQ(17, ITEM::instanceCreated);
+    delete treeRoots[0];
+    delete treeRoots[1];
+    ASSERT_EQ(0, ITEM::instanceCreated);
+}
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+TEST(TestTreeItemSlotContainers, indexes_slotVector) {
+    checkIndexes<SlotVectorItem>();
+}
+
+TEST(TestTreeItemSlotContainers, indexes_slotList) {
+    checkIndexes<SlotListItem>();
+}
+
+TEST(TestTreeItemSlotContainers, reparenting_slotVector) {
+    checkReparenting<SlotVectorItem>();
+}
+
+TEST(TestTreeItemSlotContainers, reparenting_slotList) {
+    checkReparenting<SlotListItem>();
+}
+
+TEST(TestTreeItemSlotContainers, randomChanges_slotVector) {
+    checkRandomChanges<SlotVectorItem>();
+}
+
+TEST(TestTreeItemSlotContainers, randomChanges_slotList) {
+    checkRandomChanges<SlotListItem>();
+}
+
+TEST(TestTreeItemSlotContainers, bulkInsertion_slotVector) {
+    checkBulkInsertion<SlotVectorItem>();
+}
+
+TEST(TestTreeItemSlotContainers, bulkInsertion_slotList) {
+    checkBulkInsertion<SlotListItem>();
+}
+
+TEST(TestTreeItemSlotContainers, indexes_intrusiveList) {
+    checkIndexes<IntrusiveListItem>();
+}
+
+TEST(TestTreeItemSlotContainers, reparenting_intrusiveList) {
+    checkReparenting<IntrusiveListItem>();
+}
+
+TEST(TestTreeItemSlotContainers, randomChanges_intrusiveList) {
+    checkRandomChanges<IntrusiveListItem>();
+}
+
+TEST(TestTreeItemSlotContainers, bulkInsertion_intrusiveList) {
+    checkBulkInsertion<IntrusiveListItem>();
+}
+
+TEST(TestTreeItemSlotContainers, indexes_bTree) {
+    checkIndexes<BTreeItem>();
+}
+
+TEST(TestTreeItemSlotContainers, reparenting_bTree) {
+    checkReparenting<BTreeItem>();
+}
+
+TEST(TestTreeItemSlotContainers, randomChanges_bTree) {
+    checkRandomChanges<BTreeItem>();
+}
+
+TEST(TestTreeItemSlotContainers, bulkInsertion_bTree) {
+    checkBulkInsertion<BTreeItem>();
+}
+
+TEST(TestTreeItemSlotContainers, indexes_smallVector) {
+    checkIndexes<SmallVectorItem>();
+}
+
+TEST(TestTreeItemSlotContainers, reparenting_smallVector) {
+    checkReparenting<SmallVectorItem>();
+}
+
+TEST(TestTreeItemSlotContainers, randomChanges_smallVector) {
+    checkRandomChanges<SmallVectorItem>();
+}
+
+TEST(TestTreeItemSlotContainers, bulkInsertion_smallVector) {
+    checkBulkInsertion<SmallVectorItem>();
+}
+
+TEST(TestTreeItemSlotContainers, indexes_gapVector) {
+    checkIndexes<GapVectorItem>();
+}
+
+TEST(TestTreeItemSlotContainers, reparenting_gapVector) {
+    checkReparenting<GapVectorItem>();
+}
+
+TEST(TestTreeItemSlotContainers, randomChanges_gapVector) {
+    checkRandomChanges<GapVectorItem>();
+}
+
+TEST(TestTreeItemSlotContainers, bulkInsertion_gapVector) {
+    checkBulkInsertion<GapVectorItem>();
+}
+
+TEST(TestTreeItemSlotContainers, smallVector_inlineAndAllocated) {
+    int values[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+    TreeItemContainerSmallVector<int, 2> container;
+    container.push_back(&values[1]);
+    container.push_front(&values[0]);
+    ASSERT_EQ(2, container.size());
+
+    TreeItemContainerSmallVector<int, 2> moved(std::move(container));
+    ASSERT_TRUE(container.empty());
+    ASSERT_EQ(&values[0], moved[0]);
+    ASSERT_EQ(&values[1], moved[1]);
+
+    std::vector<int*> tail = {&values[3], &values[4], &values[5]};
+    moved.insert(2, tail.begin(), tail.end());
+    moved.insert(2, &values[2]);
+    ASSERT_EQ(6, moved.size());
+    for (std::size_t i = 0; i < moved.size(); ++i) {
+        ASSERT_EQ(&values[i], moved[i]);
+    }
+
+    container = std::move(moved);
+    ASSERT_TRUE(moved.empty());
+    ASSERT_EQ(6, container.size());
+    ASSERT_EQ(4, container.indexOf(&values[4]));
+    ASSERT_EQ(std::size_t(-1), container.indexOf(&values[7]));
+
+    ASSERT_TRUE(container.remove(&values[0]));
+    container.remove_if([](const int * v) { return *v % 2 == 0; });
+    ASSERT_EQ(3, container.size());
+    ASSERT_EQ(&values[1], container[0]);
+    ASSERT_EQ(&values[5], container[2]);
+
+    container.clear();
+    ASSERT_TRUE(container.empty());
+    container.push_back(&values[7]);
+    ASSERT_EQ(&values[7], *container.begin());
+}
+
+TEST(TestTreeItemSlotContainers, gapVector_bothEnds) {
+    std::vector<int> values(500);
+    std::deque<int*> model;
+    TreeItemContainerGapVector<int> container;
+    std::mt19937 random(7);
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        int * value = &values[i];
+        switch (random() % 4) {
+            case 0: container.push_front(value);
+                model.push_front(value);
+                break;
+            case 1: container.push_back(value);
+                model.push_back(value);
+                break;
+            case 2: {
+                const std::size_t index = random() % (model.size() + 1);
+                container.insert(index, value);
+                model.insert(model.begin() + std::ptrdiff_t(index), value);
+                break;
+            }
+            default: if (!model.empty()) {
+                    const std::size_t index = random() % model.size();
+                    ASSERT_EQ(model[index], container.erase(index));
+                    model.erase(model.begin() + std::ptrdiff_t(index));
+                }
+                break;
+        }
+        ASSERT_EQ(model.size(), container.size());
+        ASSERT_TRUE(std::equal(model.begin(), model.end(), container.begin()));
+    }
+
+    TreeItemContainerGapVector<int> moved(std::move(container));
+    ASSERT_TRUE(container.empty());
+    ASSERT_TRUE(std::equal(model.begin(), model.end(), moved.begin()));
+    moved.clear();
+    moved.push_front(&values[0]);
+    ASSERT_EQ(1, moved.size());
+    ASSERT_EQ(&values[0], moved[0]);
+}
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
@@ -0,0 +1,263 @@
+/*
+**  Copyright(C) 2018, StepToSky
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  1.Redistributions of source code must retain the above copyright notice, this
+**    list of conditions and the following disclaimer.
+**  2.Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and / or other materials provided with the distribution.
+**  3.Neither the name of StepToSky nor the names of its contributors
+**    may be used to endorse or promote products derived from this software
+**    without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**  DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**  Contacts: www.steptosky.com
+*/
+
+#include "gtest/gtest.h"
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "sts/tree/TreeItemStatic.h"
+#include "sts/tree/TreeItemTraversal.h"
+
+using namespace sts::tree;
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+class TestStaticItem : public TreeItemStatic<TestStaticItem> {
+    typedef TreeItemStatic<TestStaticItem> Base;
+    friend Base;
+public:
+
+    static int instanceCreated;
+    int mMark;
+    std::vector<int> mNotifications;
+
+    explicit TestStaticItem(int inMark = -1)
+        : mMark(inMark) {
+        ++instanceCreated;
+    }
+
+    TestStaticItem(const TestStaticItem & copy)
+        : Base(copy),
+          mMark(copy.mMark) {
+        ++instanceCreated;
+    }
+
+    TestStaticItem(TestStaticItem && other)
+        : Base(std::move(other)),
+          mMark(other.mMark) {
+        ++instanceCreated;
+    }
+
+    TestStaticItem & operator =(const TestStaticItem & copy) {
+        Base::operator=(copy);
+        mMark = copy.mMark;
+        return *this;
+    }
+
+    TestStaticItem & operator =(TestStaticItem && other) {
+        Base::operator=(std::move(other));
+        mMark = other.mMark;
+        return *this;
+    }
+
+    ~TestStaticItem() {
+        --instanceCreated;
+    }
+
+protected:
+
+    void childAdded(TestStaticItem * child) {
+        mNotifications.push_back(child->mMark);
+        ASSERT_TRUE(child->parent() == this);
+    }
+
+    void childRemoved(TestStaticItem * child) {
+        mNotifications.push_back(-child->mMark);
+        ASSERT_TRUE(child->parent() == nullptr);
+        ASSERT_TRUE(indexOf(child) == npos);
+    }
+
+};
+
+int TestStaticItem::instanceCreated = 0;
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+TEST(TestTreeItemStatic, noVirtualTable) {
+    ASSERT_FALSE(std::is_polymorphic<TestStaticItem>::value);
+    ASSERT_EQ(sizeof(TreeItemStatic<TestStaticItem>::Children) + 2 * sizeof(void*), sizeof(TreeItemStatic<TestStaticItem>));
+}
+
+TEST(TestTreeItemStatic, changes) {
+    TestStaticItem * treeRoot = new TestStaticItem();
+    TestStaticItem * tree1 = treeRoot->appendChild(new TestStaticItem(1));
+    TestStaticItem * tree0 = treeRoot->prependChild(new TestStaticItem(0));
+    TestStaticItem * tree2 = treeRoot->insertChild(1, new TestStaticItem(2));
+    ASSERT_EQ(4, TestStaticItem::instanceCreated);
+    ASSERT_EQ(3, treeRoot->childrenCount());
+    ASSERT_EQ(tree0, treeRoot->childAt(0));
+    ASSERT_EQ(tree2, treeRoot->childAt(1));
+    ASSERT_EQ(tree1, treeRoot->childAt(2));
+    ASSERT_EQ(2, treeRoot->indexOf(tree1));
+    ASSERT_EQ(treeRoot, tree2->root());
+    ASSERT_TRUE(tree2->isChildOf(treeRoot));
+
+    tree1->setParent(tree0);
+    ASSERT_EQ(treeRoot, tree1->root());
+    ASSERT_EQ(tree0, tree1->parent());
+    ASSERT_TRUE(tree0->isBranch());
+
+    TestStaticItem * taken = treeRoot->takeChildAt(1);
+    ASSERT_TRUE(taken->isRoot());
+    delete taken;
+    ASSERT_TRUE(treeRoot->deleteChild(tree0));
+    ASSERT_EQ(1, TestStaticItem::instanceCreated);
+    ASSERT_EQ(std::vector<int>({1, 0, 2, -1, -2, 0}), treeRoot->mNotifications);
+    delete treeRoot;
+    ASSERT_EQ(0, TestStaticItem::instanceCreated);
+}
+
+TEST(TestTreeItemStatic, bulk) {
+    TestStaticItem treeRoot0;
+    TestStaticItem treeRoot1;
+    TestStaticItem * tree1 = treeRoot1.appendChild(new TestStaticItem(1));
+    TestStaticItem * tree2 = treeRoot1.appendChild(new TestStaticItem(2));
+    TestStaticItem * tree3 = new TestStaticItem(3);
+    std::vector<TestStaticItem*> items({tree2, tree3, tree1});
+    treeRoot0.appendChildren(items.begin(), items.end());
+    ASSERT_EQ(std::vector<int>({2, 3, 1}), treeRoot0.mNotifications);
+    ASSERT_EQ(std::vector<int>({1, 2, -2, -1}), treeRoot1.mNotifications);
+    ASSERT_FALSE(treeRoot1.hasChildren());
+    ASSERT_EQ(3, treeRoot0.childrenCount());
+    treeRoot0.deleteChildren();
+    ASSERT_EQ(2, TestStaticItem::instanceCreated);
+}
+
+TEST(TestTreeItemStatic, deleteDeep) {
+    // the depth is enough for the stack overflow if the children are deleted recursively.
+    const int depth = 500000;
+    TestStaticItem * treeRoot = new TestStaticItem();
+    TestStaticItem * last = treeRoot;
+    for (int i = 0; i < depth; ++i) {
+        last = last->appendChild(new TestStaticItem);
+    }
+    ASSERT_EQ(depth + 1, TestStaticItem::instanceCreated);
+    delete treeRoot;
+    ASSERT_EQ(0, TestStaticItem::instanceCreated);
+}
+
+TEST(TestTreeItemStatic, copy) {
+    TestStaticItem * treeRoot = new TestStaticItem(0);
+    treeRoot->appendChild(new TestStaticItem(1))->appendChild(new TestStaticItem(2));
+    treeRoot->appendChild(new TestStaticItem(3));
+
+    TestStaticItem * treeCopy = new TestStaticItem(*treeRoot);
+    ASSERT_EQ(8, TestStaticItem::instanceCreated);
+    ASSERT_EQ(2, treeCopy->childrenCount());
+    ASSERT_TRUE(treeCopy->childAt(0) != treeRoot->childAt(0));
+    ASSERT_EQ(1, treeCopy->childAt(0)->mMark);
+    ASSERT_EQ(2, treeCopy->childAt(0)->childAt(0)->mMark);
+    ASSERT_EQ(3, treeCopy->childAt(1)->mMark);
+
+    TestStaticItem * clone = treeRoot->childAt(0)->clone();
+    ASSERT_TRUE(clone->isRoot());
+    ASSERT_EQ(1, clone->childrenCount());
+    delete clone;
+
+    *treeRoot = *treeCopy->childAt(0);
+    ASSERT_EQ(1, treeRoot->mMark);
+    ASSERT_EQ(1, treeRoot->childrenCount());
+    ASSERT_EQ(2, treeRoot->childAt(0)->mMark);
+    delete treeRoot;
+    delete treeCopy;
+    ASSERT_EQ(0, TestStaticItem::instanceCreated);
+}
+
+TEST(TestTreeItemStatic, copyDeep) {
+    // the depth is enough for the stack overflow if the children are cloned recursively.
+    const int depth = 500000;
+    TestStaticItem * treeRoot = new TestStaticItem(0);
+    TestStaticItem * last = treeRoot;
+    for (int i = 1; i <= depth; ++i) {
+        last = last->appendChild(new TestStaticItem(i));
+    }
+    TestStaticItem * copy = treeRoot->clone();
+    ASSERT_EQ(2 * (depth + 1), TestStaticItem::instanceCreated);
+    const TestStaticItem * item = copy;
+    for (int i = 0; i < depth; ++i) {
+        ASSERT_EQ(i, item->mMark);
+        item = item->childAt(0);
+    }
+    ASSERT_EQ(depth, item->mMark);
+    ASSERT_TRUE(item->isLeaf());
+    delete treeRoot;
+    delete copy;
+    ASSERT_EQ(0, TestStaticItem::instanceCreated);
+}
+
+TEST(TestTreeItemStatic, move) {
+    TestStaticItem * treeRoot = new TestStaticItem(0);
+    TestStaticItem * tree1 = treeRoot->appendChild(new TestStaticItem(1));
+    TestStaticItem * tree2 = tree1->appendChild(new TestStaticItem(2));
+    tree2->appendChild(new TestStaticItem(3));
+
+    TestStaticItem * moved = new TestStaticItem(std::move(*tree1));
+    ASSERT_EQ(5, TestStaticItem::instanceCreated);
+    ASSERT_TRUE(moved->isRoot());
+    ASSERT_TRUE(tree2->parent() == moved);
+    ASSERT_FALSE(tree1->hasChildren());
+    ASSERT_EQ(std::vector<int>({2, -2}), tree1->mNotifications);
+
+    *treeRoot = std::move(*moved);
+    ASSERT_EQ(4, TestStaticItem::instanceCreated);
+    ASSERT_EQ(1, treeRoot->childrenCount());
+    ASSERT_TRUE(treeRoot->childAt(0) == tree2);
+    ASSERT_TRUE(tree2->root() == treeRoot);
+    ASSERT_EQ(std::vector<int>({1, -1, 2}), treeRoot->mNotifications);
+    ASSERT_EQ(std::vector<int>({-2}), moved->mNotifications); // the constructor doesn't notify
+
+    delete treeRoot;
+    delete moved;
+    ASSERT_EQ(0, TestStaticItem::instanceCreated);
+}
+
+TEST(TestTreeItemStatic, traversal) {
+    TestStaticItem treeRoot(0);
+    TestStaticItem * tree1 = treeRoot.appendChild(new TestStaticItem(1));
+    tree1->appendChild(new TestStaticItem(2));
+    treeRoot.appendChild(new TestStaticItem(3));
+    std::vector<int> marks;
+    for (const TestStaticItem * item : preorder(static_cast<const TestStaticItem *>(&treeRoot))) {
+        marks.push_back(item->mMark);
+    }
+    ASSERT_EQ(std::vector<int>({0, 1, 2, 3}), marks);
+    marks.clear();
+    for (TestStaticItem * item : postorder(&treeRoot)) {
+        marks.push_back(item->mMark);
+    }
+    ASSERT_EQ(std::vector<int>({2, 1, 3, 0}), marks);
+}
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
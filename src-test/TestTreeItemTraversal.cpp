@@ -0,0 +1,271 @@
+/*
+**  Copyright(C) 2018, StepToSky
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  1.Redistributions of source code must retain the above copyright notice, this
+**    list of conditions and the following disclaimer.
+**  2.Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and / or other materials provided with the distribution.
+**  3.Neither the name of StepToSky nor the names of its contributors
+**    may be used to endorse or promote products derived from this software
+**    without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**  DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**  ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+**  ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**  Contacts: www.steptosky.com
+*/
+
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <cstdlib>
+#include <deque>
+#include <iterator>
+#include <vector>
+#include "sts/tree/TreeItem.h"
+#include "sts/tree/TreeItemContainerBTree.h"
+#include "sts/tree/TreeItemTraversal.h"
+#include "TestTreeItemRandom.h"
+
+using namespace sts::tree;
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+template<typename TYPE>
+using TreeItemContainerSmallVector2 = TreeItemContainerSmallVector<TYPE, 2>;
+
+template<template<typename> class CONTAINER>
+class TestWalkItem : public TreeItem<TestWalkItem<CONTAINER>, CONTAINER<TestWalkItem<CONTAINER>>> {
+public:
+
+    static int instanceCreated;
+    int mMark;
+
+    explicit TestWalkItem(int inMark = -1)
+        : mMark(inMark) {
+        ++instanceCreated;
+    }
+
+    ~TestWalkItem() {
+        --instanceCreated;
+    }
+
+};
+
+template<template<typename> class CONTAINER>
+int TestWalkItem<CONTAINER>::instanceCreated = 0;
+
+typedef TestWalkItem<TreeItemContainerVector> VectorItem;
+typedef TestWalkItem<TreeItemContainerList> ListItem;
+typedef TestWalkItem<TreeItemContainerIntrusiveList> IntrusiveListItem;
+typedef TestWalkItem<TreeItemContainerBTree> BTreeItem;
+typedef TestWalkItem<TreeItemContainerSmallVector2> SmallVectorItem;
+typedef TestWalkItem<TreeItemContainerGapVector> GapVectorItem;
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+/*
+ * Chain where each chain item has a leaf sibling, the last chain item has a lot of children.
+ */
+template<typename ITEM>
+ITEM * deepTree(const int depth) {
+    ITEM * root = new ITEM(0);
+    ITEM * item = root;
+    for (int i = 1; i < depth; ++i) {
+        item->appendChild(new ITEM(-i));
+        item = item->prependChild(new ITEM(i));
+    }
+    for (int i = 0; i < 100; ++i) {
+        item->appendChild(new ITEM(depth + i));
+    }
+    return root;
+}
+
+template<typename ITEM>
+void preorderRecursive(const ITEM * item, std::vector<int> & outMarks) {
+    outMarks.push_back(item->mMark);
+    for (auto & it : item->children()) {
+        preorderRecursive<ITEM>(it, outMarks);
+    }
+}
+
+template<typename ITEM>
+void postorderRecursive(const ITEM * item, std::vector<int> & outMarks) {
+    for (auto & it : item->children()) {
+        postorderRecursive<ITEM>(it, outMarks);
+    }
+    outMarks.push_back(item->mMark);
+}
+
+template<typename ITEM>
+std::vector<int> levelorderQueue(const ITEM * root) {
+    std::vector<int> marks;
+    std::deque<const ITEM*> queue(1, root);
+    while (!queue.empty()) {
+        const ITEM * item = queue.front();
+        queue.pop_front();
+        marks.push_back(item->mMark);
+        for (auto & it : item->children()) {
+            queue.push_back(it);
+        }
+    }
+    return marks;
+}
+
+template<typename RANGE>
+std::vector<int> marksOf(const RANGE & range) {
+    std::vector<int> marks;
+    for (auto item : range) {
+        marks.push_back(item->mMark);
+    }
+    return marks;
+}
+
+template<typename ITEM>
+void checkOrders(ITEM * root) {
+    std::vector<int> expected;
+    preorderRecursive<ITEM>(root, expected);
+    ASSERT_EQ(expected, marksOf(preorder(root)));
+    ASSERT_EQ(expected, marksOf(preorder(static_cast<const ITEM *>(root))));
+
+    expected.clear();
+    postorderRecursive<ITEM>(root, expected);
+    ASSERT_EQ(expected, marksOf(postorder(root)));
+    ASSERT_EQ(expected, marksOf(postorder(static_cast<const ITEM *>(root))));
+
+    expected = levelorderQueue<ITEM>(root);
+    ASSERT_EQ(expected, marksOf(levelorder(root)));
+    ASSERT_EQ(expected, marksOf(levelorder(static_cast<const ITEM *>(root))));
+    ASSERT_EQ(expected, marksOf(levelorder(root, 64)));
+    ASSERT_EQ(expected, marksOf(levelorderInPlace(root)));
+    ASSERT_EQ(expected, marksOf(levelorderInPlace(static_cast<const ITEM *>(root))));
+}
+
+template<typename ITEM>
+void checkRandom() {
+    std::srand(3);
+    for (int i = 1; i < 50; i += 7) {
+        ITEM * root = randomTree<ITEM>(std::size_t(i * 10));
+        checkOrders(root);
+        delete root;
+    }
+    ASSERT_EQ(0, ITEM::instanceCreated);
+}
+
+template<typename ITEM>
+void checkDeep() {
+    ITEM * root = deepTree<ITEM>(100);
+    checkOrders(root);
+    // subtree walking doesn't go above its root
+    ITEM * subtree = root->childAt(0)->childAt(0);
+    checkOrders(subtree);
+    delete root;
+    ASSERT_EQ(0, ITEM::instanceCreated);
+}
+
+template<typename ITEM>
+void checkIterators() {
+    ITEM * root = new ITEM(0);
+    ASSERT_EQ(std::vector<int>({0}), marksOf(preorder(root)));
+    ASSERT_EQ(std::vector<int>({0}), marksOf(postorder(root)));
+    ASSERT_EQ(std::vector<int>({0}), marksOf(levelorder(root)));
+    ASSERT_EQ(std::vector<int>({0}), marksOf(levelorderInPlace(root)));
+
+    root->appendChild(new ITEM(1))->appendChild(new ITEM(3));
+    root->appendChild(new ITEM(2));
+    auto range = preorder(root);
+    ASSERT_EQ(4, std::distance(range.begin(), range.end()));
+    auto found = std::find_if(range.begin(), range.end(), [](const ITEM * item) { return item->mMark == 3; });
+    ASSERT_TRUE(found != range.end());
+    ASSERT_EQ(3, (*found)->mMark);
+    auto it = range.begin();
+    auto prev = it++;
+    ASSERT_EQ(0, (*prev)->mMark);
+    ASSERT_EQ(1, (*it)->mMark);
+    ASSERT_EQ(1, (*range.begin().operator++())->mMark);
+    ASSERT_EQ(std::vector<int>({0, 1, 2, 3}), marksOf(levelorder(root)));
+    ASSERT_EQ(std::vector<int>({0, 1, 2, 3}), marksOf(levelorderInPlace(root)));
+    ASSERT_EQ(std::vector<int>({3, 1, 2, 0}), marksOf(postorder(root)));
+
+    delete root;
+    ASSERT_EQ(0, ITEM::instanceCreated);
+}
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/
+
+TEST(TestTreeItemTraversal, random_vector) {
+    checkRandom<VectorItem>();
+}
+
+TEST(TestTreeItemTraversal, random_list) {
+    checkRandom<ListItem>();
+}
+
+TEST(TestTreeItemTraversal, deep_vector) {
+    checkDeep<VectorItem>();
+}
+
+TEST(TestTreeItemTraversal, deep_list) {
+    checkDeep<ListItem>();
+}
+
+TEST(TestTreeItemTraversal, iterators_vector) {
+    checkIterators<VectorItem>();
+}
+
+TEST(TestTreeItemTraversal, iterators_list) {
+    checkIterators<ListItem>();
+}
+
+TEST(TestTreeItemTraversal, random_intrusiveList) {
+    checkRandom<IntrusiveListItem>();
+}
+
+TEST(TestTreeItemTraversal, deep_intrusiveList) {
+    checkDeep<IntrusiveListItem>();
+}
+
+TEST(TestTreeItemTraversal, random_bTree) {
+    checkRandom<BTreeItem>();
+}
+
+TEST(TestTreeItemTraversal, deep_bTree) {
+    checkDeep<BTreeItem>();
+}
+
+TEST(TestTreeItemTraversal, random_smallVector) {
+    checkRandom<SmallVectorItem>();
+}
+
+TEST(TestTreeItemTraversal, deep_smallVector) {
+    checkDeep<SmallVectorItem>();
+}
+
+TEST(TestTreeItemTraversal, random_gapVector) {
+    checkRandom<GapVectorItem>();
+}
+
+TEST(TestTreeItemTraversal, deep_gapVector) {
+    checkDeep<GapVectorItem>();
+}
+
+/**************************************************************************************************/
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/**************************************************************************************************/